@@ -0,0 +1,8 @@
+// Runtime linked with the object files produced by the Colt compiler
+// for ahead-of-time runs of the benchmarks.
+// 'main' is provided by the Colt object file.
+#include <cstdio>
+#include <cstdint>
+
+extern "C" void _ColtPrinti64(std::int64_t value) { std::printf("%lld\n", static_cast<long long>(value)); }
+extern "C" void _ColtPrintu64(std::uint64_t value) { std::printf("%llu\n", static_cast<unsigned long long>(value)); }
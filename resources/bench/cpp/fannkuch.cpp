@@ -0,0 +1,50 @@
+// C++ baseline of 'fannkuch.ct' (fannkuch-redux).
+#include <cstdio>
+
+int main()
+{
+  const long long n = 10;
+  long long perm[n], perm1[n], count[n];
+  for (long long i = 0; i < n; i++)
+    perm1[i] = i;
+  long long r = n, max_flips = 0, checksum = 0, perm_count = 0;
+  for (;;)
+  {
+    for (; r != 1; r--)
+      count[r - 1] = r;
+    for (long long i = 0; i < n; i++)
+      perm[i] = perm1[i];
+    long long flips = 0;
+    for (long long k = perm[0]; k != 0; k = perm[0])
+    {
+      long long k2 = (k + 1) >> 1;
+      for (long long i = 0; i < k2; i++)
+      {
+        long long t = perm[i];
+        perm[i] = perm[k - i];
+        perm[k - i] = t;
+      }
+      flips++;
+    }
+    if (flips > max_flips)
+      max_flips = flips;
+    checksum += perm_count % 2 == 0 ? flips : -flips;
+    //Next permutation
+    for (;;)
+    {
+      if (r == n)
+      {
+        std::printf("%lld\n%lld\n", checksum, max_flips);
+        return 0;
+      }
+      long long perm0 = perm1[0];
+      for (long long i = 0; i < r; i++)
+        perm1[i] = perm1[i + 1];
+      perm1[r] = perm0;
+      if (--count[r] > 0)
+        break;
+      r++;
+    }
+    perm_count++;
+  }
+}
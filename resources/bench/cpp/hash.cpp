@@ -0,0 +1,54 @@
+// C++ baseline of 'hash.ct': open addressing (linear probing) inserts.
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+  std::uint64_t rng_state = 88172645463325252u;
+
+  std::uint64_t NextRandom()
+  {
+    std::uint64_t x = rng_state;
+    x = x ^ (x >> 12);
+    x = x ^ (x << 25);
+    x = x ^ (x >> 27);
+    rng_state = x;
+    return x * 2685821657736338717u;
+  }
+
+  std::uint64_t Hash(std::uint64_t k)
+  {
+    k = k ^ (k >> 33);
+    k = k * 18397679294719823053u;
+    k = k ^ (k >> 33);
+    k = k * 14181476777654086739u;
+    return k ^ (k >> 33);
+  }
+}
+
+int main()
+{
+  const std::uint64_t size = std::uint64_t(1) << 22;
+  const std::uint64_t mask = size - 1;
+  auto table = static_cast<std::uint64_t*>(std::calloc(size, 8));
+  std::uint64_t distinct = 0, probes = 0;
+  for (std::uint64_t inserted = 0; inserted < 10000000; inserted++)
+  {
+    std::uint64_t key = NextRandom() % 3000000 + 1;
+    for (std::uint64_t slot = Hash(key) & mask;; slot = (slot + 1) & mask)
+    {
+      probes++;
+      if (table[slot] == 0)
+      {
+        table[slot] = key;
+        distinct++;
+        break;
+      }
+      if (table[slot] == key)
+        break;
+    }
+  }
+  std::printf("%llu\n%llu\n", static_cast<unsigned long long>(distinct), static_cast<unsigned long long>(probes));
+  std::free(table);
+}
@@ -0,0 +1,45 @@
+// C++ baseline of 'hash_map.ct': counting and looking up keys in 'std::unordered_map'.
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+  std::uint64_t rng_state = 88172645463325252u;
+
+  std::uint64_t NextRandom()
+  {
+    std::uint64_t x = rng_state;
+    x = x ^ (x >> 12);
+    x = x ^ (x << 25);
+    x = x ^ (x >> 27);
+    rng_state = x;
+    return x * 2685821657736338717u;
+  }
+}
+
+int main()
+{
+  std::unordered_map<std::uint64_t, std::uint64_t> counts;
+  for (std::uint64_t inserted = 0; inserted < 10000000; inserted++)
+    counts[NextRandom() % 3000000 + 1] += 1;
+
+  std::vector<std::uint64_t> keys;
+  keys.reserve(counts.size());
+  for (const auto& [key, count] : counts)
+    keys.push_back(key);
+  std::uint64_t weighted = 0;
+  for (std::uint64_t key : keys)
+    weighted += key * counts.find(key)->second;
+
+  std::uint64_t found = 0;
+  for (std::uint64_t lookups = 0; lookups < 10000000; lookups++)
+  {
+    auto it = counts.find(NextRandom() % 4000000 + 1);
+    found += it == counts.end() ? 0 : it->second;
+  }
+
+  std::printf("%llu\n%llu\n%llu\n", static_cast<unsigned long long>(counts.size()),
+    static_cast<unsigned long long>(weighted), static_cast<unsigned long long>(found));
+}
@@ -0,0 +1,31 @@
+// C++ baseline of 'mandelbrot.ct'.
+#include <cstdio>
+
+int main()
+{
+  const long long size = 2000;
+  const long long max_iter = 50;
+  long long inside = 0;
+  for (long long y = 0; y < size; y++)
+  {
+    double ci = 2.0 * static_cast<double>(y) / static_cast<double>(size) - 1.0;
+    for (long long x = 0; x < size; x++)
+    {
+      double cr = 2.0 * static_cast<double>(x) / static_cast<double>(size) - 1.5;
+      double zr = 0.0, zi = 0.0, tr = 0.0, ti = 0.0;
+      long long iter = 0;
+      for (; iter < max_iter; iter++)
+      {
+        zi = 2.0 * zr * zi + ci;
+        zr = tr - ti + cr;
+        tr = zr * zr;
+        ti = zi * zi;
+        if (tr + ti > 4.0)
+          break;
+      }
+      if (iter == max_iter)
+        inside++;
+    }
+  }
+  std::printf("%lld\n", inside);
+}
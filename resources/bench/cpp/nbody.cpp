@@ -0,0 +1,100 @@
+// C++ baseline of 'nbody.ct': same bodies, same operations in the same order.
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+  constexpr double SolarMass = 39.47841760435743;
+  constexpr double DaysPerYear = 365.24;
+
+  struct Body
+  {
+    double x, y, z, vx, vy, vz, mass;
+  };
+
+  Body MakeBody(double x, double y, double z, double vx, double vy, double vz, double mass)
+  {
+    return { x, y, z, vx * DaysPerYear, vy * DaysPerYear, vz * DaysPerYear, mass * SolarMass };
+  }
+
+  void OffsetMomentum(Body* bodies)
+  {
+    double px = 0.0, py = 0.0, pz = 0.0;
+    for (int i = 0; i < 5; i++)
+    {
+      px = px + bodies[i].vx * bodies[i].mass;
+      py = py + bodies[i].vy * bodies[i].mass;
+      pz = pz + bodies[i].vz * bodies[i].mass;
+    }
+    bodies[0].vx = -px / SolarMass;
+    bodies[0].vy = -py / SolarMass;
+    bodies[0].vz = -pz / SolarMass;
+  }
+
+  double Energy(const Body* bodies)
+  {
+    double e = 0.0;
+    for (int i = 0; i < 5; i++)
+    {
+      const Body& b = bodies[i];
+      e = e + 0.5 * b.mass * (b.vx * b.vx + b.vy * b.vy + b.vz * b.vz);
+      for (int j = i + 1; j < 5; j++)
+      {
+        double dx = b.x - bodies[j].x;
+        double dy = b.y - bodies[j].y;
+        double dz = b.z - bodies[j].z;
+        e = e - b.mass * bodies[j].mass / std::sqrt(dx * dx + dy * dy + dz * dz);
+      }
+    }
+    return e;
+  }
+
+  void Advance(Body* bodies, double dt)
+  {
+    for (int i = 0; i < 5; i++)
+    {
+      for (int j = i + 1; j < 5; j++)
+      {
+        double dx = bodies[i].x - bodies[j].x;
+        double dy = bodies[i].y - bodies[j].y;
+        double dz = bodies[i].z - bodies[j].z;
+        double distance2 = dx * dx + dy * dy + dz * dz;
+        double mag = dt / (distance2 * std::sqrt(distance2));
+        double mass_i = bodies[i].mass;
+        double mass_j = bodies[j].mass;
+        bodies[i].vx = bodies[i].vx - dx * mass_j * mag;
+        bodies[i].vy = bodies[i].vy - dy * mass_j * mag;
+        bodies[i].vz = bodies[i].vz - dz * mass_j * mag;
+        bodies[j].vx = bodies[j].vx + dx * mass_i * mag;
+        bodies[j].vy = bodies[j].vy + dy * mass_i * mag;
+        bodies[j].vz = bodies[j].vz + dz * mass_i * mag;
+      }
+    }
+    for (int i = 0; i < 5; i++)
+    {
+      bodies[i].x = bodies[i].x + dt * bodies[i].vx;
+      bodies[i].y = bodies[i].y + dt * bodies[i].vy;
+      bodies[i].z = bodies[i].z + dt * bodies[i].vz;
+    }
+  }
+}
+
+int main()
+{
+  Body bodies[5] = {
+    MakeBody(0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0),
+    MakeBody(4.84143144246472090e+00, -1.16032004402742839e+00, -1.03622044471123109e-01,
+      1.66007664274403694e-03, 7.69901118419740425e-03, -6.90460016972063023e-05, 9.54791938424326609e-04),
+    MakeBody(8.34336671824457987e+00, 4.12479856412430479e+00, -4.03523417114321381e-01,
+      -2.76742510726862411e-03, 4.99852801234917238e-03, 2.30417297573763929e-05, 2.85885980666130812e-04),
+    MakeBody(1.28943695621391310e+01, -1.51111514016986312e+01, -2.23307578892655734e-01,
+      2.96460137564761618e-03, 2.37847173959480950e-03, -2.96589568540237556e-05, 4.36624404335156298e-05),
+    MakeBody(1.53796971148509165e+01, -2.59193146099879641e+01, 1.79258772950371181e-01,
+      2.68067772490389322e-03, 1.62824170038242295e-03, -9.51592254519715870e-05, 5.15138902046611451e-05),
+  };
+  OffsetMomentum(bodies);
+  std::printf("%lld\n", static_cast<long long>(Energy(bodies) * 1000000000.0));
+  for (int step = 0; step < 5000000; step++)
+    Advance(bodies, 0.01);
+  std::printf("%lld\n", static_cast<long long>(Energy(bodies) * 1000000000.0));
+}
@@ -0,0 +1,26 @@
+// C++ baseline of 'sieve.ct': sieve of Eratosthenes over a bitmask.
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+int main()
+{
+  const std::uint64_t n = 50000000;
+  auto bits = static_cast<std::uint64_t*>(std::calloc(n / 64 + 1, 8));
+  for (std::uint64_t i = 2; i * i <= n; i++)
+  {
+    if (((bits[i >> 6] >> (i & 63)) & 1) == 0)
+    {
+      for (std::uint64_t j = i * i; j <= n; j += i)
+        bits[j >> 6] = bits[j >> 6] | (std::uint64_t(1) << (j & 63));
+    }
+  }
+  std::uint64_t count = 0;
+  for (std::uint64_t i = 2; i <= n; i++)
+  {
+    if (((bits[i >> 6] >> (i & 63)) & 1) == 0)
+      count++;
+  }
+  std::printf("%llu\n", static_cast<unsigned long long>(count));
+  std::free(bits);
+}
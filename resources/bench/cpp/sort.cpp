@@ -0,0 +1,38 @@
+// C++ baseline of 'sort.ct': partitioning, sorting, removing duplicates and prefix sums using <algorithm>.
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+  std::uint64_t rng_state = 88172645463325252u;
+
+  std::uint64_t NextRandom()
+  {
+    std::uint64_t x = rng_state;
+    x = x ^ (x >> 12);
+    x = x ^ (x << 25);
+    x = x ^ (x >> 27);
+    rng_state = x;
+    return x * 2685821657736338717u;
+  }
+}
+
+int main()
+{
+  std::vector<std::uint64_t> values;
+  values.reserve(10000000);
+  for (std::uint64_t i = 0; i < 10000000; i++)
+    values.push_back(NextRandom() % 100000000);
+
+  auto below = std::stable_partition(values.begin(), values.end(),
+    [](std::uint64_t value) { return value < 50000000; }) - values.begin();
+  std::sort(values.begin(), values.end());
+  auto distinct = std::unique(values.begin(), values.end()) - values.begin();
+  std::partial_sum(values.begin(), values.begin() + distinct, values.begin());
+
+  std::printf("%llu\n%llu\n%llu\n", static_cast<unsigned long long>(below),
+    static_cast<unsigned long long>(distinct), static_cast<unsigned long long>(values[distinct - 1]));
+}
@@ -0,0 +1,58 @@
+// C++ baseline of 'spectral_norm.ct'.
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+  double EvalA(long long i, long long j)
+  {
+    return 1.0 / static_cast<double>((i + j) * (i + j + 1) / 2 + i + 1);
+  }
+
+  void MulAv(const double* v, double* out, long long n)
+  {
+    for (long long i = 0; i < n; i++)
+    {
+      double sum = 0.0;
+      for (long long j = 0; j < n; j++)
+        sum = sum + EvalA(i, j) * v[j];
+      out[i] = sum;
+    }
+  }
+
+  void MulAtv(const double* v, double* out, long long n)
+  {
+    for (long long i = 0; i < n; i++)
+    {
+      double sum = 0.0;
+      for (long long j = 0; j < n; j++)
+        sum = sum + EvalA(j, i) * v[j];
+      out[i] = sum;
+    }
+  }
+
+  void MulAtAv(const double* v, double* out, double* tmp, long long n)
+  {
+    MulAv(v, tmp, n);
+    MulAtv(tmp, out, n);
+  }
+}
+
+int main()
+{
+  const long long n = 2000;
+  std::vector<double> u(n, 1.0), v(n), tmp(n);
+  for (int i = 0; i < 10; i++)
+  {
+    MulAtAv(u.data(), v.data(), tmp.data(), n);
+    MulAtAv(v.data(), u.data(), tmp.data(), n);
+  }
+  double vbv = 0.0, vv = 0.0;
+  for (long long i = 0; i < n; i++)
+  {
+    vbv = vbv + u[i] * v[i];
+    vv = vv + v[i] * v[i];
+  }
+  std::printf("%lld\n", static_cast<long long>(std::sqrt(vbv / vv) * 1000000000.0));
+}
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""Measures the iTLB misses of large programs run through the JIT.
+
+A large program is generated (many small functions, a fraction of which are
+called on each iteration, while the others are only called every 64
+iterations), then run through the JIT ('-r') with the default memory manager,
+with '--jit-huge-pages', and with '--jit-hot-functions' using a profile of
+a first run ('--profile'). The iTLB misses are read using 'perf stat', and
+the outputs of all the runs must match.
+
+Use: itlb_benchmark.py <PATH TO COLT COMPILER> [--functions N] [--iterations N] [--hot PERCENT] [--repeat N]
+"""
+
+import argparse
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+FLAGS = ["--no-wait", "-C", "-M", "-W"]
+
+
+def generate(path, functions, iterations, hot_percent, seed):
+    """Writes the large program to 'path'."""
+    rng = random.Random(seed)
+    lines = ["//Generated by 'itlb_benchmark.py'.", "extern fn _ColtPrintu64(u64 value)->void;", ""]
+    for i in range(functions):
+        lines += [
+            "fn f{}(u64 x)->u64".format(i),
+            "{",
+            "  var mut y = x ^ (x >> {}u64);".format(rng.randint(1, 31)),
+            "  y = y * {}u64 + {}u64;".format(rng.randrange(1, 1 << 62) | 1, rng.randrange(1 << 62)),
+            "  y = y ^ (y << {}u64);".format(rng.randint(1, 31)),
+            "  y = y + (y >> {}u64) * {}u64;".format(rng.randint(1, 31), rng.randrange(1 << 30)),
+            "  return y ^ (y >> {}u64);".format(rng.randint(1, 31)),
+            "}",
+        ]
+    # Hot and cold functions are interleaved, so that they are compiled (lazily) in that order
+    order = list(range(functions))
+    rng.shuffle(order)
+    hot = set(rng.sample(order, max(1, functions * hot_percent // 100)))
+    lines += [
+        "fn main()->i64",
+        "{",
+        "  var mut x = 1u64;",
+        "  var mut i = 0u64;",
+        "  while i < {}u64".format(iterations),
+        "  {",
+        "    var cold = (i & 63u64) == 0u64;",
+    ]
+    for i in order:
+        if i in hot:
+            lines.append("    x = f{}(x);".format(i))
+        else:
+            lines.append("    if cold {{ x = f{}(x); }}".format(i))
+    lines += [
+        "    i = i + 1u64;",
+        "  }",
+        "  _ColtPrintu64(x);",
+        "  return 0;",
+        "}",
+    ]
+    with open(path, "w") as file:
+        file.write("\n".join(lines) + "\n")
+
+
+def run(command, repeat, env=None):
+    """Runs a command 'repeat' times through 'perf stat' (if available).
+    Returns (best time, fewest iTLB misses or None, stdout)."""
+    perf = shutil.which("perf")
+    best = None
+    misses = None
+    output = None
+    for _ in range(repeat):
+        prefix = [perf, "stat", "-x", ",", "-e", "iTLB-load-misses"] if perf else []
+        begin = time.perf_counter()
+        result = subprocess.run(prefix + command, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                                universal_newlines=True, env=env)
+        elapsed = time.perf_counter() - begin
+        if result.returncode != 0:
+            raise RuntimeError("'{}' failed with code {}:\n{}".format(
+                " ".join(command), result.returncode, result.stderr))
+        best = elapsed if best is None else min(best, elapsed)
+        output = result.stdout
+        for line in result.stderr.splitlines():
+            fields = line.split(",")
+            # '<not supported>' or '<not counted>' if the event is not available
+            if len(fields) > 2 and "iTLB-load-misses" in fields[2] and fields[0].isdigit():
+                misses = int(fields[0]) if misses is None else min(misses, int(fields[0]))
+    return best, misses, output
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Measures the iTLB misses of large programs run through the JIT.")
+    parser.add_argument("colt", help="path to the Colt compiler")
+    parser.add_argument("--functions", type=int, default=4000, help="number of functions of the program")
+    parser.add_argument("--iterations", type=int, default=20000, help="iterations of the main loop")
+    parser.add_argument("--hot", type=int, default=10, help="percentage of functions called on each iteration")
+    parser.add_argument("--level", default="O0", help="optimization level (O0 keeps every call)")
+    parser.add_argument("--repeat", type=int, default=3, help="runs per measure (the best is kept)")
+    parser.add_argument("--seed", type=int, default=42, help="seed of the generated program")
+    args = parser.parse_args()
+
+    if not shutil.which("perf"):
+        print("'perf' was not found: only the times are reported.")
+
+    with tempfile.TemporaryDirectory() as tmp:
+        source = os.path.join(tmp, "large_program.ct")
+        generate(source, args.functions, args.iterations, args.hot, args.seed)
+        command = [args.colt, source, "-r", "-" + args.level] + FLAGS
+
+        # Profile a first run to find the hot functions
+        env = dict(os.environ, COLT_PROFILE=os.path.join(tmp, "profile"))
+        run(command + ["--profile", "1000"], 1, env)
+
+        configurations = [
+            ("default", []),
+            ("huge pages", ["--jit-huge-pages"]),
+            ("huge pages + hot", ["--jit-hot-functions", os.path.join(tmp, "profile.folded")]),
+        ]
+        print("{:<18} {:>10} {:>16} {:>8}".format("Memory", "Time (s)", "iTLB misses", "Misses x"))
+        reference = None
+        failed = False
+        for name, flags in configurations:
+            elapsed, misses, output = run(command + flags, args.repeat)
+            if reference is None:
+                reference = (misses, output)
+            ok = output == reference[1]
+            failed = failed or not ok
+            print("{:<18} {:>10.3f} {:>16} {:>8}{}".format(
+                name, elapsed,
+                misses if misses is not None else "n/a",
+                "{:.2f}x".format(misses / reference[0]) if misses is not None and reference[0] else "-",
+                "" if ok else "  OUTPUT MISMATCH"))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""Runs the Colt benchmark suite against its C++ baselines.
+
+For each benchmark of this folder, the C++ baseline ('cpp/<name>.cpp') is
+compiled with clang++ -O3, then the Colt version ('<name>.ct') is run
+through the JIT ('-r') and compiled ahead-of-time ('-o') at every
+optimization level. The outputs of all the runs must match the one of the
+baseline, and the best wall time of each run is reported with its slowdown
+ratio over the C++ baseline.
+With '--c-backend', the C source code generated by the compiler ('--emit-c')
+is also compiled by the system C compiler, to compare both backends.
+
+Use: run_benchmarks.py <PATH TO COLT COMPILER> [--repeat N] [--levels O1,O3] [--c-backend] [--json FILE]
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+BENCHMARKS = ["nbody", "spectral_norm", "mandelbrot", "fannkuch", "sieve", "hash", "hash_map", "sort"]
+# Units of the Colt runtime linked with the ahead-of-time runs
+RUNTIME_UNITS = ["colt_containers.cpp", "colt_algorithms.cpp", "colt_thread_pool.cpp"]
+LEVELS = ["O0", "O1", "O2", "O3", "Os", "Oz"]
+
+
+def find_cxx():
+    """Returns the C++ compiler to use, preferring clang++."""
+    for cxx in ("clang++", os.environ.get("CXX", ""), "c++", "g++"):
+        if cxx and shutil.which(cxx):
+            return cxx
+    sys.exit("No C++ compiler found! Install clang++ or set $CXX.")
+
+
+def find_cc():
+    """Returns the C compiler to use for the C backend."""
+    for cc in (os.environ.get("CC", ""), "cc", "clang", "gcc"):
+        if cc and shutil.which(cc):
+            return cc
+    sys.exit("No C compiler found! Install cc or set $CC.")
+
+
+def run(command, repeat):
+    """Runs a command 'repeat' times, returning (best time, stdout)."""
+    best = None
+    output = None
+    for _ in range(repeat):
+        begin = time.perf_counter()
+        result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                                universal_newlines=True)
+        elapsed = time.perf_counter() - begin
+        if result.returncode != 0:
+            raise RuntimeError("'{}' failed with code {}:\n{}".format(
+                " ".join(command), result.returncode, result.stderr))
+        best = elapsed if best is None else min(best, elapsed)
+        output = result.stdout
+    return best, output
+
+
+def checksum(output):
+    """Extracts the integer lines printed by a benchmark."""
+    return [line.strip() for line in output.splitlines()
+            if line.strip().lstrip("-").isdigit()]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Runs the Colt benchmarks against C++ baselines.")
+    parser.add_argument("colt", help="path to the Colt compiler")
+    parser.add_argument("--repeat", type=int, default=3, help="runs per measure (the best is kept)")
+    parser.add_argument("--levels", default=",".join(LEVELS), help="comma separated optimization levels")
+    parser.add_argument("--bench", default=",".join(BENCHMARKS), help="comma separated benchmarks")
+    parser.add_argument("--no-aot", action="store_true", help="only run the JIT")
+    parser.add_argument("--c-backend", action="store_true", help="also run the code generated by '--emit-c'")
+    parser.add_argument("--json", help="writes the results to a JSON file")
+    args = parser.parse_args()
+
+    cxx = find_cxx()
+    cc = find_cc() if args.c_backend else None
+    levels = [level for level in args.levels.split(",") if level]
+    flags = ["--no-wait", "-C", "-M", "-W"]
+    results = []
+    failed = False
+
+    with tempfile.TemporaryDirectory() as tmp:
+        shim = os.path.join(BENCH_DIR, "cpp", "colt_bench_runtime.cpp")
+        shim_obj = os.path.join(tmp, "colt_bench_runtime.o")
+        subprocess.check_call([cxx, "-O2", "-c", shim, "-o", shim_obj])
+        runtime_objs = []
+        for unit in RUNTIME_UNITS:
+            runtime_objs.append(os.path.join(tmp, os.path.splitext(unit)[0] + ".o"))
+            subprocess.check_call([cxx, "-O2", "-std=c++17", "-c",
+                                   os.path.join(BENCH_DIR, "..", "..", "src", "runtime", unit), "-o", runtime_objs[-1]])
+
+        print("{:<14} {:<5} {:>10} {:>10} {:>10} {:>8} {:>8} {:>8}".format(
+            "Benchmark", "Level", "JIT (s)", "AOT (s)", "C (s)", "JIT x", "AOT x", "C x"))
+        for name in [bench for bench in args.bench.split(",") if bench]:
+            source = os.path.join(BENCH_DIR, name + ".ct")
+            baseline = os.path.join(tmp, name + "_cpp")
+            subprocess.check_call([cxx, "-O3", os.path.join(BENCH_DIR, "cpp", name + ".cpp"), "-o", baseline])
+            cpp_time, cpp_output = run([baseline], args.repeat)
+            expected = checksum(cpp_output)
+            print("{:<14} {:<5} {:>10.3f} {:>10} {:>10} {:>8} {:>8} {:>8}".format(name, "C++", cpp_time, "", "", "", "", ""))
+
+            for level in levels:
+                entry = {"benchmark": name, "level": level, "cpp": cpp_time}
+                jit_time, jit_output = run([args.colt, source, "-r", "-" + level] + flags, args.repeat)
+                entry["jit"] = jit_time
+                entry["jit_ok"] = checksum(jit_output) == expected
+
+                if not args.no_aot:
+                    obj = os.path.join(tmp, "{}_{}.o".format(name, level))
+                    exe = os.path.join(tmp, "{}_{}".format(name, level))
+                    run([args.colt, source, "-o", obj, "-" + level] + flags, 1)
+                    subprocess.check_call([cxx, obj, shim_obj] + runtime_objs + ["-no-pie", "-lm", "-pthread", "-o", exe])
+                    aot_time, aot_output = run([exe], args.repeat)
+                    entry["aot"] = aot_time
+                    entry["aot_ok"] = checksum(aot_output) == expected
+
+                if args.c_backend:
+                    c_source = os.path.join(tmp, "{}_{}.c".format(name, level))
+                    c_obj = os.path.join(tmp, "{}_{}_c.o".format(name, level))
+                    c_exe = os.path.join(tmp, "{}_{}_c".format(name, level))
+                    run([args.colt, source, "--emit-c", c_source, "-" + level] + flags, 1)
+                    # Same flags as the C backend of the compiler ('-Oz' is not supported by all C compilers)
+                    c_level = "Os" if level == "Oz" else level
+                    subprocess.check_call([cc, "-std=c11", "-fwrapv", "-w", "-" + c_level, "-c", c_source, "-o", c_obj])
+                    subprocess.check_call([cxx, c_obj, shim_obj] + runtime_objs + ["-lm", "-pthread", "-o", c_exe])
+                    c_time, c_output = run([c_exe], args.repeat)
+                    entry["c"] = c_time
+                    entry["c_ok"] = checksum(c_output) == expected
+
+                ok = entry["jit_ok"] and entry.get("aot_ok", True) and entry.get("c_ok", True)
+                failed = failed or not ok
+                results.append(entry)
+                print("{:<14} {:<5} {:>10.3f} {:>10} {:>10} {:>7.2f}x {:>8} {:>8}{}".format(
+                    "", level, jit_time,
+                    "{:.3f}".format(entry["aot"]) if "aot" in entry else "-",
+                    "{:.3f}".format(entry["c"]) if "c" in entry else "-",
+                    jit_time / cpp_time,
+                    "{:.2f}x".format(entry["aot"] / cpp_time) if "aot" in entry else "-",
+                    "{:.2f}x".format(entry["c"] / cpp_time) if "c" in entry else "-",
+                    "" if ok else "  OUTPUT MISMATCH"))
+
+    if args.json:
+        with open(args.json, "w") as file:
+            json.dump(results, file, indent=2)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
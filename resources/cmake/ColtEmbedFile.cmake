@@ -0,0 +1,21 @@
+# Writes a C++ source file defining an array containing the bytes of a file.
+# The array 'colt::gen::<NAME>' and its size 'colt::gen::<NAME>Size' are defined.
+# The array is aligned on 4 bytes, as required by the LLVM bitcode reader.
+# Use: cmake -DINPUT_FILE=<FILE> -DOUTPUT_FILE=<FILE> -DNAME=<NAME> -P ColtEmbedFile.cmake
+
+file(READ ${INPUT_FILE} content HEX)
+string(LENGTH "${content}" contentLength)
+math(EXPR contentSize "${contentLength} / 2")
+# Each byte is written as '0xXX,'
+string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${content}")
+
+file(WRITE ${OUTPUT_FILE}
+  "// Generated by 'ColtEmbedFile.cmake' from '${INPUT_FILE}': do not edit!\n"
+  "#include <cstddef>\n\n"
+  "namespace colt::gen\n{\n"
+  "  extern const unsigned char ${NAME}[];\n"
+  "  extern const std::size_t ${NAME}Size;\n\n"
+  "  alignas(4) const unsigned char ${NAME}[] = { ${bytes} };\n"
+  "  const std::size_t ${NAME}Size = ${contentSize};\n"
+  "}\n"
+)
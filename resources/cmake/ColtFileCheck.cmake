@@ -0,0 +1,67 @@
+# Checks the LLVM IR generated for a test file using FileCheck.
+# The first line of the test file is '// ARGS: <ARGS>', where <ARGS> are
+# the arguments to pass to the compiler (usually an optimization level).
+# In the arguments, '%S' is replaced by the directory of the test file.
+# The IR is printed after optimizations, and checked against the
+# 'CHECK:' directives of the test file.
+# The next lines may be:
+# - '// EXIT: <CODE>', the expected exit code of the compiler (0 by default),
+#   to check failing compilations.
+# - '// FILE: <PATH>', a file written by the compiler (relative to the directory
+#   in which it runs), whose content is checked after the IR (profiles...).
+# Use: cmake -DCOLT=<COMPILER> -DFILECHECK=<FILECHECK> -DTEST_FILE=<FILE> -DOUTPUT_FILE=<FILE> -P ColtFileCheck.cmake
+
+file(STRINGS ${TEST_FILE} firstLine LIMIT_COUNT 1)
+if (NOT "${firstLine}" MATCHES "^// *ARGS:(.*)$")
+  message(FATAL_ERROR "Test '${TEST_FILE}' should begin with '// ARGS:' followed by the arguments to pass to the compiler!")
+endif()
+get_filename_component(testDirectory ${TEST_FILE} DIRECTORY)
+string(REPLACE "%S" "${testDirectory}" testArgs "${CMAKE_MATCH_1}")
+separate_arguments(testArgs UNIX_COMMAND "${testArgs}")
+
+file(STRINGS ${TEST_FILE} firstLines LIMIT_COUNT 3)
+set(expectedResult 0)
+set(checkedFiles "")
+foreach(line ${firstLines})
+  if ("${line}" MATCHES "^// *EXIT: *([0-9]+)$")
+    set(expectedResult ${CMAKE_MATCH_1})
+  elseif ("${line}" MATCHES "^// *FILE: *(.+)$")
+    list(APPEND checkedFiles ${CMAKE_MATCH_1})
+  endif()
+endforeach()
+
+# The compiler runs in its own directory, so that the files it writes do not clash
+set(workingDirectory ${OUTPUT_FILE}.dir)
+file(REMOVE_RECURSE ${workingDirectory})
+file(MAKE_DIRECTORY ${workingDirectory})
+
+# -i: Print IR (to stderr)
+# -C: No Color
+# --no-wait: Do not wait for user input before closing the app.
+execute_process(
+  COMMAND ${COLT} ${testArgs} -i -C --no-wait ${TEST_FILE}
+  WORKING_DIRECTORY ${workingDirectory}
+  OUTPUT_VARIABLE compilerOutput
+  ERROR_VARIABLE compilerOutput
+  RESULT_VARIABLE compilerResult
+)
+if (NOT "${compilerResult}" EQUAL ${expectedResult})
+  message(FATAL_ERROR "Compiler exited with '${compilerResult}' (expected '${expectedResult}'):\n${compilerOutput}")
+endif()
+foreach(checkedFile ${checkedFiles})
+  if (NOT EXISTS ${workingDirectory}/${checkedFile})
+    message(FATAL_ERROR "Compiler did not write '${checkedFile}':\n${compilerOutput}")
+  endif()
+  file(READ ${workingDirectory}/${checkedFile} fileContent)
+  string(APPEND compilerOutput "\n${fileContent}")
+endforeach()
+# The IR is kept to simplify debugging failing tests
+file(WRITE ${OUTPUT_FILE} "${compilerOutput}")
+
+execute_process(
+  COMMAND ${FILECHECK} ${TEST_FILE} --input-file=${OUTPUT_FILE}
+  RESULT_VARIABLE checkResult
+)
+if (NOT "${checkResult}" EQUAL 0)
+  message(FATAL_ERROR "FileCheck failed for '${TEST_FILE}' (IR written to '${OUTPUT_FILE}')!")
+endif()
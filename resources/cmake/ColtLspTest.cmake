@@ -0,0 +1,49 @@
+# Runs a scripted session of the language server, and checks its responses using FileCheck.
+# Each line of the test file that is not empty, and does not begin with '//',
+# is a JSON-RPC message sent to the server (the 'Content-Length' header is added).
+# The responses are checked against the 'CHECK:' directives of the test file,
+# and the server must exit with 0 (so the session must end with 'shutdown' and 'exit').
+# Use: cmake -DCOLT=<COMPILER> -DFILECHECK=<FILECHECK> -DTEST_FILE=<FILE> -DOUTPUT_FILE=<FILE> -P ColtLspTest.cmake
+
+# The lines are not read using 'file(STRINGS)', as messages may contain ';'
+file(READ ${TEST_FILE} testContent)
+set(messages "")
+while (NOT "${testContent}" STREQUAL "")
+  string(FIND "${testContent}" "\n" lineEnd)
+  if (${lineEnd} EQUAL -1)
+    set(line "${testContent}")
+    set(testContent "")
+  else()
+    string(SUBSTRING "${testContent}" 0 ${lineEnd} line)
+    math(EXPR lineEnd "${lineEnd} + 1")
+    string(SUBSTRING "${testContent}" ${lineEnd} -1 testContent)
+  endif()
+  string(REGEX REPLACE "\r$" "" line "${line}")
+  if ("${line}" STREQUAL "" OR "${line}" MATCHES "^//")
+    continue()
+  endif()
+  # The length is in bytes
+  string(LENGTH "${line}" lineLength)
+  string(APPEND messages "Content-Length: ${lineLength}\r\n\r\n${line}")
+endwhile()
+file(WRITE ${OUTPUT_FILE}.in "${messages}")
+
+execute_process(
+  COMMAND ${COLT} --lsp
+  INPUT_FILE ${OUTPUT_FILE}.in
+  OUTPUT_VARIABLE serverOutput
+  RESULT_VARIABLE serverResult
+)
+# The responses are kept to simplify debugging failing tests
+file(WRITE ${OUTPUT_FILE} "${serverOutput}")
+if (NOT "${serverResult}" EQUAL 0)
+  message(FATAL_ERROR "Language server exited with '${serverResult}':\n${serverOutput}")
+endif()
+
+execute_process(
+  COMMAND ${FILECHECK} ${TEST_FILE} --input-file=${OUTPUT_FILE}
+  RESULT_VARIABLE checkResult
+)
+if (NOT "${checkResult}" EQUAL 0)
+  message(FATAL_ERROR "FileCheck failed for '${TEST_FILE}' (responses written to '${OUTPUT_FILE}')!")
+endif()
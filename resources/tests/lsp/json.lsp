@@ -0,0 +1,55 @@
+// JSON parsing: request IDs are written back as parsed, and malformed messages are
+// answered with a ParseError (-32700), without stopping the server.
+
+// Numbers: integers are written without exponent
+{"jsonrpc":"2.0","id":1e1,"method":"colt/unknown"}
+// CHECK: {"jsonrpc":"2.0","id":10,"error":{"code":-32601,"message":"Method not supported by the Colt language server!"}}
+{"jsonrpc":"2.0","id":-2.5,"method":"colt/unknown"}
+// CHECK: {"jsonrpc":"2.0","id":-2.5,"error":{"code":-32601,
+{"jsonrpc":"2.0","id":-12E-1,"method":"colt/unknown"}
+// CHECK: {"jsonrpc":"2.0","id":-1.2,"error":{"code":-32601,
+
+// Escapes are decoded, and written back escaped (or as UTF-8)
+{"jsonrpc":"2.0","id":"a\"b\\c\/dA\t\n","method":"colt/unknown"}
+// CHECK: {"jsonrpc":"2.0","id":"a\"b\\c/dA\t\n","error":{"code":-32601,
+{"jsonrpc":"2.0","id":"é€😀\u0001","method":"colt/unknown"}
+// CHECK: {"jsonrpc":"2.0","id":"é€😀\u0001","error":{"code":-32601,
+
+// Whitespace between tokens, and nested values
+ { "jsonrpc" : "2.0" ,	"id" : [ 1 , true , false , null , { "a" : [ ] } ] , "method" : "colt/unknown" } 
+// CHECK: {"jsonrpc":"2.0","id":[1,true,false,null,{"a":[]}],"error":{"code":-32601,
+
+// Malformed messages
+[1,
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Unexpected end of JSON!"}}
+{"id":1,
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Expected a member name!"}}
+{"id" 1}
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Expected a ':'!"}}
+{"id":1 "method":"shutdown"}
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Expected a ',' or '}'!"}}
+[1 2]
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Expected a ',' or ']'!"}}
+{"id":"abc
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Unterminated JSON string!"}}
+{"id":"\x"}
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Invalid escape sequence!"}}
+{"id":"\ud83dA"}
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Invalid unicode escape sequence!"}}
+{"id":"\u12G4"}
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Invalid unicode escape sequence!"}}
+{"id":1.2.3}
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Invalid JSON number!"}}
+{"id":tru}
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Invalid JSON keyword!"}}
+{"id":@}
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Unexpected character in JSON!"}}
+{"id":1} x
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"Unexpected characters after JSON value!"}}
+[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]
+// CHECK: {"jsonrpc":"2.0","id":null,"error":{"code":-32700,"message":"JSON is nested too deeply!"}}
+
+// The server still answers after malformed messages
+{"jsonrpc":"2.0","id":2,"method":"shutdown"}
+// CHECK: {"jsonrpc":"2.0","id":2,"result":null}
+{"jsonrpc":"2.0","method":"exit"}
@@ -0,0 +1,40 @@
+// A session of an editor: the server answers requests using the content sent by 'didOpen'.
+// Columns are in UTF-16 code units: the emoji of the comment counts as 2.
+{"jsonrpc":"2.0","id":1,"method":"initialize","params":{"processId":null,"rootUri":null,"capabilities":{}}}
+// CHECK: {"jsonrpc":"2.0","id":1,"result":{"capabilities":{"textDocumentSync":{"openClose":true,"change":1},"definitionProvider":true,"referencesProvider":true,"hoverProvider":true},"serverInfo":{"name":"colt","version":"{{[^"]*}}"}}}
+{"jsonrpc":"2.0","method":"initialized","params":{}}
+{"jsonrpc":"2.0","method":"textDocument/didOpen","params":{"textDocument":{"uri":"file:///colt/session.ct","languageId":"colt","version":1,"text":"fn add(i64 a, i64 b)->i64:\n  return a + b;\n\nfn main()->i64:\n  return /*😀*/add(1, 2) + add(3, 4);\n"}}}
+
+// Definition of the second call to 'add'
+{"jsonrpc":"2.0","id":2,"method":"textDocument/definition","params":{"textDocument":{"uri":"file:///colt/session.ct"},"position":{"line":4,"character":28}}}
+// CHECK: {"jsonrpc":"2.0","id":2,"result":{"uri":"file:///colt/session.ct","range":{"start":{"line":0,"character":3},"end":{"line":0,"character":6}}}}
+
+// References of 'add', with and without its declaration
+{"jsonrpc":"2.0","id":3,"method":"textDocument/references","params":{"textDocument":{"uri":"file:///colt/session.ct"},"position":{"line":0,"character":4},"context":{"includeDeclaration":true}}}
+// CHECK: {"jsonrpc":"2.0","id":3,"result":[{"uri":"file:///colt/session.ct","range":{"start":{"line":0,"character":3},"end":{"line":0,"character":6}}},{"uri":"file:///colt/session.ct","range":{"start":{"line":4,"character":15},"end":{"line":4,"character":18}}},{"uri":"file:///colt/session.ct","range":{"start":{"line":4,"character":27},"end":{"line":4,"character":30}}}]}
+{"jsonrpc":"2.0","id":4,"method":"textDocument/references","params":{"textDocument":{"uri":"file:///colt/session.ct"},"position":{"line":4,"character":15},"context":{"includeDeclaration":false}}}
+// CHECK: {"jsonrpc":"2.0","id":4,"result":[{"uri":"file:///colt/session.ct","range":{"start":{"line":4,"character":15},"end":{"line":4,"character":18}}},{"uri":"file:///colt/session.ct","range":{"start":{"line":4,"character":27},"end":{"line":4,"character":30}}}]}
+
+// No symbol on an empty line
+{"jsonrpc":"2.0","id":5,"method":"textDocument/definition","params":{"textDocument":{"uri":"file:///colt/session.ct"},"position":{"line":2,"character":0}}}
+// CHECK: {"jsonrpc":"2.0","id":5,"result":null}
+
+{"jsonrpc":"2.0","id":6,"method":"textDocument/hover","params":{"textDocument":{"uri":"file:///colt/session.ct"},"position":{"line":4,"character":16}}}
+// CHECK: {"jsonrpc":"2.0","id":6,"result":{"contents":{"kind":"markdown","value":"```colt\nfn add(i64 a, i64 b)->i64\n```"},"range":{"start":{"line":4,"character":15},"end":{"line":4,"character":18}}}}
+
+// Changes replace the content of the file
+{"jsonrpc":"2.0","method":"textDocument/didChange","params":{"textDocument":{"uri":"file:///colt/session.ct","version":2},"contentChanges":[{"text":"fn main()->i64:\n  return 0;\n"}]}}
+{"jsonrpc":"2.0","id":7,"method":"textDocument/references","params":{"textDocument":{"uri":"file:///colt/session.ct"},"position":{"line":0,"character":4},"context":{"includeDeclaration":true}}}
+// CHECK: {"jsonrpc":"2.0","id":7,"result":[{"uri":"file:///colt/session.ct","range":{"start":{"line":0,"character":3},"end":{"line":0,"character":7}}}]}
+
+{"jsonrpc":"2.0","id":8,"method":"workspace/symbol","params":{"query":"add"}}
+// CHECK: {"jsonrpc":"2.0","id":8,"error":{"code":-32601,"message":"Method not supported by the Colt language server!"}}
+
+// After 'shutdown', requests are invalid (and notifications are ignored)
+{"jsonrpc":"2.0","id":9,"method":"shutdown"}
+// CHECK: {"jsonrpc":"2.0","id":9,"result":null}
+{"jsonrpc":"2.0","method":"textDocument/didClose","params":{"textDocument":{"uri":"file:///colt/session.ct"}}}
+{"jsonrpc":"2.0","id":10,"method":"textDocument/definition","params":{"textDocument":{"uri":"file:///colt/session.ct"},"position":{"line":0,"character":4}}}
+// CHECK: {"jsonrpc":"2.0","id":10,"error":{"code":-32600,"message":"The Colt language server is shutting down!"}}
+// CHECK-NOT: "id":
+{"jsonrpc":"2.0","method":"exit"}
@@ -115,7 +115,7 @@ namespace colt::lang
   }
 
   ASTMaker::ASTMaker(StringView strv, AST& ast) noexcept
-    : expressions(ast.expressions), lexer(strv), global_map(ast.global_map), str_table(ast.str_table), ctx(ast.ctx)
+    : expressions(ast.expressions), lexer(strv), global_map(ast.global_map), str_table(ast.str_table), embedded_files(ast.embedded_files), ctx(ast.ctx)
   {
     current_tkn = lexer.get_next_token();
     while (current_tkn != TKN_EOF)
@@ -161,6 +161,8 @@ namespace colt::lang
     }
     else if (current_tkn == TKN_IDENTIFIER)
       to_ret = parse_identifier(line_state);
+    else if (current_tkn == TKN_KEYWORD_EMBED || current_tkn == TKN_KEYWORD_EMBED_COUNT)
+      to_ret = parse_embed(line_state);
     else if (isUnaryToken(current_tkn))
       to_ret = parse_unary();
     else if (current_tkn == TKN_LEFT_PAREN)
@@ -409,6 +411,11 @@ namespace colt::lang
 
     assert(current_tkn == TKN_KEYWORD_FN || current_tkn == TKN_KEYWORD_EXTERN);
 
+    //Saved in case the function is generic (to parse its instantiations)
+    Lexer fn_begin = lexer;
+    //Not null if parsing an instantiation of a generic function
+    PTR<GenericFn> generic = std::exchange(instantiated_fn, nullptr);
+
     bool is_extern = false;
     if (current_tkn == TKN_KEYWORD_EXTERN)
     {
@@ -422,6 +429,15 @@ namespace colt::lang
     if (check_and_consume(TKN_IDENTIFIER, &ASTMaker::panic_consume_fn_decl,
       "Expected an identifier, not '{}'!", lexer.get_current_lexeme()))
       return ErrorExpr::CreateExpr(ctx);
+    if (current_tkn == TKN_LESS)
+    {
+      if (generic == nullptr)
+        return parse_generic_fn_decl(fn_name, is_extern, std::move(fn_begin), line_state);
+      //The type parameters are bound by 'instantiate_generic_fn'
+      while (current_tkn != TKN_GREAT && current_tkn != TKN_EOF)
+        consume_current_tkn();
+      consume_current_tkn(); // consume '>'
+    }
     if (check_and_consume(TKN_LEFT_PAREN, &ASTMaker::panic_consume_fn_decl,
       "Expected a '('!"))
       return ErrorExpr::CreateExpr(ctx);
@@ -473,6 +489,9 @@ namespace colt::lang
 
     PTR<const Type> fn_ptr_t = FnType::CreateFn(return_t, std::move(args_type), is_vararg, ctx);
     PTR<FnDeclExpr> declaration = as<PTR<FnDeclExpr>>(FnDeclExpr::CreateExpr(fn_ptr_t, fn_name, std::move(args_name), is_extern, line_state.to_src_info(), ctx));
+    //Cached before parsing the body, so that instantiations can be recursive
+    if (generic != nullptr)
+      generic->instantiations.insert(instantiation_key, declaration);
 
     //Set the current function being parsed
     current_function = declaration;
@@ -523,6 +542,101 @@ namespace colt::lang
     return FnDefExpr::CreateExpr(declaration, line_state.to_src_info(), ctx);
   }
 
+  PTR<Expr> ASTMaker::parse_generic_fn_decl(StringView fn_name, bool is_extern, Lexer&& fn_begin, const SavedExprInfo& line_state) noexcept
+  {
+    assert(current_tkn == TKN_LESS);
+    consume_current_tkn(); // consume '<'
+
+    bool is_valid = true;
+    SmallVector<StringView, 4> type_params;
+    while (current_tkn != TKN_EOF && current_tkn != TKN_GREAT)
+    {
+      auto type_param = lexer.get_parsed_identifier();
+      if (current_tkn != TKN_IDENTIFIER)
+      {
+        generate_any_current<report_as::ERROR>(nullptr, "Expected the name of a type parameter!");
+        is_valid = false;
+        break;
+      }
+      consume_current_tkn(); // consume the type parameter
+      if (type_params.to_view().contains(type_param))
+      {
+        generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+          "Cannot have type parameters of same name '{}'!", type_param);
+        is_valid = false;
+      }
+      type_params.push_back(type_param);
+
+      if (current_tkn == TKN_GREAT)
+        break;
+      if (check_and_consume(TKN_COMMA, "Expected a ','!"))
+      {
+        is_valid = false;
+        break;
+      }
+    }
+    if (type_params.is_empty())
+    {
+      generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+        "Generic function '{}' expects at least a type parameter!", fn_name);
+      is_valid = false;
+    }
+
+    //The declaration is only parsed when instantiated: skip to the end of its body
+    while (current_tkn != TKN_EOF && current_tkn != TKN_SEMICOLON && !is_valid_scope_begin())
+      consume_current_tkn();
+    if (!is_valid_scope_begin())
+    {
+      generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+        "Generic function '{}' must have a body!", fn_name);
+      is_valid = false;
+    }
+    //A single statement body (beginning with ':') ends with a ';' outside of braces
+    bool is_one_expr = current_tkn == TKN_COLON;
+    u64 depth = 0;
+    while (current_tkn != TKN_EOF)
+    {
+      Token tkn = current_tkn;
+      consume_current_tkn();
+      if (tkn == TKN_LEFT_CURLY)
+        ++depth;
+      else if (tkn == TKN_RIGHT_CURLY && depth != 0 && --depth == 0 && !is_one_expr)
+        break;
+      else if (tkn == TKN_SEMICOLON && depth == 0)
+        break;
+    }
+
+    if (is_extern)
+    {
+      generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+        "Generic function '{}' cannot be 'extern'!", fn_name);
+      is_valid = false;
+    }
+    else if (fn_name == "main")
+    {
+      generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+        "Function 'main' cannot be generic!");
+      is_valid = false;
+    }
+    else if (find_generic_fn(fn_name) != nullptr)
+    {
+      generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+        "Generic function of name '{}' already exist!", fn_name);
+      is_valid = false;
+    }
+    else if (auto gptr = global_map.find(fn_name); gptr != nullptr && is_a<VarDeclExpr>(gptr->second.get_front()))
+    {
+      generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+        "Global variable of name '{}' already exist!", fn_name);
+      is_valid = false;
+    }
+    if (!is_valid)
+      return ErrorExpr::CreateExpr(ctx);
+
+    generic_fns.push_back(GenericFn{ fn_name, std::move(type_params), std::move(fn_begin), {} });
+    return NoOpExpr::CreateExpr(line_state.to_src_info(), ctx);
+  }
+
   PTR<Expr> ASTMaker::parse_scope(bool one_expr) noexcept
   {
     SavedExprInfo line_state = { *this };
@@ -945,8 +1059,20 @@ namespace colt::lang
     }
     break;
     case TKN_IDENTIFIER:
-      //TODO: add
-      colt_unreachable("not implemented");
+    {
+      //The type parameters of the instantiation being parsed
+      StringView type_name = lexer.get_parsed_identifier();
+      for (size_t i = 0; i < generic_bindings.get_size(); i++)
+      {
+        if (generic_bindings[i].first != type_name)
+          continue;
+        consume_current_tkn();
+        return is_const ? generic_bindings[i].second : generic_bindings[i].second->clone_as_mut(ctx);
+      }
+      generate_any<report_as::ERROR>(line_state.to_src_info(), panic,
+        "Typename '{}' does not exist!", type_name);
+    }
+    break;
     default:
       generate_any<report_as::ERROR>(line_state.to_src_info(), panic,
         "Expected a typename!");
@@ -996,6 +1122,431 @@ namespace colt::lang
     }
   }
 
+  namespace
+  {
+    /// @brief Returns the size of the elements of embedded data
+    /// @param type The type of the elements
+    /// @return The size of the type, or 0 if data cannot be embedded as that type
+    size_t SizeOfEmbedded(PTR<const Type> type) noexcept
+    {
+      //Pointers (and 'lstring') are only meaningful as values of the host
+      if (!type->is_builtin() || as<PTR<const BuiltInType>>(type)->is_lstring())
+        return 0;
+      switch (as<PTR<const BuiltInType>>(type)->get_builtin_id())
+      {
+      case BOOL:
+      case CHAR:
+      case U8:
+      case I8:
+        return 1;
+      case U16:
+      case I16:
+        return 2;
+      case U32:
+      case I32:
+      case F32:
+        return 4;
+      case U64:
+      case I64:
+      case F64:
+        return 8;
+      case U128:
+      case I128:
+        return 16;
+      default:
+        return 0;
+      }
+    }
+
+    /// @brief Check if a function can be called with arguments without conversions
+    /// @param fn The function
+    /// @param arguments The arguments of the call
+    /// @return True if the types of the arguments are those of the parameters
+    bool MatchesExactly(PTR<const FnDefExpr> fn, const SmallVector<PTR<Expr>, 4>& arguments) noexcept
+    {
+      if (fn->get_params_count() != arguments.get_size())
+        return false;
+      for (size_t i = 0; i < fn->get_params_count(); i++)
+      {
+        if (!arguments[i]->get_type()->is_equal(fn->get_params_type()[i]))
+          return false;
+      }
+      return true;
+    }
+
+    /// @brief The maximum number of expressions of an inlined body
+    constexpr size_t InlineBudget = 16;
+
+    /// @brief Returns the expression replacing the calls to an inlined function
+    /// @param fn The function whose body to check
+    /// @return The returned value, the single statement of a 'void' function, or nullptr
+    PTR<const Expr> GetInlinableBody(PTR<const FnDefExpr> fn) noexcept
+    {
+      if (!fn->has_body() || fn->is_main() || !is_a<ScopeExpr>(fn->get_body()))
+        return nullptr;
+      auto body = as<PTR<const ScopeExpr>>(fn->get_body())->get_body_array();
+      if (fn->get_return_type()->is_void())
+      {
+        //The 'return' at the end of 'void' functions is added while parsing
+        if (body.get_size() != 2 || !is_a<FnReturnExpr>(body[1]))
+          return nullptr;
+        return body[0];
+      }
+      if (body.get_size() != 1 || !is_a<FnReturnExpr>(body[0]))
+        return nullptr;
+      auto value = as<PTR<const FnReturnExpr>>(body[0])->get_value();
+      return value->get_type()->is_equal(fn->get_return_type()) ? value : nullptr;
+    }
+
+    /// @brief Informations about the body of a function to inline
+    struct InlineInfo
+    {
+      /// @brief The number of expressions of the body
+      size_t size = 0;
+      /// @brief The parameters read, in order of evaluation
+      SmallVector<u64, 4> reads{};
+      /// @brief True if side effects (calls or stores) happen before the last
+      ///        parameter read, or if parameters may not be read (short-circuiting)
+      bool has_inner_effects = false;
+      /// @brief True if memory (a global variable or a pointer) is read: as the
+      ///        arguments of a call are evaluated before the body, the read must not
+      ///        be moved before the side effects of the arguments
+      bool reads_memory = false;
+    };
+
+    /// @brief Check if an expression can be copied in place of a call
+    /// @param expr The expression to check
+    /// @param is_root True if the expression is the body of the function
+    /// @param info The informations to update
+    /// @return True if the expression can be inlined
+    bool IsInlinable(PTR<const Expr> expr, bool is_root, InlineInfo& info) noexcept
+    {
+      if (++info.size > InlineBudget)
+        return false;
+      switch (expr->classof())
+      {
+      case Expr::EXPR_LITERAL:
+        return true;
+      break; case Expr::EXPR_VAR_READ:
+      {
+        auto read = as<PTR<const VarReadExpr>>(expr);
+        if (!read->is_global())
+          info.reads.push_back(read->get_local_ID());
+        else if (!read->get_type()->is_const())
+          info.reads_memory = true;
+        return true;
+      }
+      break; case Expr::EXPR_UNARY:
+      {
+        //The address of a parameter is not the address of its argument
+        auto unary = as<PTR<const UnaryExpr>>(expr);
+        return unary->get_operation() != UnaryOperator::OP_ADDRESSOF
+          && IsInlinable(unary->get_child(), false, info);
+      }
+      break; case Expr::EXPR_BINARY:
+      {
+        auto binary = as<PTR<const BinaryExpr>>(expr);
+        if (binary->get_operation() == BinaryOperator::OP_BOOL_AND
+          || binary->get_operation() == BinaryOperator::OP_BOOL_OR)
+          info.has_inner_effects = true;
+        return IsInlinable(binary->get_LHS(), false, info)
+          && IsInlinable(binary->get_RHS(), false, info);
+      }
+      break; case Expr::EXPR_CONVERT:
+        return IsInlinable(as<PTR<const ConvertExpr>>(expr)->get_child(), false, info);
+      break; case Expr::EXPR_PTR_LOAD:
+        info.reads_memory = true;
+        return IsInlinable(as<PTR<const PtrLoadExpr>>(expr)->get_where(), false, info);
+      break; case Expr::EXPR_PTR_STORE:
+      {
+        //The arguments of the root are evaluated before its side effect
+        info.has_inner_effects |= !is_root;
+        auto store = as<PTR<const PtrStoreExpr>>(expr);
+        return IsInlinable(store->get_where(), false, info)
+          && IsInlinable(store->get_value(), false, info);
+      }
+      break; case Expr::EXPR_FN_CALL:
+      {
+        info.has_inner_effects |= !is_root;
+        for (auto arg : as<PTR<const FnCallExpr>>(expr)->get_arguments())
+        {
+          if (!IsInlinable(arg, false, info))
+            return false;
+        }
+        return true;
+      }
+      break; default:
+        return false;
+      }
+    }
+
+    /// @brief Check if an argument cannot be modified by side effects
+    /// @param arg The argument
+    /// @return True if the argument is a literal or a read of a constant variable
+    bool IsStableArgument(PTR<const Expr> arg) noexcept
+    {
+      return is_a<LiteralExpr>(arg)
+        || (is_a<VarReadExpr>(arg) && arg->get_type()->is_const());
+    }
+
+    /// @brief Check if the arguments of a call can be substituted to the reads of parameters.
+    /// Arguments that are not stable must be read exactly once, in order, so that
+    /// they are evaluated the same number of times and in the same order.
+    /// Arguments with side effects (calls...) may modify the memory read by the body.
+    /// @param fn The function to inline
+    /// @param arguments The arguments of the call
+    /// @param info The informations about the inlined body
+    /// @return True if the arguments can be substituted
+    bool CanSubstituteArguments(PTR<const FnDefExpr> fn, const SmallVector<PTR<Expr>, 4>& arguments, const InlineInfo& info) noexcept
+    {
+      if (fn->get_params_count() != arguments.get_size())
+        return false;
+      bool has_side_effects = false;
+      for (size_t i = 0; i < arguments.get_size(); i++)
+      {
+        //Conversions of arguments are done by the call
+        if (!arguments[i]->get_type()->is_equal(fn->get_params_type()[i]))
+          return false;
+        if (IsStableArgument(arguments[i]))
+          continue;
+        if (info.has_inner_effects)
+          return false;
+        has_side_effects |= !is_a<VarReadExpr>(arguments[i]);
+      }
+      if (!has_side_effects)
+        return true;
+      if (info.reads_memory)
+        return false;
+      u64 next = 0;
+      for (auto read : info.reads)
+      {
+        if (IsStableArgument(arguments[read]))
+          continue;
+        //Skip the arguments that are not read
+        while (next < read && IsStableArgument(arguments[next]))
+          ++next;
+        if (next != read)
+          return false;
+        ++next;
+      }
+      while (next < arguments.get_size() && IsStableArgument(arguments[next]))
+        ++next;
+      return next == arguments.get_size();
+    }
+
+    /// @brief The maximum number of expressions of the body of a specialized function
+    constexpr size_t SpecializeBudget = 128;
+    /// @brief The maximum number of specializations of the functions of a name
+    constexpr u64 SpecializeLimit = 8;
+
+    /// @brief Informations about the uses of the parameters of a function to specialize
+    struct SpecializeInfo
+    {
+      /// @brief The number of expressions of the body
+      size_t size = 0;
+      /// @brief True for each parameter read by a condition or a loop condition
+      SmallVector<bool, 4> in_control_flow{};
+      /// @brief True for each parameter written or whose address is taken
+      SmallVector<bool, 4> is_modified{};
+    };
+
+    /// @brief Marks a parameter as modified
+    /// @param ID The local ID of the variable
+    /// @param info The informations to update
+    void MarkModified(u64 ID, SpecializeInfo& info) noexcept
+    {
+      if (ID < info.is_modified.get_size())
+        info.is_modified[ID] = true;
+    }
+
+    /// @brief Collects the uses of the parameters of a function to specialize
+    /// @param expr The expression whose uses to collect
+    /// @param is_condition True if the expression is part of a condition
+    /// @param info The informations to update
+    /// @return False if the body is bigger than 'SpecializeBudget' or contains errors
+    bool CollectParamUses(PTR<const Expr> expr, bool is_condition, SpecializeInfo& info) noexcept
+    {
+      if (++info.size > SpecializeBudget)
+        return false;
+      switch (expr->classof())
+      {
+      case Expr::EXPR_LITERAL:
+      case Expr::EXPR_BREAK_CONTINUE:
+      case Expr::EXPR_NOP:
+      case Expr::EXPR_EMBED:
+        return true;
+      break; case Expr::EXPR_VAR_READ:
+      {
+        auto read = as<PTR<const VarReadExpr>>(expr);
+        if (is_condition && !read->is_global()
+          && read->get_local_ID() < info.in_control_flow.get_size())
+          info.in_control_flow[read->get_local_ID()] = true;
+        return true;
+      }
+      break; case Expr::EXPR_VAR_WRITE:
+      {
+        auto write = as<PTR<const VarWriteExpr>>(expr);
+        if (!write->is_global())
+          MarkModified(write->get_local_ID(), info);
+        return CollectParamUses(write->get_value(), is_condition, info);
+      }
+      break; case Expr::EXPR_UNARY:
+      {
+        auto unary = as<PTR<const UnaryExpr>>(expr);
+        //A literal has no address
+        if (unary->get_operation() == UnaryOperator::OP_ADDRESSOF)
+        {
+          auto read = as<PTR<const VarReadExpr>>(unary->get_child());
+          if (!read->is_global())
+            MarkModified(read->get_local_ID(), info);
+          return true;
+        }
+        return CollectParamUses(unary->get_child(), is_condition, info);
+      }
+      break; case Expr::EXPR_BINARY:
+      {
+        auto binary = as<PTR<const BinaryExpr>>(expr);
+        return CollectParamUses(binary->get_LHS(), is_condition, info)
+          && CollectParamUses(binary->get_RHS(), is_condition, info);
+      }
+      break; case Expr::EXPR_CONVERT:
+        return CollectParamUses(as<PTR<const ConvertExpr>>(expr)->get_child(), is_condition, info);
+      break; case Expr::EXPR_VAR_DECL:
+      {
+        auto decl = as<PTR<const VarDeclExpr>>(expr);
+        return !decl->is_initialized() || CollectParamUses(decl->get_value(), false, info);
+      }
+      break; case Expr::EXPR_FN_CALL:
+      {
+        for (auto arg : as<PTR<const FnCallExpr>>(expr)->get_arguments())
+        {
+          if (!CollectParamUses(arg, is_condition, info))
+            return false;
+        }
+        return true;
+      }
+      break; case Expr::EXPR_FN_RETURN:
+      {
+        auto value = as<PTR<const FnReturnExpr>>(expr)->get_value();
+        return value == nullptr || CollectParamUses(value, false, info);
+      }
+      break; case Expr::EXPR_SCOPE:
+      {
+        for (auto stt : as<PTR<const ScopeExpr>>(expr)->get_body_array())
+        {
+          if (!CollectParamUses(stt, false, info))
+            return false;
+        }
+        return true;
+      }
+      break; case Expr::EXPR_CONDITION:
+      {
+        auto condition = as<PTR<const ConditionExpr>>(expr);
+        return CollectParamUses(condition->get_if_condition(), true, info)
+          && CollectParamUses(condition->get_if_statement(), false, info)
+          && (condition->get_else_statement() == nullptr
+            || CollectParamUses(condition->get_else_statement(), false, info));
+      }
+      break; case Expr::EXPR_WHILE_LOOP:
+      {
+        auto loop = as<PTR<const WhileLoopExpr>>(expr);
+        return CollectParamUses(loop->get_condition(), true, info)
+          && CollectParamUses(loop->get_body(), false, info);
+      }
+      break; case Expr::EXPR_PTR_LOAD:
+        return CollectParamUses(as<PTR<const PtrLoadExpr>>(expr)->get_where(), is_condition, info);
+      break; case Expr::EXPR_PTR_STORE:
+      {
+        auto store = as<PTR<const PtrStoreExpr>>(expr);
+        return CollectParamUses(store->get_where(), is_condition, info)
+          && CollectParamUses(store->get_value(), is_condition, info);
+      }
+      break; default:
+        return false;
+      }
+    }
+
+    /// @brief Check if the statements following an expression are unreachable
+    /// @param expr The expression to check
+    /// @return True if the expression returns, breaks or continues
+    bool IsJumpExpr(PTR<const Expr> expr) noexcept
+    {
+      if (is_a<ScopeExpr>(expr))
+        return IsJumpExpr(as<PTR<const ScopeExpr>>(expr)->get_body_array().get_back());
+      return is_a<BreakContinueExpr>(expr) || isTerminatedExpr(expr);
+    }
+  }
+
+  PTR<Expr> ASTMaker::parse_embed(const SavedExprInfo& line_state) noexcept
+  {
+    assert(current_tkn == TKN_KEYWORD_EMBED || current_tkn == TKN_KEYWORD_EMBED_COUNT);
+
+    bool is_count = current_tkn == TKN_KEYWORD_EMBED_COUNT;
+    consume_current_tkn(); // consume '@embed'
+    if (check_and_consume(TKN_LEFT_PAREN, &ASTMaker::panic_consume_semicolon, "Expected a '('!"))
+      return ErrorExpr::CreateExpr(ctx);
+    if (current_tkn != TKN_STRING_L)
+    {
+      generate_any_current<report_as::ERROR>(&ASTMaker::panic_consume_semicolon,
+        "Expected the path of the file to embed!");
+      return ErrorExpr::CreateExpr(ctx);
+    }
+    String path = lexer.get_string_literal();
+    consume_current_tkn(); // consume the path
+    //The source code information of the path, done AFTER consuming
+    SourceCodeExprInfo path_info = line_state.to_src_info();
+    if (check_and_consume(TKN_COMMA, &ASTMaker::panic_consume_semicolon, "Expected a ','!"))
+      return ErrorExpr::CreateExpr(ctx);
+    
+    PTR<const Type> type = parse_typename(&ASTMaker::panic_consume_semicolon);
+    if (type->is_error())
+      return ErrorExpr::CreateExpr(ctx);
+    if (check_and_consume(TKN_RIGHT_PAREN, &ASTMaker::panic_consume_semicolon, "Expected a ')'!"))
+      return ErrorExpr::CreateExpr(ctx);
+
+    size_t size = SizeOfEmbedded(type);
+    if (size == 0)
+    {
+      generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+        "Files can only be embedded as built-in types (except 'lstring'), not as '{}'!", type->get_name());
+      return ErrorExpr::CreateExpr(ctx);
+    }
+    if (!type->is_const())
+    {
+      generate_any<report_as::ERROR>(line_state.to_src_info(), nullptr,
+        "Embedded files are read-only: '{}' cannot be mutable!", type->get_name());
+      return ErrorExpr::CreateExpr(ctx);
+    }
+
+    //Relative paths are relative to the file being compiled
+    std::filesystem::path file_path = std::string{ StringView{ path }.get_data(), StringView{ path }.get_size() };
+    if (file_path.is_relative() && args::GlobalArguments.file_in != nullptr)
+      file_path = std::filesystem::path{ args::GlobalArguments.file_in }.parent_path() / file_path;
+    std::string file_str = file_path.string();
+    auto content = String::getFileContent(file_str.c_str());
+    if (content.is_error())
+    {
+      generate_any<report_as::ERROR>(path_info, nullptr,
+        "Could not read file '{}'!", file_str);
+      return ErrorExpr::CreateExpr(ctx);
+    }
+    if (content->get_size() % size != 0)
+    {
+      generate_any<report_as::ERROR>(path_info, nullptr,
+        "The size of '{}' ({} bytes) is not a multiple of the size of '{}' ({} bytes)!",
+        file_str, content->get_size(), type->get_name(), size);
+      return ErrorExpr::CreateExpr(ctx);
+    }
+    embedded_files.push_back(String{ StringView{ file_str.data(), file_str.size() } });
+
+    if (is_count)
+      return LiteralExpr::CreateExpr(QWORD{ as<u64>(content->get_size() / size) },
+        BuiltInType::CreateU64(true, ctx), line_state.to_src_info(), ctx);
+    auto data = str_table.insert(std::move(content.get_value())).first;
+    return EmbedExpr::CreateExpr(PtrType::CreatePtr(true, type, ctx), data,
+      line_state.to_src_info(), ctx);
+  }
+
   PTR<Expr> ASTMaker::parse_fn_call(StringView identifier, const SavedExprInfo& line_state) noexcept
   {
     assert(current_tkn == TKN_LEFT_PAREN);
@@ -1115,9 +1666,196 @@ namespace colt::lang
     return ret;
   }
 
+  PTR<ASTMaker::GenericFn> ASTMaker::find_generic_fn(StringView name) noexcept
+  {
+    for (size_t i = 0; i < generic_fns.get_size(); i++)
+    {
+      if (generic_fns[i].name == name)
+        return &generic_fns[i];
+    }
+    return nullptr;
+  }
+
+  bool ASTMaker::deduce_type_params(PTR<const Type> arg, const GenericFn& generic, SmallVector<PTR<const Type>, 4>& deduced) noexcept
+  {
+    if (current_tkn == TKN_KEYWORD_MUT)
+      consume_current_tkn();
+    if (current_tkn == TKN_IDENTIFIER)
+    {
+      StringView type_name = lexer.get_parsed_identifier();
+      for (size_t i = 0; i < generic.type_params.get_size(); i++)
+      {
+        if (generic.type_params[i] != type_name)
+          continue;
+        consume_current_tkn();
+        //Arguments are passed by value: their constness does not matter
+        auto type = arg->clone_as_const(ctx);
+        if (deduced[i] == nullptr)
+          deduced[i] = type;
+        return deduced[i]->is_equal(type);
+      }
+      return false;
+    }
+    if (current_tkn == TKN_KEYWORD_PTR)
+    {
+      if (!arg->is_ptr())
+        return false;
+      consume_current_tkn();
+      if (current_tkn != TKN_LESS)
+        return false;
+      consume_current_tkn();
+      if (!deduce_type_params(as<PTR<const PtrType>>(arg)->get_type_to(), generic, deduced))
+        return false;
+      if (current_tkn == TKN_GREAT_GREAT) // '>>' is parsed as '>' '>'
+        current_tkn = TKN_GREAT;
+      if (current_tkn != TKN_GREAT)
+        return false;
+      consume_current_tkn();
+      return true;
+    }
+    //Parameters that do not depend on the type parameters are checked on the call
+    parse_typename();
+    return true;
+  }
+
+  PTR<const FnDeclExpr> ASTMaker::instantiate_generic_fn(GenericFn& generic, const SmallVector<PTR<Expr>, 4>& arguments, const SourceCodeExprInfo& fn_call) noexcept
+  {
+    for (auto arg : arguments)
+    {
+      //The error was already reported
+      if (arg->get_type()->is_error())
+        return nullptr;
+    }
+
+    //The generic function is parsed from its saved tokens: restore the state on exit
+    Lexer saved_lexer = std::move(lexer);
+    Token saved_tkn = current_tkn;
+    SourceCodeLexemeInfo saved_current_info = current_lexeme_info;
+    SourceCodeLexemeInfo saved_last_info = last_lexeme_info;
+    ON_EXIT{
+      lexer = std::move(saved_lexer);
+      current_tkn = saved_tkn;
+      current_lexeme_info = saved_current_info;
+      last_lexeme_info = saved_last_info;
+    };
+
+    //Deduce the type parameters from the parameters of the declaration
+    lexer = generic.lexer;
+    current_tkn = TKN_KEYWORD_FN;
+    while (current_tkn != TKN_LEFT_PAREN && current_tkn != TKN_EOF)
+      consume_current_tkn();
+    consume_current_tkn(); // consume '('
+
+    SmallVector<PTR<const Type>, 4> deduced;
+    for (size_t i = 0; i < generic.type_params.get_size(); i++)
+      deduced.push_back(nullptr);
+    bool is_valid = true;
+    size_t params_count = 0;
+    while (current_tkn != TKN_RIGHT_PAREN && current_tkn != TKN_EOF)
+    {
+      if (params_count < arguments.get_size())
+        is_valid &= deduce_type_params(arguments[params_count]->get_type(), generic, deduced);
+      ++params_count;
+      //Skip the name of the parameter (and what could not be deduced)
+      u64 depth = 0;
+      while (current_tkn != TKN_EOF && (depth != 0 || (current_tkn != TKN_COMMA && current_tkn != TKN_RIGHT_PAREN)))
+      {
+        if (current_tkn == TKN_LEFT_PAREN)
+          ++depth;
+        else if (current_tkn == TKN_RIGHT_PAREN)
+          --depth;
+        consume_current_tkn();
+      }
+      if (current_tkn == TKN_COMMA)
+        consume_current_tkn();
+    }
+    if (params_count != arguments.get_size())
+    {
+      generate_any<report_as::ERROR>(fn_call, nullptr, "Generic function '{}' expects {} argument{} not {}!",
+        generic.name, params_count, params_count == 1 ? "," : "s,", arguments.get_size());
+      return nullptr;
+    }
+    if (!is_valid)
+    {
+      generate_any<report_as::ERROR>(fn_call, nullptr,
+        "The arguments do not match the parameters of generic function '{}'!", generic.name);
+      return nullptr;
+    }
+
+    //The type signature of the instantiation: NAME<TYPE, ...>
+    String key = String{ generic.name };
+    key += '<';
+    for (size_t i = 0; i < deduced.get_size(); i++)
+    {
+      if (deduced[i] == nullptr)
+      {
+        generate_any<report_as::ERROR>(fn_call, nullptr,
+          "Type parameter '{}' of generic function '{}' cannot be deduced from the arguments!",
+          generic.type_params[i], generic.name);
+        return nullptr;
+      }
+      if (i != 0)
+        key += ", ";
+      key += deduced[i]->get_name();
+    }
+    key += '>';
+    if (auto instance = generic.instantiations.find(key); instance != nullptr)
+      return instance->second;
+
+    //Parse the instantiation as a new function (with its own local variables)
+    StringView signature = ctx.add_str(std::move(key));
+    Vector<std::pair<StringView, PTR<const Type>>> bindings;
+    for (size_t i = 0; i < deduced.get_size(); i++)
+      bindings.push_back({ generic.type_params[i], deduced[i] });
+    Vector<std::pair<StringView, PTR<const Type>>> locals;
+    std::swap(bindings, generic_bindings);
+    std::swap(locals, local_var_table);
+    PTR<const FnDeclExpr> saved_function = current_function;
+    ScopedSave saved_loop(is_parsing_loop, false);
+    ScopedSave saved_ptr(is_parsing_ptr, false);
+
+    lexer = generic.lexer;
+    current_tkn = TKN_KEYWORD_FN;
+    instantiated_fn = &generic;
+    instantiation_key = signature;
+    u16 old_error_count = error_count;
+    auto instance = parse_fn_decl();
+    if (is_a<FnDefExpr>(instance))
+      expressions.push_back(instance);
+    if (error_count != old_error_count)
+      generate_any<report_as::MESSAGE>(fn_call, nullptr, "In instantiation of '{}' required here.", signature);
+
+    std::swap(bindings, generic_bindings);
+    std::swap(locals, local_var_table);
+    current_function = saved_function;
+
+    if (auto cached = generic.instantiations.find(signature); cached != nullptr)
+      return cached->second;
+    //Do not parse the failed instantiation again
+    generic.instantiations.insert(signature, nullptr);
+    return nullptr;
+  }
+
   PTR<Expr> ASTMaker::handle_function_call(StringView identifier, SmallVector<PTR<Expr>, 4>&& arguments, const SourceCodeExprInfo& identifier_loc, const SourceCodeExprInfo& fn_call) noexcept
   {
     auto ptr = global_map.find(identifier);
+    if (auto generic = find_generic_fn(identifier); generic != nullptr)
+    {
+      //Non-generic overloads are preferred if they match exactly
+      bool has_exact_overload = false;
+      if (ptr != nullptr && is_a<FnDefExpr>(ptr->second.get_front()))
+      {
+        for (auto i : ptr->second)
+          has_exact_overload |= MatchesExactly(as<PTR<const FnDefExpr>>(i), arguments);
+      }
+      if (!has_exact_overload)
+      {
+        if (auto decl = instantiate_generic_fn(*generic, arguments, fn_call);
+          decl != nullptr && validate_fn_call(arguments, decl, identifier, fn_call))
+          return FnCallExpr::CreateExpr(decl, std::move(arguments), fn_call, ctx);
+        return ErrorExpr::CreateExpr(ctx);
+      }
+    }
     if (ptr == nullptr)
     {
       generate_any<report_as::ERROR>(identifier_loc, nullptr,
@@ -1133,9 +1871,9 @@ namespace colt::lang
 
     if (ptr->second.get_size() == 1)
     {
-      if (auto decl = as<PTR<FnDefExpr>>(ptr->second.get_front())->get_fn_decl();
-        validate_fn_call(arguments, decl, identifier, fn_call))
-        return FnCallExpr::CreateExpr(decl, std::move(arguments), fn_call, ctx);
+      if (auto fn = as<PTR<const FnDefExpr>>(ptr->second.get_front());
+        validate_fn_call(arguments, fn->get_fn_decl(), identifier, fn_call))
+        return create_fn_call(fn, std::move(arguments), fn_call);
       return ErrorExpr::CreateExpr(ctx);
     }
 
@@ -1166,8 +1904,369 @@ namespace colt::lang
         "None of the overloads of function '{}' matches these arguments!", identifier);
       return ErrorExpr::CreateExpr(ctx);
     }
-    return FnCallExpr::CreateExpr(best->get_fn_decl(),
-      std::move(arguments), fn_call, ctx);
+    return create_fn_call(best, std::move(arguments), fn_call);
+  }
+
+  PTR<Expr> ASTMaker::create_fn_call(PTR<const FnDefExpr> fn, SmallVector<PTR<Expr>, 4>&& arguments, const SourceCodeExprInfo& fn_call) noexcept
+  {
+    //Instrumented functions must be called to be profiled, and
+    //the language server must see the calls to index them.
+    if (args::GlobalArguments.instrument_functions || args::GlobalArguments.lsp_mode)
+      return FnCallExpr::CreateExpr(fn->get_fn_decl(), std::move(arguments), fn_call, ctx);
+
+    InlineInfo info;
+    if (auto body = GetInlinableBody(fn); body != nullptr
+      && IsInlinable(body, true, info)
+      && CanSubstituteArguments(fn, arguments, info))
+      return inline_expr(body, arguments, fn_call);
+    if (auto specialization = specialize_fn(fn, arguments); specialization != nullptr)
+      return FnCallExpr::CreateExpr(specialization, std::move(arguments), fn_call, ctx);
+    return FnCallExpr::CreateExpr(fn->get_fn_decl(), std::move(arguments), fn_call, ctx);
+  }
+
+  PTR<Expr> ASTMaker::inline_expr(PTR<const Expr> expr, const SmallVector<PTR<Expr>, 4>& arguments, const SourceCodeExprInfo& fn_call) noexcept
+  {
+    switch (expr->classof())
+    {
+    case Expr::EXPR_LITERAL:
+    {
+      auto literal = as<PTR<const LiteralExpr>>(expr);
+      return LiteralExpr::CreateExpr(literal->get_value(), literal->get_type(), fn_call, ctx);
+    }
+    break; case Expr::EXPR_VAR_READ:
+    {
+      auto read = as<PTR<const VarReadExpr>>(expr);
+      if (read->is_global())
+        return VarReadExpr::CreateExpr(read->get_type(), read->get_name(), fn_call, ctx);
+      //Parameters are the first local variables of the function
+      return arguments[read->get_local_ID()];
+    }
+    break; case Expr::EXPR_UNARY:
+    {
+      auto unary = as<PTR<const UnaryExpr>>(expr);
+      return UnaryExpr::CreateExpr(unary->get_type(), UnaryOperatorToToken(unary->get_operation()),
+        inline_expr(unary->get_child(), arguments, fn_call), fn_call, ctx);
+    }
+    break; case Expr::EXPR_BINARY:
+    {
+      auto binary = as<PTR<const BinaryExpr>>(expr);
+      auto lhs = inline_expr(binary->get_LHS(), arguments, fn_call);
+      auto rhs = inline_expr(binary->get_RHS(), arguments, fn_call);
+      return BinaryExpr::CreateExpr(binary->get_type(), lhs,
+        BinaryOperatorToToken(binary->get_operation()), rhs, fn_call, ctx);
+    }
+    break; case Expr::EXPR_CONVERT:
+    {
+      auto convert = as<PTR<const ConvertExpr>>(expr);
+      return ConvertExpr::CreateExpr(convert->get_type(), inline_expr(convert->get_child(), arguments, fn_call),
+        convert->get_conversion_type() == ConvertExpr::CNV_AS ? TKN_KEYWORD_AS : TKN_KEYWORD_BIT_AS, fn_call, ctx);
+    }
+    break; case Expr::EXPR_PTR_LOAD:
+      return PtrLoadExpr::CreateExpr(inline_expr(as<PTR<const PtrLoadExpr>>(expr)->get_where(), arguments, fn_call), fn_call, ctx);
+    break; case Expr::EXPR_PTR_STORE:
+    {
+      auto store = as<PTR<const PtrStoreExpr>>(expr);
+      auto where = inline_expr(store->get_where(), arguments, fn_call);
+      auto value = inline_expr(store->get_value(), arguments, fn_call);
+      return PtrStoreExpr::CreateExpr(where, value, fn_call, ctx);
+    }
+    break; case Expr::EXPR_FN_CALL:
+    {
+      auto call = as<PTR<const FnCallExpr>>(expr);
+      SmallVector<PTR<Expr>, 4> call_args;
+      for (auto arg : call->get_arguments())
+        call_args.push_back(inline_expr(arg, arguments, fn_call));
+      return FnCallExpr::CreateExpr(call->get_fn_decl(), std::move(call_args), fn_call, ctx);
+    }
+    break; default:
+      colt_unreachable("Expression cannot be inlined!");
+    }
+  }
+
+  PTR<const FnDeclExpr> ASTMaker::specialize_fn(PTR<const FnDefExpr> fn, SmallVector<PTR<Expr>, 4>& arguments) noexcept
+  {
+    if (!fn->has_body() || fn->is_main() || fn->get_params_count() != arguments.get_size())
+      return nullptr;
+
+    SpecializeInfo info;
+    for (size_t i = 0; i < fn->get_params_count(); i++)
+    {
+      info.in_control_flow.push_back(false);
+      info.is_modified.push_back(false);
+    }
+    if (!CollectParamUses(fn->get_body(), false, info))
+      return nullptr;
+
+    //The key of the specialization: NAME, TYPE, then the value of each literal
+    //(or '_' for the parameters that are kept)
+    String key = String{ fn->get_name() };
+    key += fn->get_type()->get_name();
+    //Buffer in which to convert the values of the literals
+    char buffer[20];
+    SpecializedParams params = { {}, {}, 0 };
+    for (size_t i = 0; i < arguments.get_size(); i++)
+    {
+      key += ',';
+      if (info.in_control_flow[i] && !info.is_modified[i] && is_a<LiteralExpr>(arguments[i])
+        && !arguments[i]->get_type()->is_lstring()
+        && arguments[i]->get_type()->is_equal(fn->get_params_type()[i]))
+      {
+        auto literal = as<PTR<const LiteralExpr>>(arguments[i]);
+        params.constants.push_back(literal);
+        params.params_ID.push_back(0);
+        ++params.removed_count;
+
+        auto [ptr, ec] = std::to_chars(buffer, buffer + 20, literal->get_value().as<u64>());
+        key += StringView{ buffer, ptr };
+      }
+      else
+      {
+        params.constants.push_back(nullptr);
+        params.params_ID.push_back(i - params.removed_count);
+        key += '_';
+      }
+    }
+    if (params.removed_count == 0)
+      return nullptr;
+
+    PTR<const FnDeclExpr> specialization = nullptr;
+    if (auto cached = specializations.find(key); cached != nullptr)
+      specialization = cached->second;
+    else
+    {
+      //Limit the code size of the copies of the functions of a name
+      auto count = specializations_count.find(fn->get_name());
+      if (count == nullptr)
+      {
+        specializations_count.insert(fn->get_name(), 0);
+        count = specializations_count.find(fn->get_name());
+      }
+      if (count->second == SpecializeLimit)
+        return nullptr;
+
+      //The name of the specialization: NAME$INDEX ('$' cannot appear in identifiers)
+      String name = String{ fn->get_name() };
+      name += '$';
+      auto [ptr, ec] = std::to_chars(buffer, buffer + 20, count->second++);
+      name += StringView{ buffer, ptr };
+
+      SmallVector<PTR<const Type>, 4> params_type;
+      SmallVector<StringView, 4> params_name;
+      for (size_t i = 0; i < fn->get_params_count(); i++)
+      {
+        if (params.constants[i] != nullptr)
+          continue;
+        params_type.push_back(fn->get_params_type()[i]);
+        params_name.push_back(fn->get_params_name()[i]);
+      }
+      PTR<const Type> fn_ptr_t = FnType::CreateFn(fn->get_return_type(), std::move(params_type), false, ctx);
+      PTR<FnDeclExpr> declaration = as<PTR<FnDeclExpr>>(FnDeclExpr::CreateExpr(fn_ptr_t, ctx.add_str(std::move(name)),
+        std::move(params_name), false, fn->get_fn_decl()->get_src_code(), ctx));
+
+      expressions.push_back(FnDefExpr::CreateExpr(declaration,
+        specialize_expr(fn->get_body(), params), fn->get_src_code(), ctx));
+      specializations.insert(ctx.add_str(std::move(key)), declaration);
+      specialization = declaration;
+    }
+
+    //The literals are no longer passed to the function
+    SmallVector<PTR<Expr>, 4> kept_arguments;
+    for (size_t i = 0; i < arguments.get_size(); i++)
+    {
+      if (params.constants[i] == nullptr)
+        kept_arguments.push_back(arguments[i]);
+    }
+    std::swap(arguments, kept_arguments);
+    return specialization;
+  }
+
+  PTR<Expr> ASTMaker::specialize_expr(PTR<const Expr> expr, const SpecializedParams& params) noexcept
+  {
+    const SourceCodeExprInfo& src_info = expr->get_src_code();
+    switch (expr->classof())
+    {
+    case Expr::EXPR_LITERAL:
+    {
+      auto literal = as<PTR<const LiteralExpr>>(expr);
+      return LiteralExpr::CreateExpr(literal->get_value(), literal->get_type(), src_info, ctx);
+    }
+    break; case Expr::EXPR_VAR_READ:
+    {
+      auto read = as<PTR<const VarReadExpr>>(expr);
+      if (read->is_global())
+        return VarReadExpr::CreateExpr(read->get_type(), read->get_name(), src_info, ctx);
+      u64 ID = read->get_local_ID();
+      if (ID >= params.constants.get_size())
+        return VarReadExpr::CreateExpr(read->get_type(), read->get_name(), ID - params.removed_count, src_info, ctx);
+      if (auto literal = params.constants[ID]; literal != nullptr)
+        return LiteralExpr::CreateExpr(literal->get_value(), literal->get_type(), src_info, ctx);
+      return VarReadExpr::CreateExpr(read->get_type(), read->get_name(), params.params_ID[ID], src_info, ctx);
+    }
+    break; case Expr::EXPR_VAR_WRITE:
+    {
+      auto write = as<PTR<const VarWriteExpr>>(expr);
+      auto value = specialize_expr(write->get_value(), params);
+      PTR<Expr> var;
+      if (write->is_global())
+        var = VarReadExpr::CreateExpr(write->get_type(), write->get_name(), src_info, ctx);
+      else
+      {
+        //Removed parameters are never written
+        u64 ID = write->get_local_ID();
+        var = VarReadExpr::CreateExpr(write->get_type(), write->get_name(),
+          ID < params.params_ID.get_size() ? params.params_ID[ID] : ID - params.removed_count, src_info, ctx);
+      }
+      return VarWriteExpr::CreateExpr(as<PTR<const VarReadExpr>>(var), value, src_info, ctx);
+    }
+    break; case Expr::EXPR_UNARY:
+    {
+      auto unary = as<PTR<const UnaryExpr>>(expr);
+      auto child = specialize_expr(unary->get_child(), params);
+      if (is_a<LiteralExpr>(child))
+      {
+        auto literal = as<PTR<const LiteralExpr>>(child);
+        op::ResultQWORD result = { literal->get_value(), op::NO_ERROR };
+        switch (unary->get_operation())
+        {
+        case UnaryOperator::OP_NEGATE:
+          result = op::neg(literal->get_value(), literal->get_type()->get_builtin_id());
+        break; case UnaryOperator::OP_BIT_NOT:
+          result = op::bit_not(literal->get_value(), literal->get_type()->get_builtin_id());
+        break; case UnaryOperator::OP_BOOL_NOT:
+          result.first = QWORD{ !literal->get_value().as<bool>() };
+        break; default:
+          colt_unreachable("Invalid unary operator on literal!");
+        }
+        if (result.second == op::NO_ERROR)
+          return LiteralExpr::CreateExpr(result.first, unary->get_type(), src_info, ctx);
+      }
+      return UnaryExpr::CreateExpr(unary->get_type(), UnaryOperatorToToken(unary->get_operation()),
+        child, src_info, ctx);
+    }
+    break; case Expr::EXPR_BINARY:
+    {
+      auto binary = as<PTR<const BinaryExpr>>(expr);
+      BinaryOperator bin_op = binary->get_operation();
+      auto lhs = specialize_expr(binary->get_LHS(), params);
+      //Short-circuiting operators whose result is known from their LHS
+      if (is_a<LiteralExpr>(lhs)
+        && (bin_op == BinaryOperator::OP_BOOL_AND || bin_op == BinaryOperator::OP_BOOL_OR))
+      {
+        if (as<PTR<const LiteralExpr>>(lhs)->get_value().as<bool>() == (bin_op == BinaryOperator::OP_BOOL_OR))
+          return lhs;
+        return specialize_expr(binary->get_RHS(), params);
+      }
+      auto rhs = specialize_expr(binary->get_RHS(), params);
+      if (is_a<LiteralExpr>(lhs) && is_a<LiteralExpr>(rhs) && !lhs->get_type()->is_lstring())
+      {
+        auto lhs_l = as<PTR<const LiteralExpr>>(lhs);
+        auto [value, err] = op::getInstFromBinaryOperator(bin_op)(lhs_l->get_value(),
+          as<PTR<const LiteralExpr>>(rhs)->get_value(), lhs_l->get_type()->get_builtin_id());
+        //Errors (such as division by zero) are left to the execution
+        if (err == op::NO_ERROR)
+          return LiteralExpr::CreateExpr(value, binary->get_type(), src_info, ctx);
+      }
+      return BinaryExpr::CreateExpr(binary->get_type(), lhs,
+        BinaryOperatorToToken(bin_op), rhs, src_info, ctx);
+    }
+    break; case Expr::EXPR_CONVERT:
+    {
+      auto convert = as<PTR<const ConvertExpr>>(expr);
+      auto child = specialize_expr(convert->get_child(), params);
+      if (is_a<LiteralExpr>(child) && convert->get_conversion_type() == ConvertExpr::CNV_AS
+        && !convert->get_type()->is_lstring())
+      {
+        auto literal = as<PTR<const LiteralExpr>>(child);
+        auto [value, err] = op::cnv(literal->get_value(), literal->get_type()->get_builtin_id(),
+          convert->get_type()->get_builtin_id());
+        if (err == op::NO_ERROR)
+          return LiteralExpr::CreateExpr(value, convert->get_type(), src_info, ctx);
+      }
+      return ConvertExpr::CreateExpr(convert->get_type(), child,
+        convert->get_conversion_type() == ConvertExpr::CNV_AS ? TKN_KEYWORD_AS : TKN_KEYWORD_BIT_AS, src_info, ctx);
+    }
+    break; case Expr::EXPR_VAR_DECL:
+    {
+      auto decl = as<PTR<const VarDeclExpr>>(expr);
+      return VarDeclExpr::CreateExpr(decl->get_type(), decl->get_name(),
+        decl->is_initialized() ? specialize_expr(decl->get_value(), params) : nullptr,
+        false, src_info, ctx);
+    }
+    break; case Expr::EXPR_FN_CALL:
+    {
+      auto call = as<PTR<const FnCallExpr>>(expr);
+      SmallVector<PTR<Expr>, 4> call_args;
+      for (auto arg : call->get_arguments())
+        call_args.push_back(specialize_expr(arg, params));
+      return FnCallExpr::CreateExpr(call->get_fn_decl(), std::move(call_args), src_info, ctx);
+    }
+    break; case Expr::EXPR_FN_RETURN:
+    {
+      auto value = as<PTR<const FnReturnExpr>>(expr)->get_value();
+      return FnReturnExpr::CreateExpr(value == nullptr ? nullptr : specialize_expr(value, params),
+        src_info, ctx);
+    }
+    break; case Expr::EXPR_SCOPE:
+    {
+      Vector<PTR<Expr>> statements = {};
+      for (auto stt : as<PTR<const ScopeExpr>>(expr)->get_body_array())
+      {
+        statements.push_back(specialize_expr(stt, params));
+        //The statements following a folded condition may be unreachable
+        if (IsJumpExpr(statements.get_back()))
+          break;
+      }
+      return ScopeExpr::CreateExpr(std::move(statements), src_info, ctx);
+    }
+    break; case Expr::EXPR_CONDITION:
+    {
+      auto condition = as<PTR<const ConditionExpr>>(expr);
+      auto if_cond = specialize_expr(condition->get_if_condition(), params);
+      //Only the branch taken is kept
+      if (is_a<LiteralExpr>(if_cond))
+      {
+        if (as<PTR<const LiteralExpr>>(if_cond)->get_value().as<bool>())
+          return specialize_expr(condition->get_if_statement(), params);
+        if (condition->get_else_statement() != nullptr)
+          return specialize_expr(condition->get_else_statement(), params);
+        return NoOpExpr::CreateExpr(src_info, ctx);
+      }
+      auto if_stmt = specialize_expr(condition->get_if_statement(), params);
+      auto else_stmt = condition->get_else_statement() == nullptr ? nullptr
+        : specialize_expr(condition->get_else_statement(), params);
+      return ConditionExpr::CreateExpr(if_cond, if_stmt, else_stmt, src_info, ctx);
+    }
+    break; case Expr::EXPR_WHILE_LOOP:
+    {
+      auto loop = as<PTR<const WhileLoopExpr>>(expr);
+      auto condition = specialize_expr(loop->get_condition(), params);
+      //The body of a loop whose condition is false is never executed
+      if (is_a<LiteralExpr>(condition) && !as<PTR<const LiteralExpr>>(condition)->get_value().as<bool>())
+        return NoOpExpr::CreateExpr(src_info, ctx);
+      return WhileLoopExpr::CreateExpr(condition, specialize_expr(loop->get_body(), params),
+        src_info, ctx);
+    }
+    break; case Expr::EXPR_BREAK_CONTINUE:
+      return BreakContinueExpr::CreateExpr(as<PTR<const BreakContinueExpr>>(expr)->is_break(), src_info, ctx);
+    break; case Expr::EXPR_NOP:
+      return NoOpExpr::CreateExpr(src_info, ctx);
+    break; case Expr::EXPR_PTR_LOAD:
+      return PtrLoadExpr::CreateExpr(specialize_expr(as<PTR<const PtrLoadExpr>>(expr)->get_where(), params), src_info, ctx);
+    break; case Expr::EXPR_PTR_STORE:
+    {
+      auto store = as<PTR<const PtrStoreExpr>>(expr);
+      auto where = specialize_expr(store->get_where(), params);
+      auto value = specialize_expr(store->get_value(), params);
+      return PtrStoreExpr::CreateExpr(where, value, src_info, ctx);
+    }
+    break; case Expr::EXPR_EMBED:
+    {
+      auto embed = as<PTR<const EmbedExpr>>(expr);
+      return EmbedExpr::CreateExpr(embed->get_type(), embed->get_data_str(), src_info, ctx);
+    }
+    break; default:
+      colt_unreachable("Expression cannot be specialized!");
+    }
   }
 
   void ASTMaker::handle_unreachable_code() noexcept
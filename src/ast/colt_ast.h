@@ -74,6 +74,31 @@ namespace colt::lang
       SourceCodeExprInfo to_src_info() const noexcept;
     };
 
+    /// @brief A generic function, whose instantiations are parsed from its tokens
+    struct GenericFn
+    {
+      /// @brief The name of the function
+      StringView name;
+      /// @brief The names of the type parameters
+      SmallVector<StringView, 4> type_params;
+      /// @brief The lexer saved on the 'fn' of the declaration
+      Lexer lexer;
+      /// @brief The instantiations, by type signature ('NAME<TYPE, ...>').
+      ///        The declaration is nullptr if the instantiation failed.
+      Map<StringView, PTR<const FnDeclExpr>> instantiations;
+    };
+
+    /// @brief The parameters of a function being specialized
+    struct SpecializedParams
+    {
+      /// @brief The literal substituted to each parameter, or nullptr if the parameter is kept
+      SmallVector<PTR<const LiteralExpr>, 4> constants;
+      /// @brief The local ID of each parameter in the specialization (if kept)
+      SmallVector<u64, 4> params_ID;
+      /// @brief The number of parameters removed (the IDs of other locals are shifted by it)
+      u64 removed_count;
+    };
+
     /************* MEMBERS ************/
 
     /// @brief The array of expressions
@@ -102,8 +127,23 @@ namespace colt::lang
     Map<StringView, SmallVector<PTR<Expr>>>& global_map;
     /// @brief Table of String literals
     StableSet<String>& str_table;
+    /// @brief The paths of the files embedded through '@embed'
+    Vector<String>& embedded_files;
     /// @brief The context storing types and expressions
     COLTContext& ctx;
+    /// @brief The generic functions, instantiated on use
+    Vector<GenericFn> generic_fns = {};
+    /// @brief The types bound to the type parameters of the instantiation being parsed
+    Vector<std::pair<StringView, PTR<const Type>>> generic_bindings = {};
+    /// @brief The generic function whose instantiation is about to be parsed, or nullptr
+    PTR<GenericFn> instantiated_fn = nullptr;
+    /// @brief The type signature of the instantiation about to be parsed
+    StringView instantiation_key = {};
+    /// @brief The specializations of functions on constant arguments,
+    ///        by function and values of the arguments
+    Map<StringView, PTR<const FnDeclExpr>> specializations = {};
+    /// @brief The number of specializations of the functions of each name
+    Map<StringView, u64> specializations_count = {};
 
     /************* STATE HANDLING HELPERS ************/
 
@@ -227,6 +267,17 @@ namespace colt::lang
     /// @return Resulting expression or ErrorExpr on errors
     PTR<Expr> parse_fn_decl() noexcept;
 
+    /// @brief Parses the declaration of a generic function ('fn NAME<T, ...>(...)').
+    /// The declaration is not type checked: its tokens are skipped, and parsed
+    /// again (with the type parameters bound) for each instantiation.
+    /// Precondition: current_tkn == TKN_LESS
+    /// @param fn_name The name of the function
+    /// @param is_extern True if the function was declared 'extern'
+    /// @param fn_begin The lexer saved on the 'fn' of the declaration
+    /// @param line_state The line state of the declaration
+    /// @return NoOpExpr or ErrorExpr
+    PTR<Expr> parse_generic_fn_decl(StringView fn_name, bool is_extern, Lexer&& fn_begin, const SavedExprInfo& line_state) noexcept;
+
     /// @brief Parses a scope.
     /// If 'one_expr' is true, accepts a single statement scope
     /// (starting with ':', not '{').
@@ -273,6 +324,12 @@ namespace colt::lang
     /// @return VarReadExpr, FnCallExpr, or ErrorExpr
     PTR<Expr> parse_identifier(const SavedExprInfo& line_state) noexcept;
 
+    /// @brief Parses '@embed("PATH", TYPE)' or '@embed_count("PATH", TYPE)'.
+    /// The file is read at compile time: relative paths are relative to the
+    /// directory of the file being compiled (or to the working directory).
+    /// @return EmbedExpr (pointer to the content), LiteralExpr (the number of TYPE in the file), or ErrorExpr
+    PTR<Expr> parse_embed(const SavedExprInfo& line_state) noexcept;
+
     /// @brief Handles a function call, with overload resolution
     /// @param identifier The function name
     /// @param line_state The line state from of the function calling this function
@@ -304,8 +361,71 @@ namespace colt::lang
     /// @brief Check recursively and prints errors if 'expr' does not end with a return
     void validate_all_path_return(PTR<const Expr> expr) noexcept;
 
+    /// @brief Searches for a generic function
+    /// @param name The name of the function
+    /// @return The generic function or nullptr if not found
+    PTR<GenericFn> find_generic_fn(StringView name) noexcept;
+
+    /// @brief Deduces type parameters from the type of an argument, consuming
+    ///        the typename of the corresponding parameter.
+    /// Only parameters of type 'T', 'mut T' or 'PTR<...T>' bind the type parameter 'T'.
+    /// @param arg The type of the argument
+    /// @param generic The generic function being called
+    /// @param deduced The types deduced for each type parameter (nullptr if not deduced yet)
+    /// @return False if the argument does not match the parameter
+    bool deduce_type_params(PTR<const Type> arg, const GenericFn& generic, SmallVector<PTR<const Type>, 4>& deduced) noexcept;
+
+    /// @brief Instantiates a generic function for the types of the arguments of a call.
+    /// Instantiations are cached by type signature: each is parsed once, and
+    /// added to the AST before the function calling it.
+    /// @param generic The generic function being called
+    /// @param arguments The arguments of the call
+    /// @param fn_call The source code information of the call
+    /// @return The declaration of the instantiation, or nullptr on errors
+    PTR<const FnDeclExpr> instantiate_generic_fn(GenericFn& generic, const SmallVector<PTR<Expr>, 4>& arguments, const SourceCodeExprInfo& fn_call) noexcept;
+
     PTR<Expr> handle_function_call(StringView identifier, SmallVector<PTR<Expr>, 4>&& arguments, const SourceCodeExprInfo&  identifier_loc, const SourceCodeExprInfo& fn_call) noexcept;
 
+    /// @brief Creates a call to a function, or inlines the function if its body
+    /// is a single small expression (such as a wrapper calling another function).
+    /// Inlining is done at all optimization levels, so that calls through wrappers
+    /// do not require a call frame even when the LLVM inliner does not run.
+    /// Functions called with literals read by their conditions are specialized
+    /// for these literals (see 'specialize_fn').
+    /// @param fn The function to call
+    /// @param arguments The (validated) arguments of the call
+    /// @param fn_call The source code information of the call
+    /// @return FnCallExpr or the inlined body of the function
+    PTR<Expr> create_fn_call(PTR<const FnDefExpr> fn, SmallVector<PTR<Expr>, 4>&& arguments, const SourceCodeExprInfo& fn_call) noexcept;
+
+    /// @brief Copies an expression of the body of an inlined function, replacing
+    /// the reads of the parameters by the arguments of the call
+    /// @param expr The expression to copy (accepted by 'IsInlinable')
+    /// @param arguments The arguments of the call
+    /// @param fn_call The source code information of the call
+    /// @return The copy of the expression
+    PTR<Expr> inline_expr(PTR<const Expr> expr, const SmallVector<PTR<Expr>, 4>& arguments, const SourceCodeExprInfo& fn_call) noexcept;
+
+    /// @brief Specializes a function for the literal arguments of a call, if
+    /// the corresponding parameters are read by conditions or loop conditions.
+    /// The parameters are removed from the specialization, which is a copy of
+    /// the function where their reads are replaced by the literals and folded.
+    /// Specializations are cached by function and values of the literals, and
+    /// added to the AST before the function calling them.
+    /// @param fn The function to call
+    /// @param arguments The (validated) arguments of the call, from which the
+    ///        literals are removed if the function is specialized
+    /// @return The specialization, or nullptr if the function was not specialized
+    PTR<const FnDeclExpr> specialize_fn(PTR<const FnDefExpr> fn, SmallVector<PTR<Expr>, 4>& arguments) noexcept;
+
+    /// @brief Copies an expression of the body of a function being specialized,
+    /// replacing the reads of the removed parameters by their literal and folding
+    /// the resulting constant expressions, conditions and loops.
+    /// @param expr The expression to copy
+    /// @param params The parameters of the specialization
+    /// @return The copy of the expression
+    PTR<Expr> specialize_expr(PTR<const Expr> expr, const SpecializedParams& params) noexcept;
+
     PTR<Expr> save_var_decl(bool is_global, PTR<const Type> var_type, StringView var_name, PTR<Expr> var_init, const SourceCodeExprInfo& src_info) noexcept;
 
     //PTR<Expr> generate_move();
@@ -434,6 +554,8 @@ namespace colt::lang
     Map<StringView, SmallVector<PTR<Expr>>> global_map = {};
     /// @brief The table of String literals
     StableSet<String> str_table = {};
+    /// @brief The paths of the files embedded through '@embed' (for dependency files)
+    Vector<String> embedded_files = {};
     /// @brief The context storing type and expression informations
     COLTContext& ctx;
 
@@ -178,4 +178,12 @@ namespace colt::lang
       as<PTR<const PtrType>>(where->get_type()), where, src_info
       ));
   }
+
+  PTR<Expr> EmbedExpr::CreateExpr(PTR<const Type> ptr_type, PTR<const String> data, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept
+  {
+    assert_true(ptr_type->is_ptr(), "Expected a pointer type!");
+    return ctx.add_expr(make_unique<EmbedExpr>(
+      as<PTR<const PtrType>>(ptr_type), data, src_info
+      ));
+  }
 }
\ No newline at end of file
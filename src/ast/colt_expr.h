@@ -97,7 +97,9 @@ namespace colt::lang
       /// @brief PtrStoreExpr
       EXPR_PTR_STORE,
       /// @brief PtrLoadExpr
-      EXPR_PTR_LOAD
+      EXPR_PTR_LOAD,
+      /// @brief EmbedExpr
+      EXPR_EMBED
     };
 
     /// @brief Helper for dyn_cast and is_a
@@ -1131,6 +1133,51 @@ namespace colt::lang
     static PTR<Expr> CreateExpr(PTR<Expr> where, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
   };
   
+  /// @brief Represents the content of a file embedded at compile time ('@embed').
+  /// The content is emitted as a read-only global, and the expression is a pointer to it.
+  class EmbedExpr
+    final : public Expr
+  {
+    /// @brief The content of the file (stored in the string table of the AST)
+    PTR<const String> data;
+
+  public:
+    /// @brief Helper for dyn_cast and is_a
+    static constexpr ExprID classof_v = EXPR_EMBED;
+
+    //No default copy constructor 
+    EmbedExpr(const EmbedExpr&) = delete;
+    //No default constructor
+    EmbedExpr() = delete;
+    /// @brief Destructor
+    ~EmbedExpr() noexcept override = default;
+
+    /// @brief Constructs an embedded file expression
+    /// @param ptr_type The type of the resulting expression (pointer to the type of the elements)
+    /// @param data The content of the file
+    /// @param src_info The source code information
+    EmbedExpr(PTR<const PtrType> ptr_type, PTR<const String> data, const SourceCodeExprInfo& src_info) noexcept
+      : Expr(EXPR_EMBED, ptr_type, src_info), data(data) {}
+
+    /// @brief Returns the type of the expression
+    /// @return Pointer to the type of the elements
+    PTR<const PtrType> get_ptr_type() const noexcept { return as<PTR<const PtrType>>(get_type()); }
+    /// @brief Returns the content of the embedded file
+    /// @return The content of the file
+    StringView get_data() const noexcept { return *data; }
+    /// @brief Returns the string storing the content of the embedded file
+    /// @return The content of the file
+    PTR<const String> get_data_str() const noexcept { return data; }
+
+    /// @brief Constructs an embedded file expression
+    /// @param ptr_type The type of the resulting expression (pointer to the type of the elements)
+    /// @param data The content of the file (which must outlive the expression)
+    /// @param src_info The source code information
+    /// @param ctx The COLTContext to store the resulting expression
+    /// @return Pointer to the created expression
+    static PTR<Expr> CreateExpr(PTR<const Type> ptr_type, PTR<const String> data, const SourceCodeExprInfo& src_info, COLTContext& ctx) noexcept;
+  };
+
   template<typename T, typename>
   PTR<Expr> LiteralExpr::CreateValue(T value, COLTContext& ctx) noexcept
   {
@@ -22,6 +22,23 @@ namespace colt::lang
       colt_unreachable("Invalid Unary Operator!");
     }
     }
+
+  Token UnaryOperatorToToken(UnaryOperator op) noexcept
+  {
+    switch (op)
+    {
+    case UnaryOperator::OP_ADDRESSOF:
+      return TKN_AND;
+    case UnaryOperator::OP_NEGATE:
+      return TKN_MINUS;
+    case UnaryOperator::OP_BOOL_NOT:
+      return TKN_BANG;
+    case UnaryOperator::OP_BIT_NOT:
+      return TKN_TILDE;
+    default:
+      colt_unreachable("Invalid Unary Operator!");
+    }
+  }
   
   BinaryOperator TokenToBinaryOperator(Token tkn) noexcept
   {
@@ -29,6 +46,12 @@ namespace colt::lang
     assert_true(static_cast<size_t>(tkn) < TKN_COMMA, "Invalid Binary Operator!");
     return static_cast<BinaryOperator>(tkn);
   }
+
+  Token BinaryOperatorToToken(BinaryOperator op) noexcept
+  {
+    //Binary operators have the same value as their tokens
+    return static_cast<Token>(op);
+  }
   
   const char* BinaryOperatorToString(BinaryOperator tkn) noexcept
   {
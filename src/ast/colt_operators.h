@@ -29,6 +29,11 @@ namespace colt::lang
 	/// @return Assertion failure or a valid UnaryOperator
 	UnaryOperator TokenToUnaryOperator(Token tkn) noexcept;
 
+	/// @brief Converts a UnaryOperator to the Token from which it is parsed
+	/// @param op The operator to convert
+	/// @return The Token of the operator
+	Token UnaryOperatorToToken(UnaryOperator op) noexcept;
+
 	/// @brief Possible binary operators
 	enum class BinaryOperator
 		: u8
@@ -108,6 +113,11 @@ namespace colt::lang
 	/// @param tkn The Token to convert
 	/// @return Assertion failure or a valid BinaryOperator
 	BinaryOperator TokenToBinaryOperator(Token tkn) noexcept;
+
+	/// @brief Converts a BinaryOperator to the Token from which it is parsed
+	/// @param op The operator to convert
+	/// @return The Token of the operator
+	Token BinaryOperatorToToken(BinaryOperator op) noexcept;
 	
 	/// @brief Converts a binary operator to an 'lstring'
 	/// @param tkn The operator
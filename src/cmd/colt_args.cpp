@@ -32,6 +32,8 @@ namespace colt::args
     //Set to default if the value was not already changed
     if (details::global_args.opt_level == static_cast<gen::OptimizationLevel>(0))
       details::global_args.opt_level = gen::OptimizationLevel::O1;
+    //'--lib-path' may follow '--link-lib'
+    details::resolve_link_libs();
   }
 
   namespace details
@@ -171,6 +173,173 @@ namespace colt::args
       std::exit(0);
     }
 
+    void remarks_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      if (global_args.remarks_regex != nullptr)
+        print_error_and_exit("Remarks regex can only be set once!");
+      global_args.remarks_regex = argv[++current_arg];
+    }
+
+    void remarks_file_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      if (global_args.remarks_file != nullptr)
+        print_error_and_exit("Remarks file can only be set once!");
+      auto file = argv[++current_arg];
+      if (!colt::isValidFileName({ file, std::strlen(file) }))
+        print_error_and_exit("Path '{}' is invalid!", file);
+      global_args.remarks_file = file;
+    }
+
+    void instrument_functions_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      if (global_args.profile_hz != 0)
+        print_error_and_exit("'--instrument-functions' cannot be used with '--profile'!");
+      global_args.instrument_functions = true;
+    }
+
+    void emit_c_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      auto file = argv[++current_arg];
+      if (!colt::isValidFileName({ file, std::strlen(file) }))
+        print_error_and_exit("Path '{}' is invalid!", file);
+      global_args.emit_c = file;
+    }
+
+    void profile_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      if (global_args.instrument_functions)
+        print_error_and_exit("'--profile' cannot be used with '--instrument-functions'!");
+      StringView hz = argv[++current_arg];
+      u32 value = 0;
+      if (auto [ptr, err] = std::from_chars(hz.begin(), hz.end(), value);
+        err != std::errc{} || ptr != hz.end() || value == 0 || value > 10000)
+        print_error_and_exit("Invalid sampling frequency '{}'!", hz);
+      global_args.profile_hz = value;
+    }
+
+    void jit_huge_pages_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      global_args.jit_huge_pages = true;
+    }
+
+    void jit_hot_functions_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      auto file = argv[++current_arg];
+      if (std::error_code code; !std::filesystem::exists(file, code))
+        print_error_and_exit("File at path '{}' does not exist!", file);
+      global_args.jit_hot_functions = file;
+      global_args.jit_huge_pages = true;
+    }
+
+    void link_lib_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      global_args.link_libs.push_back(argv[++current_arg]);
+    }
+
+    void lib_path_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      auto dir = argv[++current_arg];
+      if (std::error_code code; !std::filesystem::is_directory(dir, code))
+        print_error_and_exit("Directory '{}' does not exist!", dir);
+      global_args.lib_paths.push_back(dir);
+    }
+
+    void dep_file_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      auto file = argv[++current_arg];
+      if (!colt::isValidFileName({ file, std::strlen(file) }))
+        print_error_and_exit("Path '{}' is invalid!", file);
+      global_args.dep_file = file;
+    }
+
+    void mir_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      global_args.use_mir = true;
+    }
+
+    void print_mir_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      global_args.use_mir = true;
+      global_args.print_mir = true;
+    }
+
+    void function_order_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      auto file = argv[++current_arg];
+      if (std::error_code code; !std::filesystem::exists(file, code))
+        print_error_and_exit("File at path '{}' does not exist!", file);
+      global_args.function_order = file;
+    }
+
+    void size_report_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      global_args.size_report = true;
+    }
+
+    void stack_usage_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      global_args.stack_usage = true;
+    }
+
+    void stack_budget_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      StringView bytes = argv[++current_arg];
+      u64 value = 0;
+      if (auto [ptr, err] = std::from_chars(bytes.begin(), bytes.end(), value);
+        err != std::errc{} || ptr != bytes.end() || value == 0)
+        print_error_and_exit("Invalid stack budget '{}'!", bytes);
+      global_args.stack_budget = value;
+    }
+
+    void lsp_callback(int argc, const char** argv, size_t& current_arg) noexcept
+    {
+      global_args.lsp_mode = true;
+      //stdout is reserved for the protocol
+      global_args.wait_for_user_input = false;
+      global_args.colored_output = false;
+      global_args.print_errors = false;
+      global_args.print_warnings = false;
+      global_args.print_messages = false;
+    }
+
+    void resolve_link_libs() noexcept
+    {
+#if defined(_WIN32)
+      constexpr const char* Prefix = "";
+      constexpr const char* Extension = ".dll";
+#elif defined(__APPLE__)
+      constexpr const char* Prefix = "lib";
+      constexpr const char* Extension = ".dylib";
+#else
+      constexpr const char* Prefix = "lib";
+      constexpr const char* Extension = ".so";
+#endif
+      for (auto& lib : global_args.link_libs)
+      {
+        std::error_code code;
+        if (std::filesystem::is_regular_file(lib, code))
+          continue;
+        bool found = false;
+        for (auto dir : global_args.lib_paths)
+        {
+          for (auto name : { lib, fmt::format("{}{}{}", Prefix, lib, Extension) })
+          {
+            auto path = std::filesystem::path(dir) / name;
+            if (std::filesystem::is_regular_file(path, code))
+            {
+              lib = path.string();
+              found = true;
+              break;
+            }
+          }
+          if (found)
+            break;
+        }
+        if (!found)
+          print_error_and_exit("Library '{}' was not found!", lib);
+      }
+    }
+
     /*************************************
     * ARGUMENT HANDLING
     *************************************/
@@ -13,6 +13,8 @@
 #include <array>
 #include <algorithm>
 #include <filesystem>
+#include <string>
+#include <vector>
 
 #include <colt/data_structs/String.h>
 #include <code_gen/opt_level.h>
@@ -43,6 +45,40 @@ namespace colt::args
 		bool jit_run_main = false;
 		/// @brief Optimization level
 		gen::OptimizationLevel opt_level = static_cast<gen::OptimizationLevel>(0);
+		/// @brief If not null, the regex of the passes whose optimization remarks are printed
+		const char* remarks_regex = nullptr;
+		/// @brief If not null, the path of the YAML file in which to write optimization remarks
+		const char* remarks_file = nullptr;
+		/// @brief If true, functions call the profiler runtime on entry and exit
+		bool instrument_functions = false;
+		/// @brief If not null, the path of the file in which to write the generated C source code
+		const char* emit_c = nullptr;
+		/// @brief If true, runs the language server instead of compiling
+		bool lsp_mode = false;
+		/// @brief If not 0, the frequency (in Hz) at which 'main' is sampled when run through the JIT
+		u32 profile_hz = 0;
+		/// @brief If true, the code emitted by the JIT is allocated in huge pages
+		bool jit_huge_pages = false;
+		/// @brief If not null, the path of the folded stacks whose hot functions are packed by the JIT
+		const char* jit_hot_functions = nullptr;
+		/// @brief If not null, the path of the Makefile rule listing the files on which the output depends
+		const char* dep_file = nullptr;
+		/// @brief If true, function bodies are lowered to the MIR and optimized before generating LLVM IR
+		bool use_mir = false;
+		/// @brief If true, the optimized MIR of each function is printed
+		bool print_mir = false;
+		/// @brief If not null, the path of the file listing the functions to place first (hottest first)
+		const char* function_order = nullptr;
+		/// @brief If true, the size of the machine code of each function is printed after optimizations
+		bool size_report = false;
+		/// @brief If true, the worst-case stack usage of each function is printed after optimizations
+		bool stack_usage = false;
+		/// @brief If not 0, the maximum worst-case stack usage of entry points: compilation fails if exceeded
+		u64 stack_budget = 0;
+		/// @brief The shared libraries to load (resolved to paths once all the arguments are parsed)
+		std::vector<std::string> link_libs{};
+		/// @brief The directories in which to search 'link_libs'
+		std::vector<const char*> lib_paths{};
 	};
 
 	/// @brief Parses the command line arguments, and stores them globally.
@@ -164,6 +200,95 @@ namespace colt::args
 		/// @param argv The array of arguments
 		/// @param current_arg The current argument
 		void demangle_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Remarks callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void remarks_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Remarks file callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void remarks_file_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Instrument functions callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void instrument_functions_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Emit C callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void emit_c_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Language server callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void lsp_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Sampling profiler callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void profile_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief JIT huge pages callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void jit_huge_pages_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief JIT hot functions callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void jit_hot_functions_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Link library callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void link_lib_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Library path callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void lib_path_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Dependency file callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void dep_file_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief MIR callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void mir_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Print MIR callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void print_mir_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Function order callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void function_order_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Size report callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void size_report_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Stack usage callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void stack_usage_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+		/// @brief Stack budget callback
+		/// @param argc The total argument count
+		/// @param argv The array of arguments
+		/// @param current_arg The current argument
+		void stack_budget_callback(int argc, const char** argv, size_t& current_arg) noexcept;
+
+		/// @brief Resolves the libraries of '--link-lib' to paths, searching
+		///        in the '--lib-path' directories. Exits if a library is not found.
+		void resolve_link_libs() noexcept;
 
 
 		/// @brief Contains all predefined valid arguments
@@ -172,7 +297,7 @@ namespace colt::args
 			Argument{ "version", "v", "Prints the version of the compiler.\nUse: --version/-v", 0, &version_callback},
 			Argument{ "help", "h", "Prints the documentation of a command.\nUse: --help/-h <COMMAND>", 1, &help_callback},
 			Argument{ "enum", "e", "Enumerates all possible commands.\nUse: --enum/-e", 0, &enum_callback},
-			Argument{ "print-ir", "i", "Prints generated LLVM IR.\nUse: --print-ir/-i", 0, &print_ir_callback},
+			Argument{ "print-ir", "i", "Prints generated LLVM IR (or C source code if compiled without LLVM).\nUse: --print-ir/-i", 0, &print_ir_callback},
 			Argument{ "no-color", "C", "Removes colored/highlighted outputs on the console.\nUse: --no-color/-C", 0, &no_color_callback},
 			Argument{ "no-error", "E", "Removes error outputs.\nUse: --no-error/-E", 0, &no_error_callback},
 			Argument{ "no-warn", "W", "Removes warning outputs.\nUse: --no-warn/-W", 0, &no_warning_callback},
@@ -187,6 +312,23 @@ namespace colt::args
 			Argument{ "opt-z", "Oz", "Optimize for small code size at all cost.\nUse: --opt-z/-Oz", 0, &oz_callback},
 			Argument{ "run-main", "r", "Run 'main' function inside the compiler if it exists.\nUse: --run-main/-r", 0, &run_main_callback},
 			Argument{ "demangle", "", "Demangles a string.\nUse: --demangle <STRING>", 1, &demangle_callback},
+			Argument{ "remarks", "", "Prints the optimization remarks of the passes matching a regex.\nUse: --remarks <REGEX>", 1, &remarks_callback},
+			Argument{ "remarks-file", "", "Writes the optimization remarks to a YAML file.\nUse: --remarks-file <PATH>", 1, &remarks_file_callback},
+			Argument{ "instrument-functions", "", "Instruments functions to profile the time spent in them.\nThe report is written at exit to '$COLT_PROFILE.txt/.folded' (default 'colt_profile').\nUse: --instrument-functions", 0, &instrument_functions_callback},
+			Argument{ "emit-c", "", "Writes the C source code generated from the file.\nUse: --emit-c <PATH>", 1, &emit_c_callback},
+			Argument{ "lsp", "", "Runs the language server (Language Server Protocol over stdin/stdout).\nUse: --lsp", 0, &lsp_callback},
+			Argument{ "profile", "", "Samples 'main' run through '--run-main' at a frequency (in Hz, 1 to 10000).\nThe report is written at exit to '$COLT_PROFILE.txt/.folded' (default 'colt_profile').\nUse: --profile <HZ>", 1, &profile_callback},
+			Argument{ "jit-huge-pages", "", "Allocates the code emitted by the JIT in 2MB (transparent) huge pages.\nCode pages are made read-execute once written, which splits the mapping of the huge pages in 4KB pages.\nUse: --jit-huge-pages", 0, &jit_huge_pages_callback},
+			Argument{ "jit-hot-functions", "", "Packs the hottest functions of a folded stacks profile (from '--profile' or '--instrument-functions') in their own huge pages.\nImplies '--jit-huge-pages'.\nUse: --jit-hot-functions <PATH>", 1, &jit_hot_functions_callback},
+			Argument{ "link-lib", "", "Loads a shared library whose symbols can be used through 'extern fn' when running 'main'.\nThe name is searched as is, then as 'lib<NAME>.so/.dylib' or '<NAME>.dll' in the '--lib-path' directories.\nCan be specified multiple times.\nUse: --link-lib <PATH>", 1, &link_lib_callback},
+			Argument{ "lib-path", "L", "Adds a directory in which the libraries of '--link-lib' are searched.\nUse: --lib-path/-L <DIR>", 1, &lib_path_callback},
+			Argument{ "dep-file", "", "Writes a Makefile rule listing the files on which the output depends (the compiled file and the files of '@embed').\nUse: --dep-file <PATH>", 1, &dep_file_callback},
+			Argument{ "mir", "", "Lowers function bodies to the Colt MIR (mid-level IR), whose passes run before generating LLVM IR.\nUse: --mir", 0, &mir_callback},
+			Argument{ "print-mir", "", "Prints the optimized MIR of each function.\nImplies '--mir'.\nUse: --print-mir", 0, &print_mir_callback},
+			Argument{ "function-order", "", "Places functions contiguously in the emitted code, hottest first, in '.text.hot' sections.\nThe file is a folded stacks profile (from '--profile' or '--instrument-functions'), or lists a function per line.\nUse: --function-order <PATH>", 1, &function_order_callback},
+			Argument{ "size-report", "", "Prints the size of the machine code of each function, after optimizations.\nUse: --size-report", 0, &size_report_callback},
+			Argument{ "stack-usage", "", "Prints the frame size and worst-case stack usage of each function, after optimizations.\nRecursive functions, and calls to extern functions, are flagged.\nUse: --stack-usage", 0, &stack_usage_callback},
+			Argument{ "stack-budget", "", "Fails compilation (exit code 1) if the worst-case stack usage of an entry point exceeds BYTES.\nRecursive entry points always exceed the budget, as their usage is unbounded.\nUse: --stack-budget <BYTES>", 1, &stack_budget_callback},
 		};
 
 		/// @brief Handles an argument, searching for it and doing error handling
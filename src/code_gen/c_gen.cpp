@@ -0,0 +1,974 @@
+/** @file c_gen.cpp
+* Contains definition of functions declared in 'c_gen.h'.
+*/
+
+#include "c_gen.h"
+
+#include <cstdio>
+#include <iterator>
+
+#ifndef _WIN32
+  #include <sys/wait.h>
+#endif
+
+namespace colt::gen
+{
+  namespace
+  {
+    /// @brief The C runtime linked with executables produced by the C backend.
+    /// These are the equivalent of the functions exported by the compiler for the JIT.
+    constexpr const char* CRuntimeSource =
+      "#include <inttypes.h>\n"
+      "#include <stdbool.h>\n"
+      "#include <stdint.h>\n"
+      "#include <stdio.h>\n"
+      "#include <stdlib.h>\n"
+      "\n"
+      "/* Prints the shortest representation that round-trips */\n"
+      "static void print_double(double a)\n"
+      "{\n"
+      "  char buffer[32];\n"
+      "  for (int precision = 1; precision <= 17; precision++)\n"
+      "  {\n"
+      "    snprintf(buffer, sizeof(buffer), \"%.*g\", precision, a);\n"
+      "    if (strtod(buffer, NULL) == a)\n"
+      "      break;\n"
+      "  }\n"
+      "  puts(buffer);\n"
+      "}\n"
+      "\n"
+      "int64_t _ColtRand(int64_t a, int64_t b) { return a + (int64_t)((uint64_t)rand() % (uint64_t)(b - a + 1)); }\n"
+      "void _ColtPrinti8(int8_t a) { printf(\"%\" PRId8 \"\\n\", a); }\n"
+      "void _ColtPrinti16(int16_t a) { printf(\"%\" PRId16 \"\\n\", a); }\n"
+      "void _ColtPrinti32(int32_t a) { printf(\"%\" PRId32 \"\\n\", a); }\n"
+      "void _ColtPrinti64(int64_t a) { printf(\"%\" PRId64 \"\\n\", a); }\n"
+      "void _ColtPrintu8(uint8_t a) { printf(\"%\" PRIu8 \"\\n\", a); }\n"
+      "void _ColtPrintu16(uint16_t a) { printf(\"%\" PRIu16 \"\\n\", a); }\n"
+      "void _ColtPrintu32(uint32_t a) { printf(\"%\" PRIu32 \"\\n\", a); }\n"
+      "void _ColtPrintu64(uint64_t a) { printf(\"%\" PRIu64 \"\\n\", a); }\n"
+      "void _ColtPrintbool(bool a) { puts(a ? \"true\" : \"false\"); }\n"
+      "void _ColtPrintf32(float a) { print_double(a); }\n"
+      "void _ColtPrintf64(double a) { print_double(a); }\n"
+      "void _ColtPrintchar(char a) { printf(\"%c\\n\", a); }\n"
+      "void _ColtPrintlstring(const char* a) { puts(a); }\n"
+      "void _ColtPrintPTR(void* a) { printf(\"%p\\n\", a); }\n";
+
+    /// @brief Identifiers that cannot be used as variable names in the generated C
+    constexpr const char* CReservedNames[] = {
+      "auto", "bool", "break", "case", "char", "const", "continue", "default", "do",
+      "double", "else", "enum", "extern", "false", "float", "for", "goto", "if", "inline",
+      "int", "int8_t", "int16_t", "int32_t", "int64_t", "long", "register", "restrict",
+      "return", "short", "signed", "sizeof", "static", "struct", "switch", "true",
+      "typedef", "uint8_t", "uint16_t", "uint32_t", "uint64_t", "union", "unsigned",
+      "void", "volatile", "while", "_Alignas", "_Alignof", "_Atomic", "_Bool",
+      "_Complex", "_Generic", "_Imaginary", "_Noreturn", "_Static_assert", "_Thread_local"
+    };
+
+    /// @brief Check if an identifier cannot be used as a variable name in the generated C
+    /// @param name The identifier
+    /// @return True if reserved in C
+    bool IsReservedInC(const std::string& name) noexcept
+    {
+      return std::find_if(std::begin(CReservedNames), std::end(CReservedNames),
+        [&](const char* reserved) { return name == reserved; }) != std::end(CReservedNames);
+    }
+
+    /// @brief Converts a StringView to a std::string
+    /// @param view The StringView to convert
+    /// @return The converted string
+    std::string ToString(StringView view) noexcept
+    {
+      return std::string{ view.get_data(), view.get_size() };
+    }
+
+    /// @brief Returns the name in C of a function.
+    /// Mangled names may contain characters that are invalid in C identifiers
+    /// (' ' of 'PTR<mut T>', '<', '>' and ',' of generic instances, '$' of
+    /// specializations, UTF-8...): they are escaped as '_' followed by their hexadecimal value.
+    /// @param decl The function declaration
+    /// @return The name in C
+    std::string FnNameInC(PTR<const lang::FnDeclExpr> decl) noexcept
+    {
+      auto mangled = colt::gen::mangle(decl);
+      StringView view = mangled;
+      std::string name;
+      name.reserve(view.get_size());
+      for (size_t i = 0; i < view.get_size(); i++)
+      {
+        auto chr = static_cast<unsigned char>(view[i]);
+        if ((chr >= 'a' && chr <= 'z') || (chr >= 'A' && chr <= 'Z') || (chr >= '0' && chr <= '9') || chr == '_')
+          name += static_cast<char>(chr);
+        else
+          fmt::format_to(std::back_inserter(name), "_{:02X}", chr);
+      }
+      return name;
+    }
+
+    /// @brief Check if the result of an operation on a type must be converted back
+    ///        to that type, as C promotes types smaller than 'int' to 'int'.
+    /// @param type The type of the operation
+    /// @return True if a conversion is needed
+    bool isPromotedInC(PTR<const lang::Type> type) noexcept
+    {
+      if (!type->is_builtin())
+        return false;
+      switch (as<PTR<const lang::BuiltInType>>(type)->get_builtin_id())
+      {
+      case lang::BOOL:
+      case lang::CHAR:
+      case lang::U8:
+      case lang::U16:
+      case lang::I8:
+      case lang::I16:
+        return true;
+      default:
+        return false;
+      }
+    }
+
+    /// @brief Returns the unsigned C type of the same size as a signed built-in type
+    /// @param type The signed type
+    /// @return The unsigned C type
+    const char* toUnsignedC(PTR<const lang::BuiltInType> type) noexcept
+    {
+      switch (type->get_builtin_id())
+      {
+      case lang::I8:
+        return "uint8_t";
+      case lang::I16:
+        return "uint16_t";
+      case lang::I32:
+        return "uint32_t";
+      case lang::I64:
+        return "uint64_t";
+      default:
+        return "unsigned __int128";
+      }
+    }
+
+    /// @brief Check if an expression can be used to initialize a global variable in C
+    /// @param ptr The expression to check
+    /// @return True if the expression is a constant expression
+    bool isConstantExpr(PTR<const lang::Expr> ptr) noexcept
+    {
+      using namespace lang;
+      switch (ptr->classof())
+      {
+      case Expr::EXPR_LITERAL:
+      case Expr::EXPR_EMBED:
+        return true;
+      case Expr::EXPR_UNARY:
+        return as<PTR<const UnaryExpr>>(ptr)->get_operation() != UnaryOperator::OP_ADDRESSOF
+          && isConstantExpr(as<PTR<const UnaryExpr>>(ptr)->get_child());
+      case Expr::EXPR_BINARY:
+        return isConstantExpr(as<PTR<const BinaryExpr>>(ptr)->get_LHS())
+          && isConstantExpr(as<PTR<const BinaryExpr>>(ptr)->get_RHS());
+      case Expr::EXPR_CONVERT:
+        return as<PTR<const ConvertExpr>>(ptr)->get_conversion_type() == ConvertExpr::CNV_AS
+          && isConstantExpr(as<PTR<const ConvertExpr>>(ptr)->get_child());
+      default:
+        return false;
+      }
+    }
+
+    /// @brief Writes a floating point value so that it is parsed back exactly
+    /// @param value The value to write
+    /// @param suffix The suffix of the literal ("" or "f")
+    /// @param to The string in which to write
+    void writeFloating(f64 value, const char* suffix, std::string& to) noexcept
+    {
+      if (value != value)
+        to += "(0.0/0.0)";
+      else if (value == std::numeric_limits<f64>::infinity())
+        to += "(1.0/0.0)";
+      else if (value == -std::numeric_limits<f64>::infinity())
+        to += "(-1.0/0.0)";
+      else
+      {
+        //{fmt} writes the shortest representation that round-trips
+        auto str = *suffix == 'f' ? fmt::format("{}", as<f32>(value)) : fmt::format("{}", value);
+        if (str.find_first_of(".e") == std::string::npos)
+          str += ".0";
+        to += str;
+        to += suffix;
+      }
+    }
+
+    /// @brief Writes a signed integer literal
+    /// @param value The value to write
+    /// @param to The string in which to write
+    void writeSigned(i64 value, std::string& to) noexcept
+    {
+      if (value == std::numeric_limits<i64>::min())
+        to += "INT64_MIN";
+      else if (value < 0)
+        fmt::format_to(std::back_inserter(to), "(-INT64_C({}))", -value);
+      else
+        fmt::format_to(std::back_inserter(to), "INT64_C({})", value);
+    }
+
+    /// @brief Returns the command invoking the system C compiler
+    /// @param level The optimization level
+    /// @return The command, to which the files can be appended
+    std::string getCompilerCommand(OptimizationLevel level) noexcept
+    {
+      const char* cc = std::getenv("CC");
+      std::string command = fmt::format("\"{}\" -std=c11 -fwrapv -w", cc != nullptr && *cc != '\0' ? cc : "cc");
+      switch (level)
+      {
+      break; case OptimizationLevel::O0:
+        command += " -O0";
+      break; case OptimizationLevel::O1:
+        command += " -O1";
+      break; case OptimizationLevel::O2:
+        command += " -O2";
+      break; case OptimizationLevel::O3:
+        command += " -O3";
+      //'-Oz' is not supported by all C compilers
+      break; case OptimizationLevel::Os:
+      case OptimizationLevel::Oz:
+        command += " -Os";
+      break; default:
+        colt_unreachable("Invalid optimization level");
+      }
+      return command;
+    }
+
+    /// @brief Returns a path in the temporary directory that is not used
+    /// @param extension The extension of the file
+    /// @return The path
+    std::filesystem::path getTemporaryPath(const char* extension) noexcept
+    {
+      static std::atomic<u64> counter = 0;
+      std::error_code code;
+      auto directory = std::filesystem::temp_directory_path(code);
+      return directory / fmt::format("colt_{}_{}{}",
+        std::chrono::steady_clock::now().time_since_epoch().count(), counter++, extension);
+    }
+  }
+
+  std::string GenerateC(const lang::AST& ast) noexcept
+  {
+    std::string out;
+    CGenerator c_gen = { ast, out };
+    return out;
+  }
+
+  Expected<bool, const char*> WriteC(const std::string& source, const char* path) noexcept
+  {
+    std::FILE* file = std::fopen(path, "wb");
+    if (file == nullptr)
+      return { Error, "Could not open file!" };
+    bool success = std::fwrite(source.data(), 1, source.size(), file) == source.size();
+    success &= std::fclose(file) == 0;
+    if (!success)
+      return { Error, "Could not write file!" };
+    return true;
+  }
+
+  Expected<bool, std::string> CompileC(const std::string& source, const char* path, OptimizationLevel level, bool executable) noexcept
+  {
+    auto source_path = getTemporaryPath(".c");
+    auto runtime_path = getTemporaryPath(".c");
+    ON_EXIT{
+      std::error_code code;
+      std::filesystem::remove(source_path, code);
+      std::filesystem::remove(runtime_path, code);
+    };
+
+    if (WriteC(source, source_path.string().c_str()).is_error())
+      return { Error, fmt::format("Could not write '{}'!", source_path.string()) };
+
+    auto command = getCompilerCommand(level);
+    if (executable)
+    {
+      if (WriteC(CRuntimeSource, runtime_path.string().c_str()).is_error())
+        return { Error, fmt::format("Could not write '{}'!", runtime_path.string()) };
+      fmt::format_to(std::back_inserter(command), " \"{}\" \"{}\" -lm -o \"{}\"",
+        source_path.string(), runtime_path.string(), path);
+      //Libraries of '--link-lib' (already resolved to paths)
+      for (const auto& lib : args::GlobalArguments.link_libs)
+      {
+        fmt::format_to(std::back_inserter(command), " \"{}\"", lib);
+#ifndef _WIN32
+        //So that the executable finds the library when it is run
+        std::error_code code;
+        fmt::format_to(std::back_inserter(command), " -Wl,-rpath,\"{}\"",
+          std::filesystem::absolute(lib, code).parent_path().string());
+#endif
+      }
+    }
+    else
+      fmt::format_to(std::back_inserter(command), " -c \"{}\" -o \"{}\"", source_path.string(), path);
+
+    std::fflush(stdout);
+    if (std::system(command.c_str()) != 0)
+      return { Error, fmt::format("C compiler failed: '{}'!", command) };
+    return true;
+  }
+
+  Expected<i64, std::string> RunC(const std::string& source, OptimizationLevel level) noexcept
+  {
+#ifdef _WIN32
+    auto executable = getTemporaryPath(".exe");
+#else
+    auto executable = getTemporaryPath("");
+#endif
+    ON_EXIT{ std::error_code code; std::filesystem::remove(executable, code); };
+
+    if (auto result = CompileC(source, executable.string().c_str(), level, true); result.is_error())
+      return { Error, result.get_error() };
+
+    std::fflush(stdout);
+    int status = std::system(fmt::format("\"{}\"", executable.string()).c_str());
+#ifdef _WIN32
+    return as<i64>(status);
+#else
+    if (!WIFEXITED(status))
+      return { Error, "Executable did not exit normally!" };
+    //Only the low 8 bits of the value returned by 'main' are available
+    return as<i64>(WEXITSTATUS(status));
+#endif
+  }
+
+  CGenerator::CGenerator(const lang::AST& ast, std::string& out) noexcept
+    : out(out)
+  {
+    for (size_t i = 0; i < ast.expressions.get_size(); i++)
+      gen_stmt(ast.expressions[i]);
+
+    out += "/* Generated by the Colt compiler */\n";
+    out += "#include <stdbool.h>\n";
+    out += "#include <stdint.h>\n\n";
+    out += declarations;
+    if (!helpers.empty())
+    {
+      out += '\n';
+      out += helpers;
+    }
+    out += '\n';
+    out += definitions;
+  }
+
+  void CGenerator::gen_stmt(PTR<const lang::Expr> ptr) noexcept
+  {
+    using namespace lang;
+
+    switch (ptr->classof())
+    {
+    break; case Expr::EXPR_VAR_DECL:
+      gen_var_decl(as<PTR<const VarDeclExpr>>(ptr));
+    break; case Expr::EXPR_FN_DEF:
+      gen_fn_def(as<PTR<const FnDefExpr>>(ptr));
+    break; case Expr::EXPR_FN_RETURN:
+      write_indent();
+      if (auto value = as<PTR<const FnReturnExpr>>(ptr)->get_value())
+      {
+        definitions += "return ";
+        gen_expr(value, definitions);
+        definitions += ";\n";
+      }
+      else
+        definitions += "return;\n";
+    break; case Expr::EXPR_SCOPE:
+      write_indent();
+      gen_scope(as<PTR<const ScopeExpr>>(ptr));
+    break; case Expr::EXPR_CONDITION:
+      write_indent();
+      gen_condition(as<PTR<const ConditionExpr>>(ptr));
+    break; case Expr::EXPR_WHILE_LOOP:
+      write_indent();
+      gen_while_loop(as<PTR<const WhileLoopExpr>>(ptr));
+    break; case Expr::EXPR_BREAK_CONTINUE:
+      write_indent();
+      definitions += as<PTR<const BreakContinueExpr>>(ptr)->is_break() ? "break;\n" : "continue;\n";
+    break; case Expr::EXPR_NOP:
+    case Expr::EXPR_FOR_LOOP:
+    break; default:
+      write_indent();
+      gen_expr(ptr, definitions);
+      definitions += ";\n";
+    }
+  }
+
+  void CGenerator::gen_expr(PTR<const lang::Expr> ptr, std::string& to) noexcept
+  {
+    using namespace lang;
+
+    switch (ptr->classof())
+    {
+    break; case Expr::EXPR_LITERAL:
+      gen_literal(as<PTR<const LiteralExpr>>(ptr), to);
+    break; case Expr::EXPR_UNARY:
+      gen_unary(as<PTR<const UnaryExpr>>(ptr), to);
+    break; case Expr::EXPR_BINARY:
+      gen_binary(as<PTR<const BinaryExpr>>(ptr), to);
+    break; case Expr::EXPR_CONVERT:
+      gen_convert(as<PTR<const ConvertExpr>>(ptr), to);
+    break; case Expr::EXPR_VAR_READ:
+    {
+      auto var_read = as<PTR<const VarReadExpr>>(ptr);
+      if (var_read->is_global())
+        to += global_c_name(var_read->get_name());
+      else
+        to += local_vars[var_read->get_local_ID()];
+    }
+    break; case Expr::EXPR_VAR_WRITE:
+    {
+      //Assignments are expressions in Colt and C
+      auto var_write = as<PTR<const VarWriteExpr>>(ptr);
+      to += '(';
+      if (var_write->is_global())
+        to += global_c_name(var_write->get_name());
+      else
+        to += local_vars[var_write->get_local_ID()];
+      to += " = ";
+      gen_expr(var_write->get_value(), to);
+      to += ')';
+    }
+    break; case Expr::EXPR_FN_CALL:
+      gen_fn_call(as<PTR<const FnCallExpr>>(ptr), to);
+    break; case Expr::EXPR_PTR_LOAD:
+      to += "(*";
+      gen_expr(as<PTR<const PtrLoadExpr>>(ptr)->get_where(), to);
+      to += ')';
+    break; case Expr::EXPR_EMBED:
+      gen_embed(as<PTR<const EmbedExpr>>(ptr), to);
+    break; case Expr::EXPR_PTR_STORE:
+      to += "(*";
+      gen_expr(as<PTR<const PtrStoreExpr>>(ptr)->get_where(), to);
+      to += " = ";
+      gen_expr(as<PTR<const PtrStoreExpr>>(ptr)->get_value(), to);
+      to += ')';
+    break; default:
+      colt_unreachable("Generating invalid expression!");
+    }
+  }
+
+  void CGenerator::gen_literal(PTR<const lang::LiteralExpr> ptr, std::string& to) noexcept
+  {
+    using namespace colt::lang;
+
+    auto value = ptr->get_value();
+    switch (ptr->get_type()->get_builtin_id())
+    {
+    break; case U8:
+      fmt::format_to(std::back_inserter(to), "((uint8_t){}u)", value.as<u8>());
+    break; case U16:
+      fmt::format_to(std::back_inserter(to), "((uint16_t){}u)", value.as<u16>());
+    break; case U32:
+      fmt::format_to(std::back_inserter(to), "{}u", value.as<u32>());
+    break; case U64:
+      fmt::format_to(std::back_inserter(to), "UINT64_C({})", value.as<u64>());
+    break; case U128:
+      fmt::format_to(std::back_inserter(to), "((unsigned __int128)UINT64_C({}))", value.as<u64>());
+    break; case I8:
+      to += "((int8_t)";
+      writeSigned(value.as<i8>(), to);
+      to += ')';
+    break; case I16:
+      to += "((int16_t)";
+      writeSigned(value.as<i16>(), to);
+      to += ')';
+    break; case I32:
+      to += "((int32_t)";
+      writeSigned(value.as<i32>(), to);
+      to += ')';
+    break; case I64:
+      writeSigned(value.as<i64>(), to);
+    break; case I128:
+      to += "((__int128)";
+      writeSigned(value.as<i64>(), to);
+      to += ')';
+    break; case F32:
+      writeFloating(value.as<f32>(), "f", to);
+    break; case F64:
+      writeFloating(value.as<f64>(), "", to);
+    break; case BOOL:
+      to += value.as<bool>() ? "true" : "false";
+    break; case CHAR:
+    {
+      char chr = value.as<char>();
+      if (chr == '\'' || chr == '\\')
+        fmt::format_to(std::back_inserter(to), "'\\{}'", chr);
+      else if (' ' <= chr && chr <= '~')
+        fmt::format_to(std::back_inserter(to), "'{}'", chr);
+      else
+        fmt::format_to(std::back_inserter(to), "((char){})", as<i32>(chr));
+    }
+    break; case lang::lstring:
+    {
+      StringView str = *value.as<PTR<String>>();
+      to += '"';
+      for (size_t i = 0; i < str.get_size(); i++)
+      {
+        char chr = str.get_data()[i];
+        if (chr == '"' || chr == '\\')
+        {
+          to += '\\';
+          to += chr;
+        }
+        else if (' ' <= chr && chr <= '~')
+          to += chr;
+        //Octal escapes have at most 3 digits, unlike hexadecimal escapes
+        else if (chr != '\0' || i + 1 != str.get_size())
+          fmt::format_to(std::back_inserter(to), "\\{:03o}", as<u8>(chr));
+      }
+      to += '"';
+    }
+    break; default:
+      colt_unreachable("Invalid literal expr!");
+    }
+  }
+
+  void CGenerator::gen_unary(PTR<const lang::UnaryExpr> ptr, std::string& to) noexcept
+  {
+    using namespace colt::lang;
+
+    bool is_promoted = isPromotedInC(ptr->get_type());
+    if (is_promoted)
+      fmt::format_to(std::back_inserter(to), "(({})", type_to_c(ptr->get_type()));
+
+    switch (ptr->get_operation())
+    {
+    break; case UnaryOperator::OP_ADDRESSOF:
+      to += "(&";
+    break; case UnaryOperator::OP_NEGATE:
+      to += "(-";
+    break; case UnaryOperator::OP_BIT_NOT:
+      //On 'bool', '~' is the same as '!'
+      to += ptr->get_type()->is_bool() ? "(!" : "(~";
+    break; case UnaryOperator::OP_BOOL_NOT:
+      to += "(!";
+    break; default:
+      colt_unreachable("Not implemented!");
+    }
+    gen_expr(ptr->get_child(), to);
+    to += ')';
+
+    if (is_promoted)
+      to += ')';
+  }
+
+  void CGenerator::gen_binary(PTR<const lang::BinaryExpr> ptr, std::string& to) noexcept
+  {
+    using namespace colt::lang;
+
+    auto type_t = ptr->get_LHS()->get_type();
+    bool is_promoted = isPromotedInC(ptr->get_type());
+    if (is_promoted)
+      fmt::format_to(std::back_inserter(to), "(({})", type_to_c(ptr->get_type()));
+
+    //'>>' is a logical shift in Colt, but an arithmetic shift in C for signed integers
+    if (ptr->get_operation() == BinaryOperator::OP_BIT_RSHIFT && type_t->is_signed_int())
+    {
+      fmt::format_to(std::back_inserter(to), "(({})(({})",
+        type_to_c(type_t), toUnsignedC(as<PTR<const BuiltInType>>(type_t)));
+      gen_expr(ptr->get_LHS(), to);
+      to += " >> ";
+      gen_expr(ptr->get_RHS(), to);
+      to += "))";
+      if (is_promoted)
+        to += ')';
+      return;
+    }
+
+    to += '(';
+    gen_expr(ptr->get_LHS(), to);
+    switch (ptr->get_operation())
+    {
+      /*********** ARITHMETIC ***********/
+
+    break; case BinaryOperator::OP_SUM:
+      to += " + ";
+    break; case BinaryOperator::OP_SUB:
+      to += " - ";
+    break; case BinaryOperator::OP_MUL:
+      to += " * ";
+    break; case BinaryOperator::OP_DIV:
+      to += " / ";
+    break; case BinaryOperator::OP_MOD:
+      to += " % ";
+
+      /*********** BITWISE ***********/
+
+    break; case BinaryOperator::OP_BIT_AND:
+      to += " & ";
+    break; case BinaryOperator::OP_BIT_OR:
+      to += " | ";
+    break; case BinaryOperator::OP_BIT_XOR:
+      to += " ^ ";
+    break; case BinaryOperator::OP_BIT_LSHIFT:
+      to += " << ";
+    break; case BinaryOperator::OP_BIT_RSHIFT:
+      to += " >> ";
+
+      /*********** BOOLEANS ***********/
+
+    break; case BinaryOperator::OP_BOOL_AND:
+      to += " && ";
+    break; case BinaryOperator::OP_BOOL_OR:
+      to += " || ";
+    break; case BinaryOperator::OP_LESS:
+      to += " < ";
+    break; case BinaryOperator::OP_LESS_EQUAL:
+      to += " <= ";
+    break; case BinaryOperator::OP_GREAT:
+      to += " > ";
+    break; case BinaryOperator::OP_GREAT_EQUAL:
+      to += " >= ";
+    break; case BinaryOperator::OP_EQUAL:
+      to += " == ";
+    break; case BinaryOperator::OP_NOT_EQUAL:
+      to += " != ";
+
+    break; default:
+      colt_unreachable("Invalid operation!");
+    }
+    gen_expr(ptr->get_RHS(), to);
+    to += ')';
+
+    if (is_promoted)
+      to += ')';
+  }
+
+  void CGenerator::gen_convert(PTR<const lang::ConvertExpr> ptr, std::string& to) noexcept
+  {
+    if (ptr->get_conversion_type() == lang::ConvertExpr::CNV_AS)
+      fmt::format_to(std::back_inserter(to), "(({})", type_to_c(ptr->get_type()));
+    else // bit_as
+      fmt::format_to(std::back_inserter(to), "{}(", bit_as_helper(ptr->get_child()->get_type(), ptr->get_type()));
+    gen_expr(ptr->get_child(), to);
+    to += ')';
+  }
+
+  void CGenerator::gen_embed(PTR<const lang::EmbedExpr> ptr, std::string& to) noexcept
+  {
+    StringView data = ptr->get_data();
+    //C does not allow empty arrays
+    fmt::format_to(std::back_inserter(declarations),
+      "_Alignas(16) static const unsigned char ColtEmbed{}[{}] = {{",
+      embed_count, data.get_size() == 0 ? 1 : data.get_size());
+    for (size_t i = 0; i < data.get_size(); i++)
+    {
+      if (i % 16 == 0)
+        declarations += "\n  ";
+      fmt::format_to(std::back_inserter(declarations), "{},", as<u8>(data.get_data()[i]));
+    }
+    declarations += " };\n";
+    fmt::format_to(std::back_inserter(to), "(({})ColtEmbed{})", type_to_c(ptr->get_type()), embed_count++);
+  }
+
+  void CGenerator::gen_var_decl(PTR<const lang::VarDeclExpr> ptr) noexcept
+  {
+    if (in_function) //LOCAL VARIABLE
+    {
+      auto name = local_name(ptr->get_name());
+      write_indent();
+      fmt::format_to(std::back_inserter(definitions), "{} {}", type_to_c(ptr->get_type()), name);
+      //The variable is visible in C in its own initializer, so it is pushed after
+      if (ptr->get_value())
+      {
+        definitions += " = ";
+        gen_expr(ptr->get_value(), definitions);
+      }
+      definitions += ";\n";
+      local_vars.push_back(std::move(name));
+    }
+    else //GLOBAL VARIABLE
+    {
+      auto name = global_name(ptr->get_name());
+      fmt::format_to(std::back_inserter(definitions), "{} {}", type_to_c(ptr->get_type()), name);
+      if (ptr->is_initialized())
+      {
+        if (isConstantExpr(ptr->get_value()))
+        {
+          definitions += " = ";
+          gen_expr(ptr->get_value(), definitions);
+        }
+        else
+        {
+          //Initialized at the beginning of 'main'
+          fmt::format_to(std::back_inserter(init_before_main), "  {} = ", name);
+          gen_expr(ptr->get_value(), init_before_main);
+          init_before_main += ";\n";
+        }
+      }
+      definitions += ";\n";
+      global_vars.insert({ ToString(ptr->get_name()), name });
+      global_names.insert(std::move(name));
+    }
+  }
+
+  void CGenerator::gen_fn_def(PTR<const lang::FnDefExpr> ptr) noexcept
+  {
+    auto decl = ptr->get_fn_decl();
+    //Extern functions do not have bodies
+    if (decl->is_extern())
+    {
+      declarations += "extern ";
+      write_fn_decl(decl, declarations);
+      declarations += ";\n";
+      return;
+    }
+
+    write_fn_decl(decl, declarations);
+    declarations += ";\n";
+
+    in_function = true;
+    ON_EXIT{ in_function = false; };
+
+    //Parameters are the first local variables
+    size_t current_scope_var_count = local_vars.size();
+    auto params_name = ptr->get_params_name();
+    for (size_t i = 0; i < params_name.get_size(); i++)
+      local_vars.push_back(local_name(params_name[i]));
+
+    //Parameter names are only known now
+    definitions += '\n';
+    write_fn_decl(decl, definitions);
+    definitions += "\n{\n";
+    indent = 1;
+    if (ptr->is_main())
+      definitions += init_before_main;
+
+    auto body = ptr->get_body();
+    if (is_a<lang::ScopeExpr>(body))
+    {
+      //Avoid nesting the body in another block
+      for (auto body_expr : as<PTR<const lang::ScopeExpr>>(body)->get_body_array())
+        gen_stmt(body_expr);
+    }
+    else
+      gen_stmt(body);
+    indent = 0;
+    definitions += "}\n";
+
+    local_vars.resize(current_scope_var_count);
+  }
+
+  void CGenerator::gen_fn_call(PTR<const lang::FnCallExpr> ptr, std::string& to) noexcept
+  {
+    to += FnNameInC(ptr->get_fn_decl());
+    to += '(';
+    auto call_args = ptr->get_arguments();
+    for (size_t i = 0; i < call_args.get_size(); i++)
+    {
+      if (i != 0)
+        to += ", ";
+      gen_expr(call_args[i], to);
+    }
+    to += ')';
+  }
+
+  void CGenerator::gen_scope(PTR<const lang::ScopeExpr> ptr) noexcept
+  {
+    //We store the variables count to be able to pop variables of the scope
+    size_t current_scope_var_count = local_vars.size();
+
+    definitions += "{\n";
+    ++indent;
+    for (auto body_expr : ptr->get_body_array())
+      gen_stmt(body_expr);
+    --indent;
+    write_indent();
+    definitions += "}\n";
+
+    //We pop variables allocated in the current scope
+    local_vars.resize(current_scope_var_count);
+  }
+
+  void CGenerator::gen_condition(PTR<const lang::ConditionExpr> ptr) noexcept
+  {
+    definitions += "if (";
+    gen_expr(ptr->get_if_condition(), definitions);
+    definitions += ")\n";
+    gen_block(ptr->get_if_statement());
+
+    if (auto else_stmt = ptr->get_else_statement())
+    {
+      write_indent();
+      definitions += "else";
+      //'elif' is written as 'else if'
+      if (is_a<lang::ConditionExpr>(else_stmt))
+      {
+        definitions += ' ';
+        gen_condition(as<PTR<const lang::ConditionExpr>>(else_stmt));
+      }
+      else
+      {
+        definitions += '\n';
+        gen_block(else_stmt);
+      }
+    }
+  }
+
+  void CGenerator::gen_while_loop(PTR<const lang::WhileLoopExpr> ptr) noexcept
+  {
+    definitions += "while (";
+    gen_expr(ptr->get_condition(), definitions);
+    definitions += ")\n";
+    gen_block(ptr->get_body());
+  }
+
+  void CGenerator::gen_block(PTR<const lang::Expr> ptr) noexcept
+  {
+    write_indent();
+    if (is_a<lang::ScopeExpr>(ptr))
+      return gen_scope(as<PTR<const lang::ScopeExpr>>(ptr));
+
+    //A declaration is not a valid statement in C
+    size_t current_scope_var_count = local_vars.size();
+    definitions += "{\n";
+    ++indent;
+    gen_stmt(ptr);
+    --indent;
+    write_indent();
+    definitions += "}\n";
+    local_vars.resize(current_scope_var_count);
+  }
+
+  void CGenerator::write_indent() noexcept
+  {
+    definitions.append(2 * indent, ' ');
+  }
+
+  void CGenerator::write_fn_decl(PTR<const lang::FnDeclExpr> decl, std::string& to) noexcept
+  {
+    fmt::format_to(std::back_inserter(to), "{} {}(",
+      type_to_c(decl->get_return_type()), FnNameInC(decl));
+
+    auto params_type = decl->get_params_type();
+    //Declarations do not need names (and the local variables are not yet known)
+    bool with_names = &to == &definitions;
+    for (size_t i = 0; i < params_type.get_size(); i++)
+    {
+      if (i != 0)
+        to += ", ";
+      to += type_to_c(params_type[i]);
+      if (with_names)
+      {
+        to += ' ';
+        to += local_vars[local_vars.size() - params_type.get_size() + i];
+      }
+    }
+    if (decl->get_type()->is_varargs())
+    {
+      //'(...)' is an unprototyped function in C11, which accepts any arguments
+      if (params_type.get_size() != 0)
+        to += ", ...";
+    }
+    else if (params_type.get_size() == 0)
+      to += "void";
+    to += ')';
+  }
+
+  std::string CGenerator::bit_as_helper(PTR<const lang::Type> from, PTR<const lang::Type> to) noexcept
+  {
+    auto from_c = type_to_c(from);
+    auto to_c = type_to_c(to);
+    auto key = fmt::format("{}|{}", from_c, to_c);
+    if (auto it = bit_as_helpers.find(key); it != bit_as_helpers.end())
+      return it->second;
+
+    //Type punning through unions is valid C
+    auto name = fmt::format("_ColtBitAs{}", bit_as_helpers.size());
+    fmt::format_to(std::back_inserter(helpers),
+      "static inline {1} {0}({2} value)\n"
+      "{{\n"
+      "  union {{ {2} from; {1} to; }} bits = {{ value }};\n"
+      "  return bits.to;\n"
+      "}}\n",
+      name, to_c, from_c);
+    bit_as_helpers.insert({ std::move(key), name });
+    return name;
+  }
+
+  std::string CGenerator::local_name(StringView name) const noexcept
+  {
+    auto str = ToString(name);
+    bool clashes = global_names.count(str) != 0
+      || std::find(local_vars.begin(), local_vars.end(), str) != local_vars.end()
+      || IsReservedInC(str);
+    if (clashes)
+      fmt::format_to(std::back_inserter(str), "_{}", local_vars.size());
+    return str;
+  }
+
+  std::string CGenerator::global_name(StringView name) const noexcept
+  {
+    auto str = ToString(name);
+    if (global_names.count(str) == 0 && !IsReservedInC(str))
+      return str;
+    //The suffixed name may be the name of another global variable
+    for (size_t i = global_names.size();; i++)
+    {
+      if (auto escaped = fmt::format("{}_{}", str, i); global_names.count(escaped) == 0)
+        return escaped;
+    }
+  }
+
+  const std::string& CGenerator::global_c_name(StringView name) const noexcept
+  {
+    auto it = global_vars.find(ToString(name));
+    assert_true(it != global_vars.end(), "Global variable must be declared before its use!");
+    return it->second;
+  }
+
+  std::string CGenerator::type_to_c(PTR<const lang::Type> type) noexcept
+  {
+    using namespace lang;
+
+    switch (type->classof())
+    {
+    case lang::Type::TYPE_VOID:
+      return "void";
+    case lang::Type::TYPE_BUILTIN:
+    {
+      auto ptr = as<PTR<const BuiltInType>>(type);
+      switch (ptr->get_builtin_id())
+      {
+      case U8:
+        return "uint8_t";
+      case U16:
+        return "uint16_t";
+      case U32:
+        return "uint32_t";
+      case U64:
+        return "uint64_t";
+      case U128:
+        return "unsigned __int128";
+      case I8:
+        return "int8_t";
+      case I16:
+        return "int16_t";
+      case I32:
+        return "int32_t";
+      case I64:
+        return "int64_t";
+      case I128:
+        return "__int128";
+      case F32:
+        return "float";
+      case F64:
+        return "double";
+      case BOOL:
+        return "bool";
+      case CHAR:
+        return "char";
+      case lang::lstring:
+        return "const char*";
+      default:
+        colt_unreachable("Invalid ID!");
+      }
+    }
+    case lang::Type::TYPE_PTR:
+      return type_to_c(as<PTR<const PtrType>>(type)->get_type_to()) + "*";
+    case lang::Type::TYPE_FN:
+    case lang::Type::TYPE_ARRAY:
+    case lang::Type::TYPE_CLASS:
+    default:
+      colt_unreachable("Unimplemented type!");
+    }
+  }
+}
@@ -0,0 +1,201 @@
+/** @file c_gen.h
+* Contains utilities responsible of generating C source code from an AST.
+* The C backend does not depend on LLVM: it is the only backend of builds
+* configured with 'COLT_NO_LLVM', where the generated C (C11) is compiled
+* by the system C compiler ('$CC' or 'cc').
+*/
+
+#ifndef HG_COLT_C_GEN
+#define HG_COLT_C_GEN
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <util/colt_pch.h>
+#include <type/colt_type.h>
+#include <ast/colt_ast.h>
+#include <code_gen/mangle.h>
+#include <code_gen/opt_level.h>
+
+namespace colt::gen
+{
+	/// @brief Generates the C source code corresponding to a valid AST.
+	/// Functions use the names returned by 'mangle', and extern functions
+	/// (such as the runtime) are declared as 'extern'.
+	/// @param ast The AST from which to generate C
+	/// @return The C source code
+	std::string GenerateC(const lang::AST& ast) noexcept;
+
+	/// @brief Writes C source code to a file
+	/// @param source The C source code
+	/// @param path The path of the file to write
+	/// @return True if no errors, or a const char* representing the error
+	Expected<bool, const char*> WriteC(const std::string& source, const char* path) noexcept;
+
+	/// @brief Compiles C source code using the system C compiler ('$CC' or 'cc').
+	/// The code is compiled with '-fwrapv', as integer overflow wraps in Colt.
+	/// @param source The C source code
+	/// @param path The path of the object file or executable to produce
+	/// @param level The optimization level
+	/// @param executable If true, links an executable with the C runtime (printing functions...) and the '--link-lib' libraries
+	/// @return True if no errors, or a String representing the error
+	Expected<bool, std::string> CompileC(const std::string& source, const char* path, OptimizationLevel level, bool executable) noexcept;
+
+	/// @brief Compiles C source code to an executable and runs it
+	/// @param source The C source code, which must define 'main'
+	/// @param level The optimization level
+	/// @return The exit code of the executable, or a String representing the error
+	Expected<i64, std::string> RunC(const std::string& source, OptimizationLevel level) noexcept;
+
+	/// @brief Class responsible of generating C source code
+	class CGenerator
+	{
+		/// @brief The resulting C source code
+		std::string& out;
+		/// @brief The declarations of the functions (so that definition order does not matter)
+		std::string declarations{};
+		/// @brief The helpers needed by 'bit_as' conversions
+		std::string helpers{};
+		/// @brief The definitions of global variables and functions
+		std::string definitions{};
+		/// @brief The assignments of global variables whose value is not constant,
+		///        which are done before the code in main
+		std::string init_before_main{};
+		/// @brief Maps the C types of 'bit_as' conversions ("FROM|TO") to their helper
+		std::unordered_map<std::string, std::string> bit_as_helpers{};
+		/// @brief The names in C of the global variables
+		std::unordered_set<std::string> global_names{};
+		/// @brief Maps the names of the global variables to their names in C
+		std::unordered_map<std::string, std::string> global_vars{};
+		/// @brief Contains the C names of all local variables, indexed by local ID
+		std::vector<std::string> local_vars{};
+		/// @brief The number of embedded files (used to name their arrays)
+		u64 embed_count = 0;
+		/// @brief The current indentation level
+		u32 indent = 0;
+		/// @brief True while generating a function body
+		bool in_function = false;
+
+	public:
+		/// @brief No default constructor
+		CGenerator() = delete;
+		/// @brief No default copy constructor
+		CGenerator(const CGenerator&) = delete;
+		/// @brief No default move constructor
+		CGenerator(CGenerator&&) = delete;
+
+		/// @brief Generates C source code from expressions
+		/// @param ast The AST to compile to C
+		/// @param out The string in which to write the C source code
+		CGenerator(const lang::AST& ast, std::string& out) noexcept;
+
+	private:
+		/// @brief Generates C for a statement by calling the corresponding function.
+		/// Expressions are followed by ';'.
+		/// @param ptr The statement for which to generate C
+		void gen_stmt(PTR<const lang::Expr> ptr) noexcept;
+
+		/// @brief Generates C for an expression by calling the corresponding function.
+		/// The result is appended to 'to'.
+		/// @param ptr The expression for which to generate C
+		/// @param to The string in which to write
+		void gen_expr(PTR<const lang::Expr> ptr, std::string& to) noexcept;
+
+		/// @brief Generates C for literal expressions
+		/// @param ptr The expression for which to generate C
+		/// @param to The string in which to write
+		void gen_literal(PTR<const lang::LiteralExpr> ptr, std::string& to) noexcept;
+
+		/// @brief Generates C for unary expressions
+		/// @param ptr The expression for which to generate C
+		/// @param to The string in which to write
+		void gen_unary(PTR<const lang::UnaryExpr> ptr, std::string& to) noexcept;
+
+		/// @brief Generates C for binary expressions
+		/// @param ptr The expression for which to generate C
+		/// @param to The string in which to write
+		void gen_binary(PTR<const lang::BinaryExpr> ptr, std::string& to) noexcept;
+
+		/// @brief Generates C for conversion expressions
+		/// @param ptr The expression for which to generate C
+		/// @param to The string in which to write
+		void gen_convert(PTR<const lang::ConvertExpr> ptr, std::string& to) noexcept;
+
+		/// @brief Generates C for embedded files.
+		/// The content is written in a static array, declared before the definitions.
+		/// @param ptr The expression for which to generate C
+		/// @param to The string in which to write
+		void gen_embed(PTR<const lang::EmbedExpr> ptr, std::string& to) noexcept;
+
+		/// @brief Generates C for variable declarations
+		/// @param ptr The expression for which to generate C
+		void gen_var_decl(PTR<const lang::VarDeclExpr> ptr) noexcept;
+
+		/// @brief Generates C for function definitions/declarations
+		/// @param ptr The expression for which to generate C
+		void gen_fn_def(PTR<const lang::FnDefExpr> ptr) noexcept;
+
+		/// @brief Generates C for function calls
+		/// @param ptr The expression for which to generate C
+		/// @param to The string in which to write
+		void gen_fn_call(PTR<const lang::FnCallExpr> ptr, std::string& to) noexcept;
+
+		/// @brief Generates C for scope expressions
+		/// @param ptr The expression for which to generate C
+		void gen_scope(PTR<const lang::ScopeExpr> ptr) noexcept;
+
+		/// @brief Generates C for conditional expressions
+		/// @param ptr The expression for which to generate C
+		void gen_condition(PTR<const lang::ConditionExpr> ptr) noexcept;
+
+		/// @brief Generates C for while expressions
+		/// @param ptr The expression for which to generate C
+		void gen_while_loop(PTR<const lang::WhileLoopExpr> ptr) noexcept;
+
+		/// @brief Generates the body of a branch or loop, which is always a block in C
+		/// @param ptr The body
+		void gen_block(PTR<const lang::Expr> ptr) noexcept;
+
+		/// @brief Writes the current indentation
+		void write_indent() noexcept;
+
+		/// @brief Writes the declaration of a function (without ';')
+		/// @param decl The function declaration
+		/// @param to The string in which to write
+		void write_fn_decl(PTR<const lang::FnDeclExpr> decl, std::string& to) noexcept;
+
+		/// @brief Returns the name of the helper converting bits from a type to another,
+		///        generating it if it does not exist.
+		/// @param from The type to convert from
+		/// @param to The type to convert to
+		/// @return The name of the helper
+		std::string bit_as_helper(PTR<const lang::Type> from, PTR<const lang::Type> to) noexcept;
+
+		/// @brief Returns the name of a new local variable or parameter in C.
+		/// Names that would clash in C (keywords, globals, shadowed variables)
+		/// are suffixed by their local ID.
+		/// @param name The name of the variable
+		/// @return The name in C
+		std::string local_name(StringView name) const noexcept;
+
+		/// @brief Returns the name of a new global variable in C.
+		/// Names that would clash in C (keywords, other globals) are suffixed.
+		/// @param name The name of the variable
+		/// @return The name in C
+		std::string global_name(StringView name) const noexcept;
+
+		/// @brief Returns the name in C of a declared global variable
+		/// @param name The name of the variable
+		/// @return The name in C
+		const std::string& global_c_name(StringView name) const noexcept;
+
+		/// @brief Converts a Colt type to a C type
+		/// @param type The type to convert
+		/// @return Converted type
+		static std::string type_to_c(PTR<const lang::Type> type) noexcept;
+	};
+}
+
+#endif //!HG_COLT_C_GEN
@@ -0,0 +1,131 @@
+/** @file function_order.cpp
+* Contains definition of functions declared in 'function_order.h'.
+*/
+
+#include "function_order.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <string_view>
+#include <unordered_map>
+
+namespace colt::gen
+{
+  namespace
+  {
+    /// @brief Reads the lines of a file, without their line terminators
+    /// @param path The path of the file
+    /// @param lines The lines of the file
+    /// @return False if the file could not be read
+    bool ReadLines(const char* path, std::vector<std::string>& lines) noexcept
+    {
+      std::FILE* file = std::fopen(path, "r");
+      if (file == nullptr)
+        return false;
+      ON_EXIT{ std::fclose(file); };
+
+      char buffer[4096];
+      std::string line;
+      while (std::fgets(buffer, sizeof(buffer), file) != nullptr)
+      {
+        line += buffer;
+        //The line did not fit in the buffer
+        if (line.back() != '\n' && !std::feof(file))
+          continue;
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r'))
+          line.pop_back();
+        lines.push_back(std::move(line));
+        line.clear();
+      }
+      return std::ferror(file) == 0;
+    }
+
+    /// @brief Parses a line of a folded stacks file
+    /// @param line The line ('caller;...;function <count>')
+    /// @param leaf The function in which the samples were taken
+    /// @param count The number of samples
+    /// @return False if the line is not a line of a folded stacks file
+    bool ParseFoldedLine(std::string_view line, std::string_view& leaf, u64& count) noexcept
+    {
+      size_t space = line.rfind(' ');
+      if (space == std::string_view::npos || space + 1 == line.size())
+        return false;
+      auto [ptr, ec] = std::from_chars(line.data() + space + 1, line.data() + line.size(), count);
+      if (ec != std::errc{} || ptr != line.data() + line.size())
+        return false;
+      leaf = line.substr(0, space);
+      if (size_t separator = leaf.rfind(';'); separator != std::string_view::npos)
+        leaf.remove_prefix(separator + 1);
+      return true;
+    }
+
+    /// @brief Sums the self weight of the functions of the lines of a folded stacks file
+    /// @param lines The lines of the file (which must all be valid)
+    /// @param weights The functions and their self weight, by decreasing weight
+    void SumSelfWeights(const std::vector<std::string>& lines, std::vector<std::pair<std::string, u64>>& weights) noexcept
+    {
+      std::unordered_map<std::string, u64> self;
+      for (const auto& line : lines)
+      {
+        std::string_view leaf;
+        u64 count = 0;
+        if (!ParseFoldedLine(line, leaf, count))
+          continue;
+        //Frames outside of the JIT are not functions that can be placed
+        if (leaf.empty() || leaf.front() == '[')
+          continue;
+        self[std::string{ leaf }] += count;
+      }
+      weights.assign(self.begin(), self.end());
+      std::sort(weights.begin(), weights.end(), [](const auto& a, const auto& b)
+        { return a.second > b.second || (a.second == b.second && a.first < b.first); });
+    }
+  }
+
+  bool ReadSelfWeights(const char* path, std::vector<std::pair<std::string, u64>>& weights) noexcept
+  {
+    std::vector<std::string> lines;
+    if (!ReadLines(path, lines))
+      return false;
+    SumSelfWeights(lines, weights);
+    return true;
+  }
+
+  bool ReadFunctionOrder(const char* path, std::vector<std::string>& order) noexcept
+  {
+    std::vector<std::string> lines;
+    if (!ReadLines(path, lines))
+      return false;
+    //Comments and empty lines are removed
+    lines.erase(std::remove_if(lines.begin(), lines.end(), [](const std::string& line)
+      { return line.empty() || line.front() == '#'; }), lines.end());
+
+    bool is_folded = !lines.empty() && std::all_of(lines.begin(), lines.end(), [](const std::string& line)
+      {
+        std::string_view leaf;
+        u64 count;
+        return ParseFoldedLine(line, leaf, count);
+      });
+    if (!is_folded)
+    {
+      for (auto& line : lines)
+      {
+        if (std::find(order.begin(), order.end(), line) == order.end())
+          order.push_back(std::move(line));
+      }
+      return true;
+    }
+
+    std::vector<std::pair<std::string, u64>> weights;
+    SumSelfWeights(lines, weights);
+    for (auto& [name, count] : weights)
+    {
+      //Functions without samples were not executed
+      if (count == 0)
+        break;
+      order.push_back(std::move(name));
+    }
+    return true;
+  }
+}
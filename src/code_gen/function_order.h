@@ -0,0 +1,38 @@
+/** @file function_order.h
+* Contains the readers of the profiles used to place functions.
+* A folded stacks profile (written by '--profile' or '--instrument-functions')
+* gives the self weight of each function. A function order is either such a
+* profile (hottest functions first) or a list of functions, one per line.
+*/
+
+#ifndef HG_COLT_FUNCTION_ORDER
+#define HG_COLT_FUNCTION_ORDER
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <util/colt_pch.h>
+
+namespace colt::gen
+{
+	/// @brief Reads the self weight of the functions of a folded stacks file.
+	/// Each line is 'caller;...;function <count>': the count is the self weight of the leaf.
+	/// Frames outside of the JIT ('[native]') are skipped.
+	/// @param path The path of the file
+	/// @param weights The functions and their self weight, by decreasing weight
+	/// @return False if the file could not be read
+	bool ReadSelfWeights(const char* path, std::vector<std::pair<std::string, u64>>& weights) noexcept;
+
+	/// @brief Reads the order in which to place functions.
+	/// If the file is a folded stacks profile, the functions with samples are
+	/// ordered by decreasing self weight. Else each line is a function, named
+	/// as demangled ('fn(i64)->i64'), as mangled, or by its name only (all its overloads).
+	/// Empty lines and lines beginning with '#' are ignored.
+	/// @param path The path of the file
+	/// @param order The functions, hottest first
+	/// @return False if the file could not be read
+	bool ReadFunctionOrder(const char* path, std::vector<std::string>& order) noexcept;
+}
+
+#endif //!HG_COLT_FUNCTION_ORDER
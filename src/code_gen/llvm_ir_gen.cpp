@@ -4,9 +4,28 @@
 
 #include <code_gen/llvm_ir_gen.h>
 #include <ast/colt_ast.h>
+#include <cmd/colt_args.h>
 
 #ifndef COLT_NO_LLVM
 
+#include <llvm/IR/DiagnosticHandler.h>
+#include <llvm/IR/DiagnosticInfo.h>
+#include <llvm/IR/LLVMRemarkStreamer.h>
+#include <llvm/Remarks/RemarkStreamer.h>
+#include <llvm/Support/Regex.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Analysis/CallGraph.h>
+#include <llvm/ADT/SCCIterator.h>
+#include <llvm/Object/ObjectFile.h>
+#include <llvm/Object/SymbolSize.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <string_view>
+#include <unordered_map>
+
 /// @brief Contains code generators
 namespace colt::gen
 {
@@ -17,7 +36,230 @@ namespace colt::gen
     return StringRef(view.get_data(), view.get_size());
   }
 
-  Expected<GeneratedIR, std::string> GenerateIR(const lang::AST& ast, const std::string& target_triple) noexcept
+#ifdef COLT_RUNTIME_BITCODE
+  /// @brief The bitcode of 'runtime/colt_print.c' (generated by CMake)
+  extern const unsigned char ColtRuntimeBitcode[];
+  /// @brief The size of ColtRuntimeBitcode
+  extern const size_t ColtRuntimeBitcodeSize;
+#endif //COLT_RUNTIME_BITCODE
+
+  namespace
+  {
+    /// @brief Diagnostic handler which prints the optimization remarks
+    ///        of passes matching a regex through the Colt diagnostics.
+    class RemarkDiagnosticHandler final : public DiagnosticHandler
+    {
+      /// @brief The regex of passes whose remarks are printed
+      Regex pass_regex;
+      /// @brief Maps debug locations to the expression they were generated from
+      const Map<u64, lang::SourceCodeExprInfo>& locations;
+
+    public:
+      /// @brief Constructs a handler
+      /// @param pass_regex The (valid) regex of passes whose remarks are printed
+      /// @param locations The debug locations of the module
+      RemarkDiagnosticHandler(Regex&& pass_regex, const Map<u64, lang::SourceCodeExprInfo>& locations) noexcept
+        : pass_regex(std::move(pass_regex)), locations(locations) {}
+
+      bool isAnalysisRemarkEnabled(StringRef pass_name) const override { return pass_regex.match(pass_name); }
+      bool isMissedOptRemarkEnabled(StringRef pass_name) const override { return pass_regex.match(pass_name); }
+      bool isPassedOptRemarkEnabled(StringRef pass_name) const override { return pass_regex.match(pass_name); }
+      bool isAnyRemarkEnabled() const override { return true; }
+
+      bool handleDiagnostics(const DiagnosticInfo& DI) override
+      {
+        auto remark = dyn_cast<DiagnosticInfoOptimizationBase>(&DI);
+        //Let LLVM handle any other diagnostic
+        if (remark == nullptr)
+          return false;
+        if (!pass_regex.match(remark->getPassName()))
+          return true;
+
+        //If no expression is found, only the message is printed
+        lang::SourceCodeExprInfo src_info = {};
+        if (remark->isLocationAvailable())
+        {
+          auto loc = remark->getLocation();
+          if (auto found = locations.find(DebugLocationKey(loc.getLine(), loc.getColumn())))
+            src_info = found->second;
+        }
+
+        if (remark->isMissed())
+          lang::GenerateWarning(src_info, "Missed optimization ({}): {}", remark->getPassName().str(), remark->getMsg());
+        else if (remark->isPassed())
+          lang::GenerateMessage(src_info, "Optimization ({}): {}", remark->getPassName().str(), remark->getMsg());
+        else
+          lang::GenerateMessage(src_info, "Optimization analysis ({}): {}", remark->getPassName().str(), remark->getMsg());
+        return true;
+      }
+    };
+
+    /// @brief Enables optimization remarks (as requested by the command line arguments)
+    ///        for the lifetime of the object.
+    class RemarkScope
+    {
+      /// @brief The context whose remarks are enabled
+      LLVMContext& context;
+      /// @brief The file in which remarks are serialized, or nullptr
+      std::unique_ptr<ToolOutputFile> remarks_file = nullptr;
+      /// @brief True if the diagnostic handler was replaced
+      bool has_handler = false;
+
+    public:
+      /// @brief Enables optimization remarks
+      /// @param context The context whose remarks to enable
+      /// @param locations The debug locations, or nullptr if remarks were not requested
+      RemarkScope(LLVMContext& context, PTR<const Map<u64, lang::SourceCodeExprInfo>> locations) noexcept
+        : context(context)
+      {
+        if (locations == nullptr)
+          return;
+
+        const char* pass_regex = args::GlobalArguments.remarks_regex;
+        if (pass_regex != nullptr)
+        {
+          Regex regex = { pass_regex };
+          if (std::string error; !regex.isValid(error))
+            io::PrintError("Invalid remarks regex '{}': {}!", pass_regex, error);
+          else
+          {
+            context.setDiagnosticHandler(std::make_unique<RemarkDiagnosticHandler>(std::move(regex), *locations));
+            has_handler = true;
+          }
+        }
+        if (const char* path = args::GlobalArguments.remarks_file)
+        {
+          //Serialize every remark if no regex was specified
+          auto file = setupLLVMOptimizationRemarks(context, path,
+            pass_regex != nullptr ? pass_regex : "", "yaml", false);
+          if (!file)
+            io::PrintError("Could not open remarks file '{}': {}!", path, toString(file.takeError()));
+          else
+            remarks_file = std::move(*file);
+        }
+      }
+
+      /// @brief Disables optimization remarks, writing the remarks file if any
+      ~RemarkScope() noexcept
+      {
+        if (has_handler)
+          context.setDiagnosticHandler(std::make_unique<DiagnosticHandler>());
+        if (remarks_file)
+        {
+          //The streamers refer to the file, which is about to be closed
+          context.setLLVMRemarkStreamer(nullptr);
+          context.setMainRemarkStreamer(nullptr);
+          remarks_file->keep();
+        }
+      }
+    };
+
+    /// @brief Diagnostic handler which records the stack frame size of
+    ///        functions, reported by the backend through 'warn-stack-size'.
+    class StackSizeDiagnosticHandler final : public DiagnosticHandler
+    {
+      /// @brief The frame size of the functions (functions without frame are not reported)
+      std::unordered_map<const Function*, u64>& frame_sizes;
+
+    public:
+      /// @brief Constructs a handler
+      /// @param frame_sizes The map in which to record the frame sizes
+      StackSizeDiagnosticHandler(std::unordered_map<const Function*, u64>& frame_sizes) noexcept
+        : frame_sizes(frame_sizes) {}
+
+      bool handleDiagnostics(const DiagnosticInfo& DI) override
+      {
+        auto stack_size = dyn_cast<DiagnosticInfoStackSize>(&DI);
+        //Let LLVM handle any other diagnostic
+        if (stack_size == nullptr)
+          return false;
+        frame_sizes[&stack_size->getFunction()] = stack_size->getStackSize();
+        return true;
+      }
+    };
+
+    /// @brief Compiles a module to an object file in memory
+    /// @param target_machine The target machine
+    /// @param module The module to compile (which is modified by code generation)
+    /// @param buffer The buffer in which to write the object file
+    /// @return False if the target does not support emitting object files
+    bool EmitObject(TargetMachine& target_machine, Module& module, SmallVector<char, 0>& buffer) noexcept
+    {
+      raw_svector_ostream stream{ buffer };
+      legacy::PassManager pass;
+      if (target_machine.addPassesToEmitFile(pass, stream, nullptr, CGFT_ObjectFile))
+        return false;
+      pass.run(module);
+      return true;
+    }
+
+    /// @brief Returns the demangled name of a function
+    /// @param fn The function
+    /// @return The demangled name
+    std::string DemangledName(const Function& fn) noexcept
+    {
+      auto demangled = demangle(StringView{ fn.getName().data(), fn.getName().size() });
+      StringView view = demangled;
+      return std::string{ view.get_data(), view.get_size() };
+    }
+
+    /// @brief Links the runtime bitcode in a module.
+    /// Only the runtime functions used by the module are linked, and are made internal,
+    /// so that they can be inlined and are removed if unused after optimizations.
+    /// Nothing is linked if the bitcode is not embedded, or was compiled for another architecture.
+    /// @param module The module in which to link the runtime
+    void LinkRuntime(Module& module) noexcept
+    {
+#ifdef COLT_RUNTIME_BITCODE
+      auto buffer = MemoryBufferRef(StringRef(reinterpret_cast<const char*>(ColtRuntimeBitcode), ColtRuntimeBitcodeSize),
+        "colt_runtime");
+      auto runtime = parseBitcodeFile(buffer, module.getContext());
+      if (!runtime)
+      {
+        //The bitcode may have been produced by a newer version of clang
+        io::PrintWarning("Could not read the runtime bitcode: {}!", toString(runtime.takeError()));
+        return;
+      }
+      if (Triple((*runtime)->getTargetTriple()).getArch() != Triple(module.getTargetTriple()).getArch())
+        return;
+      (*runtime)->setTargetTriple(module.getTargetTriple());
+      (*runtime)->setDataLayout(module.getDataLayout());
+
+      std::vector<std::string> defined;
+      for (auto& fn : **runtime)
+      {
+        if (fn.isDeclaration())
+          continue;
+        //Functions defined by the program take precedence over the runtime
+        if (auto defined_fn = module.getFunction(fn.getName()); defined_fn != nullptr && !defined_fn->isDeclaration())
+        {
+          fn.deleteBody();
+          continue;
+        }
+        //The features of the host must not prevent inlining in generic code
+        fn.removeFnAttr("target-cpu");
+        fn.removeFnAttr("target-features");
+        fn.removeFnAttr("tune-cpu");
+        //The sampling profiler walks the stack through frame pointers
+        if (args::GlobalArguments.profile_hz != 0)
+          fn.addFnAttr("frame-pointer", "all");
+        defined.push_back(fn.getName().str());
+      }
+      if (Linker::linkModules(module, std::move(*runtime), Linker::Flags::LinkOnlyNeeded))
+      {
+        io::PrintWarning("Could not link the runtime bitcode!");
+        return;
+      }
+      for (const auto& name : defined)
+      {
+        if (auto fn = module.getFunction(name); fn != nullptr && !fn->isDeclaration())
+          fn->setLinkage(GlobalValue::InternalLinkage);
+      }
+#endif //COLT_RUNTIME_BITCODE
+    }
+  }
+
+  Expected<GeneratedIR, std::string> GenerateIR(const lang::AST& ast, PTR<const HostFnRegistry> host_functions, const std::string& target_triple) noexcept
   {
     GeneratedIR ir;
     std::string error;
@@ -28,8 +270,14 @@ namespace colt::gen
     ir.module->setTargetTriple(target_triple);
     ir.module->setDataLayout(ir.target_machine->createDataLayout());
 
+    //Debug locations are needed to map remarks back to expressions
+    if (args::GlobalArguments.remarks_regex || args::GlobalArguments.remarks_file)
+      ir.debug_locations = std::make_unique<Map<u64, lang::SourceCodeExprInfo>>();
+
     //Generate and store the IR in 'ir'
-    LLVMIRGenerator ir_gen = { ast, *ir.context, *ir.module };
+    LLVMIRGenerator ir_gen = { ast, *ir.context, *ir.module, ir.debug_locations.get(), host_functions };
+    //Link the runtime before optimizations, so that it can be inlined
+    LinkRuntime(*ir.module);
     //Verify module
     if (llvm::verifyModule(*ir.module, &llvm::errs()))
       return { Error, "Generated IR is invalid!" };
@@ -70,7 +318,12 @@ namespace colt::gen
     CGSCCAnalysisManager CGAM;
     ModuleAnalysisManager MAM;
 
-    PassBuilder PB;
+    //Functions with identical bodies (such as the instantiations of a generic
+    //function for 'i64' and 'u64') are merged
+    PipelineTuningOptions tuning;
+    tuning.MergeFunctions = true;
+    //The target machine provides the cost models (needed for vectorization)
+    PassBuilder PB{ target_machine, tuning };
 
     PB.registerModuleAnalyses(MAM);
     PB.registerCGSCCAnalyses(CGAM);
@@ -90,26 +343,271 @@ namespace colt::gen
     break; case colt::gen::OptimizationLevel::Os:
       opt = llvm::OptimizationLevel::Os;
     break; case colt::gen::OptimizationLevel::Oz:
-      opt = llvm::OptimizationLevel::Os;
+      opt = llvm::OptimizationLevel::Oz;
     break; default:
       colt_unreachable("Invalid optimization level");
     }
 
+    //Print or serialize remarks while optimizing
+    RemarkScope remarks = { *context, debug_locations.get() };
+
     ModulePassManager MPM = PB.buildPerModuleDefaultPipeline(opt);
     MPM.run(*module, MAM);
   }
 
-  LLVMIRGenerator::LLVMIRGenerator(const lang::AST& ast, llvm::LLVMContext& ctx, llvm::Module& mod) noexcept
-    : context(ctx), module(mod), builder(ctx)
+  size_t GeneratedIR::order_functions(const std::vector<std::string>& order) noexcept
+  {
+    //The functions defined in the module, and their demangled names
+    std::vector<std::pair<PTR<Function>, std::string>> defined;
+    for (auto& fn : *module)
+    {
+      if (!fn.isDeclaration())
+        defined.push_back({ &fn, DemangledName(fn) });
+    }
+
+    auto& functions = module->getFunctionList();
+    auto insert_point = functions.begin();
+    size_t placed = 0;
+    for (const auto& name : order)
+    {
+      for (auto& [fn, demangled] : defined)
+      {
+        if (fn == nullptr)
+          continue;
+        //A name without parameters matches all the overloads
+        std::string_view fn_name = std::string_view{ demangled }.substr(0, demangled.find('('));
+        if (name != demangled && name != fn_name && fn->getName() != name)
+          continue;
+        fn->setSectionPrefix("hot");
+        if (&*insert_point == fn)
+          ++insert_point;
+        else
+          functions.splice(insert_point, functions, fn->getIterator());
+        //Each function is only placed once
+        fn = nullptr;
+        ++placed;
+      }
+    }
+    return placed;
+  }
+
+  Expected<bool, const char*> GeneratedIR::write_size_report(std::FILE* report) noexcept
+  {
+    //Code generation modifies the IR: compile a copy of the module
+    auto copy = CloneModule(*module);
+    SmallVector<char, 0> buffer;
+    if (!EmitObject(*target_machine, *copy, buffer))
+      return "Target does not support emitting object file!";
+
+    auto object_file = object::ObjectFile::createObjectFile(
+      MemoryBufferRef{ StringRef{ buffer.data(), buffer.size() }, "colt" });
+    if (!object_file)
+    {
+      consumeError(object_file.takeError());
+      return "Could not read the emitted object file!";
+    }
+
+    std::vector<std::pair<std::string, u64>> sizes;
+    u64 total = 0;
+    for (const auto& [symbol, size] : object::computeSymbolSizes(**object_file))
+    {
+      auto type = symbol.getType();
+      auto name = symbol.getName();
+      if (!type || !name)
+      {
+        consumeError(type.takeError());
+        consumeError(name.takeError());
+        continue;
+      }
+      if (*type != object::SymbolRef::ST_Function)
+        continue;
+      auto demangled = demangle(StringView{ name->data(), name->size() });
+      StringView view = demangled;
+      sizes.push_back({ std::string{ view.get_data(), view.get_size() }, size });
+      total += size;
+    }
+    std::sort(sizes.begin(), sizes.end(), [](const auto& a, const auto& b)
+      { return a.second > b.second || (a.second == b.second && a.first < b.first); });
+
+    std::fprintf(report, "Colt machine code size: %" PRIu64 " bytes in %zu functions\n\n%12s %8s  %s\n",
+      total, sizes.size(), "Bytes", "Size %", "Function");
+    for (const auto& [name, size] : sizes)
+    {
+      std::fprintf(report, "%12" PRIu64 " %7.2f%%  %s\n", size,
+        total == 0 ? 0.0 : 100.0 * static_cast<double>(size) / static_cast<double>(total), name.c_str());
+    }
+    return true;
+  }
+
+  Expected<std::vector<FnStackUsage>, const char*> GeneratedIR::stack_usage() noexcept
   {
+    //Code generation modifies the IR: compile a copy of the module,
+    //whose functions report their frame size (if greater than 0)
+    auto copy = CloneModule(*module);
+    for (auto& fn : *copy)
+    {
+      if (!fn.isDeclaration())
+        fn.addFnAttr("warn-stack-size", "0");
+    }
+
+    std::unordered_map<const Function*, u64> frame_sizes;
+    auto old_handler = context->getDiagnosticHandler();
+    context->setDiagnosticHandler(std::make_unique<StackSizeDiagnosticHandler>(frame_sizes));
+    SmallVector<char, 0> buffer;
+    bool emitted = EmitObject(*target_machine, *copy, buffer);
+    context->setDiagnosticHandler(std::move(old_handler));
+    if (!emitted)
+      return { Error, "Target does not support emitting object file!" };
+
+    //Functions called by another function of the module are not entry points
+    CallGraph call_graph{ *copy };
+    std::unordered_map<const Function*, bool> is_called;
+    for (const auto& [fn, node] : call_graph)
+    {
+      //The external node calls every function visible outside of the module
+      if (fn == nullptr)
+        continue;
+      for (const auto& [call, callee] : *node)
+      {
+        if (callee->getFunction() != nullptr && callee->getFunction() != fn)
+          is_called[callee->getFunction()] = true;
+      }
+    }
+
+    //The strongly connected components are visited callees first: the
+    //worst case of the callees of a component is known when it is visited
+    std::vector<FnStackUsage> usages;
+    std::unordered_map<const Function*, size_t> usage_index;
+    for (auto scc = scc_begin(&call_graph); !scc.isAtEnd(); ++scc)
+    {
+      const auto& nodes = *scc;
+      //The functions of a cycle are executed once per recursion
+      u64 frames = 0;
+      u64 callees_worst_case = 0;
+      bool is_recursive = scc.hasCycle();
+      bool calls_unknown = false;
+      for (auto node : nodes)
+      {
+        auto fn = node->getFunction();
+        if (fn == nullptr || fn->isDeclaration())
+          continue;
+        frames += frame_sizes[fn];
+        for (const auto& [call, callee] : *node)
+        {
+          auto callee_fn = callee->getFunction();
+          //Intrinsics are expanded by code generation (or call library routines using little stack)
+          if (callee_fn != nullptr && callee_fn->isIntrinsic())
+            continue;
+          //Indirect calls and calls to extern functions
+          if (callee_fn == nullptr || callee_fn->isDeclaration())
+          {
+            calls_unknown = true;
+            continue;
+          }
+          if (std::find(nodes.begin(), nodes.end(), callee) != nodes.end())
+            continue;
+          auto& callee_usage = usages[usage_index[callee_fn]];
+          callees_worst_case = std::max(callees_worst_case, callee_usage.worst_case);
+          is_recursive |= callee_usage.is_recursive;
+          calls_unknown |= callee_usage.calls_unknown;
+        }
+      }
+
+      for (auto node : nodes)
+      {
+        auto fn = node->getFunction();
+        if (fn == nullptr || fn->isDeclaration())
+          continue;
+        usage_index[fn] = usages.size();
+        usages.push_back({ DemangledName(*fn), frame_sizes[fn], frames + callees_worst_case,
+          is_recursive, calls_unknown, !is_called[fn] || fn->getName() == "main" });
+      }
+    }
+    std::sort(usages.begin(), usages.end(), [](const auto& a, const auto& b)
+      { return a.worst_case > b.worst_case || (a.worst_case == b.worst_case && a.name < b.name); });
+    return usages;
+  }
+
+  void WriteStackUsage(std::FILE* report, const std::vector<FnStackUsage>& usages) noexcept
+  {
+    std::fprintf(report, "Colt stack usage: %zu functions\n\n%12s %12s  %s\n",
+      usages.size(), "Frame", "Worst case", "Function");
+    for (const auto& usage : usages)
+    {
+      std::fprintf(report, "%12" PRIu64 " %12" PRIu64 "  %s%s%s%s\n", usage.frame_size, usage.worst_case, usage.name.c_str(),
+        usage.is_entry ? " [entry]" : "",
+        usage.is_recursive ? " [recursive: unbounded]" : "",
+        usage.calls_unknown ? " [calls extern or indirect functions]" : "");
+    }
+  }
+
+  LLVMIRGenerator::LLVMIRGenerator(const lang::AST& ast, llvm::LLVMContext& ctx, llvm::Module& mod, PTR<Map<u64, lang::SourceCodeExprInfo>> debug_locations,
+    PTR<const HostFnRegistry> host_functions) noexcept
+    : context(ctx), module(mod), builder(ctx), debug_locations(debug_locations),
+    colt_ctx(ast.ctx), host_functions(host_functions)
+  {
+    if (debug_locations)
+    {
+      //Line tables are enough to map instructions back to expressions
+      di_builder = std::make_unique<DIBuilder>(module);
+      di_file = di_builder->createFile(
+        args::GlobalArguments.file_in ? args::GlobalArguments.file_in : "<colt>", ".");
+      di_builder->createCompileUnit(dwarf::DW_LANG_C, di_file, "colt", true, "", 0, "",
+        DICompileUnit::LineTablesOnly);
+      module.addModuleFlag(Module::Warning, "Debug Info Version", DEBUG_METADATA_VERSION);
+    }
+    if (args::GlobalArguments.instrument_functions)
+    {
+      //Hooks of the profiler runtime (see 'runtime/colt_profiler.h')
+      AttributeList no_unwind = AttributeList::get(context, AttributeList::FunctionIndex, Attribute::NoUnwind);
+      prof_enter = module.getOrInsertFunction("_ColtProfEnter", no_unwind,
+        builder.getVoidTy(), builder.getInt8PtrTy());
+      prof_exit = module.getOrInsertFunction("_ColtProfExit", no_unwind, builder.getVoidTy());
+    }
+
     for (size_t i = 0; i < ast.expressions.get_size(); i++)
       gen_ir(ast.expressions[i]);
+
+    if (di_builder)
+      di_builder->finalize();
+  }
+
+  void LLVMIRGenerator::set_debug_location(PTR<const lang::Expr> ptr) noexcept
+  {
+    if (!di_builder)
+      return;
+    if (current_fn == nullptr || current_fn->getSubprogram() == nullptr)
+    {
+      builder.SetCurrentDebugLocation(DebugLoc());
+      return;
+    }
+
+    const auto& src_info = ptr->get_src_code();
+    u32 line = 0;
+    u32 column = 0;
+    if (src_info.is_valid())
+    {
+      line = src_info.line_begin;
+      if (src_info.lines.begin() <= src_info.expression.begin())
+        column = as<u32>(src_info.expression.begin() - src_info.lines.begin()) + 1;
+      //Parents are visited before their children, so a location
+      //shared by nested expressions maps to the outermost one
+      if (!debug_locations->find(DebugLocationKey(line, column)))
+        debug_locations->insert(DebugLocationKey(line, column), src_info);
+    }
+    builder.SetCurrentDebugLocation(
+      DILocation::get(context, line, column, current_fn->getSubprogram()));
   }
 
   void LLVMIRGenerator::gen_ir(PTR<const lang::Expr> ptr) noexcept
   {
     using namespace lang;
 
+    //Restore the location of the parent expression once generated
+    DebugLoc parent_location = builder.getCurrentDebugLocation();
+    ON_EXIT{ builder.SetCurrentDebugLocation(parent_location); };
+    set_debug_location(ptr);
+
     switch (ptr->classof())
     {
     break; case Expr::EXPR_LITERAL:
@@ -144,6 +642,8 @@ namespace colt::gen
       gen_ptr_load(as<PTR<const PtrLoadExpr>>(ptr));
     break; case Expr::EXPR_PTR_STORE:
       gen_ptr_store(as<PTR<const PtrStoreExpr>>(ptr));
+    break; case Expr::EXPR_EMBED:
+      gen_embed(as<PTR<const EmbedExpr>>(ptr));
     break; case Expr::EXPR_FOR_LOOP:
     break; case Expr::EXPR_BREAK_CONTINUE:    
     break; default:
@@ -152,42 +652,47 @@ namespace colt::gen
   }
 
   void LLVMIRGenerator::gen_literal(PTR<const lang::LiteralExpr> ptr) noexcept
+  {
+    returned_value = gen_constant(ptr->get_value(), ptr->get_type());
+  }
+
+  PTR<llvm::Value> LLVMIRGenerator::gen_constant(QWORD value, PTR<const lang::BuiltInType> type) noexcept
   {
     using namespace colt::lang;
 
-    switch (ptr->get_type()->get_builtin_id())
-    {
-    break; case U8:
-      returned_value = ConstantInt::get(llvm::Type::getInt8Ty(context), ptr->get_value().as<u8>());
-    break; case U16:
-      returned_value = ConstantInt::get(llvm::Type::getInt16Ty(context), ptr->get_value().as<u16>());
-    break; case U32:
-      returned_value = ConstantInt::get(llvm::Type::getInt32Ty(context), ptr->get_value().as<u32>());
-    break; case U64:
-      returned_value = ConstantInt::get(llvm::Type::getInt64Ty(context), ptr->get_value().as<u64>());
-    break; case U128:
-      returned_value = ConstantInt::get(llvm::Type::getInt128Ty(context), ptr->get_value().as<u64>());
-    break; case I8:
-      returned_value = ConstantInt::get(llvm::Type::getInt8Ty(context), ptr->get_value().as<i8>());
-    break; case I16:
-      returned_value = ConstantInt::get(llvm::Type::getInt16Ty(context), ptr->get_value().as<i16>());
-    break; case I32:
-      returned_value = ConstantInt::get(llvm::Type::getInt32Ty(context), ptr->get_value().as<i32>());
-    break; case I64:
-      returned_value = ConstantInt::get(llvm::Type::getInt64Ty(context), ptr->get_value().as<i64>());
-    break; case I128:
-      returned_value = ConstantInt::get(llvm::Type::getInt128Ty(context), ptr->get_value().as<i64>());
-    break; case F32:
-      returned_value = ConstantFP::get(llvm::Type::getFloatTy(context), ptr->get_value().as<f32>());
-    break; case F64:
-      returned_value = ConstantFP::get(llvm::Type::getDoubleTy(context), ptr->get_value().as<f64>());
-    break; case BOOL:
-      returned_value = ConstantInt::get(llvm::Type::getInt1Ty(context), ptr->get_value().as<bool>());
-    break; case CHAR:
-      returned_value = ConstantInt::get(llvm::Type::getInt8Ty(context), ptr->get_value().as<char>());
-    break; case lang::lstring:
-      returned_value = builder.CreateGlobalStringPtr(ToStringRef(*ptr->get_value().as<PTR<String>>()), "GlobStr", 0U, &module);
-    break; default:
+    switch (type->get_builtin_id())
+    {
+    case U8:
+      return ConstantInt::get(llvm::Type::getInt8Ty(context), value.as<u8>());
+    case U16:
+      return ConstantInt::get(llvm::Type::getInt16Ty(context), value.as<u16>());
+    case U32:
+      return ConstantInt::get(llvm::Type::getInt32Ty(context), value.as<u32>());
+    case U64:
+      return ConstantInt::get(llvm::Type::getInt64Ty(context), value.as<u64>());
+    case U128:
+      return ConstantInt::get(llvm::Type::getInt128Ty(context), value.as<u64>());
+    case I8:
+      return ConstantInt::get(llvm::Type::getInt8Ty(context), value.as<i8>());
+    case I16:
+      return ConstantInt::get(llvm::Type::getInt16Ty(context), value.as<i16>());
+    case I32:
+      return ConstantInt::get(llvm::Type::getInt32Ty(context), value.as<i32>());
+    case I64:
+      return ConstantInt::get(llvm::Type::getInt64Ty(context), value.as<i64>());
+    case I128:
+      return ConstantInt::get(llvm::Type::getInt128Ty(context), value.as<i64>());
+    case F32:
+      return ConstantFP::get(llvm::Type::getFloatTy(context), value.as<f32>());
+    case F64:
+      return ConstantFP::get(llvm::Type::getDoubleTy(context), value.as<f64>());
+    case BOOL:
+      return ConstantInt::get(llvm::Type::getInt1Ty(context), value.as<bool>());
+    case CHAR:
+      return ConstantInt::get(llvm::Type::getInt8Ty(context), value.as<char>());
+    case lang::lstring:
+      return builder.CreateGlobalStringPtr(ToStringRef(*value.as<PTR<String>>()), "GlobStr", 0U, &module);
+    default:
       colt_unreachable("Invalid literal expr!");
     }
   }
@@ -209,20 +714,35 @@ namespace colt::gen
       else
         returned_value = global_vars.find(var_read->get_name())->second;
     }    
-    break; case UnaryOperator::OP_NEGATE:
-      returned_value = builder.CreateNeg(child);
-      break;
+    break; default:
+      returned_value = gen_unary_op(ptr->get_operation(), child);
+    }
+  }
+
+  PTR<llvm::Value> LLVMIRGenerator::gen_unary_op(lang::UnaryOperator op, PTR<llvm::Value> child) noexcept
+  {
+    using namespace colt::lang;
+
+    switch (op)
+    {
+    case UnaryOperator::OP_NEGATE:
+      if (child->getType()->isFloatingPointTy())
+        return builder.CreateFNeg(child);
+      return builder.CreateNeg(child);
     case UnaryOperator::OP_BIT_NOT:
     case UnaryOperator::OP_BOOL_NOT:
-      returned_value = builder.CreateNot(child);
-
-    break; default:
+      return builder.CreateNot(child);
+    default:
       colt_unreachable("Not implemented!");
     }
   }
 
   void LLVMIRGenerator::gen_binary(PTR<const lang::BinaryExpr> ptr) noexcept
   {
+    if (ptr->get_operation() == lang::BinaryOperator::OP_BOOL_AND
+      || ptr->get_operation() == lang::BinaryOperator::OP_BOOL_OR)
+      return gen_short_circuit(ptr);
+
     gen_ir(ptr->get_LHS());
     Value* lhs = returned_value;
     gen_ir(ptr->get_RHS());
@@ -230,141 +750,199 @@ namespace colt::gen
     
     assert_true(lhs && rhs, "Error generating binary expr!");    
 
-    using namespace colt::lang;
+    returned_value = gen_binary_op(ptr->get_operation(), as<PTR<const lang::BuiltInType>>(ptr->get_type()),
+      as<PTR<const lang::BuiltInType>>(ptr->get_LHS()->get_type()), lhs, rhs);
+  }
 
-    auto expr_t = as<PTR<const BuiltInType>>(ptr->get_type());
-    auto type_t = as<PTR<const BuiltInType>>(ptr->get_LHS()->get_type());
+  void LLVMIRGenerator::gen_short_circuit(PTR<const lang::BinaryExpr> ptr) noexcept
+  {
+    bool is_and = ptr->get_operation() == lang::BinaryOperator::OP_BOOL_AND;
 
-    switch (ptr->get_operation())
+    gen_ir(ptr->get_LHS());
+    Value* lhs = returned_value;
+    //The LHS may itself have created blocks
+    BasicBlock* lhs_end = builder.GetInsertBlock();
+    Function* function = lhs_end->getParent();
+
+    BasicBlock* rhs_st = BasicBlock::Create(context, is_and ? "and_rhs" : "or_rhs", function);
+    BasicBlock* after_st = BasicBlock::Create(context, is_and ? "after_and" : "after_or");
+    //'false && ...' is false, 'true || ...' is true
+    if (is_and)
+      builder.CreateCondBr(lhs, rhs_st, after_st);
+    else
+      builder.CreateCondBr(lhs, after_st, rhs_st);
+
+    builder.SetInsertPoint(rhs_st);
+    gen_ir(ptr->get_RHS());
+    Value* rhs = returned_value;
+    BasicBlock* rhs_end = builder.GetInsertBlock();
+    builder.CreateBr(after_st);
+
+    function->getBasicBlockList().push_back(after_st);
+    builder.SetInsertPoint(after_st);
+    PHINode* result = builder.CreatePHI(lhs->getType(), 2, is_and ? "bool_and" : "bool_or");
+    result->addIncoming(ConstantInt::get(lhs->getType(), is_and ? 0 : 1), lhs_end);
+    result->addIncoming(rhs, rhs_end);
+    returned_value = result;
+  }
+
+  PTR<llvm::Value> LLVMIRGenerator::gen_binary_op(lang::BinaryOperator op, PTR<const lang::BuiltInType> expr_t,
+    PTR<const lang::BuiltInType> type_t, PTR<llvm::Value> lhs, PTR<llvm::Value> rhs) noexcept
+  {
+    using namespace colt::lang;
+
+    PTR<Value> result = nullptr;
+    switch (op)
     {
       /*********** ARITHMETIC ***********/
 
     break; case BinaryOperator::OP_SUM:
       if (expr_t->is_integral())
-        returned_value = builder.CreateAdd(lhs, rhs);
+        result = builder.CreateAdd(lhs, rhs);
       else if (expr_t->is_floating())
-        returned_value = builder.CreateFAdd(lhs, rhs);
+        result = builder.CreateFAdd(lhs, rhs);
     break; case BinaryOperator::OP_SUB:
       if (expr_t->is_integral())
-        returned_value = builder.CreateSub(lhs, rhs);
+        result = builder.CreateSub(lhs, rhs);
       else if (expr_t->is_floating())
-        returned_value = builder.CreateFSub(lhs, rhs);
+        result = builder.CreateFSub(lhs, rhs);
     break; case BinaryOperator::OP_MUL:
       if (expr_t->is_integral())
-        returned_value = builder.CreateMul(lhs, rhs);
+        result = builder.CreateMul(lhs, rhs);
       else if (expr_t->is_floating())
-        returned_value = builder.CreateFMul(lhs, rhs);
+        result = builder.CreateFMul(lhs, rhs);
     break; case BinaryOperator::OP_DIV:
       if (expr_t->is_unsigned_int())
-        returned_value = builder.CreateUDiv(lhs, rhs);
+        result = builder.CreateUDiv(lhs, rhs);
       else if (expr_t->is_signed_int())
-        returned_value = builder.CreateSDiv(lhs, rhs);
+        result = builder.CreateSDiv(lhs, rhs);
       else if (expr_t->is_floating())
-        returned_value = builder.CreateFDiv(lhs, rhs);
+        result = builder.CreateFDiv(lhs, rhs);
     break; case BinaryOperator::OP_MOD:
       if (expr_t->is_unsigned_int())
-        returned_value = builder.CreateURem(lhs, rhs);
+        result = builder.CreateURem(lhs, rhs);
       if (expr_t->is_signed_int())
-        returned_value = builder.CreateSRem(lhs, rhs);
+        result = builder.CreateSRem(lhs, rhs);
 
       /*********** BITWISE ***********/
 
     break; case BinaryOperator::OP_BIT_AND:
-      returned_value = builder.CreateAnd(lhs, rhs);
+      result = builder.CreateAnd(lhs, rhs);
     break; case BinaryOperator::OP_BIT_OR:
-      returned_value = builder.CreateOr(lhs, rhs);
+      result = builder.CreateOr(lhs, rhs);
     break; case BinaryOperator::OP_BIT_XOR:
-      returned_value = builder.CreateXor(lhs, rhs);
+      result = builder.CreateXor(lhs, rhs);
     break; case BinaryOperator::OP_BIT_LSHIFT:
-      returned_value = builder.CreateShl(lhs, rhs);
+      result = builder.CreateShl(lhs, rhs);
     break; case BinaryOperator::OP_BIT_RSHIFT:
-      returned_value = builder.CreateLShr(lhs, rhs);
+      result = builder.CreateLShr(lhs, rhs);
 
       /*********** BOOLEANS ***********/
 
     break; case BinaryOperator::OP_LESS:
       if (type_t->is_unsigned_int())
-        returned_value = builder.CreateICmpULT(lhs, rhs, "ui_lt");
+        result = builder.CreateICmpULT(lhs, rhs, "ui_lt");
       else if (type_t->is_signed_int())
-        returned_value = builder.CreateICmpSLT(lhs, rhs, "si_lt");
+        result = builder.CreateICmpSLT(lhs, rhs, "si_lt");
       else if (type_t->is_floating())
-        returned_value = builder.CreateFCmpOLT(lhs, rhs, "fp_lt");
+        result = builder.CreateFCmpOLT(lhs, rhs, "fp_lt");
     break; case BinaryOperator::OP_LESS_EQUAL:
       if (type_t->is_unsigned_int())
-        returned_value = builder.CreateICmpULE(lhs, rhs, "ui_leq");
+        result = builder.CreateICmpULE(lhs, rhs, "ui_leq");
       else if (type_t->is_signed_int())
-        returned_value = builder.CreateICmpSLE(lhs, rhs, "si_leq");
+        result = builder.CreateICmpSLE(lhs, rhs, "si_leq");
       else if (type_t->is_floating())
-        returned_value = builder.CreateFCmpOLE(lhs, rhs, "fp_leq");
+        result = builder.CreateFCmpOLE(lhs, rhs, "fp_leq");
     break; case BinaryOperator::OP_GREAT:
       if (type_t->is_unsigned_int())
-        returned_value = builder.CreateICmpUGT(lhs, rhs, "ui_gt");
+        result = builder.CreateICmpUGT(lhs, rhs, "ui_gt");
       else if (type_t->is_signed_int())
-        returned_value = builder.CreateICmpSGT(lhs, rhs, "si_gt");
+        result = builder.CreateICmpSGT(lhs, rhs, "si_gt");
       else if (type_t->is_floating())
-        returned_value = builder.CreateFCmpOGT(lhs, rhs, "fp_gt");
+        result = builder.CreateFCmpOGT(lhs, rhs, "fp_gt");
     break; case BinaryOperator::OP_GREAT_EQUAL:
       if (type_t->is_unsigned_int())
-        returned_value = builder.CreateICmpUGE(lhs, rhs, "ui_geq");
+        result = builder.CreateICmpUGE(lhs, rhs, "ui_geq");
       else if (type_t->is_signed_int())
-        returned_value = builder.CreateICmpSGE(lhs, rhs, "si_geq");
+        result = builder.CreateICmpSGE(lhs, rhs, "si_geq");
       else if (type_t->is_floating())
-        returned_value = builder.CreateFCmpOGE(lhs, rhs, "fp_geq");
+        result = builder.CreateFCmpOGE(lhs, rhs, "fp_geq");
     break; case BinaryOperator::OP_EQUAL:
       if (type_t->is_integral())
-        returned_value = builder.CreateICmpEQ(lhs, rhs, "i_eq");
+        result = builder.CreateICmpEQ(lhs, rhs, "i_eq");
       else if (type_t->is_floating())
-        returned_value = builder.CreateFCmpOEQ(lhs, rhs, "fp_eq");
+        result = builder.CreateFCmpOEQ(lhs, rhs, "fp_eq");
     break; case BinaryOperator::OP_NOT_EQUAL:
       if (type_t->is_integral())
-        returned_value = builder.CreateICmpNE(lhs, rhs, "i_neq");
+        result = builder.CreateICmpNE(lhs, rhs, "i_neq");
       else if (type_t->is_floating())
-        returned_value = builder.CreateFCmpONE(lhs, rhs, "fp_neq");
+        result = builder.CreateFCmpONE(lhs, rhs, "fp_neq");
 
     break; default:
       colt_unreachable("Invalid operation!");
     }
+    return result;
   }
 
   void LLVMIRGenerator::gen_convert(PTR<const lang::ConvertExpr> ptr) noexcept
   {
-    using namespace colt::lang;
-
     gen_ir(ptr->get_child());
 
     assert_true(ptr->get_type()->is_builtin(), "Type must be built-in!");
 
-    auto expr_t = ptr->get_type();
-    auto child_t = as<PTR<const BuiltInType>>(ptr->get_child()->get_type());
+    returned_value = gen_conversion(ptr->get_conversion_type(), ptr->get_type(),
+      as<PTR<const lang::BuiltInType>>(ptr->get_child()->get_type()), returned_value);
+  }
+
+  PTR<llvm::Value> LLVMIRGenerator::gen_conversion(lang::ConvertExpr::ConversionType cnv, PTR<const lang::BuiltInType> expr_t,
+    PTR<const lang::BuiltInType> child_t, PTR<llvm::Value> value) noexcept
+  {
+    using namespace colt::lang;
 
-    if (ptr->get_conversion_type() == ConvertExpr::CNV_AS)
+    PTR<Value> result = value;
+    if (cnv == ConvertExpr::CNV_AS)
     {
       if (expr_t->get_builtin_id() == BOOL)
-        returned_value = builder.CreateIsNotNull(returned_value, "to_bool");
+        result = builder.CreateIsNotNull(result, "to_bool");
       if (child_t->is_floating() && expr_t->is_signed_int())
-        returned_value = builder.CreateFPToSI(returned_value, type_to_llvm(expr_t), "fp_to_si");
+        result = builder.CreateFPToSI(result, type_to_llvm(expr_t), "fp_to_si");
       else if (child_t->is_floating() && expr_t->is_unsigned_int())
-        returned_value = builder.CreateFPToUI(returned_value, type_to_llvm(expr_t), "fp_to_ui");
+        result = builder.CreateFPToUI(result, type_to_llvm(expr_t), "fp_to_ui");
       else if (child_t->is_unsigned_int() && expr_t->is_floating())
-        returned_value = builder.CreateUIToFP(returned_value, type_to_llvm(expr_t), "ui_to_fp");
+        result = builder.CreateUIToFP(result, type_to_llvm(expr_t), "ui_to_fp");
       else if (child_t->is_signed_int() && expr_t->is_floating())
-        returned_value = builder.CreateSIToFP(returned_value, type_to_llvm(expr_t), "si_to_fp");
+        result = builder.CreateSIToFP(result, type_to_llvm(expr_t), "si_to_fp");
       //Same types conversions
       else if (child_t->is_integral())
-        returned_value = builder.CreateIntCast(returned_value, type_to_llvm(expr_t), child_t->is_bool() ? false : expr_t->is_signed_int(), "i_to_i");
+        result = builder.CreateIntCast(result, type_to_llvm(expr_t), child_t->is_signed_int(), "i_to_i");
       else if (child_t->is_floating())
-        returned_value = builder.CreateFPCast(returned_value, type_to_llvm(expr_t), "fp_to_fp");
+        result = builder.CreateFPCast(result, type_to_llvm(expr_t), "fp_to_fp");
       else
         colt_unreachable("Invalid conversion!");
     }
     else // bit_as
     {
-      auto alloc = builder.CreateAlloca(returned_value->getType());
-      builder.CreateStore(returned_value, alloc);
-      returned_value = builder.CreateBitCast(alloc,
+      auto alloc = create_entry_alloca(result->getType());
+      builder.CreateStore(result, alloc);
+      result = builder.CreateBitCast(alloc,
         llvm::PointerType::get(type_to_llvm(expr_t), 0));
-      returned_value = builder.CreateLoad(type_to_llvm(expr_t), returned_value);
+      result = builder.CreateLoad(type_to_llvm(expr_t), result);
     }
+    return result;
+  }
+
+  void LLVMIRGenerator::gen_embed(PTR<const lang::EmbedExpr> ptr) noexcept
+  {
+    StringView data = ptr->get_data();
+    auto content = ConstantDataArray::get(context,
+      ArrayRef<u8>(reinterpret_cast<const u8*>(data.get_data()), data.get_size()));
+    //A private constant is emitted in '.rodata' (and identical files can be merged)
+    auto gvar = new GlobalVariable(module, content->getType(), true, GlobalValue::PrivateLinkage, content, "Embed");
+    gvar->setUnnamedAddr(GlobalValue::UnnamedAddr::Global);
+    //Aligned for vectorized loads of the elements
+    llvm::Type* element = type_to_llvm(ptr->get_ptr_type()->get_type_to());
+    gvar->setAlignment(Align(std::max<u64>(16, module.getDataLayout().getABITypeAlign(element).value())));
+    returned_value = builder.CreateBitCast(gvar, type_to_llvm(ptr->get_type()));
   }
 
   void LLVMIRGenerator::gen_var_decl(PTR<const lang::VarDeclExpr> ptr) noexcept
@@ -373,8 +951,7 @@ namespace colt::gen
     {
       //Create an allocation on the stack and store it
       local_vars.push_back(
-        builder.CreateAlloca(type_to_llvm(ptr->get_type()), nullptr,
-          ToStringRef(ptr->get_name()))
+        create_entry_alloca(type_to_llvm(ptr->get_type()), ToStringRef(ptr->get_name()))
       );
     
       //If initialized
@@ -439,6 +1016,27 @@ namespace colt::gen
     }
   }
 
+  void LLVMIRGenerator::add_host_attributes(PTR<const lang::FnDeclExpr> decl, PTR<llvm::Function> fn) noexcept
+  {
+    auto host_fn = host_functions->find(decl->get_name());
+    if (host_fn == nullptr)
+      return;
+    if (!host_fn->matches(decl->get_type(), colt_ctx))
+    {
+      io::PrintWarning("Declaration of '{}' does not match the signature of the host function!", decl->get_name());
+      return;
+    }
+    if (!(host_fn->attributes & HOST_FN_NOUNWIND))
+      fn->removeFnAttr(llvm::Attribute::NoUnwind);
+    if (host_fn->attributes & HOST_FN_PURE)
+    {
+      fn->setDoesNotAccessMemory();
+      fn->setWillReturn();
+    }
+    else if (host_fn->attributes & HOST_FN_READONLY)
+      fn->setOnlyReadsMemory();
+  }
+
   void LLVMIRGenerator::gen_fn_def(PTR<const lang::FnDefExpr> ptr) noexcept
   {
     PTR<Function> fn = Function::Create(
@@ -451,10 +1049,17 @@ namespace colt::gen
     
     //noexcept
     fn->addFnAttr(llvm::Attribute::NoUnwind);
+    //The sampling profiler walks the stack through frame pointers
+    if (args::GlobalArguments.profile_hz != 0)
+      fn->addFnAttr("frame-pointer", "all");
     
     //Extern functions do not have bodies
     if (ptr->get_fn_decl()->is_extern())
+    {
+      if (host_functions != nullptr)
+        add_host_attributes(ptr->get_fn_decl(), fn);
       return;
+    }
     
     assert_true(ptr->get_body(), "Body should not be empty!");       
     
@@ -462,6 +1067,16 @@ namespace colt::gen
     //Reset current_fn to nullptr
     ON_EXIT{ current_fn = nullptr; };
 
+    if (di_builder)
+    {
+      u32 line = ptr->get_src_code().line_begin;
+      fn->setSubprogram(di_builder->createFunction(di_file, ToStringRef(ptr->get_name()), fn->getName(),
+        di_file, line, di_builder->createSubroutineType(di_builder->getOrCreateTypeArray({})), line,
+        DINode::FlagZero, DISubprogram::SPFlagDefinition));
+      //The location was set before 'fn' had a subprogram
+      set_debug_location(ptr);
+    }
+
     PTR<llvm::BasicBlock> BB = BasicBlock::Create(context, "entry", fn);
     
     if (ptr->get_name() == "main" && !call_before_main.is_empty())
@@ -474,6 +1089,26 @@ namespace colt::gen
     }    
     builder.SetInsertPoint(BB);
 
+    if (prof_enter)
+    {
+      //The profiler reports demangled names
+      auto name = gen::demangle(StringView{ fn->getName().data(), fn->getName().size() });
+      builder.CreateCall(prof_enter,
+        { builder.CreateGlobalStringPtr(ToStringRef(name), "ProfName", 0U, &module) });
+    }
+
+    if (args::GlobalArguments.use_mir)
+    {
+      auto mir_fn = mir::Lower(ptr, colt_ctx);
+      mir::Optimize(mir_fn);
+      if (args::GlobalArguments.print_mir)
+        std::fputs(mir::ToString(mir_fn).c_str(), stderr);
+      for (size_t i = 0; i < ptr->get_params_count(); i++)
+        fn->getArg(as<unsigned>(i))->setName(ToStringRef(ptr->get_params_name()[i]));
+      gen_mir(mir_fn);
+      return;
+    }
+
     size_t i = 0;
 
     //We store the variables count to be able to pop variables of the scope
@@ -496,15 +1131,107 @@ namespace colt::gen
     local_vars.pop_back_n(local_vars.get_size() - current_scope_var_count);
   }
 
+  void LLVMIRGenerator::gen_mir(const mir::Function& mir_fn) noexcept
+  {
+    using namespace colt::lang;
+
+    std::vector<PTR<llvm::AllocaInst>> slots;
+    for (const auto& slot : mir_fn.slots)
+      slots.push_back(create_entry_alloca(type_to_llvm(slot.type), ToStringRef(slot.name)));
+
+    //The entry block of the MIR is the current block (which follows the profiler hook)
+    std::vector<PTR<llvm::BasicBlock>> blocks = { builder.GetInsertBlock() };
+    for (size_t i = 1; i < mir_fn.blocks.size(); i++)
+      blocks.push_back(mir_fn.blocks[i].empty() ? nullptr : BasicBlock::Create(context, "bb", current_fn));
+
+    //Values are only used in their block or in blocks dominated by the entry
+    //block, so generating the blocks in order defines values before their uses
+    std::vector<PTR<Value>> values(mir_fn.instrs.size(), nullptr);
+    for (size_t block = 0; block < mir_fn.blocks.size(); block++)
+    {
+      if (mir_fn.blocks[block].empty())
+        continue;
+      builder.SetInsertPoint(blocks[block]);
+      for (auto id : mir_fn.blocks[block])
+      {
+        const mir::Instr& instr = mir_fn.instrs[id];
+        auto operand = [&](size_t i) { return values[instr.operands[i]]; };
+        set_debug_location(instr.expr);
+
+        switch (instr.opcode)
+        {
+        break; case mir::Opcode::CONST:
+          values[id] = gen_constant(instr.value, as<PTR<const BuiltInType>>(instr.type));
+        break; case mir::Opcode::PARAM:
+          values[id] = current_fn->getArg(instr.index);
+        break; case mir::Opcode::UNARY:
+          values[id] = gen_unary_op(static_cast<UnaryOperator>(instr.op), operand(0));
+        break; case mir::Opcode::BINARY:
+          values[id] = gen_binary_op(static_cast<BinaryOperator>(instr.op), as<PTR<const BuiltInType>>(instr.type),
+            as<PTR<const BuiltInType>>(mir_fn.instrs[instr.operands[0]].type), operand(0), operand(1));
+        break; case mir::Opcode::CONVERT:
+          values[id] = gen_conversion(static_cast<ConvertExpr::ConversionType>(instr.op), as<PTR<const BuiltInType>>(instr.type),
+            as<PTR<const BuiltInType>>(mir_fn.instrs[instr.operands[0]].type), operand(0));
+        break; case mir::Opcode::SLOT_ADDR:
+          values[id] = slots[instr.index];
+        break; case mir::Opcode::SLOT_LOAD:
+          values[id] = builder.CreateLoad(slots[instr.index]->getAllocatedType(), slots[instr.index]);
+        break; case mir::Opcode::SLOT_STORE:
+          builder.CreateStore(operand(0), slots[instr.index]);
+        break; case mir::Opcode::GLOBAL_ADDR:
+          values[id] = global_vars.find(instr.global)->second;
+        break; case mir::Opcode::PTR_LOAD:
+          values[id] = builder.CreateLoad(type_to_llvm(instr.type), operand(0));
+        break; case mir::Opcode::PTR_STORE:
+          builder.CreateStore(operand(1), operand(0));
+        break; case mir::Opcode::CALL:
+        {
+          llvm::SmallVector<PTR<Value>> args;
+          for (auto arg : instr.operands)
+            args.push_back(values[arg]);
+          values[id] = builder.CreateCall(function_map.find(instr.callee)->second, args,
+            instr.type == nullptr ? "" : "call_ret");
+        }
+        break; case mir::Opcode::EMBED:
+          gen_embed(as<PTR<const EmbedExpr>>(instr.expr));
+          values[id] = returned_value;
+        break; case mir::Opcode::BR:
+          builder.CreateBr(blocks[instr.index]);
+        break; case mir::Opcode::COND_BR:
+          builder.CreateCondBr(operand(0), blocks[instr.index], blocks[instr.index_false]);
+        break; case mir::Opcode::RET:
+          if (prof_exit)
+            builder.CreateCall(prof_exit);
+          if (instr.operands.empty())
+            builder.CreateRetVoid();
+          else
+            builder.CreateRet(operand(0));
+        break; case mir::Opcode::UNREACHABLE:
+          builder.CreateUnreachable();
+        break; default:
+          colt_unreachable("Invalid MIR opcode!");
+        }
+      }
+    }
+  }
+
   void LLVMIRGenerator::gen_fn_ret(PTR<const lang::FnReturnExpr> ptr) noexcept
   {
     if (ptr->get_value() != nullptr) //null means return void
     {
       gen_ir(ptr->get_value());
-      returned_value = builder.CreateRet(returned_value);
+      PTR<Value> to_ret = returned_value;
+      //The returned value is part of the time spent in the function
+      if (prof_exit)
+        builder.CreateCall(prof_exit);
+      returned_value = builder.CreateRet(to_ret);
     }
     else
+    {
+      if (prof_exit)
+        builder.CreateCall(prof_exit);
       returned_value = builder.CreateRetVoid();
+    }
   }
 
   void LLVMIRGenerator::gen_fn_call(PTR<const lang::FnCallExpr> ptr) noexcept
@@ -616,10 +1343,22 @@ namespace colt::gen
     auto value = returned_value;
     gen_ir(ptr->get_where());
     auto store = builder.CreateStore(value, returned_value);
-    returned_value = builder.CreateLoad(returned_value->getType(),
+    returned_value = builder.CreateLoad(value->getType(),
       store->getPointerOperand());
   }
 
+  PTR<llvm::AllocaInst> LLVMIRGenerator::create_entry_alloca(PTR<llvm::Type> type, const llvm::Twine& name) noexcept
+  {
+    assert_true(current_fn, "Allocations can only happen inside a function!");
+    //Insert after the allocations already present
+    BasicBlock& entry = current_fn->getEntryBlock();
+    auto where = entry.begin();
+    while (where != entry.end() && isa<AllocaInst>(*where))
+      ++where;
+    IRBuilder<> entry_builder(&entry, where);
+    return entry_builder.CreateAlloca(type, nullptr, name);
+  }
+
   PTR<llvm::Type> LLVMIRGenerator::type_to_llvm(PTR<const lang::Type> type) noexcept
   {
     using namespace lang;
@@ -11,6 +11,8 @@
 #include <llvm/ADT/STLExtras.h>
 #include <llvm/IR/BasicBlock.h>
 #include <llvm/IR/Constants.h>
+#include <llvm/IR/DIBuilder.h>
+#include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/IRBuilder.h>
@@ -30,7 +32,9 @@
 #include <util/colt_pch.h>
 #include <type/colt_type.h>
 #include <ast/colt_ast.h>
+#include <mir/colt_mir.h>
 #include <code_gen/mangle.h>
+#include <interpreter/colt_host_fn.h>
 
 /// @brief Contains classes responsible of producing code from the Colt AST
 namespace colt::gen
@@ -40,6 +44,26 @@ namespace colt::gen
 	/// @return The converted StringRef
 	llvm::StringRef ToStringRef(colt::StringView view) noexcept;
 
+	/// @brief The stack usage of a function (see GeneratedIR::stack_usage)
+	struct FnStackUsage
+	{
+		/// @brief The demangled name of the function
+		std::string name;
+		/// @brief The size of the stack frame of the function, in bytes (excluding the return address)
+		u64 frame_size;
+		/// @brief The worst-case stack usage of the function and its callees, in bytes.
+		///        For recursive functions, this is the usage of a single recursion.
+		u64 worst_case;
+		/// @brief True if the function, or one of its callees, is (mutually) recursive:
+		///        its usage is then unbounded
+		bool is_recursive;
+		/// @brief True if the function (or one of its callees) calls an extern function,
+		///        or calls indirectly: the usage of such calls is not known
+		bool calls_unknown;
+		/// @brief True if the function is 'main', or is not called by other functions of the module
+		bool is_entry;
+	};
+
 	/// @brief Represents valid LLVM IR
 	struct GeneratedIR
 	{
@@ -49,6 +73,9 @@ namespace colt::gen
 		std::unique_ptr<llvm::Module> module = std::make_unique<llvm::Module>("Colt", *context);
 		/// @brief The target machine for which the IR was generated
 		PTR<llvm::TargetMachine> target_machine;
+		/// @brief Maps debug locations (see DebugLocationKey) to the expression from which
+		///        they were generated. Only allocated when optimization remarks are requested.
+		std::unique_ptr<Map<u64, lang::SourceCodeExprInfo>> debug_locations = nullptr;
 
 	public:
 		/// @brief Prints the generated IR
@@ -60,16 +87,53 @@ namespace colt::gen
 		/// @return True if no errors, or a const char* representing the error
 		Expected<bool, const char*> to_object_file(const char* path) noexcept;
 
-		/// @brief Optimizes the generated IR
+		/// @brief Optimizes the generated IR.
+		/// If '--remarks' or '--remarks-file' were specified, the optimization
+		/// remarks are printed or written to the remarks file.
 		/// @param level The optimization level
 		void optimize(colt::gen::OptimizationLevel level) noexcept;
+
+		/// @brief Places functions at the beginning of the module, in order, and marks them hot.
+		/// Hot functions are emitted in '.text.hot' sections, which linkers place together
+		/// before the rest of the code.
+		/// @param order The functions to place (see ReadFunctionOrder)
+		/// @return The number of functions placed
+		size_t order_functions(const std::vector<std::string>& order) noexcept;
+
+		/// @brief Writes the size of the machine code of each function, biggest first.
+		/// A copy of the module is compiled in memory, whose symbols are measured.
+		/// @param report The file in which to write the report
+		/// @return True if no errors, or a const char* representing the error
+		Expected<bool, const char*> write_size_report(std::FILE* report) noexcept;
+
+		/// @brief Computes the worst-case stack usage of each function, biggest first.
+		/// The frame sizes are reported by the backend while compiling a copy of the module,
+		/// and the worst case of a function is its frame plus the worst case of its callees.
+		/// @return The stack usage of the functions defined in the module, or a const char* representing the error
+		Expected<std::vector<FnStackUsage>, const char*> stack_usage() noexcept;
 	};	
 
+	/// @brief Writes the stack usage of functions
+	/// @param report The file in which to write the report
+	/// @param usages The stack usage of the functions (see GeneratedIR::stack_usage)
+	void WriteStackUsage(std::FILE* report, const std::vector<FnStackUsage>& usages) noexcept;
+
+	/// @brief Returns the key of a debug location in GeneratedIR::debug_locations
+	/// @param line The line of the location
+	/// @param column The column of the location
+	/// @return The key of the location
+	constexpr u64 DebugLocationKey(u32 line, u32 column) noexcept
+	{
+		return (as<u64>(line) << 32) | column;
+	}
+
 	/// @brief Generates the LLVM corresponding to a valid AST
 	/// @param ast The AST from which to generate IR
+	/// @param host_functions If not nullptr, the attributes of the registered functions are added to their extern declarations
 	/// @param target_triple The target for which to generate IR
 	/// @return IR or std::string representing the error (related to targets)
-	Expected<GeneratedIR, std::string> GenerateIR(const lang::AST& ast, const std::string& target_triple = LLVM_DEFAULT_TARGET_TRIPLE) noexcept;
+	Expected<GeneratedIR, std::string> GenerateIR(const lang::AST& ast, PTR<const HostFnRegistry> host_functions = nullptr,
+		const std::string& target_triple = LLVM_DEFAULT_TARGET_TRIPLE) noexcept;
 
 	/// @brief Class responsible of generating LLVM IR
 	class LLVMIRGenerator
@@ -94,6 +158,20 @@ namespace colt::gen
 		PTR<llvm::Function> current_fn = nullptr;
 		/// @brief Current loop begin block (used for continue)
 		PTR<llvm::BasicBlock> loop_begin = nullptr;
+		/// @brief Maps debug locations to expressions, or nullptr if no debug locations are needed
+		PTR<Map<u64, lang::SourceCodeExprInfo>> debug_locations;
+		/// @brief The helper for generating debug informations (only used if debug_locations is not null)
+		std::unique_ptr<llvm::DIBuilder> di_builder = nullptr;
+		/// @brief The file from which the AST was generated
+		PTR<llvm::DIFile> di_file = nullptr;
+		/// @brief '_ColtProfEnter', called on entry of functions if '--instrument-functions' was specified
+		llvm::FunctionCallee prof_enter = {};
+		/// @brief '_ColtProfExit', called before functions return if '--instrument-functions' was specified
+		llvm::FunctionCallee prof_exit = {};
+		/// @brief The context of the AST (in which to create the types of host functions)
+		lang::COLTContext& colt_ctx;
+		/// @brief The functions of the host whose attributes to add to extern declarations, or nullptr
+		PTR<const HostFnRegistry> host_functions;
 
 	public:
 		/// @brief No default constructor
@@ -107,29 +185,74 @@ namespace colt::gen
 		/// @param ast The AST to compile to IR
 		/// @param ctx The LLVMContext in which to store resulting informations
 		/// @param mod The module in which to write the IR
-		LLVMIRGenerator(const lang::AST& ast, llvm::LLVMContext& ctx, llvm::Module& mod) noexcept;
+		/// @param debug_locations If not null, debug locations are emitted and stored in it
+		/// @param host_functions If not null, the functions of the host whose attributes to add to extern declarations
+		LLVMIRGenerator(const lang::AST& ast, llvm::LLVMContext& ctx, llvm::Module& mod,
+			PTR<Map<u64, lang::SourceCodeExprInfo>> debug_locations = nullptr,
+			PTR<const HostFnRegistry> host_functions = nullptr) noexcept;
 
 	private:
 		/// @brief Generates IR for any expression by calling the
 		///        corresponding function.
 		void gen_ir(PTR<const lang::Expr> ptr) noexcept;
 
+		/// @brief Sets the debug location of the next instructions to the location
+		///        of an expression, if debug locations are needed.
+		/// @param ptr The expression whose location to use
+		void set_debug_location(PTR<const lang::Expr> ptr) noexcept;
+
 		/// @brief Generates IR for literal expressions
 		/// @param ptr The expression for which to generate the IR
 		void gen_literal(PTR<const lang::LiteralExpr> ptr) noexcept;
 
+		/// @brief Generates a constant
+		/// @param value The value of the constant
+		/// @param type The type of the constant
+		/// @return The constant
+		PTR<llvm::Value> gen_constant(QWORD value, PTR<const lang::BuiltInType> type) noexcept;
+
 		/// @brief Generates IR for unary expressions
 		/// @param ptr The expression for which to generate the IR
 		void gen_unary(PTR<const lang::UnaryExpr> ptr) noexcept;
 
+		/// @brief Generates IR for a unary operation (other than OP_ADDRESSOF)
+		/// @param op The operator
+		/// @param child The operand
+		/// @return The result of the operation
+		PTR<llvm::Value> gen_unary_op(lang::UnaryOperator op, PTR<llvm::Value> child) noexcept;
+
 		/// @brief Generates IR for binary expressions
 		/// @param ptr The expression for which to generate the IR
 		void gen_binary(PTR<const lang::BinaryExpr> ptr) noexcept;
 
+		/// @brief Generates IR for '&&' and '||', which only evaluate
+		///        their right hand side if the left hand side does not decide the result
+		/// @param ptr The expression for which to generate the IR
+		void gen_short_circuit(PTR<const lang::BinaryExpr> ptr) noexcept;
+
+		/// @brief Generates IR for a binary operation
+		/// @param op The operator
+		/// @param expr_t The type of the result
+		/// @param type_t The type of the operands
+		/// @param lhs The left hand side
+		/// @param rhs The right hand side
+		/// @return The result of the operation
+		PTR<llvm::Value> gen_binary_op(lang::BinaryOperator op, PTR<const lang::BuiltInType> expr_t,
+			PTR<const lang::BuiltInType> type_t, PTR<llvm::Value> lhs, PTR<llvm::Value> rhs) noexcept;
+
 		/// @brief Generates IR for conversion expressions
 		/// @param ptr The expression for which to generate the IR 
 		void gen_convert(PTR<const lang::ConvertExpr> ptr) noexcept;
 
+		/// @brief Generates IR for a conversion
+		/// @param cnv The kind of conversion
+		/// @param expr_t The type to convert to
+		/// @param child_t The type of the value to convert
+		/// @param value The value to convert
+		/// @return The converted value
+		PTR<llvm::Value> gen_conversion(lang::ConvertExpr::ConversionType cnv, PTR<const lang::BuiltInType> expr_t,
+			PTR<const lang::BuiltInType> child_t, PTR<llvm::Value> value) noexcept;
+
 		/// @brief Generates IR for variable declaration
 		/// @param ptr The expression for which to generate the IR
 		void gen_var_decl(PTR<const lang::VarDeclExpr> ptr) noexcept;
@@ -146,6 +269,19 @@ namespace colt::gen
 		/// @param ptr The expression for which to generate the IR
 		void gen_fn_def(PTR<const lang::FnDefExpr> ptr) noexcept;
 
+		/// @brief Generates IR for the (optimized) MIR of the body of the current function
+		/// @param mir_fn The MIR of the function
+		void gen_mir(const mir::Function& mir_fn) noexcept;
+
+		/// @brief Generates IR for embedded files
+		/// @param ptr The expression for which to generate the IR
+		void gen_embed(PTR<const lang::EmbedExpr> ptr) noexcept;
+
+		/// @brief Adds the attributes of a host function to its extern declaration
+		/// @param decl The extern declaration
+		/// @param fn The LLVM function of the declaration
+		void add_host_attributes(PTR<const lang::FnDeclExpr> decl, PTR<llvm::Function> fn) noexcept;
+
 		/// @brief Generates IR for function returns
 		/// @param ptr The expression for which to generate the IR
 		void gen_fn_ret(PTR<const lang::FnReturnExpr> ptr) noexcept;
@@ -171,6 +307,14 @@ namespace colt::gen
 		void gen_ptr_store(PTR<const lang::PtrStoreExpr> ptr) noexcept;
 		
 
+		/// @brief Creates a stack allocation in the entry block of the current function.
+		/// This ensures allocations in loops do not grow the stack on each iteration,
+		/// and that they can be promoted to registers.
+		/// @param type The type to allocate
+		/// @param name The name of the allocation
+		/// @return The allocation
+		PTR<llvm::AllocaInst> create_entry_alloca(PTR<llvm::Type> type, const llvm::Twine& name = "") noexcept;
+
 		/// @brief Converts a Colt type to an LLVM type
 		/// @param type The type to convert
 		/// @return Converted type
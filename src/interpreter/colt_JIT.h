@@ -16,6 +16,11 @@
 #include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
 #include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
 #include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/ExecutionEngine/JITEventListener.h>
+#include <llvm/Object/SymbolSize.h>
+#include <llvm/Object/ELFObjectFile.h>
+#include <llvm/Support/DynamicLibrary.h>
+#include <llvm/ADT/DenseSet.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <llvm/IR/DataLayout.h>
 #include <llvm/IR/LLVMContext.h>
@@ -25,22 +30,95 @@
 #include <llvm/Transforms/Scalar/GVN.h>
 #include <llvm/Support/TargetSelect.h>
 #include <memory>
+#include <type_traits>
 #include <code_gen/llvm_ir_gen.h>
+#include <code_gen/mangle.h>
+#include <interpreter/colt_sampler.h>
+#include <interpreter/colt_jit_memory.h>
+#include <interpreter/colt_host_fn.h>
 
 namespace colt::gen
 {
+  /// @brief Registers the functions emitted by the JIT (including lazily compiled ones) to a SamplingProfiler
+  class SamplerSymbolListener
+    : public llvm::JITEventListener
+  {
+    /// @brief The profiler to which to add the symbols
+    SamplingProfiler& profiler;
+
+  public:
+    /// @brief Constructor
+    /// @param profiler The profiler to which to add the symbols
+    SamplerSymbolListener(SamplingProfiler& profiler) noexcept
+      : profiler(profiler) {}
+
+    /// @brief Adds the functions of an object file that was loaded
+    /// @param key The key of the object (unused)
+    /// @param obj The object that was loaded
+    /// @param info Informations about where the object was loaded
+    void notifyObjectLoaded(ObjectKey key, const llvm::object::ObjectFile& obj,
+      const llvm::RuntimeDyld::LoadedObjectInfo& info) override
+    {
+      //The debug object has its sections at their load addresses
+      auto debug_obj = info.getObjectForDebug(obj);
+      const llvm::object::ObjectFile& loaded = debug_obj.getBinary() ? *debug_obj.getBinary() : obj;
+      for (const auto& [symbol, size] : llvm::object::computeSymbolSizes(loaded))
+      {
+        auto type = symbol.getType();
+        auto name = symbol.getName();
+        auto address = symbol.getAddress();
+        if (!type || !name || !address)
+        {
+          llvm::consumeError(type.takeError());
+          llvm::consumeError(name.takeError());
+          llvm::consumeError(address.takeError());
+          continue;
+        }
+        if (*type != llvm::object::SymbolRef::ST_Function)
+          continue;
+        auto demangled = demangle(StringView{ name->data(), name->size() });
+        StringView view = demangled;
+        profiler.add_symbol(static_cast<std::uintptr_t>(*address), static_cast<size_t>(size),
+          std::string{ view.get_data(), view.get_size() });
+      }
+    }
+  };
+
   /// @brief An LLVM JIT interpreter
   class ColtJIT
   {
-    /// @brief Pointer to the JIT
+    /// @brief The memory of the emitted code if using huge pages, or nullptr
+    std::unique_ptr<HugePageArena> arena;
+    /// @brief The listener registering symbols to a profiler, or nullptr
+    std::unique_ptr<SamplerSymbolListener> listener;
+    /// @brief Pointer to the JIT (destroyed before the listener and the arena)
     std::unique_ptr<llvm::orc::LLLazyJIT> JIT;
+    /// @brief The symbols defined by 'addHostFunctions' and 'addLibrary'
+    llvm::DenseSet<llvm::orc::SymbolStringPtr> defined_symbols;
+
+    /// @brief Creates the definition of an absolute symbol (whose type depends on the version of LLVM)
+    /// @tparam Def The type of the definition
+    /// @param address The address of the symbol
+    /// @param flags The flags of the symbol
+    /// @return The definition
+    template<typename Def = llvm::orc::SymbolMap::mapped_type>
+    static Def MakeAbsoluteSymbol(llvm::JITTargetAddress address, llvm::JITSymbolFlags flags) noexcept
+    {
+      if constexpr (std::is_constructible_v<Def, llvm::orc::ExecutorAddr, llvm::JITSymbolFlags>)
+        return Def(llvm::orc::ExecutorAddr(address), flags);
+      else
+        return Def(address, flags);
+    }
 
   public:
     ColtJIT() = delete;
     /// @brief Constructor
     /// @param JIT The JIT to store
-    ColtJIT(std::unique_ptr<llvm::orc::LLLazyJIT> JIT) noexcept
-      : JIT(std::move(JIT)) {}
+    /// @param listener The listener registered to the JIT, or nullptr
+    /// @param arena The arena from which the JIT allocates, or nullptr
+    ColtJIT(std::unique_ptr<llvm::orc::LLLazyJIT> JIT, std::unique_ptr<SamplerSymbolListener> listener = nullptr,
+      std::unique_ptr<HugePageArena> arena = nullptr) noexcept
+      : arena(std::move(arena)), listener(std::move(listener)), JIT(std::move(JIT)) {}
 
     /// @brief Adds generated IR to compile
     /// @param IR The IR to compile
@@ -52,6 +130,79 @@ namespace colt::gen
       return llvm::Error::success();
     }
 
+    /// @brief Defines the functions of a registry as absolute symbols, so that
+    ///        calls to them are resolved without searching the process.
+    /// Symbols already defined (by a previous registry or library) are not overridden.
+    /// @param registry The registry whose functions to define
+    /// @return success if no error are encountered
+    llvm::Error addHostFunctions(const HostFnRegistry& registry) noexcept
+    {
+      using namespace llvm;
+
+      orc::SymbolMap symbols;
+      for (const auto& function : registry.get_functions())
+      {
+        auto interned = JIT->mangleAndIntern(function.name);
+        if (!defined_symbols.insert(interned).second)
+          continue;
+        symbols[interned] = MakeAbsoluteSymbol(pointerToJITTargetAddress(function.address),
+          JITSymbolFlags::Exported | JITSymbolFlags::Callable);
+      }
+      if (symbols.empty())
+        return Error::success();
+      return JIT->getMainJITDylib().define(orc::absoluteSymbols(std::move(symbols)));
+    }
+
+    /// @brief Loads a shared library, whose symbols can then be used by the generated code.
+    /// The exported symbols of ELF libraries are resolved once, and defined in the main JITDylib.
+    /// Symbols already defined (by a previous library) are not overridden.
+    /// @param path The path of the library
+    /// @return success if no error are encountered
+    llvm::Error addLibrary(const char* path) noexcept
+    {
+      using namespace llvm;
+
+      std::string error;
+      //Permanent libraries are also searched by the generator of the process
+      auto library = sys::DynamicLibrary::getPermanentLibrary(path, &error);
+      if (!library.isValid())
+        return make_error<StringError>(error, inconvertibleErrorCode());
+
+      auto binary = object::ObjectFile::createObjectFile(path);
+      if (!binary)
+        return binary.takeError();
+      auto elf = dyn_cast<object::ELFObjectFileBase>(binary->getBinary());
+      if (elf == nullptr) //Other formats are resolved on lookup
+        return Error::success();
+
+      auto& main_dylib = JIT->getMainJITDylib();
+      orc::SymbolMap symbols;
+      for (const auto& symbol : elf->getDynamicSymbolIterators())
+      {
+        auto flags = symbol.getFlags();
+        auto name = symbol.getName();
+        if (!flags || !name)
+        {
+          consumeError(flags.takeError());
+          consumeError(name.takeError());
+          continue;
+        }
+        if ((*flags & object::SymbolRef::SF_Undefined) || !(*flags & object::SymbolRef::SF_Global) || name->empty())
+          continue;
+        auto interned = JIT->mangleAndIntern(*name);
+        if (defined_symbols.count(interned) != 0)
+          continue;
+        if (void* address = library.getAddressOfSymbol(name->str().c_str()))
+        {
+          defined_symbols.insert(interned);
+          symbols[interned] = MakeAbsoluteSymbol(pointerToJITTargetAddress(address), JITSymbolFlags::Exported);
+        }
+      }
+      if (symbols.empty())
+        return Error::success();
+      return main_dylib.define(orc::absoluteSymbols(std::move(symbols)));
+    }
+
     /// @brief Lookups a symbol in the generated code
     /// @param str The name of the symbol
     /// @return The symbol if found or error
@@ -61,12 +212,47 @@ namespace colt::gen
     }
 
     /// @brief Creates an instance of the JIT
+    /// @param profiler If not nullptr, the profiler to which to add the emitted functions
+    /// @param arena If not nullptr, the arena from which to allocate the emitted code (see '--jit-huge-pages')
     /// @return A JIT if no error was generated
-    static llvm::Expected<std::unique_ptr<ColtJIT>> Create() noexcept
+    static llvm::Expected<std::unique_ptr<ColtJIT>> Create(SamplingProfiler* profiler = nullptr,
+      std::unique_ptr<HugePageArena> arena = nullptr) noexcept
     {
       using namespace llvm;
 
-      auto JIT = orc::LLLazyJITBuilder().create();
+      orc::LLLazyJITBuilder builder;
+      std::unique_ptr<SamplerSymbolListener> listener;
+      if (profiler != nullptr)
+        listener = std::make_unique<SamplerSymbolListener>(*profiler);
+      if (arena != nullptr && arena->get_hot_count() != 0)
+      {
+        //Each function is emitted in its own section, to place hot functions apart
+        auto JTMB = orc::JITTargetMachineBuilder::detectHost();
+        if (!JTMB)
+          return JTMB.takeError();
+        JTMB->getOptions().FunctionSections = true;
+        builder.setJITTargetMachineBuilder(std::move(*JTMB));
+      }
+      if (listener != nullptr || arena != nullptr)
+      {
+        //Only RuntimeDyld notifies event listeners
+        builder.setObjectLinkingLayerCreator(
+          [listener = listener.get(), arena = arena.get()](orc::ExecutionSession& ES, const Triple&)
+            -> llvm::Expected<std::unique_ptr<orc::ObjectLayer>>
+          {
+            auto layer = std::make_unique<orc::RTDyldObjectLinkingLayer>(ES,
+              [arena]() -> std::unique_ptr<RuntimeDyld::MemoryManager>
+              {
+                if (arena != nullptr)
+                  return std::make_unique<HugePageMemoryManager>(*arena);
+                return std::make_unique<SectionMemoryManager>();
+              });
+            if (listener != nullptr)
+              layer->registerJITEventListener(*listener);
+            return std::move(layer);
+          });
+      }
+      auto JIT = builder.create();
       if (!JIT)
         return JIT.takeError();
       const DataLayout& DL = (*JIT)->getDataLayout();
@@ -75,7 +261,7 @@ namespace colt::gen
         return DLSG.takeError();
       (*JIT)->getMainJITDylib().addGenerator(std::move(*DLSG));
 
-      return std::make_unique<ColtJIT>(std::move(*JIT));
+      return std::make_unique<ColtJIT>(std::move(*JIT), std::move(listener), std::move(arena));
     }
   };
 }
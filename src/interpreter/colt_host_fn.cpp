@@ -0,0 +1,88 @@
+/** @file colt_host_fn.cpp
+* Contains definition of functions declared in 'colt_host_fn.h'.
+*/
+
+#include "colt_host_fn.h"
+#include "ast/colt_context.h"
+
+namespace colt::gen
+{
+  namespace
+  {
+    /// @brief Returns the name of a type, without its top-level 'mut'.
+    /// The constness of parameters passed by value does not change the signature.
+    /// @param type The type whose name to return
+    /// @return The name of the type
+    StringView GetUnqualifiedName(PTR<const lang::Type> type) noexcept
+    {
+      StringView name = type->get_name();
+      if (name.begins_with("mut "))
+        name = StringView{ name.get_data() + 4, name.get_size() - 4 };
+      return name;
+    }
+  }
+
+  bool HostFn::matches(PTR<const lang::FnType> decl, lang::COLTContext& ctx) const noexcept
+  {
+    auto type = as<PTR<const lang::FnType>>(make_type(ctx));
+    if (type->is_varargs() != decl->is_varargs()
+      || type->get_params_type().get_size() != decl->get_params_type().get_size()
+      || GetUnqualifiedName(type->get_return_type()) != GetUnqualifiedName(decl->get_return_type()))
+      return false;
+    for (size_t i = 0; i < type->get_params_type().get_size(); i++)
+    {
+      if (GetUnqualifiedName(type->get_params_type()[i]) != GetUnqualifiedName(decl->get_params_type()[i]))
+        return false;
+    }
+    return true;
+  }
+
+  void HostFnRegistry::add(std::string name, void* address,
+    PTR<const lang::Type>(*make_type)(lang::COLTContext&) noexcept, u8 attributes) noexcept
+  {
+    for (auto& function : functions)
+    {
+      if (function.name == name)
+      {
+        function = { std::move(name), address, make_type, attributes };
+        return;
+      }
+    }
+    functions.push_back({ std::move(name), address, make_type, attributes });
+  }
+
+  const HostFn* HostFnRegistry::find(StringView name) const noexcept
+  {
+    for (const auto& function : functions)
+    {
+      if (StringView{ function.name.data(), function.name.size() } == name)
+        return &function;
+    }
+    return nullptr;
+  }
+
+  std::string HostFnRegistry::get_declarations(lang::COLTContext& ctx) const noexcept
+  {
+    std::string result;
+    for (const auto& function : functions)
+    {
+      auto type = as<PTR<const lang::FnType>>(function.make_type(ctx));
+      result += "extern fn ";
+      result += function.name;
+      result += '(';
+      for (size_t i = 0; i < type->get_params_type().get_size(); i++)
+      {
+        if (i != 0)
+          result += ", ";
+        StringView param = GetUnqualifiedName(type->get_params_type()[i]);
+        result.append(param.get_data(), param.get_size());
+        result += " a" + std::to_string(i);
+      }
+      StringView ret = GetUnqualifiedName(type->get_return_type());
+      result += ")->";
+      result.append(ret.get_data(), ret.get_size());
+      result += ";\n";
+    }
+    return result;
+  }
+}
@@ -0,0 +1,102 @@
+/** @file colt_host_fn.h
+* Contains the registry of host functions callable by the code run through the JIT.
+* The Colt signature of a host function is derived from its C++ signature
+* (see 'from_cpp_equivalent'), so that the declarations can be generated.
+* The JIT defines the registered functions as absolute symbols (see
+* 'ColtJIT::addHostFunctions'): calls do not search the process for them.
+* The attributes of a host function are added to its extern declaration
+* (see 'GenerateIR'), so that the optimizer can reason about the calls.
+*/
+
+#ifndef HG_COLT_HOST_FN
+#define HG_COLT_HOST_FN
+
+#include <string>
+#include <vector>
+
+#include <util/colt_pch.h>
+#include <type/colt_type.h>
+
+namespace colt::gen
+{
+	/// @brief The attributes of a host function
+	enum HostFnAttribute
+		: u8
+	{
+		/// @brief No attributes: the function may unwind and access any memory
+		HOST_FN_NONE = 0,
+		/// @brief The function does not throw exceptions
+		HOST_FN_NOUNWIND = 1,
+		/// @brief The function only reads memory
+		HOST_FN_READONLY = 2,
+		/// @brief The function does not access memory and always returns:
+		///        its result only depends on its arguments
+		HOST_FN_PURE = 4,
+	};
+
+	/// @brief A function of the host callable by Colt code
+	struct HostFn
+	{
+		/// @brief The name of the function (its symbol, as declared in Colt)
+		std::string name;
+		/// @brief The address of the function
+		void* address;
+		/// @brief Creates the Colt type of the function
+		PTR<const lang::Type>(*make_type)(lang::COLTContext&) noexcept;
+		/// @brief The attributes of the function (HostFnAttribute)
+		u8 attributes;
+
+		/// @brief Check if an extern declaration matches the signature of the function
+		/// @param decl The declaration whose name is 'name'
+		/// @param ctx The context in which to create the type of the function
+		/// @return True if the parameters and return types match (ignoring their constness)
+		bool matches(PTR<const lang::FnType> decl, lang::COLTContext& ctx) const noexcept;
+	};
+
+	/// @brief Registry of the functions of the host
+	class HostFnRegistry
+	{
+		/// @brief The registered functions, in order of registration
+		std::vector<HostFn> functions{};
+
+	public:
+		/// @brief Registers a function.
+		/// The Colt signature is derived from 'Ret(Args...)' using 'from_cpp_equivalent'.
+		/// @tparam Ret The return type of the function
+		/// @tparam ...Args The types of the parameters of the function
+		/// @param name The name through which the function is declared in Colt
+		/// @param fn The function
+		/// @param attributes The attributes of the function (HostFnAttribute)
+		template<typename Ret, typename... Args>
+		void add(std::string name, Ret(*fn)(Args...), u8 attributes = HOST_FN_NOUNWIND) noexcept
+		{
+			add(std::move(name), reinterpret_cast<void*>(fn),
+				&lang::from_cpp_equivalent<Ret(*)(Args...)>, attributes);
+		}
+
+		/// @brief Registers a function whose Colt type is already known.
+		/// Registering a function twice overrides the previous registration.
+		/// @param name The name through which the function is declared in Colt
+		/// @param address The address of the function
+		/// @param make_type Creates the Colt type of the function
+		/// @param attributes The attributes of the function (HostFnAttribute)
+		void add(std::string name, void* address,
+			PTR<const lang::Type>(*make_type)(lang::COLTContext&) noexcept, u8 attributes) noexcept;
+
+		/// @brief Searches for a registered function
+		/// @param name The name of the function
+		/// @return The function, or nullptr if not registered
+		const HostFn* find(StringView name) const noexcept;
+
+		/// @brief Returns all the registered functions
+		/// @return The functions, in order of registration
+		const std::vector<HostFn>& get_functions() const noexcept { return functions; }
+
+		/// @brief Generates the Colt extern declarations of all the registered functions
+		/// @param ctx The context in which to create the types of the functions
+		/// @return Source code declaring the functions (one per line)
+		std::string get_declarations(lang::COLTContext& ctx) const noexcept;
+	};
+}
+
+#endif //!HG_COLT_HOST_FN
@@ -0,0 +1,206 @@
+/** @file colt_jit_memory.cpp
+* Contains definition of functions declared in 'colt_jit_memory.h'.
+*/
+
+#include "colt_jit_memory.h"
+
+#ifndef COLT_NO_LLVM
+
+#include <algorithm>
+
+#include <llvm/Support/Memory.h>
+#include <llvm/Support/Process.h>
+#include <code_gen/mangle.h>
+#include <code_gen/function_order.h>
+
+#ifdef __linux__
+  #include <sys/mman.h>
+  /// @brief Defined if transparent huge pages are supported
+  #define COLT_HUGE_PAGES_SUPPORTED
+#endif
+
+namespace colt::gen
+{
+  HugePageArena::~HugePageArena() noexcept
+  {
+#ifdef COLT_HUGE_PAGES_SUPPORTED
+    for (auto& region : mappings)
+      munmap(region.begin, region.size);
+#endif
+  }
+
+  std::unique_ptr<HugePageArena> HugePageArena::Create(const char* hot_profile, std::string& error) noexcept
+  {
+#ifdef COLT_HUGE_PAGES_SUPPORTED
+    auto arena = std::unique_ptr<HugePageArena>(new HugePageArena());
+    if (hot_profile != nullptr && !arena->load_hot_functions(hot_profile))
+    {
+      error = fmt::format("Could not read the profile '{}'!", hot_profile);
+      return nullptr;
+    }
+    //Executable memory may be forbidden (SELinux 'execmem'...)
+    void* probe = mmap(nullptr, 1, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (probe == MAP_FAILED)
+    {
+      error = "Could not map executable memory!";
+      return nullptr;
+    }
+    munmap(probe, 1);
+    std::scoped_lock lock{ arena->mutex };
+    if (!arena->map_region(MEMORY_CODE, HugePageSize))
+    {
+      error = "Could not map memory!";
+      return nullptr;
+    }
+    return arena;
+#else
+    error = "Huge pages are only supported on Linux!";
+    return nullptr;
+#endif
+  }
+
+  bool HugePageArena::map_region(MemoryKind kind, size_t min_size) noexcept
+  {
+#ifdef COLT_HUGE_PAGES_SUPPORTED
+    size_t size = (min_size + HugePageSize - 1) & ~(HugePageSize - 1);
+    //Code and read-only data are protected once written (see 'finalizeMemory')
+    int protection = PROT_READ | PROT_WRITE;
+
+    //Read-write data does not benefit from being aligned
+    size_t mapped_size = kind == MEMORY_READ_WRITE ? size : size + HugePageSize;
+    void* ptr = mmap(nullptr, mapped_size, protection, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED)
+      return false;
+    auto begin = static_cast<u8*>(ptr);
+    if (kind != MEMORY_READ_WRITE)
+    {
+      //Unmap the memory before and after the aligned region
+      auto aligned = reinterpret_cast<u8*>((reinterpret_cast<uintptr_t>(begin) + HugePageSize - 1) & ~(HugePageSize - 1));
+      if (aligned != begin)
+        munmap(begin, as<size_t>(aligned - begin));
+      if (size_t after = mapped_size - as<size_t>(aligned - begin) - size; after != 0)
+        munmap(aligned + size, after);
+      begin = aligned;
+      //Only a hint: the kernel falls back to 4KB pages if THP are disabled
+      madvise(begin, size, MADV_HUGEPAGE);
+    }
+    regions[kind] = { begin, size, 0 };
+    mappings.push_back(regions[kind]);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  u8* HugePageArena::allocate(MemoryKind kind, size_t size, size_t alignment) noexcept
+  {
+    std::scoped_lock lock{ mutex };
+    alignment = std::max<size_t>(alignment, 16);
+    Region* region = &regions[kind];
+    size_t offset = (region->used + alignment - 1) & ~(alignment - 1);
+    if (region->begin == nullptr || offset + size > region->size)
+    {
+      //The rest of the current region is lost, as regions are not contiguous
+      if (!map_region(kind, size + alignment))
+        return nullptr;
+      region = &regions[kind];
+      offset = 0;
+    }
+    region->used = offset + size;
+    return region->begin + offset;
+  }
+
+  bool HugePageArena::is_hot(llvm::StringRef mangled_name) const noexcept
+  {
+    if (hot_functions.empty())
+      return false;
+    auto demangled = demangle(StringView{ mangled_name.data(), mangled_name.size() });
+    StringView view = demangled;
+    return hot_functions.count(std::string{ view.get_data(), view.get_size() }) != 0;
+  }
+
+  bool HugePageArena::load_hot_functions(const char* path) noexcept
+  {
+    std::vector<std::pair<std::string, u64>> weights;
+    if (!ReadSelfWeights(path, weights))
+      return false;
+    u64 total = 0;
+    for (const auto& [name, count] : weights)
+      total += count;
+    //The functions accounting for 90% of the self weight are hot
+    u64 cumulated = 0;
+    for (auto& [name, count] : weights)
+    {
+      if (count == 0 || cumulated * 10 >= total * 9)
+        break;
+      cumulated += count;
+      hot_functions.insert(std::move(name));
+    }
+    return true;
+  }
+
+  u8* HugePageMemoryManager::allocateCodeSection(uintptr_t size, unsigned alignment, unsigned section_id,
+    llvm::StringRef section_name)
+  {
+    //With function sections, the code of 'FN' is in '.text.FN'
+    bool hot = section_name.consume_front(".text.") && arena.is_hot(section_name);
+    return allocate_owned(hot ? HugePageArena::MEMORY_HOT_CODE : HugePageArena::MEMORY_CODE, size, alignment);
+  }
+
+  u8* HugePageMemoryManager::allocateDataSection(uintptr_t size, unsigned alignment, unsigned section_id,
+    llvm::StringRef section_name, bool is_read_only)
+  {
+    if (is_read_only)
+      return allocate_owned(HugePageArena::MEMORY_READ_ONLY, size, alignment);
+    //Read-write data is never protected, so it can share pages with other objects
+    return arena.allocate(HugePageArena::MEMORY_READ_WRITE, size, alignment);
+  }
+
+  u8* HugePageMemoryManager::allocate_owned(HugePageArena::MemoryKind kind, size_t size, size_t alignment) noexcept
+  {
+    alignment = std::max<size_t>(alignment, 16);
+    //Search for the last pages of that kind
+    auto chunk = std::find_if(chunks.rbegin(), chunks.rend(), [=](const Chunk& chunk) { return chunk.kind == kind; });
+    if (chunk != chunks.rend())
+    {
+      size_t offset = (chunk->used + alignment - 1) & ~(alignment - 1);
+      if (offset + size <= chunk->size)
+      {
+        chunk->used = offset + size;
+        return chunk->begin + offset;
+      }
+    }
+    //The pages are not shared with other objects, whose memory may still be
+    //written when this object is finalized
+    size_t page_size = llvm::sys::Process::getPageSizeEstimate();
+    size_t pages_size = (std::max<size_t>(size, 1) + page_size - 1) & ~(page_size - 1);
+    u8* begin = arena.allocate(kind, pages_size, std::max(alignment, page_size));
+    if (begin == nullptr)
+      return nullptr;
+    chunks.push_back({ kind, begin, pages_size, size });
+    return begin;
+  }
+
+  bool HugePageMemoryManager::finalizeMemory(std::string* error)
+  {
+    using llvm::sys::Memory;
+    for (const auto& chunk : chunks)
+    {
+      bool is_code = chunk.kind != HugePageArena::MEMORY_READ_ONLY;
+      unsigned flags = is_code ? Memory::MF_READ | Memory::MF_EXEC : Memory::MF_READ;
+      if (auto err = Memory::protectMappedMemory(llvm::sys::MemoryBlock(chunk.begin, chunk.size), flags))
+      {
+        if (error != nullptr)
+          *error = err.message();
+        return true;
+      }
+      if (is_code)
+        Memory::InvalidateInstructionCache(chunk.begin, chunk.size);
+    }
+    //The protected pages cannot be written anymore
+    chunks.clear();
+    return false;
+  }
+}
+
+#endif //!COLT_NO_LLVM
@@ -0,0 +1,189 @@
+/** @file colt_jit_memory.h
+* Contains the huge page memory manager of the JIT ('--jit-huge-pages').
+* The default memory manager maps new pages for each object emitted by the
+* JIT, which scatters the code of lazily compiled functions across 4KB pages.
+* The HugePageArena instead carves code and read-only data out of 2MB aligned
+* regions backed by transparent huge pages, so that the code of a program
+* only needs a few iTLB entries.
+* Regions are mapped read-write: each object emitted by the JIT owns whole pages,
+* which are made read-execute (code) or read-only (data) once the object is
+* finalized, so that no page is both writable and executable. Changing the
+* protection of part of a huge page splits its mapping: the pages of code stay
+* contiguous in physical memory, but then need one iTLB entry per 4KB page.
+* Functions listed as hot by a profile are packed in their own region.
+* Huge pages are only supported on Linux.
+*/
+
+#ifndef HG_COLT_JIT_MEMORY
+#define HG_COLT_JIT_MEMORY
+
+#ifndef COLT_NO_LLVM
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <llvm/ExecutionEngine/RTDyldMemoryManager.h>
+
+#include <util/colt_pch.h>
+
+namespace colt::gen
+{
+	/// @brief Owns the memory of the code emitted by a JIT
+	class HugePageArena
+	{
+	public:
+		/// @brief The kind of memory to allocate
+		enum MemoryKind
+			: u8
+		{
+			/// @brief Code of hot functions (executable once finalized)
+			MEMORY_HOT_CODE,
+			/// @brief Code (executable once finalized)
+			MEMORY_CODE,
+			/// @brief Read-only data (read-only once finalized)
+			MEMORY_READ_ONLY,
+			/// @brief Read-write data (not backed by huge pages)
+			MEMORY_READ_WRITE,
+			/// @brief The number of kinds of memory
+			MEMORY_KIND_COUNT
+		};
+
+		/// @brief The size of a huge page
+		static constexpr size_t HugePageSize = size_t{ 2 } << 20;
+
+	private:
+		/// @brief A region from which memory is carved
+		struct Region
+		{
+			/// @brief The beginning of the region
+			u8* begin = nullptr;
+			/// @brief The size of the region
+			size_t size = 0;
+			/// @brief The number of bytes used
+			size_t used = 0;
+		};
+
+		/// @brief Protects all the members
+		std::mutex mutex{};
+		/// @brief The current region of each kind of memory
+		Region regions[MEMORY_KIND_COUNT]{};
+		/// @brief All the mapped regions (unmapped on destruction)
+		std::vector<Region> mappings{};
+		/// @brief The (demangled) names of the hot functions
+		std::unordered_set<std::string> hot_functions{};
+
+		/// @brief Constructs an empty arena (see Create)
+		HugePageArena() noexcept = default;
+
+	public:
+		HugePageArena(const HugePageArena&) = delete;
+		HugePageArena& operator=(const HugePageArena&) = delete;
+		/// @brief Unmaps all the regions
+		~HugePageArena() noexcept;
+
+		/// @brief Creates an arena
+		/// @param hot_profile If not nullptr, the folded stacks file whose hottest functions
+		///                    (accounting for 90% of the self samples) are packed together
+		/// @param error The string in which to write the error
+		/// @return The arena, or nullptr if huge pages are not supported (or executable memory cannot be mapped)
+		static std::unique_ptr<HugePageArena> Create(const char* hot_profile, std::string& error) noexcept;
+
+		/// @brief Allocates memory
+		/// @param kind The kind of memory
+		/// @param size The size of the allocation
+		/// @param alignment The alignment of the allocation
+		/// @return The memory, or nullptr if out of memory
+		u8* allocate(MemoryKind kind, size_t size, size_t alignment) noexcept;
+
+		/// @brief Check if a function is hot
+		/// @param mangled_name The mangled name of the function
+		/// @return True if the function was listed as hot by the profile
+		bool is_hot(llvm::StringRef mangled_name) const noexcept;
+
+		/// @brief Returns the number of functions listed as hot
+		/// @return The number of hot functions
+		size_t get_hot_count() const noexcept { return hot_functions.size(); }
+
+	private:
+		/// @brief Maps a new region (the lock must be held)
+		/// @param kind The kind of memory of the region
+		/// @param min_size The minimum size of the region
+		/// @return False if the region could not be mapped
+		bool map_region(MemoryKind kind, size_t min_size) noexcept;
+
+		/// @brief Reads the hot functions of a folded stacks file
+		/// @param path The path of the file
+		/// @return False if the file could not be read
+		bool load_hot_functions(const char* path) noexcept;
+	};
+
+	/// @brief Memory manager of a single object emitted by the JIT, allocating from a HugePageArena
+	class HugePageMemoryManager
+		: public llvm::RTDyldMemoryManager
+	{
+		/// @brief Pages owned by the object, from which its sections are carved
+		struct Chunk
+		{
+			/// @brief The kind of memory of the pages
+			HugePageArena::MemoryKind kind;
+			/// @brief The beginning of the pages
+			u8* begin;
+			/// @brief The size of the pages
+			size_t size;
+			/// @brief The number of bytes used
+			size_t used;
+		};
+
+		/// @brief The arena from which to allocate
+		HugePageArena& arena;
+		/// @brief The pages of code and read-only data of the object (protected when finalized)
+		std::vector<Chunk> chunks{};
+
+	public:
+		/// @brief Constructor
+		/// @param arena The arena from which to allocate (which must outlive the object)
+		HugePageMemoryManager(HugePageArena& arena) noexcept
+			: arena(arena) {}
+
+		/// @brief Allocates a code section (hot functions are identified through function sections)
+		/// @param size The size of the section
+		/// @param alignment The alignment of the section
+		/// @param section_id The ID of the section
+		/// @param section_name The name of the section ('.text.<FUNCTION>')
+		/// @return The memory of the section
+		u8* allocateCodeSection(uintptr_t size, unsigned alignment, unsigned section_id,
+			llvm::StringRef section_name) override;
+
+		/// @brief Allocates a data section
+		/// @param size The size of the section
+		/// @param alignment The alignment of the section
+		/// @param section_id The ID of the section
+		/// @param section_name The name of the section
+		/// @param is_read_only True if the section is read-only
+		/// @return The memory of the section
+		u8* allocateDataSection(uintptr_t size, unsigned alignment, unsigned section_id,
+			llvm::StringRef section_name, bool is_read_only) override;
+
+		/// @brief Makes the code read-execute (invalidating the instruction cache),
+		///        and the read-only data read-only
+		/// @param error The string in which to write the error
+		/// @return True if the memory could not be protected
+		bool finalizeMemory(std::string* error = nullptr) override;
+
+	private:
+		/// @brief Allocates memory from pages owned by the object
+		/// @param kind The kind of memory (code or read-only data)
+		/// @param size The size of the allocation
+		/// @param alignment The alignment of the allocation
+		/// @return The memory, or nullptr if out of memory
+		u8* allocate_owned(HugePageArena::MemoryKind kind, size_t size, size_t alignment) noexcept;
+	};
+}
+
+#endif //!COLT_NO_LLVM
+
+#endif //!HG_COLT_JIT_MEMORY
@@ -0,0 +1,281 @@
+/** @file colt_sampler.cpp
+* Contains definition of functions declared in 'colt_sampler.h'.
+*/
+
+#include "colt_sampler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <map>
+#include <unordered_map>
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+  #include <cerrno>
+  #include <csignal>
+  #include <ctime>
+  #include <pthread.h>
+  #include <sys/syscall.h>
+  #include <ucontext.h>
+  #include <unistd.h>
+  /// @brief Defined if sampling is supported
+  #define COLT_SAMPLER_SUPPORTED
+
+  #ifndef sigev_notify_thread_id
+    /// @brief The thread to which SIGEV_THREAD_ID signals are sent (not exposed by older glibc)
+    #define sigev_notify_thread_id _sigev_un._tid
+  #endif
+#endif
+
+namespace colt::gen
+{
+#ifdef COLT_SAMPLER_SUPPORTED
+  namespace
+  {
+    /// @brief Returns the CPU time of the current thread
+    /// @return The CPU time in nanoseconds
+    u64 GetThreadCPUTime() noexcept
+    {
+      struct timespec time;
+      clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+      return static_cast<u64>(time.tv_sec) * 1'000'000'000ULL + static_cast<u64>(time.tv_nsec);
+    }
+
+    /// @brief The profiler that is sampling (read by the signal handler)
+    std::atomic<SamplingProfiler*> active_profiler = nullptr;
+    /// @brief The timer sending SIGPROF
+    timer_t sample_timer;
+    /// @brief The action of SIGPROF before sampling
+    struct sigaction previous_action;
+  }
+#endif
+
+  bool SamplingProfiler::is_supported() noexcept
+  {
+#ifdef COLT_SAMPLER_SUPPORTED
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  void SamplingProfiler::add_symbol(std::uintptr_t address, size_t size, std::string name) noexcept
+  {
+    std::scoped_lock lock{ symbols_mutex };
+    symbols.push_back({ address, address + std::max<size_t>(size, 1), std::move(name) });
+  }
+
+  const char* SamplingProfiler::start(u32 hz) noexcept
+  {
+#ifdef COLT_SAMPLER_SUPPORTED
+    if (running)
+      return "The profiler is already sampling!";
+    if (hz == 0)
+      return "The sampling frequency must not be 0!";
+
+    //The signal handler may only read the stack of the sampled thread
+    pthread_attr_t attributes;
+    if (pthread_getattr_np(pthread_self(), &attributes) != 0)
+      return "Could not query the stack of the current thread!";
+    void* stack_addr;
+    size_t stack_size;
+    pthread_attr_getstack(&attributes, &stack_addr, &stack_size);
+    pthread_attr_destroy(&attributes);
+    stack_low = reinterpret_cast<std::uintptr_t>(stack_addr);
+    stack_high = stack_low + stack_size;
+
+    //The handler cannot allocate: the buffer is allocated upfront
+    samples.resize(size_t{ 1 } << 21);
+    samples_size = 0;
+    dropped = 0;
+    frequency = hz;
+
+    SamplingProfiler* expected = nullptr;
+    if (!active_profiler.compare_exchange_strong(expected, this))
+      return "Another profiler is already sampling!";
+
+    struct sigaction action = {};
+    action.sa_sigaction = [](int signal, siginfo_t* info, void* context) { on_signal(signal, info, context); };
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, &previous_action) != 0)
+    {
+      active_profiler = nullptr;
+      return "Could not install the SIGPROF handler!";
+    }
+
+    //Measuring the CPU time of the thread only samples it while it is running
+    struct sigevent event = {};
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGPROF;
+    event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+    if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &sample_timer) != 0)
+    {
+      sigaction(SIGPROF, &previous_action, nullptr);
+      active_profiler = nullptr;
+      return "Could not create the sampling timer!";
+    }
+    struct itimerspec interval = {};
+    interval.it_interval.tv_sec = 1 / hz;
+    interval.it_interval.tv_nsec = static_cast<long>((1'000'000'000ULL / hz) % 1'000'000'000ULL);
+    interval.it_value = interval.it_interval;
+    timer_settime(sample_timer, 0, &interval, nullptr);
+
+    cpu_time = GetThreadCPUTime();
+    running = true;
+    return nullptr;
+#else
+    return "Sampling is only supported on Linux (x86-64 and AArch64)!";
+#endif
+  }
+
+  void SamplingProfiler::stop() noexcept
+  {
+#ifdef COLT_SAMPLER_SUPPORTED
+    if (!running)
+      return;
+    timer_delete(sample_timer);
+    cpu_time = GetThreadCPUTime() - cpu_time;
+    sigaction(SIGPROF, &previous_action, nullptr);
+    active_profiler = nullptr;
+    //Samples written by the handler are visible to the (same) thread
+    std::atomic_signal_fence(std::memory_order_acquire);
+    running = false;
+#endif
+  }
+
+  void SamplingProfiler::on_signal(int signal, void* info, void* context) noexcept
+  {
+#ifdef COLT_SAMPLER_SUPPORTED
+    SamplingProfiler* profiler = active_profiler.load(std::memory_order_relaxed);
+    if (profiler == nullptr)
+      return;
+    int saved_errno = errno;
+
+    auto& machine = static_cast<ucontext_t*>(context)->uc_mcontext;
+  #if defined(__x86_64__)
+    auto pc = static_cast<std::uintptr_t>(machine.gregs[REG_RIP]);
+    auto fp = static_cast<std::uintptr_t>(machine.gregs[REG_RBP]);
+    auto sp = static_cast<std::uintptr_t>(machine.gregs[REG_RSP]);
+  #else
+    auto pc = static_cast<std::uintptr_t>(machine.pc);
+    auto fp = static_cast<std::uintptr_t>(machine.regs[29]);
+    auto sp = static_cast<std::uintptr_t>(machine.sp);
+  #endif
+
+    std::uintptr_t frames[MaxDepth];
+    size_t depth = 0;
+    frames[depth++] = pc;
+    //Each frame starts with the frame pointer of the caller followed by the return address.
+    //Code without frame pointers can leave anything in the register: only the stack is read.
+    while (depth < MaxDepth && fp >= sp && fp % sizeof(std::uintptr_t) == 0
+      && fp + 2 * sizeof(std::uintptr_t) <= profiler->stack_high)
+    {
+      auto frame = reinterpret_cast<const std::uintptr_t*>(fp);
+      if (frame[1] == 0)
+        break;
+      //Return addresses are past the call: point to the call instead
+      frames[depth++] = frame[1] - 1;
+      if (frame[0] <= fp)
+        break;
+      fp = frame[0];
+    }
+
+    if (profiler->samples_size + depth + 1 > profiler->samples.size())
+      ++profiler->dropped;
+    else
+    {
+      std::uintptr_t* to = profiler->samples.data() + profiler->samples_size;
+      to[0] = depth;
+      std::copy(frames, frames + depth, to + 1);
+      profiler->samples_size += depth + 1;
+    }
+    std::atomic_signal_fence(std::memory_order_release);
+    errno = saved_errno;
+#endif
+  }
+
+  const char* SamplingProfiler::resolve(std::uintptr_t address) const noexcept
+  {
+    auto it = std::upper_bound(symbols.begin(), symbols.end(), address,
+      [](std::uintptr_t address, const Symbol& symbol) { return address < symbol.begin; });
+    if (it == symbols.begin() || address >= std::prev(it)->end)
+      return nullptr;
+    return std::prev(it)->name.c_str();
+  }
+
+  void SamplingProfiler::write_profile(std::FILE* report, std::FILE* folded, size_t top) noexcept
+  {
+    std::scoped_lock lock{ symbols_mutex };
+    std::sort(symbols.begin(), symbols.end(),
+      [](const Symbol& a, const Symbol& b) { return a.begin < b.begin; });
+
+    /// @brief The samples of a function
+    struct FunctionSamples
+    {
+      /// @brief The samples in which the function is the leaf
+      size_t self = 0;
+      /// @brief The samples in which the function appears (recursion counted once)
+      size_t total = 0;
+    };
+    std::unordered_map<std::string_view, FunctionSamples> functions;
+    std::map<std::string, size_t> stacks;
+    size_t sample_count = 0;
+
+    std::vector<std::string_view> names;
+    std::string path;
+    for (size_t i = 0; i < samples_size; i += samples[i] + 1)
+    {
+      ++sample_count;
+      //Consecutive frames outside of the JIT are merged into a single '[native]'
+      names.clear();
+      for (size_t j = 0; j < samples[i]; j++)
+      {
+        const char* name = resolve(samples[i + 1 + j]);
+        std::string_view frame = name != nullptr ? name : "[native]";
+        if (names.empty() || frame != "[native]" || names.back() != "[native]")
+          names.push_back(frame);
+      }
+      //Frames below 'main' belong to the compiler
+      if (auto it = std::find(names.begin(), names.end(), "main"); it != names.end())
+        names.erase(it + 1, names.end());
+
+      functions[names.front()].self += 1;
+      for (size_t j = 0; j < names.size(); j++)
+        if (std::find(names.begin() + j + 1, names.end(), names[j]) == names.end())
+          functions[names[j]].total += 1;
+
+      path.clear();
+      for (auto it = names.rbegin(); it != names.rend(); ++it)
+      {
+        if (!path.empty())
+          path += ';';
+        path += *it;
+      }
+      stacks[path] += 1;
+    }
+
+    std::vector<std::pair<std::string_view, FunctionSamples>> sorted{ functions.begin(), functions.end() };
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b)
+      { return a.second.self > b.second.self || (a.second.self == b.second.self && a.first < b.first); });
+
+    auto percent = [=](size_t count) { return sample_count == 0 ? 0.0 : 100.0 * static_cast<double>(count) / static_cast<double>(sample_count); };
+    //The kernel may deliver the signals at a lower frequency than requested (its tick rate)
+    std::fprintf(report, "Colt sampling profile: %zu samples in %.3f s of CPU time (%" PRIu32 " Hz requested)",
+      sample_count, static_cast<double>(cpu_time) / 1e9, frequency);
+    if (dropped != 0)
+      std::fprintf(report, ", %zu samples dropped", dropped);
+    std::fprintf(report, "\n\n%12s %8s %12s %8s  %s\n", "Self", "Self %", "Total", "Total %", "Function");
+    for (size_t i = 0; i < sorted.size() && i < top; i++)
+    {
+      const auto& [name, count] = sorted[i];
+      std::fprintf(report, "%12zu %7.2f%% %12zu %7.2f%%  %.*s\n", count.self, percent(count.self),
+        count.total, percent(count.total), static_cast<int>(name.size()), name.data());
+    }
+    if (sorted.size() > top)
+      std::fprintf(report, "... %zu more functions\n", sorted.size() - top);
+
+    for (const auto& [stack, count] : stacks)
+      std::fprintf(folded, "%s %zu\n", stack.c_str(), count);
+  }
+}
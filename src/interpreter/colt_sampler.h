@@ -0,0 +1,108 @@
+/** @file colt_sampler.h
+* Contains the sampling profiler of programs run through the JIT ('--profile').
+* The running thread is interrupted by a SIGPROF timer (measuring the CPU time
+* of the thread), and the signal handler walks the frame pointers of the
+* interrupted code, so that no external tool or privilege is needed.
+* Addresses are resolved when writing the profile, against the symbols of the
+* code emitted by the JIT (see 'ColtJIT').
+* Sampling is only supported on Linux (x86-64 and AArch64).
+*/
+
+#ifndef HG_COLT_SAMPLER
+#define HG_COLT_SAMPLER
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <util/colt_pch.h>
+
+namespace colt::gen
+{
+	/// @brief Samples the call stacks of the thread that started it
+	class SamplingProfiler
+	{
+		/// @brief A function emitted by the JIT
+		struct Symbol
+		{
+			/// @brief The address of the first byte of the function
+			std::uintptr_t begin;
+			/// @brief The address past the last byte of the function
+			std::uintptr_t end;
+			/// @brief The (demangled) name of the function
+			std::string name;
+		};
+
+		/// @brief Protects 'symbols' (which may be added by any thread compiling code)
+		std::mutex symbols_mutex{};
+		/// @brief The functions emitted by the JIT
+		std::vector<Symbol> symbols{};
+		/// @brief The samples, each stored as its depth followed by its return addresses (leaf first)
+		std::vector<std::uintptr_t> samples{};
+		/// @brief The number of words of 'samples' written by the signal handler
+		size_t samples_size = 0;
+		/// @brief The number of samples dropped as 'samples' was full
+		size_t dropped = 0;
+		/// @brief The lowest and highest addresses of the stack of the sampled thread
+		std::uintptr_t stack_low = 0, stack_high = 0;
+		/// @brief The requested frequency of the samples
+		u32 frequency = 0;
+		/// @brief The CPU time of the sampled thread when sampling started, then the
+		///        CPU time spent while sampling (in nanoseconds)
+		u64 cpu_time = 0;
+		/// @brief True while sampling
+		bool running = false;
+
+	public:
+		/// @brief The maximum number of frames of a sample
+		static constexpr size_t MaxDepth = 128;
+
+		/// @brief Constructs a profiler (which is not yet sampling)
+		SamplingProfiler() noexcept = default;
+		SamplingProfiler(const SamplingProfiler&) = delete;
+		SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+		/// @brief Stops sampling if needed
+		~SamplingProfiler() noexcept { stop(); }
+
+		/// @brief Check if sampling is supported on the current platform
+		/// @return True if supported
+		static bool is_supported() noexcept;
+
+		/// @brief Registers a function emitted by the JIT
+		/// @param address The address of the function
+		/// @param size The size of the function
+		/// @param name The (demangled) name of the function
+		void add_symbol(std::uintptr_t address, size_t size, std::string name) noexcept;
+
+		/// @brief Starts sampling the current thread.
+		/// Only one profiler may be sampling at a time.
+		/// @param hz The frequency of the samples (in CPU time of the thread)
+		/// @return nullptr on success, or the reason of the failure
+		const char* start(u32 hz) noexcept;
+
+		/// @brief Stops sampling (must be called by the sampled thread)
+		void stop() noexcept;
+
+		/// @brief Writes the profile (sampling must be stopped)
+		/// @param report The file in which to write the functions sorted by self samples
+		/// @param folded The file in which to write the folded stacks (in samples)
+		/// @param top The maximum number of functions written to 'report'
+		void write_profile(std::FILE* report, std::FILE* folded, size_t top) noexcept;
+
+	private:
+		/// @brief The signal handler recording samples
+		/// @param signal The signal
+		/// @param info The informations about the signal
+		/// @param context The 'ucontext_t' of the interrupted code
+		static void on_signal(int signal, void* info, void* context) noexcept;
+
+		/// @brief Resolves an address to the name of its function
+		/// @param address The address (symbols must be sorted)
+		/// @return The name of the function, or nullptr for code not emitted by the JIT
+		const char* resolve(std::uintptr_t address) const noexcept;
+	};
+}
+
+#endif //!HG_COLT_SAMPLER
@@ -0,0 +1,419 @@
+/** @file colt_json.cpp
+* Contains definition of functions declared in 'colt_json.h'.
+*/
+
+#include "colt_json.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+
+namespace colt::lsp
+{
+  namespace
+  {
+    /// @brief Recursive descent JSON parser
+    class JSONParser
+    {
+      /// @brief The text being parsed
+      std::string_view text;
+      /// @brief The current offset in the text
+      size_t offset = 0;
+      /// @brief The current nesting depth (to avoid overflowing the stack)
+      u32 depth = 0;
+      /// @brief The error, or nullptr if no errors were found
+      const char* error = nullptr;
+
+    public:
+      /// @brief Constructs a parser over a text
+      /// @param text The text to parse
+      JSONParser(std::string_view text) noexcept
+        : text(text) {}
+
+      /// @brief Parses the whole text as a single value
+      /// @param value The value in which to write the result
+      /// @return nullptr if no errors, or the error
+      const char* parse_document(JSONValue& value) noexcept
+      {
+        parse_value(value);
+        skip_spaces();
+        if (error == nullptr && offset != text.size())
+          error = "Unexpected characters after JSON value!";
+        return error;
+      }
+
+    private:
+      /// @brief Skips whitespaces
+      void skip_spaces() noexcept
+      {
+        while (offset < text.size()
+          && (text[offset] == ' ' || text[offset] == '\t' || text[offset] == '\n' || text[offset] == '\r'))
+          ++offset;
+      }
+
+      /// @brief Consumes a keyword if it is the next text
+      /// @param keyword The keyword to consume
+      /// @return True if consumed
+      bool consume(std::string_view keyword) noexcept
+      {
+        if (text.substr(offset, keyword.size()) != keyword)
+          return false;
+        offset += keyword.size();
+        return true;
+      }
+
+      /// @brief Parses any value
+      /// @param value The value in which to write the result
+      void parse_value(JSONValue& value) noexcept
+      {
+        skip_spaces();
+        if (offset == text.size())
+        {
+          error = "Unexpected end of JSON!";
+          return;
+        }
+        switch (text[offset])
+        {
+        break; case '{':
+          parse_object(value);
+        break; case '[':
+          parse_array(value);
+        break; case '"':
+          value.kind = JSONValue::JSON_STRING;
+          parse_string(value.string);
+        break; case 't':
+        case 'f':
+          value.kind = JSONValue::JSON_BOOL;
+          value.boolean = text[offset] == 't';
+          if (!consume(value.boolean ? "true" : "false"))
+            error = "Invalid JSON keyword!";
+        break; case 'n':
+          value.kind = JSONValue::JSON_NULL;
+          if (!consume("null"))
+            error = "Invalid JSON keyword!";
+        break; default:
+          parse_number(value);
+        }
+      }
+
+      /// @brief Parses an object
+      /// @param value The value in which to write the result
+      void parse_object(JSONValue& value) noexcept
+      {
+        if (++depth > 256)
+        {
+          error = "JSON is nested too deeply!";
+          return;
+        }
+        ON_EXIT{ --depth; };
+
+        value.kind = JSONValue::JSON_OBJECT;
+        ++offset; //consume '{'
+        skip_spaces();
+        if (consume("}"))
+          return;
+        while (error == nullptr)
+        {
+          skip_spaces();
+          auto& member = value.object.emplace_back();
+          if (offset == text.size() || text[offset] != '"')
+          {
+            error = "Expected a member name!";
+            return;
+          }
+          parse_string(member.first);
+          skip_spaces();
+          if (!consume(":"))
+          {
+            error = "Expected a ':'!";
+            return;
+          }
+          parse_value(member.second);
+          skip_spaces();
+          if (consume("}"))
+            return;
+          if (error == nullptr && !consume(","))
+            error = "Expected a ',' or '}'!";
+        }
+      }
+
+      /// @brief Parses an array
+      /// @param value The value in which to write the result
+      void parse_array(JSONValue& value) noexcept
+      {
+        if (++depth > 256)
+        {
+          error = "JSON is nested too deeply!";
+          return;
+        }
+        ON_EXIT{ --depth; };
+
+        value.kind = JSONValue::JSON_ARRAY;
+        ++offset; //consume '['
+        skip_spaces();
+        if (consume("]"))
+          return;
+        while (error == nullptr)
+        {
+          parse_value(value.array.emplace_back());
+          skip_spaces();
+          if (consume("]"))
+            return;
+          if (error == nullptr && !consume(","))
+            error = "Expected a ',' or ']'!";
+        }
+      }
+
+      /// @brief Parses 4 hexadecimal digits
+      /// @return The value, or a value greater than 0x10FFFF (not a code point) on errors
+      u32 parse_hex4() noexcept
+      {
+        if (text.size() - offset < 4)
+          return 0x110000;
+        u32 result = 0;
+        for (size_t i = 0; i < 4; i++)
+        {
+          char chr = text[offset++];
+          result <<= 4;
+          if ('0' <= chr && chr <= '9')
+            result |= chr - '0';
+          else if ('a' <= chr && chr <= 'f')
+            result |= chr - 'a' + 10;
+          else if ('A' <= chr && chr <= 'F')
+            result |= chr - 'A' + 10;
+          else
+            return 0x110000;
+        }
+        return result;
+      }
+
+      /// @brief Appends a code point encoded as UTF-8
+      /// @param code The code point
+      /// @param to The string in which to write
+      static void append_utf8(u32 code, std::string& to) noexcept
+      {
+        if (code < 0x80)
+          to += as<char>(code);
+        else if (code < 0x800)
+        {
+          to += as<char>(0xC0 | (code >> 6));
+          to += as<char>(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+          to += as<char>(0xE0 | (code >> 12));
+          to += as<char>(0x80 | ((code >> 6) & 0x3F));
+          to += as<char>(0x80 | (code & 0x3F));
+        }
+        else
+        {
+          to += as<char>(0xF0 | (code >> 18));
+          to += as<char>(0x80 | ((code >> 12) & 0x3F));
+          to += as<char>(0x80 | ((code >> 6) & 0x3F));
+          to += as<char>(0x80 | (code & 0x3F));
+        }
+      }
+
+      /// @brief Parses a string
+      /// @param to The string in which to write the result
+      void parse_string(std::string& to) noexcept
+      {
+        ++offset; //consume '"'
+        for (;;)
+        {
+          //Copy runs of characters that do not need unescaping
+          size_t end = text.find_first_of("\"\\", offset);
+          if (end == std::string_view::npos)
+          {
+            error = "Unterminated JSON string!";
+            return;
+          }
+          to.append(text.data() + offset, end - offset);
+          offset = end + 1;
+          if (text[end] == '"')
+            return;
+
+          if (offset == text.size())
+          {
+            error = "Unterminated JSON string!";
+            return;
+          }
+          switch (text[offset++])
+          {
+          break; case '"':
+            to += '"';
+          break; case '\\':
+            to += '\\';
+          break; case '/':
+            to += '/';
+          break; case 'b':
+            to += '\b';
+          break; case 'f':
+            to += '\f';
+          break; case 'n':
+            to += '\n';
+          break; case 'r':
+            to += '\r';
+          break; case 't':
+            to += '\t';
+          break; case 'u':
+          {
+            u32 code = parse_hex4();
+            //Surrogate pairs encode code points over 0xFFFF
+            if (0xD800 <= code && code <= 0xDBFF && consume("\\u"))
+            {
+              u32 low = parse_hex4();
+              if (0xDC00 <= low && low <= 0xDFFF)
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+              else
+                code = 0x110000; //invalid
+            }
+            //Surrogates that are not part of a pair cannot be encoded as UTF-8
+            if (code > 0x10FFFF || (0xD800 <= code && code <= 0xDFFF))
+            {
+              error = "Invalid unicode escape sequence!";
+              return;
+            }
+            append_utf8(code, to);
+          }
+          break; default:
+            error = "Invalid escape sequence!";
+            return;
+          }
+        }
+      }
+
+      /// @brief Parses a number
+      /// @param value The value in which to write the result
+      void parse_number(JSONValue& value) noexcept
+      {
+        size_t end = offset;
+        while (end < text.size() && std::string_view{ "+-0123456789.eE" }.find(text[end]) != std::string_view::npos)
+          ++end;
+        if (end == offset)
+        {
+          error = "Unexpected character in JSON!";
+          return;
+        }
+        //strtod needs a NUL-terminated string
+        std::string number{ text.data() + offset, end - offset };
+        char* parsed_end;
+        value.kind = JSONValue::JSON_NUMBER;
+        value.number = std::strtod(number.c_str(), &parsed_end);
+        if (parsed_end != number.c_str() + number.size())
+          error = "Invalid JSON number!";
+        offset = end;
+      }
+    };
+  }
+
+  const JSONValue* JSONValue::find(std::string_view key) const noexcept
+  {
+    if (kind != JSON_OBJECT)
+      return nullptr;
+    for (auto& [name, member] : object)
+      if (name == key)
+        return &member;
+    return nullptr;
+  }
+
+  const JSONValue* JSONValue::find_path(std::initializer_list<std::string_view> keys) const noexcept
+  {
+    const JSONValue* current = this;
+    for (auto key : keys)
+    {
+      current = current->find(key);
+      if (current == nullptr)
+        return nullptr;
+    }
+    return current;
+  }
+
+  std::string_view JSONValue::get_string(std::string_view key) const noexcept
+  {
+    if (auto member = find(key); member != nullptr && member->kind == JSON_STRING)
+      return member->string;
+    return {};
+  }
+
+  i64 JSONValue::get_integer(std::string_view key, i64 default_v) const noexcept
+  {
+    if (auto member = find(key); member != nullptr && member->kind == JSON_NUMBER)
+      return as<i64>(member->number);
+    return default_v;
+  }
+
+  Expected<JSONValue, const char*> ParseJSON(std::string_view text) noexcept
+  {
+    JSONValue value;
+    if (auto error = JSONParser{ text }.parse_document(value); error != nullptr)
+      return { Error, error };
+    return { InPlace, std::move(value) };
+  }
+
+  void WriteJSONString(std::string_view str, std::string& to) noexcept
+  {
+    to += '"';
+    for (char chr : str)
+    {
+      switch (chr)
+      {
+      break; case '"':
+        to += "\\\"";
+      break; case '\\':
+        to += "\\\\";
+      break; case '\n':
+        to += "\\n";
+      break; case '\r':
+        to += "\\r";
+      break; case '\t':
+        to += "\\t";
+      break; default:
+        if (as<u8>(chr) < 0x20)
+          fmt::format_to(std::back_inserter(to), "\\u{:04x}", as<u32>(chr));
+        else
+          to += chr;
+      }
+    }
+    to += '"';
+  }
+
+  void WriteJSON(const JSONValue& value, std::string& to) noexcept
+  {
+    switch (value.kind)
+    {
+    break; case JSONValue::JSON_NULL:
+      to += "null";
+    break; case JSONValue::JSON_BOOL:
+      to += value.boolean ? "true" : "false";
+    break; case JSONValue::JSON_NUMBER:
+      //Integers (such as request IDs) must be written back without exponent
+      if (value.number == std::trunc(value.number) && std::abs(value.number) < 9.0e15)
+        fmt::format_to(std::back_inserter(to), "{}", as<i64>(value.number));
+      else
+        fmt::format_to(std::back_inserter(to), "{}", value.number);
+    break; case JSONValue::JSON_STRING:
+      WriteJSONString(value.string, to);
+    break; case JSONValue::JSON_ARRAY:
+      to += '[';
+      for (size_t i = 0; i < value.array.size(); i++)
+      {
+        if (i != 0)
+          to += ',';
+        WriteJSON(value.array[i], to);
+      }
+      to += ']';
+    break; case JSONValue::JSON_OBJECT:
+      to += '{';
+      for (size_t i = 0; i < value.object.size(); i++)
+      {
+        if (i != 0)
+          to += ',';
+        WriteJSONString(value.object[i].first, to);
+        to += ':';
+        WriteJSON(value.object[i].second, to);
+      }
+      to += '}';
+    }
+  }
+}
@@ -0,0 +1,92 @@
+/** @file colt_json.h
+* Contains a minimal JSON reader and writing helpers, used by the
+* language server to decode requests and encode responses.
+* Responses are written directly as text, so only reading produces a tree.
+*/
+
+#ifndef HG_COLT_JSON
+#define HG_COLT_JSON
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+#include <util/colt_pch.h>
+
+namespace colt::lsp
+{
+	/// @brief A parsed JSON value
+	struct JSONValue
+	{
+		/// @brief The kind of JSON value
+		enum JSONKind
+			: u8
+		{
+			/// @brief null
+			JSON_NULL,
+			/// @brief true or false
+			JSON_BOOL,
+			/// @brief A number (stored as a double)
+			JSON_NUMBER,
+			/// @brief A string (stored as UTF-8)
+			JSON_STRING,
+			/// @brief An array of values
+			JSON_ARRAY,
+			/// @brief An object (members are kept in order)
+			JSON_OBJECT
+		};
+
+		/// @brief The kind of the value
+		JSONKind kind = JSON_NULL;
+		/// @brief The value of a JSON_BOOL
+		bool boolean = false;
+		/// @brief The value of a JSON_NUMBER
+		f64 number = 0.0;
+		/// @brief The value of a JSON_STRING
+		std::string string{};
+		/// @brief The elements of a JSON_ARRAY
+		std::vector<JSONValue> array{};
+		/// @brief The members of a JSON_OBJECT
+		std::vector<std::pair<std::string, JSONValue>> object{};
+
+		/// @brief Returns the member of an object
+		/// @param key The name of the member
+		/// @return Pointer to the member, or nullptr if not an object or not found
+		const JSONValue* find(std::string_view key) const noexcept;
+
+		/// @brief Follows a path of members ("textDocument", "uri")
+		/// @param keys The names of the members to follow
+		/// @return Pointer to the member, or nullptr if any member is not found
+		const JSONValue* find_path(std::initializer_list<std::string_view> keys) const noexcept;
+
+		/// @brief Returns the string of a JSON_STRING member
+		/// @param key The name of the member
+		/// @return The string, or an empty string if not found
+		std::string_view get_string(std::string_view key) const noexcept;
+
+		/// @brief Returns the number of a JSON_NUMBER member
+		/// @param key The name of the member
+		/// @param default_v The value to return if not found
+		/// @return The number converted to i64, or 'default_v' if not found
+		i64 get_integer(std::string_view key, i64 default_v = 0) const noexcept;
+	};
+
+	/// @brief Parses a JSON document
+	/// @param text The text to parse
+	/// @return The parsed value, or a const char* representing the error
+	Expected<JSONValue, const char*> ParseJSON(std::string_view text) noexcept;
+
+	/// @brief Appends a JSON string (with quotes), escaping it as needed
+	/// @param str The UTF-8 string to write
+	/// @param to The string in which to write
+	void WriteJSONString(std::string_view str, std::string& to) noexcept;
+
+	/// @brief Appends a JSON value as text
+	/// @param value The value to write
+	/// @param to The string in which to write
+	void WriteJSON(const JSONValue& value, std::string& to) noexcept;
+}
+
+#endif //!HG_COLT_JSON
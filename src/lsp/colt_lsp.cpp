@@ -0,0 +1,658 @@
+/** @file colt_lsp.cpp
+* Contains definition of functions declared in 'colt_lsp.h'.
+*/
+
+#include "colt_lsp.h"
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#ifdef _WIN32
+  #include <fcntl.h>
+  #include <io.h>
+#endif
+
+namespace colt::lsp
+{
+  namespace
+  {
+    /// @brief JSON-RPC error code of unknown methods
+    constexpr i64 MethodNotFound = -32601;
+    /// @brief JSON-RPC error code of requests that are not valid (sent after 'shutdown')
+    constexpr i64 InvalidRequest = -32600;
+    /// @brief JSON-RPC error code of invalid JSON
+    constexpr i64 ParseError = -32700;
+
+    /// @brief Reads a file
+    /// @param path The path of the file
+    /// @param content The string in which to write the content
+    /// @return True if the file could be read
+    bool ReadFile(const std::string& path, std::string& content) noexcept
+    {
+      std::FILE* file = std::fopen(path.c_str(), "rb");
+      if (file == nullptr)
+        return false;
+      ON_EXIT{ std::fclose(file); };
+
+      content.clear();
+      char buffer[4096];
+      size_t read;
+      while ((read = std::fread(buffer, 1, sizeof(buffer), file)) != 0)
+        content.append(buffer, read);
+      return std::ferror(file) == 0;
+    }
+
+    /// @brief Reads a JSON-RPC message from stdin
+    /// @param content The string in which to write the content of the message
+    /// @return False on end of input
+    bool ReadMessage(std::string& content) noexcept
+    {
+      size_t length = 0;
+      bool has_length = false;
+      //Headers are terminated by an empty line
+      for (;;)
+      {
+        std::string header;
+        int chr;
+        while ((chr = std::getchar()) != EOF && chr != '\n')
+          header += as<char>(chr);
+        if (chr == EOF)
+          return false;
+        if (!header.empty() && header.back() == '\r')
+          header.pop_back();
+        if (header.empty())
+        {
+          if (has_length)
+            break;
+          continue;
+        }
+        constexpr std::string_view ContentLength = "Content-Length:";
+        if (header.compare(0, ContentLength.size(), ContentLength) == 0)
+        {
+          length = std::strtoull(header.c_str() + ContentLength.size(), nullptr, 10);
+          has_length = true;
+        }
+      }
+      content.resize(length);
+      return std::fread(content.data(), 1, length, stdin) == length;
+    }
+
+    /// @brief Writes a range as JSON
+    /// @param location The range to write
+    /// @param to The string in which to write
+    void WriteRange(const SymbolLocation& location, std::string& to) noexcept
+    {
+      fmt::format_to(std::back_inserter(to),
+        R"({{"start":{{"line":{0},"character":{1}}},"end":{{"line":{0},"character":{2}}}}})",
+        location.line, location.column, location.column + location.length);
+    }
+
+    /// @brief Writes a location (URI and range) as JSON
+    /// @param location The location to write
+    /// @param to The string in which to write
+    void WriteLocation(const SymbolLocation& location, std::string& to) noexcept
+    {
+      to += R"({"uri":)";
+      WriteJSONString(PathToURI(location.path), to);
+      to += R"(,"range":)";
+      WriteRange(location, to);
+      to += '}';
+    }
+
+    /// @brief The language server
+    class LanguageServer
+    {
+      /// @brief The kind of work done by the indexer thread
+      enum JobKind
+        : u8
+      {
+        /// @brief Index all the files of the workspace
+        JOB_SCAN_WORKSPACE,
+        /// @brief Index a file from the content sent by the editor
+        JOB_INDEX_CONTENT,
+        /// @brief Index a file from the disk (skipped if the file is open)
+        JOB_INDEX_DISK,
+        /// @brief Remove a file from the index
+        JOB_REMOVE
+      };
+
+      /// @brief Work for the indexer thread
+      struct IndexJob
+      {
+        /// @brief The kind of job
+        JobKind kind;
+        /// @brief The path of the file (or of the workspace)
+        std::string path;
+        /// @brief The content of the file for JOB_INDEX_CONTENT
+        std::string content{};
+        /// @brief True if pushed by the editor (such jobs are run first)
+        bool from_editor = false;
+      };
+
+      /// @brief The index answering requests
+      SymbolIndex index{};
+      /// @brief Protects 'jobs', 'open_files', 'editor_jobs' and 'stop'
+      std::mutex job_mutex{};
+      /// @brief Notified when a job is pushed
+      std::condition_variable job_cv{};
+      /// @brief Notified when all the jobs pushed by the editor are run
+      std::condition_variable editor_cv{};
+      /// @brief The count of jobs pushed by the editor that were not run
+      size_t editor_jobs = 0;
+      /// @brief The jobs of the indexer thread (changes of open files are pushed in front)
+      std::deque<IndexJob> jobs{};
+      /// @brief The files opened in the editor, whose content is not read from the disk
+      std::unordered_set<std::string> open_files{};
+      /// @brief If true, the indexer thread must stop
+      bool stop = false;
+      /// @brief Protects stdout, as the indexer thread sends log messages
+      std::mutex output_mutex{};
+      /// @brief True if 'shutdown' was requested
+      bool shutdown_requested = false;
+      /// @brief The indexer thread
+      std::thread indexer;
+
+    public:
+      /// @brief Starts the indexer thread
+      LanguageServer() noexcept
+        : indexer([this]() { run_indexer(); }) {}
+
+      /// @brief Stops the indexer thread
+      ~LanguageServer() noexcept
+      {
+        {
+          std::scoped_lock lock{ job_mutex };
+          stop = true;
+        }
+        job_cv.notify_one();
+        indexer.join();
+      }
+
+      /// @brief Reads and handles messages until 'exit' or end of input
+      /// @return The exit code of the server
+      int run() noexcept
+      {
+        std::string content;
+        while (ReadMessage(content))
+        {
+          auto message = ParseJSON(content);
+          if (message.is_error())
+          {
+            send_error(JSONValue{}, ParseError, message.get_error());
+            continue;
+          }
+          auto method = message.get_value().get_string("method");
+          if (method == "exit")
+            return shutdown_requested ? 0 : 1;
+          handle(method, message.get_value());
+        }
+        return 1;
+      }
+
+    private:
+      /// @brief Handles a request or notification
+      /// @param method The method of the message
+      /// @param message The message
+      void handle(std::string_view method, const JSONValue& message) noexcept
+      {
+        static const JSONValue Null = {};
+        const JSONValue* id = message.find("id");
+        const JSONValue& params = message.find("params") != nullptr ? *message.find("params") : Null;
+
+        //After 'shutdown', only 'exit' is valid: requests are answered with an error
+        if (shutdown_requested)
+        {
+          if (id != nullptr)
+            send_error(*id, InvalidRequest, "The Colt language server is shutting down!");
+          return;
+        }
+
+        if (method == "initialize")
+          on_initialize(id != nullptr ? *id : Null, params);
+        else if (method == "shutdown")
+        {
+          shutdown_requested = true;
+          send_result(id != nullptr ? *id : Null, "null");
+        }
+        else if (method == "textDocument/didOpen")
+        {
+          auto document = params.find("textDocument");
+          if (document == nullptr)
+            return;
+          push_job({ JOB_INDEX_CONTENT, get_document_path(params), std::string{ document->get_string("text") } }, true);
+        }
+        else if (method == "textDocument/didChange")
+        {
+          //Only full synchronization is supported, so the last change is the whole file
+          auto changes = params.find("contentChanges");
+          if (changes == nullptr || changes->kind != JSONValue::JSON_ARRAY || changes->array.empty())
+            return;
+          push_job({ JOB_INDEX_CONTENT, get_document_path(params), std::string{ changes->array.back().get_string("text") } }, true);
+        }
+        else if (method == "textDocument/didClose")
+        {
+          auto path = get_document_path(params);
+          {
+            std::scoped_lock lock{ job_mutex };
+            open_files.erase(path);
+          }
+          //The file may not have been saved
+          push_job({ JOB_INDEX_DISK, std::move(path) }, true);
+        }
+        else if (method == "workspace/didChangeWatchedFiles")
+        {
+          auto changes = params.find("changes");
+          if (changes == nullptr || changes->kind != JSONValue::JSON_ARRAY)
+            return;
+          for (auto& change : changes->array)
+          {
+            auto path = URIToPath(change.get_string("uri"));
+            //FileChangeType.Deleted is 3
+            push_job({ change.get_integer("type") == 3 ? JOB_REMOVE : JOB_INDEX_DISK, path }, false);
+          }
+        }
+        else if (id == nullptr) //Other notifications ('initialized'...) are ignored
+          return;
+        else if (method == "textDocument/definition")
+        {
+          wait_for_editor_jobs();
+          on_definition(*id, params);
+        }
+        else if (method == "textDocument/references")
+        {
+          wait_for_editor_jobs();
+          on_references(*id, params);
+        }
+        else if (method == "textDocument/hover")
+        {
+          wait_for_editor_jobs();
+          on_hover(*id, params);
+        }
+        else //Unknown requests must be answered
+          send_error(*id, MethodNotFound, "Method not supported by the Colt language server!");
+      }
+
+      /// @brief Handles 'initialize'
+      /// @param id The ID of the request
+      /// @param params The parameters of the request
+      void on_initialize(const JSONValue& id, const JSONValue& params) noexcept
+      {
+        std::string root;
+        if (auto uri = params.get_string("rootUri"); !uri.empty())
+          root = URIToPath(uri);
+        else if (auto path = params.get_string("rootPath"); !path.empty())
+          root = std::filesystem::path(path).lexically_normal().generic_string();
+        if (!root.empty())
+          push_job({ JOB_SCAN_WORKSPACE, std::move(root) }, false);
+
+        send_result(id, fmt::format(R"({{"capabilities":{{)"
+          R"("textDocumentSync":{{"openClose":true,"change":1}},)"
+          R"("definitionProvider":true,"referencesProvider":true,"hoverProvider":true}},)"
+          R"("serverInfo":{{"name":"colt","version":"{}"}}}})", COLT_VERSION_STRING));
+      }
+
+      /// @brief Returns the path of the 'textDocument' of parameters
+      /// @param params The parameters
+      /// @return The path of the document, or an empty string
+      static std::string get_document_path(const JSONValue& params) noexcept
+      {
+        if (auto document = params.find("textDocument"))
+          return URIToPath(document->get_string("uri"));
+        return {};
+      }
+
+      /// @brief Returns the path and position of a 'TextDocumentPositionParams'
+      /// @param params The parameters
+      /// @param line The line in which to write
+      /// @param column The column in which to write
+      /// @return The path of the document
+      static std::string get_position(const JSONValue& params, u32& line, u32& column) noexcept
+      {
+        line = 0;
+        column = 0;
+        if (auto position = params.find("position"))
+        {
+          line = as<u32>(position->get_integer("line"));
+          column = as<u32>(position->get_integer("character"));
+        }
+        return get_document_path(params);
+      }
+
+      /// @brief Handles 'textDocument/definition'
+      /// @param id The ID of the request
+      /// @param params The parameters of the request
+      void on_definition(const JSONValue& id, const JSONValue& params) noexcept
+      {
+        u32 line, column;
+        auto path = get_position(params, line, column);
+        SymbolLocation location;
+        if (!index.find_definition(path, line, column, location))
+          return send_result(id, "null");
+
+        std::string result;
+        WriteLocation(location, result);
+        send_result(id, result);
+      }
+
+      /// @brief Handles 'textDocument/references'
+      /// @param id The ID of the request
+      /// @param params The parameters of the request
+      void on_references(const JSONValue& id, const JSONValue& params) noexcept
+      {
+        u32 line, column;
+        auto path = get_position(params, line, column);
+        bool include_declaration = false;
+        if (auto value = params.find_path({ "context", "includeDeclaration" }); value != nullptr)
+          include_declaration = value->boolean;
+
+        std::string result = "[";
+        auto references = index.find_references(path, line, column, include_declaration);
+        for (size_t i = 0; i < references.size(); i++)
+        {
+          if (i != 0)
+            result += ',';
+          WriteLocation(references[i], result);
+        }
+        result += ']';
+        send_result(id, result);
+      }
+
+      /// @brief Handles 'textDocument/hover'
+      /// @param id The ID of the request
+      /// @param params The parameters of the request
+      void on_hover(const JSONValue& id, const JSONValue& params) noexcept
+      {
+        u32 line, column;
+        auto path = get_position(params, line, column);
+        SymbolHover hover;
+        if (!index.hover(path, line, column, hover))
+          return send_result(id, "null");
+
+        std::string markdown = fmt::format("```colt\n{}\n```", hover.signatures.front());
+        if (hover.signatures.size() > 1)
+        {
+          fmt::format_to(std::back_inserter(markdown), "\n{} other overload{}:\n```colt\n",
+            hover.signatures.size() - 1, hover.signatures.size() == 2 ? "" : "s");
+          for (size_t i = 1; i < hover.signatures.size(); i++)
+          {
+            markdown += hover.signatures[i];
+            markdown += '\n';
+          }
+          markdown += "```";
+        }
+
+        std::string result = R"({"contents":{"kind":"markdown","value":)";
+        WriteJSONString(markdown, result);
+        result += R"(},"range":)";
+        WriteRange(hover.range, result);
+        result += '}';
+        send_result(id, result);
+      }
+
+      /// @brief Sends a JSON-RPC message
+      /// @param content The JSON content of the message
+      void send(const std::string& content) noexcept
+      {
+        std::scoped_lock lock{ output_mutex };
+        std::fprintf(stdout, "Content-Length: %zu\r\n\r\n", content.size());
+        std::fwrite(content.data(), 1, content.size(), stdout);
+        std::fflush(stdout);
+      }
+
+      /// @brief Sends the result of a request
+      /// @param id The ID of the request
+      /// @param result The JSON result
+      void send_result(const JSONValue& id, std::string_view result) noexcept
+      {
+        std::string content = R"({"jsonrpc":"2.0","id":)";
+        WriteJSON(id, content);
+        content += R"(,"result":)";
+        content += result;
+        content += '}';
+        send(content);
+      }
+
+      /// @brief Sends an error response
+      /// @param id The ID of the request (null if unknown)
+      /// @param code The JSON-RPC error code
+      /// @param error The error message
+      void send_error(const JSONValue& id, i64 code, std::string_view error) noexcept
+      {
+        std::string content = R"({"jsonrpc":"2.0","id":)";
+        WriteJSON(id, content);
+        fmt::format_to(std::back_inserter(content), R"(,"error":{{"code":{},"message":)", code);
+        WriteJSONString(error, content);
+        content += "}}";
+        send(content);
+      }
+
+      /// @brief Sends a message to be logged by the client
+      /// @param message The message
+      void log_message(std::string_view message) noexcept
+      {
+        //MessageType.Info is 3
+        std::string content = R"({"jsonrpc":"2.0","method":"window/logMessage","params":{"type":3,"message":)";
+        WriteJSONString(message, content);
+        content += "}}";
+        send(content);
+      }
+
+      /// @brief Pushes a job for the indexer thread
+      /// @param job The job
+      /// @param from_editor If true, the job is prioritized and replaces pending jobs of the same file
+      void push_job(IndexJob&& job, bool from_editor) noexcept
+      {
+        job.from_editor = from_editor;
+        {
+          std::scoped_lock lock{ job_mutex };
+          if (from_editor)
+          {
+            if (job.kind == JOB_INDEX_CONTENT)
+              open_files.insert(job.path);
+            //Only the last version of a file needs to be indexed
+            auto replaced = std::remove_if(jobs.begin(), jobs.end(), [&](const IndexJob& pending) {
+              return pending.kind != JOB_SCAN_WORKSPACE && pending.path == job.path;
+              });
+            editor_jobs -= std::count_if(replaced, jobs.end(), [](const IndexJob& pending) { return pending.from_editor; });
+            jobs.erase(replaced, jobs.end());
+            jobs.push_front(std::move(job));
+            ++editor_jobs;
+          }
+          else
+            jobs.push_back(std::move(job));
+        }
+        job_cv.notify_one();
+      }
+
+      /// @brief Pops the next job
+      /// @param job The job in which to write
+      /// @param from_editor_only If true, only pops jobs pushed by the editor (without waiting)
+      /// @return False if no job is available (or the thread must stop)
+      bool pop_job(IndexJob& job, bool from_editor_only) noexcept
+      {
+        std::unique_lock lock{ job_mutex };
+        if (!from_editor_only)
+          job_cv.wait(lock, [this]() { return stop || !jobs.empty(); });
+        //Jobs of the editor are always in front
+        if (stop || jobs.empty() || (from_editor_only && !jobs.front().from_editor))
+          return false;
+        job = std::move(jobs.front());
+        jobs.pop_front();
+        return true;
+      }
+
+      /// @brief Waits until the jobs pushed by the editor are run, so that
+      ///        requests are answered using the last changes of the editor
+      void wait_for_editor_jobs() noexcept
+      {
+        std::unique_lock lock{ job_mutex };
+        editor_cv.wait(lock, [this]() { return editor_jobs == 0; });
+      }
+
+      /// @brief Marks a job as run, notifying 'wait_for_editor_jobs' if needed
+      /// @param job The job that was run
+      void finish_job(const IndexJob& job) noexcept
+      {
+        if (!job.from_editor)
+          return;
+        std::scoped_lock lock{ job_mutex };
+        if (--editor_jobs == 0)
+          editor_cv.notify_all();
+      }
+
+      /// @brief Check if a file is open in the editor
+      /// @param path The path of the file
+      /// @return True if open
+      bool is_open(const std::string& path) noexcept
+      {
+        std::scoped_lock lock{ job_mutex };
+        return open_files.count(path) != 0;
+      }
+
+      /// @brief Runs a job (other than JOB_SCAN_WORKSPACE)
+      /// @param job The job to run
+      void run_job(const IndexJob& job) noexcept
+      {
+        switch (job.kind)
+        {
+        break; case JOB_INDEX_CONTENT:
+          index.update_file(job.path, job.content);
+        break; case JOB_INDEX_DISK:
+        {
+          //Changes made in the editor take precedence over the disk
+          if (is_open(job.path))
+            break;
+          std::string content;
+          if (ReadFile(job.path, content))
+            index.update_file(job.path, content);
+          else
+            index.remove_file(job.path);
+        }
+        break; case JOB_REMOVE:
+          index.remove_file(job.path);
+        break; default:
+          break;
+        }
+      }
+
+      /// @brief Indexes all the Colt files of a workspace.
+      /// Jobs pushed by the editor meanwhile are run between files.
+      /// @param root The root of the workspace
+      void scan_workspace(const std::string& root) noexcept
+      {
+        auto begin_time = std::chrono::steady_clock::now();
+        size_t count = 0;
+
+        std::error_code code;
+        auto it = std::filesystem::recursive_directory_iterator(root,
+          std::filesystem::directory_options::skip_permission_denied, code);
+        for (; !code && it != std::filesystem::recursive_directory_iterator(); it.increment(code))
+        {
+          if (!it->is_regular_file(code) || it->path().extension() != ".ct")
+            continue;
+
+          //Keep answering with up-to-date open files while indexing
+          IndexJob job;
+          while (pop_job(job, true))
+          {
+            run_job(job);
+            finish_job(job);
+          }
+
+          {
+            std::scoped_lock lock{ job_mutex };
+            if (stop)
+              return;
+          }
+          run_job({ JOB_INDEX_DISK, it->path().lexically_normal().generic_string() });
+          ++count;
+        }
+
+        log_message(fmt::format("Indexed {} file{} of '{}' in {:.3}.", count, count == 1 ? "" : "s", root,
+          std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - begin_time)));
+      }
+
+      /// @brief The loop of the indexer thread
+      void run_indexer() noexcept
+      {
+        IndexJob job;
+        while (pop_job(job, false))
+        {
+          if (job.kind == JOB_SCAN_WORKSPACE)
+            scan_workspace(job.path);
+          else
+          {
+            run_job(job);
+            finish_job(job);
+          }
+        }
+      }
+    };
+  }
+
+  std::string URIToPath(std::string_view uri) noexcept
+  {
+    constexpr std::string_view FileScheme = "file://";
+    if (uri.substr(0, FileScheme.size()) != FileScheme)
+      return {};
+    uri.remove_prefix(FileScheme.size());
+
+    auto hex_value = [](char chr) { return as<u8>(std::isdigit(as<u8>(chr)) ? chr - '0' : std::tolower(as<u8>(chr)) - 'a' + 10); };
+    std::string path;
+    for (size_t i = 0; i < uri.size(); i++)
+    {
+      //Decode percent-encoded characters
+      if (uri[i] == '%' && i + 2 < uri.size() && std::isxdigit(as<u8>(uri[i + 1])) && std::isxdigit(as<u8>(uri[i + 2])))
+      {
+        path += as<char>((hex_value(uri[i + 1]) << 4) | hex_value(uri[i + 2]));
+        i += 2;
+      }
+      else
+        path += uri[i];
+    }
+#ifdef _WIN32
+    //'file:///c:/a' is 'c:/a'
+    if (path.size() > 2 && path[0] == '/' && path[2] == ':')
+      path.erase(0, 1);
+#endif
+    return std::filesystem::path(path).lexically_normal().generic_string();
+  }
+
+  std::string PathToURI(std::string_view path) noexcept
+  {
+    std::string uri = "file://";
+#ifdef _WIN32
+    if (path.size() > 1 && path[1] == ':')
+      uri += '/';
+#endif
+    for (char chr : path)
+    {
+      if (std::isalnum(as<u8>(chr)) || chr == '/' || chr == '-' || chr == '.' || chr == '_' || chr == '~')
+        uri += chr;
+      else if (chr == '\\')
+        uri += '/';
+      else
+        fmt::format_to(std::back_inserter(uri), "%{:02X}", as<u8>(chr));
+    }
+    return uri;
+  }
+
+  int RunLanguageServer() noexcept
+  {
+#ifdef _WIN32
+    //The protocol counts bytes, so '\n' must not be translated
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    LanguageServer server;
+    return server.run();
+  }
+}
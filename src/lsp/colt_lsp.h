@@ -0,0 +1,33 @@
+/** @file colt_lsp.h
+* Contains the language server of Colt (see '--lsp').
+* The server communicates through the Language Server Protocol (JSON-RPC
+* over stdin/stdout), and answers go-to-definition, find-references and
+* hover requests from a persistent SymbolIndex. The workspace is indexed
+* by a background thread, and open files are reindexed on each change.
+*/
+
+#ifndef HG_COLT_LSP
+#define HG_COLT_LSP
+
+#include <lsp/colt_json.h>
+#include <lsp/colt_symbol_index.h>
+
+/// @brief Contains the language server
+namespace colt::lsp
+{
+	/// @brief Converts a 'file://' URI to a path
+	/// @param uri The URI to convert
+	/// @return The (normalized) path, or an empty string if not a 'file://' URI
+	std::string URIToPath(std::string_view uri) noexcept;
+
+	/// @brief Converts a path to a 'file://' URI
+	/// @param path The path to convert
+	/// @return The URI
+	std::string PathToURI(std::string_view path) noexcept;
+
+	/// @brief Runs the language server until the client sends 'exit'
+	/// @return The exit code of the server (0 if 'shutdown' was requested before 'exit')
+	int RunLanguageServer() noexcept;
+}
+
+#endif //!HG_COLT_LSP
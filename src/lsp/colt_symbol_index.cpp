@@ -0,0 +1,437 @@
+/** @file colt_symbol_index.cpp
+* Contains definition of functions declared in 'colt_symbol_index.h'.
+*/
+
+#include "colt_symbol_index.h"
+
+#include <algorithm>
+#include <mutex>
+#include <tuple>
+
+#include <ast/colt_ast.h>
+#include <code_gen/mangle.h>
+
+namespace colt::lsp
+{
+  namespace
+  {
+    /// @brief Converts a StringView to a std::string
+    /// @param view The StringView to convert
+    /// @return The converted string
+    std::string ToString(StringView view) noexcept
+    {
+      return std::string{ view.get_data(), view.get_size() };
+    }
+
+    /// @brief Returns the count of UTF-16 code units needed to encode UTF-8 text
+    /// @param begin The beginning of the text
+    /// @param end The end of the text
+    /// @return The count of UTF-16 code units
+    u32 CountUTF16(const char* begin, const char* end) noexcept
+    {
+      u32 count = 0;
+      for (; begin < end; ++begin)
+      {
+        auto byte = as<u8>(*begin);
+        //Continuation bytes are not counted, 4 bytes sequences need 2 code units
+        if ((byte & 0xC0) != 0x80)
+          count += byte >= 0xF0 ? 2 : 1;
+      }
+      return count;
+    }
+
+    /// @brief Returns the signature of a function, as it would be declared in Colt
+    /// @param decl The function declaration
+    /// @return The signature
+    std::string FnSignature(PTR<const lang::FnDeclExpr> decl) noexcept
+    {
+      std::string signature = decl->is_extern() ? "extern fn " : "fn ";
+      signature += ToString(decl->get_name());
+      signature += '(';
+      auto params_type = decl->get_params_type();
+      auto params_name = decl->get_params_name();
+      for (size_t i = 0; i < params_type.get_size(); i++)
+      {
+        if (i != 0)
+          signature += ", ";
+        signature += ToString(params_type[i]->get_name());
+        if (i < params_name.get_size())
+        {
+          signature += ' ';
+          signature += ToString(params_name[i]);
+        }
+      }
+      if (decl->get_type()->is_varargs())
+        signature += params_type.get_size() == 0 ? "va_arg" : ", va_arg";
+      signature += ")->";
+      signature += ToString(decl->get_return_type()->get_name());
+      return signature;
+    }
+
+    /// @brief Builds the index of a file by walking its AST
+    class IndexBuilder
+    {
+      /// @brief The content of the file
+      std::string_view content;
+      /// @brief The offsets of the beginning of each line
+      std::vector<u32> line_starts{};
+      /// @brief The index being built
+      SymbolIndex::FileIndex& index;
+      /// @brief Maps function declarations to their symbol
+      std::unordered_map<PTR<const lang::FnDeclExpr>, u32> fn_symbols{};
+      /// @brief Maps keys (mangled names and global variables names) to their symbol
+      std::unordered_map<std::string, u32> key_symbols{};
+
+    public:
+      /// @brief Builds the index of a file
+      /// @param content The content of the file (whose NUL terminator must follow)
+      /// @param ast The AST parsed from 'content'
+      /// @param index The index in which to write
+      IndexBuilder(std::string_view content, const lang::AST& ast, SymbolIndex::FileIndex& index) noexcept
+        : content(content), index(index)
+      {
+        line_starts.push_back(0);
+        for (u32 i = 0; i < content.size(); i++)
+          if (content[i] == '\n')
+            line_starts.push_back(i + 1);
+
+        //Declarations are registered first, as functions can be called before their definition
+        for (size_t i = 0; i < ast.expressions.get_size(); i++)
+          add_declaration(ast.expressions[i]);
+        for (size_t i = 0; i < ast.expressions.get_size(); i++)
+          add_references(ast.expressions[i]);
+
+        auto& occurrences = index.occurrences;
+        //Compound assignments read and write through the same identifier
+        std::vector<u32> order(occurrences.size());
+        for (u32 i = 0; i < order.size(); i++)
+          order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](u32 a, u32 b) {
+          return std::tie(occurrences[a].line, occurrences[a].column) < std::tie(occurrences[b].line, occurrences[b].column);
+          });
+        std::vector<SymbolIndex::Occurrence> sorted;
+        std::vector<u32> new_index(occurrences.size());
+        sorted.reserve(occurrences.size());
+        for (auto i : order)
+        {
+          if (sorted.empty() || sorted.back().line != occurrences[i].line || sorted.back().column != occurrences[i].column)
+            sorted.push_back(occurrences[i]);
+          new_index[i] = as<u32>(sorted.size() - 1);
+        }
+        occurrences = std::move(sorted);
+        for (auto& symbol : index.symbols)
+        {
+          symbol.declaration = new_index[symbol.declaration];
+          for (auto& occurrence : symbol.occurrences)
+            occurrence = new_index[occurrence];
+          std::sort(symbol.occurrences.begin(), symbol.occurrences.end());
+          symbol.occurrences.erase(std::unique(symbol.occurrences.begin(), symbol.occurrences.end()), symbol.occurrences.end());
+        }
+      }
+
+    private:
+      /// @brief Registers a global declaration
+      /// @param ptr The top-level expression
+      void add_declaration(PTR<const lang::Expr> ptr) noexcept
+      {
+        using namespace lang;
+
+        if (is_a<FnDefExpr>(ptr) && is_in_content(as<PTR<const FnDefExpr>>(ptr)->get_name()))
+        {
+          auto decl = as<PTR<const FnDefExpr>>(ptr)->get_fn_decl();
+          auto key = ToString(gen::mangle(decl));
+          //'extern' functions can be declared more than once
+          if (auto it = key_symbols.find(key); it != key_symbols.end())
+          {
+            fn_symbols.insert({ decl, it->second });
+            add_occurrence(decl->get_name(), it->second);
+            return;
+          }
+          u32 symbol = add_symbol(std::move(key), decl->get_name(), FnSignature(decl), SymbolIndex::SYMBOL_FUNCTION);
+          fn_symbols.insert({ decl, symbol });
+        }
+        else if (is_a<VarDeclExpr>(ptr) && is_in_content(as<PTR<const VarDeclExpr>>(ptr)->get_name()))
+        {
+          auto var_decl = as<PTR<const VarDeclExpr>>(ptr);
+          //A function of the same name was already reported as an error
+          if (key_symbols.find(ToString(var_decl->get_name())) != key_symbols.end())
+            return;
+          std::string signature = "var ";
+          signature += ToString(var_decl->get_name());
+          signature += ": ";
+          signature += ToString(var_decl->get_type()->get_name());
+          add_symbol(ToString(var_decl->get_name()), var_decl->get_name(), std::move(signature), SymbolIndex::SYMBOL_GLOBAL_VAR);
+        }
+      }
+
+      /// @brief Adds a new symbol and the occurrence of its declaration
+      /// @param key The key of the symbol
+      /// @param name The name of the symbol (which must point into the content)
+      /// @param signature The signature of the symbol
+      /// @param kind The kind of the symbol
+      /// @return The index of the symbol
+      u32 add_symbol(std::string&& key, StringView name, std::string&& signature, SymbolIndex::SymbolKind kind) noexcept
+      {
+        u32 symbol = as<u32>(index.symbols.size());
+        key_symbols.insert({ key, symbol });
+        index.symbols.push_back({ std::move(key), ToString(name), std::move(signature), kind, 0, {} });
+        index.symbols.back().declaration = as<u32>(index.occurrences.size());
+        add_occurrence(name, symbol);
+        return symbol;
+      }
+
+      /// @brief Check if an identifier was parsed from the content
+      /// @param name The identifier
+      /// @return True if 'name' points into the content
+      bool is_in_content(StringView name) const noexcept
+      {
+        return content.data() <= name.get_data()
+          && name.get_data() + name.get_size() <= content.data() + content.size();
+      }
+
+      /// @brief Adds an occurrence of a symbol
+      /// @param name The identifier (which should point into the content)
+      /// @param symbol The index of the symbol
+      void add_occurrence(StringView name, u32 symbol) noexcept
+      {
+        //Names that were not parsed from the file are ignored
+        if (!is_in_content(name))
+          return;
+
+        u32 offset = as<u32>(name.get_data() - content.data());
+        auto line = std::upper_bound(line_starts.begin(), line_starts.end(), offset) - line_starts.begin() - 1;
+        const char* line_begin = content.data() + line_starts[line];
+        index.symbols[symbol].occurrences.push_back(as<u32>(index.occurrences.size()));
+        index.occurrences.push_back({ as<u32>(line),
+          CountUTF16(line_begin, name.get_data()),
+          CountUTF16(name.get_data(), name.get_data() + name.get_size()),
+          symbol });
+      }
+
+      /// @brief Adds the occurrence of a global variable
+      /// @param name The name of the variable
+      void add_global_var_occurrence(StringView name) noexcept
+      {
+        if (auto it = key_symbols.find(ToString(name)); it != key_symbols.end()
+          && index.symbols[it->second].kind == SymbolIndex::SYMBOL_GLOBAL_VAR)
+          add_occurrence(name, it->second);
+      }
+
+      /// @brief Adds the references of an expression and of its children
+      /// @param ptr The expression (can be nullptr)
+      void add_references(PTR<const lang::Expr> ptr) noexcept
+      {
+        using namespace lang;
+
+        if (ptr == nullptr)
+          return;
+
+        switch (ptr->classof())
+        {
+        break; case Expr::EXPR_UNARY:
+          add_references(as<PTR<const UnaryExpr>>(ptr)->get_child());
+        break; case Expr::EXPR_BINARY:
+          add_references(as<PTR<const BinaryExpr>>(ptr)->get_LHS());
+          add_references(as<PTR<const BinaryExpr>>(ptr)->get_RHS());
+        break; case Expr::EXPR_CONVERT:
+          add_references(as<PTR<const ConvertExpr>>(ptr)->get_child());
+        break; case Expr::EXPR_VAR_DECL:
+          add_references(as<PTR<const VarDeclExpr>>(ptr)->get_value());
+        break; case Expr::EXPR_VAR_READ:
+          if (auto var_read = as<PTR<const VarReadExpr>>(ptr); var_read->is_global())
+            add_global_var_occurrence(var_read->get_name());
+        break; case Expr::EXPR_VAR_WRITE:
+        {
+          auto var_write = as<PTR<const VarWriteExpr>>(ptr);
+          if (var_write->is_global())
+            add_global_var_occurrence(var_write->get_name());
+          add_references(var_write->get_value());
+        }
+        break; case Expr::EXPR_FN_DEF:
+          if (as<PTR<const FnDefExpr>>(ptr)->has_body())
+            add_references(as<PTR<const FnDefExpr>>(ptr)->get_body());
+        break; case Expr::EXPR_FN_CALL:
+        {
+          auto fn_call = as<PTR<const FnCallExpr>>(ptr);
+          auto decl = fn_call->get_fn_decl();
+          if (auto it = fn_symbols.find(decl); it != fn_symbols.end())
+          {
+            //The source code of a call begins with the name of the function
+            StringView call = fn_call->get_src_code().expression;
+            StringView name = decl->get_name();
+            std::string_view call_str = { call.get_data(), call.get_size() };
+            if (auto pos = call_str.find(std::string_view{ name.get_data(), name.get_size() }); pos != std::string_view::npos)
+              add_occurrence({ call.get_data() + pos, name.get_size() }, it->second);
+          }
+          auto call_args = fn_call->get_arguments();
+          for (size_t i = 0; i < call_args.get_size(); i++)
+            add_references(call_args[i]);
+        }
+        break; case Expr::EXPR_FN_RETURN:
+          add_references(as<PTR<const FnReturnExpr>>(ptr)->get_value());
+        break; case Expr::EXPR_SCOPE:
+          for (auto body_expr : as<PTR<const ScopeExpr>>(ptr)->get_body_array())
+            add_references(body_expr);
+        break; case Expr::EXPR_CONDITION:
+          add_references(as<PTR<const ConditionExpr>>(ptr)->get_if_condition());
+          add_references(as<PTR<const ConditionExpr>>(ptr)->get_if_statement());
+          add_references(as<PTR<const ConditionExpr>>(ptr)->get_else_statement());
+        break; case Expr::EXPR_WHILE_LOOP:
+          add_references(as<PTR<const WhileLoopExpr>>(ptr)->get_condition());
+          add_references(as<PTR<const WhileLoopExpr>>(ptr)->get_body());
+        break; case Expr::EXPR_PTR_LOAD:
+          add_references(as<PTR<const PtrLoadExpr>>(ptr)->get_where());
+        break; case Expr::EXPR_PTR_STORE:
+          add_references(as<PTR<const PtrStoreExpr>>(ptr)->get_where());
+          add_references(as<PTR<const PtrStoreExpr>>(ptr)->get_value());
+        break; default:
+          //Literals, errors, NOP, break/continue do not reference symbols
+          break;
+        }
+      }
+    };
+  }
+
+  SymbolIndex::FileIndex SymbolIndex::index_source(std::string_view content) noexcept
+  {
+    FileIndex result;
+    //The lexer expects a NUL-terminated string
+    std::string source{ content };
+
+    lang::COLTContext ctx;
+    lang::AST ast = { ctx };
+    //Errors are not printed in server mode, and do not prevent indexing valid declarations
+    lang::ASTMaker maker = { StringView{ source.data(), source.size() }, ast };
+    IndexBuilder builder = { source, ast, result };
+    return result;
+  }
+
+  void SymbolIndex::update_file(const std::string& path, std::string_view content) noexcept
+  {
+    //Parsing is done without holding the lock
+    FileIndex index = index_source(content);
+
+    std::unique_lock lock{ mutex };
+    remove_file_unlocked(path);
+    for (auto& symbol : index.symbols)
+      files_of_key[symbol.key].push_back(path);
+    files.insert_or_assign(path, std::move(index));
+  }
+
+  void SymbolIndex::remove_file(const std::string& path) noexcept
+  {
+    std::unique_lock lock{ mutex };
+    remove_file_unlocked(path);
+  }
+
+  bool SymbolIndex::contains_file(const std::string& path) const noexcept
+  {
+    std::shared_lock lock{ mutex };
+    return files.find(path) != files.end();
+  }
+
+  size_t SymbolIndex::get_file_count() const noexcept
+  {
+    std::shared_lock lock{ mutex };
+    return files.size();
+  }
+
+  void SymbolIndex::remove_file_unlocked(const std::string& path) noexcept
+  {
+    auto file = files.find(path);
+    if (file == files.end())
+      return;
+    for (auto& symbol : file->second.symbols)
+    {
+      auto it = files_of_key.find(symbol.key);
+      if (it == files_of_key.end())
+        continue;
+      auto& paths = it->second;
+      paths.erase(std::remove(paths.begin(), paths.end(), path), paths.end());
+      if (paths.empty())
+        files_of_key.erase(it);
+    }
+    files.erase(file);
+  }
+
+  std::pair<const SymbolIndex::FileIndex*, const SymbolIndex::Occurrence*> SymbolIndex::find_occurrence(const std::string& path, u32 line, u32 column) const noexcept
+  {
+    auto file = files.find(path);
+    if (file == files.end())
+      return { nullptr, nullptr };
+    auto& occurrences = file->second.occurrences;
+    //Search for the last occurrence beginning before the position
+    auto it = std::upper_bound(occurrences.begin(), occurrences.end(), std::make_pair(line, column),
+      [](const std::pair<u32, u32>& pos, const Occurrence& occurrence) {
+        return pos < std::make_pair(occurrence.line, occurrence.column);
+      });
+    if (it == occurrences.begin())
+      return { nullptr, nullptr };
+    --it;
+    //The cursor can be right after the identifier
+    if (it->line != line || column > it->column + it->length)
+      return { nullptr, nullptr };
+    return { &file->second, &*it };
+  }
+
+  bool SymbolIndex::find_definition(const std::string& path, u32 line, u32 column, SymbolLocation& result) const noexcept
+  {
+    std::shared_lock lock{ mutex };
+    auto [file, occurrence] = find_occurrence(path, line, column);
+    if (occurrence == nullptr)
+      return false;
+    auto& declaration = file->occurrences[file->symbols[occurrence->symbol].declaration];
+    result = { path, declaration.line, declaration.column, declaration.length };
+    return true;
+  }
+
+  std::vector<SymbolLocation> SymbolIndex::find_references(const std::string& path, u32 line, u32 column, bool include_declaration) const noexcept
+  {
+    std::vector<SymbolLocation> result;
+
+    std::shared_lock lock{ mutex };
+    auto [file, occurrence] = find_occurrence(path, line, column);
+    if (occurrence == nullptr)
+      return result;
+    auto& key = file->symbols[occurrence->symbol].key;
+    auto paths = files_of_key.find(key);
+    if (paths == files_of_key.end())
+      return result;
+
+    for (auto& other_path : paths->second)
+    {
+      auto& other = files.find(other_path)->second;
+      for (auto& symbol : other.symbols)
+      {
+        if (symbol.key != key)
+          continue;
+        for (auto index : symbol.occurrences)
+        {
+          if (!include_declaration && index == symbol.declaration)
+            continue;
+          auto& ref = other.occurrences[index];
+          result.push_back({ other_path, ref.line, ref.column, ref.length });
+        }
+      }
+    }
+    return result;
+  }
+
+  bool SymbolIndex::hover(const std::string& path, u32 line, u32 column, SymbolHover& result) const noexcept
+  {
+    std::shared_lock lock{ mutex };
+    auto [file, occurrence] = find_occurrence(path, line, column);
+    if (occurrence == nullptr)
+      return false;
+    result.range = { path, occurrence->line, occurrence->column, occurrence->length };
+
+    auto& hovered = file->symbols[occurrence->symbol];
+    result.signatures.push_back(hovered.signature);
+    for (auto& symbol : file->symbols)
+    {
+      if (&symbol != &hovered && symbol.kind == SYMBOL_FUNCTION && symbol.name == hovered.name)
+        result.signatures.push_back(symbol.signature);
+    }
+    return true;
+  }
+}
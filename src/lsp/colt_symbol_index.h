@@ -0,0 +1,172 @@
+/** @file colt_symbol_index.h
+* Contains the persistent symbol index of the language server.
+* Each file is parsed once (when it is indexed or changed), and the
+* declarations and references of its global symbols (functions and
+* global variables) are stored so that queries never reparse.
+* Positions are 0-based lines and columns in UTF-16 code units (as in the
+* Language Server Protocol).
+*/
+
+#ifndef HG_COLT_SYMBOL_INDEX
+#define HG_COLT_SYMBOL_INDEX
+
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <util/colt_pch.h>
+
+namespace colt::lsp
+{
+	/// @brief A range in a file
+	struct SymbolLocation
+	{
+		/// @brief The path of the file
+		std::string path{};
+		/// @brief The line (0-based)
+		u32 line = 0;
+		/// @brief The column in UTF-16 code units (0-based)
+		u32 column = 0;
+		/// @brief The length of the range in UTF-16 code units
+		u32 length = 0;
+	};
+
+	/// @brief The result of a hover query
+	struct SymbolHover
+	{
+		/// @brief The range of the hovered identifier
+		SymbolLocation range{};
+		/// @brief The signature of the hovered symbol, followed by the
+		///        signatures of its overloads declared in the same file
+		std::vector<std::string> signatures{};
+	};
+
+	/// @brief Thread-safe index of the declarations and references of global symbols.
+	/// Files are (re)indexed by 'update_file', which parses outside of the lock,
+	/// so that queries are only blocked while the results are swapped in.
+	class SymbolIndex
+	{
+	public:
+		/// @brief The kind of an indexed symbol
+		enum SymbolKind
+			: u8
+		{
+			/// @brief A function
+			SYMBOL_FUNCTION,
+			/// @brief A global variable
+			SYMBOL_GLOBAL_VAR
+		};
+
+		/// @brief A symbol declared in a file
+		struct Symbol
+		{
+			/// @brief The key identifying the symbol across files (mangled name)
+			std::string key;
+			/// @brief The name of the symbol
+			std::string name;
+			/// @brief The signature of the symbol, as written in Colt
+			std::string signature;
+			/// @brief The kind of the symbol
+			SymbolKind kind;
+			/// @brief The index of the occurrence of the declaration
+			u32 declaration;
+			/// @brief The indices of the occurrences (declaration included)
+			std::vector<u32> occurrences;
+		};
+
+		/// @brief An occurrence of a symbol in a file
+		struct Occurrence
+		{
+			/// @brief The line (0-based)
+			u32 line;
+			/// @brief The column in UTF-16 code units (0-based)
+			u32 column;
+			/// @brief The length in UTF-16 code units
+			u32 length;
+			/// @brief The index of the symbol in the file's symbols
+			u32 symbol;
+		};
+
+		/// @brief The index of a single file
+		struct FileIndex
+		{
+			/// @brief The symbols declared in the file
+			std::vector<Symbol> symbols{};
+			/// @brief The occurrences of symbols, sorted by position
+			std::vector<Occurrence> occurrences{};
+		};
+
+	private:
+		/// @brief Protects all the members
+		mutable std::shared_mutex mutex{};
+		/// @brief The indexed files, by path
+		std::unordered_map<std::string, FileIndex> files{};
+		/// @brief Maps the key of a symbol to the paths of the files declaring it
+		std::unordered_map<std::string, std::vector<std::string>> files_of_key{};
+
+	public:
+		/// @brief Parses a file and replaces its entries in the index.
+		/// Parsing errors are ignored: the valid declarations are indexed.
+		/// @param path The path of the file
+		/// @param content The content of the file
+		void update_file(const std::string& path, std::string_view content) noexcept;
+
+		/// @brief Removes a file from the index
+		/// @param path The path of the file
+		void remove_file(const std::string& path) noexcept;
+
+		/// @brief Check if a file is indexed
+		/// @param path The path of the file
+		/// @return True if indexed
+		bool contains_file(const std::string& path) const noexcept;
+
+		/// @brief Returns the number of indexed files
+		/// @return The number of indexed files
+		size_t get_file_count() const noexcept;
+
+		/// @brief Finds the declaration of the symbol at a position
+		/// @param path The path of the file
+		/// @param line The line (0-based)
+		/// @param column The column in UTF-16 code units (0-based)
+		/// @param result The location in which to write the declaration
+		/// @return True if a symbol was found at the position
+		bool find_definition(const std::string& path, u32 line, u32 column, SymbolLocation& result) const noexcept;
+
+		/// @brief Finds the references of the symbol at a position, in every indexed file
+		/// @param path The path of the file
+		/// @param line The line (0-based)
+		/// @param column The column in UTF-16 code units (0-based)
+		/// @param include_declaration If true, the declarations are part of the result
+		/// @return The references (empty if no symbol was found at the position)
+		std::vector<SymbolLocation> find_references(const std::string& path, u32 line, u32 column, bool include_declaration) const noexcept;
+
+		/// @brief Returns the signatures of the symbol at a position and of its overloads
+		/// @param path The path of the file
+		/// @param line The line (0-based)
+		/// @param column The column in UTF-16 code units (0-based)
+		/// @param result The hover in which to write the result
+		/// @return True if a symbol was found at the position
+		bool hover(const std::string& path, u32 line, u32 column, SymbolHover& result) const noexcept;
+
+	private:
+		/// @brief Parses a file and builds its index (without locking)
+		/// @param content The content of the file
+		/// @return The index of the file
+		static FileIndex index_source(std::string_view content) noexcept;
+
+		/// @brief Removes the entries of a file (the lock must be held)
+		/// @param path The path of the file
+		void remove_file_unlocked(const std::string& path) noexcept;
+
+		/// @brief Returns the occurrence at a position (the lock must be held)
+		/// @param path The path of the file
+		/// @param line The line (0-based)
+		/// @param column The column in UTF-16 code units (0-based)
+		/// @return The file and the occurrence, or nullptrs if not found
+		std::pair<const FileIndex*, const Occurrence*> find_occurrence(const std::string& path, u32 line, u32 column) const noexcept;
+	};
+}
+
+#endif //!HG_COLT_SYMBOL_INDEX
@@ -10,6 +10,7 @@ COLT_EXPORT i64 _ColtRand(i64 a, i64 b)
   return distr(generator);
 }
 
+//Most print helpers are also linked as bitcode (see 'runtime/colt_print.c'), which must print the same
 COLT_EXPORT void _ColtPrinti8(i8 a)           { io::Print("{}", a); }
 COLT_EXPORT void _ColtPrinti16(i16 a)         { io::Print("{}", a); }
 COLT_EXPORT void _ColtPrinti32(i32 a)         { io::Print("{}", a); }
@@ -25,18 +26,117 @@ COLT_EXPORT void _ColtPrintchar(char a)       { io::Print("{}", a); }
 COLT_EXPORT void _ColtPrintlstring(lstring a) { io::Print("{}", a); }
 COLT_EXPORT void _ColtPrintPTR(PTR<void> a)   { io::Print("{}", a); }
 
+/// @brief Registers the functions of the host callable by Colt code
+void RegisterHostFunctions() noexcept
+{
+  HostFunctions.add("_ColtRand", &_ColtRand);
+  HostFunctions.add("_ColtPrinti8", &_ColtPrinti8);
+  HostFunctions.add("_ColtPrinti16", &_ColtPrinti16);
+  HostFunctions.add("_ColtPrinti32", &_ColtPrinti32);
+  HostFunctions.add("_ColtPrinti64", &_ColtPrinti64);
+  HostFunctions.add("_ColtPrintu8", &_ColtPrintu8);
+  HostFunctions.add("_ColtPrintu16", &_ColtPrintu16);
+  HostFunctions.add("_ColtPrintu32", &_ColtPrintu32);
+  HostFunctions.add("_ColtPrintu64", &_ColtPrintu64);
+  HostFunctions.add("_ColtPrintbool", &_ColtPrintbool);
+  HostFunctions.add("_ColtPrintf32", &_ColtPrintf32);
+  HostFunctions.add("_ColtPrintf64", &_ColtPrintf64);
+  HostFunctions.add("_ColtPrintchar", &_ColtPrintchar);
+  HostFunctions.add("_ColtPrintlstring", &_ColtPrintlstring);
+  HostFunctions.add("_ColtPrintPTR", &_ColtPrintPTR);
+
+  //Containers of the runtime (see 'runtime/colt_containers.h')
+  constexpr u8 READONLY = gen::HOST_FN_NOUNWIND | gen::HOST_FN_READONLY;
+  HostFunctions.add("_ColtArenaNew", &_ColtArenaNew);
+  HostFunctions.add("_ColtArenaFree", &_ColtArenaFree);
+  HostFunctions.add("_ColtVecNew", &_ColtVecNew);
+  HostFunctions.add("_ColtVecNewIn", &_ColtVecNewIn);
+  HostFunctions.add("_ColtVecFree", &_ColtVecFree);
+  HostFunctions.add("_ColtVecPush", &_ColtVecPush);
+  HostFunctions.add("_ColtVecPop", &_ColtVecPop);
+  HostFunctions.add("_ColtVecGet", &_ColtVecGet, READONLY);
+  HostFunctions.add("_ColtVecSet", &_ColtVecSet);
+  HostFunctions.add("_ColtVecSize", &_ColtVecSize, READONLY);
+  HostFunctions.add("_ColtVecData", &_ColtVecData, READONLY);
+  HostFunctions.add("_ColtVecReserve", &_ColtVecReserve);
+  HostFunctions.add("_ColtVecClear", &_ColtVecClear);
+  HostFunctions.add("_ColtMapNew", &_ColtMapNew);
+  HostFunctions.add("_ColtMapNewIn", &_ColtMapNewIn);
+  HostFunctions.add("_ColtMapFree", &_ColtMapFree);
+  HostFunctions.add("_ColtMapInsert", &_ColtMapInsert);
+  HostFunctions.add("_ColtMapAdd", &_ColtMapAdd);
+  HostFunctions.add("_ColtMapGet", &_ColtMapGet, READONLY);
+  HostFunctions.add("_ColtMapContains", &_ColtMapContains, READONLY);
+  HostFunctions.add("_ColtMapErase", &_ColtMapErase);
+  HostFunctions.add("_ColtMapSize", &_ColtMapSize, READONLY);
+  HostFunctions.add("_ColtMapClear", &_ColtMapClear);
+  HostFunctions.add("_ColtMapKeys", &_ColtMapKeys);
+  HostFunctions.add("_ColtMapValues", &_ColtMapValues);
+
+  //Algorithms of the runtime (see 'runtime/colt_algorithms.h')
+#define COLT_REGISTER_ALGORITHMS(NAME, TYPE) \
+  HostFunctions.add("_ColtSort" #NAME, &_ColtSort##NAME); \
+  HostFunctions.add("_ColtParallelSort" #NAME, &_ColtParallelSort##NAME); \
+  HostFunctions.add("_ColtPartition" #NAME, &_ColtPartition##NAME); \
+  HostFunctions.add("_ColtUnique" #NAME, &_ColtUnique##NAME); \
+  HostFunctions.add("_ColtPrefixSum" #NAME, &_ColtPrefixSum##NAME);
+  COLT_RUNTIME_NUMERIC_TYPES(COLT_REGISTER_ALGORITHMS)
+#undef COLT_REGISTER_ALGORITHMS
+
+  //Memory-mapped files of the runtime (see 'runtime/colt_mapped_file.h')
+  HostFunctions.add("_ColtMmapRead", &_ColtMmapRead);
+  HostFunctions.add("_ColtMmapWrite", &_ColtMmapWrite);
+  HostFunctions.add("_ColtMmapData", &_ColtMmapData, READONLY);
+  HostFunctions.add("_ColtMmapSize", &_ColtMmapSize, READONLY);
+  HostFunctions.add("_ColtMmapResize", &_ColtMmapResize);
+  HostFunctions.add("_ColtMmapSync", &_ColtMmapSync);
+  HostFunctions.add("_ColtMmapClose", &_ColtMmapClose);
+
+  //Asynchronous I/O of the runtime (see 'runtime/colt_async_io.h')
+  HostFunctions.add("_ColtIoNew", &_ColtIoNew);
+  HostFunctions.add("_ColtIoFree", &_ColtIoFree);
+  HostFunctions.add("_ColtIoUsesUring", &_ColtIoUsesUring, READONLY);
+  HostFunctions.add("_ColtIoBuffer", &_ColtIoBuffer, READONLY);
+  HostFunctions.add("_ColtIoBufferSize", &_ColtIoBufferSize, READONLY);
+  HostFunctions.add("_ColtIoOpen", &_ColtIoOpen);
+  HostFunctions.add("_ColtIoClose", &_ColtIoClose);
+  HostFunctions.add("_ColtIoRead", &_ColtIoRead);
+  HostFunctions.add("_ColtIoWrite", &_ColtIoWrite);
+  HostFunctions.add("_ColtIoAccept", &_ColtIoAccept);
+  HostFunctions.add("_ColtIoRecv", &_ColtIoRecv);
+  HostFunctions.add("_ColtIoSubmit", &_ColtIoSubmit);
+  HostFunctions.add("_ColtIoPoll", &_ColtIoPoll);
+  HostFunctions.add("_ColtIoResult", &_ColtIoResult, READONLY);
+  HostFunctions.add("_ColtIoUserData", &_ColtIoUserData, READONLY);
+  HostFunctions.add("_ColtIoPending", &_ColtIoPending, READONLY);
+
+  //Text ingestion of the runtime (see 'runtime/colt_text.h')
+  HostFunctions.add("_ColtFindByte", &_ColtFindByte);
+  HostFunctions.add("_ColtFindSeparators", &_ColtFindSeparators);
+  HostFunctions.add("_ColtParseI64", &_ColtParseI64);
+  HostFunctions.add("_ColtParseF64", &_ColtParseF64);
+  HostFunctions.add("_ColtParseI64Fields", &_ColtParseI64Fields);
+  HostFunctions.add("_ColtParseF64Fields", &_ColtParseF64Fields);
+}
+
 int main(int argc, const char** argv)
 {
+  RegisterHostFunctions();
   //Populates the GlobalArguments
   args::ParseArguments(argc, argv);
   //Initialize code generators
   InitializeCOLT();
 
+  if (args::GlobalArguments.lsp_mode)
+    return lsp::RunLanguageServer();
+  //The exit code is 1 if the file could not be compiled
+  bool success = true;
   if (args::GlobalArguments.file_in != nullptr)
-    CompileFile(args::GlobalArguments.file_in);
+    success = CompileFile(args::GlobalArguments.file_in);
   else
     REPL();
 
   if (args::GlobalArguments.wait_for_user_input)
     io::PressToContinue();
+  return success ? 0 : 1;
 }
\ No newline at end of file
@@ -9,16 +9,18 @@ using namespace colt::lang;
 
 namespace colt
 {
-  void CompileFile(const char* path) noexcept
+  gen::HostFnRegistry HostFunctions;
+
+  bool CompileFile(const char* path) noexcept
   {
     auto str = String::getFileContent(path);
     if (str.is_error())
-      io::PrintError("Error reading file at path '{}'.", path);
-    else
     {
-      str.get_value().c_str(); //Appends a NUL terminator if needed
-      CompileStr(str.get_value());
+      io::PrintError("Error reading file at path '{}'.", path);
+      return false;
     }
+    str.get_value().c_str(); //Appends a NUL terminator if needed
+    return CompileStr(str.get_value());
   }
 
   void InitializeCOLT() noexcept
@@ -60,20 +62,10 @@ namespace colt
       str.strip_spaces();
       if (!str.begins_with("fn") && !str.begins_with("var"))
       {
-        auto to_cmp = String{
-          "extern fn _ColtPrintbool(bool a)->void;\n"
-          "extern fn _ColtPrinti8(i8 a)->void;\n"
-          "extern fn _ColtPrinti16(i16 a)->void;\n"
-          "extern fn _ColtPrinti32(i32 a)->void;\n"
-          "extern fn _ColtPrinti64(i64 a)->void;\n"
-          "extern fn _ColtPrintu8(u8 a)->void;\n"
-          "extern fn _ColtPrintu16(u16 a)->void;\n"
-          "extern fn _ColtPrintu32(u32 a)->void;\n"
-          "extern fn _ColtPrintu64(u64 a)->void;\n"
-          "extern fn _ColtPrintf32(float a)->void;\n"
-          "extern fn _ColtPrintf64(double a)->void;\n"
-          "extern fn _ColtPrintchar(char a)->void;\n"
-          "extern fn _ColtPrintlstring(lstring a)->void;\n"
+        //The host functions are declared from their registered signatures
+        auto declarations = HostFunctions.get_declarations(ctx);
+        auto to_cmp = String{ StringView{ declarations.data(), declarations.size() } };
+        to_cmp +=
           "fn print(bool a)->void: _ColtPrintbool(a);\n"
           "fn print(i8 a)->void: _ColtPrinti8(a);\n"
           "fn print(i16 a)->void: _ColtPrinti16(a);\n"
@@ -88,15 +80,14 @@ namespace colt
           "fn print(char a)->void: _ColtPrintchar(a);\n"
           "fn print(lstring a)->void: _ColtPrintlstring(a);\n"
           "fn print()->void: pass;\n"
-          "fn main()->i64 { print(@line(1)\n"
-        };
+          "fn main()->i64 { print(@line(1)\n";
         to_cmp += str;
         to_cmp += "\n); }";
         to_cmp.c_str();
         if (CompileAndAdd(ctx.add_str(std::move(to_cmp)), ast))
         {
 #ifndef COLT_NO_LLVM
-          if (auto result = GenerateIR(ast); result.is_expected())
+          if (auto result = GenerateIR(ast, &HostFunctions); result.is_expected())
             RunMain(std::move(result.get_value()), false);
 #endif //!COLT_NO_LLVM
         }
@@ -107,7 +98,7 @@ namespace colt
         if (CompileAndAdd(ctx.add_str(std::move(line.get_value())), ast))
         {
 #ifndef COLT_NO_LLVM
-          if (auto result = GenerateIR(ast); result.is_expected())
+          if (auto result = GenerateIR(ast, &HostFunctions); result.is_expected())
             RunMain(std::move(result.get_value()), false);
 #endif //!COLT_NO_LLVM
         }
@@ -115,10 +106,10 @@ namespace colt
     }
   }
 
-  void CompileStr(StringView str) noexcept
+  bool CompileStr(StringView str) noexcept
   {
     if (str.is_empty())
-      return;
+      return true;
 
     //Record beginning of compilation
     auto begin_time = std::chrono::steady_clock::now();
@@ -134,44 +125,227 @@ namespace colt
     if (AST.is_expected())
     {
       io::PrintMessage("Compilation successful!");
-      CompileAST(AST.get_value());
+      return CompileAST(AST.get_value());
     }
-    else
-      io::PrintWarning("Compilation failed with {} error{}", AST.get_error(), AST.get_error() == 1 ? "!" : "s!");
+    io::PrintWarning("Compilation failed with {} error{}", AST.get_error(), AST.get_error() == 1 ? "!" : "s!");
+    return false;
   }
 
-  void CompileAST(const lang::AST& ast) noexcept
+  bool CompileAST(const lang::AST& ast) noexcept
   {
+    //False if an output could not be written
+    bool success = true;
+    if (args::GlobalArguments.dep_file)
+      WriteDepFile(ast);
+
+    if (args::GlobalArguments.emit_c) //Write C source code
+    {
+      if (auto result = gen::WriteC(gen::GenerateC(ast), args::GlobalArguments.emit_c); result.is_error())
+      {
+        io::PrintError("{}", result.get_error());
+        success = false;
+      }
+      else
+        io::PrintMessage("Successfully written C source '{}'!", args::GlobalArguments.emit_c);
+    }
+
 #ifndef COLT_NO_LLVM
-    auto IR = gen::GenerateIR(ast);
+    auto IR = gen::GenerateIR(ast, &HostFunctions);
     if (IR.is_error())
     {
       io::PrintError("{}", IR.get_error());
-      return;
+      return false;
     }
 
     //Optimize resulting IR
     IR->optimize(args::GlobalArguments.opt_level);
 
+    if (args::GlobalArguments.function_order) //Place hot functions first
+    {
+      std::vector<std::string> order;
+      if (!gen::ReadFunctionOrder(args::GlobalArguments.function_order, order))
+        io::PrintError("Could not read the function order '{}'!", args::GlobalArguments.function_order);
+      else
+        IR->order_functions(order);
+    }
+
     if (args::GlobalArguments.print_llvm_ir) //Print IR
       IR->print_module(llvm::errs());
+    if (args::GlobalArguments.size_report) //Print machine code size
+    {
+      if (auto result = IR->write_size_report(stderr); result.is_error())
+        io::PrintError("{}", result.get_error());
+    }
+    if (args::GlobalArguments.stack_usage || args::GlobalArguments.stack_budget != 0)
+    {
+      auto usages = IR->stack_usage();
+      if (usages.is_error())
+      {
+        io::PrintError("{}", usages.get_error());
+        success = false;
+      }
+      else
+      {
+        if (args::GlobalArguments.stack_usage) //Print stack usage
+          WriteStackUsage(stderr, usages.get_value());
+
+        bool exceeds_budget = false;
+        for (const auto& usage : usages.get_value())
+        {
+          if (!usage.is_entry || args::GlobalArguments.stack_budget == 0)
+            continue;
+          if (usage.worst_case > args::GlobalArguments.stack_budget)
+          {
+            io::PrintError("Worst-case stack usage of '{}' ({} bytes) exceeds the budget of {} bytes!",
+              usage.name, usage.worst_case, args::GlobalArguments.stack_budget);
+            exceeds_budget = true;
+          }
+          else if (usage.is_recursive)
+          {
+            //No budget can bound the usage of a recursion
+            io::PrintError("Stack usage of '{}' is unbounded, as it recurses, and exceeds the budget of {} bytes!",
+              usage.name, args::GlobalArguments.stack_budget);
+            exceeds_budget = true;
+          }
+        }
+        if (exceeds_budget)
+          return false;
+      }
+    }
     if (args::GlobalArguments.file_out) //Write object file
     {
       if (auto result = IR->to_object_file(args::GlobalArguments.file_out); result.is_error())
+      {
         io::PrintError("{}", result.get_error());
+        success = false;
+      }
       else
         io::PrintMessage("Successfully written object file '{}'!", args::GlobalArguments.file_out);
     }
 
     if (args::GlobalArguments.jit_run_main)
       RunMain(std::move(*IR));
+#else
+    if (args::GlobalArguments.function_order)
+      io::PrintWarning("'--function-order' requires LLVM: compile Colt with LLVM to use it!");
+    if (args::GlobalArguments.size_report)
+      io::PrintWarning("'--size-report' requires LLVM: compile Colt with LLVM to use it!");
+    if (args::GlobalArguments.stack_usage || args::GlobalArguments.stack_budget != 0)
+      io::PrintWarning("'--stack-usage' and '--stack-budget' require LLVM: compile Colt with LLVM to use them!");
+    auto source = gen::GenerateC(ast);
+
+    if (args::GlobalArguments.print_llvm_ir) //Print C
+      std::fputs(source.c_str(), stderr);
+    if (args::GlobalArguments.file_out) //Write object file
+    {
+      if (auto result = gen::CompileC(source, args::GlobalArguments.file_out, args::GlobalArguments.opt_level, false); result.is_error())
+      {
+        io::PrintError("{}", result.get_error());
+        success = false;
+      }
+      else
+        io::PrintMessage("Successfully written object file '{}'!", args::GlobalArguments.file_out);
+    }
+
+    if (args::GlobalArguments.jit_run_main)
+      RunMain(source);
 #endif //!COLT_NO_LLVM
+    return success;
+  }
+
+  namespace
+  {
+    /// @brief Writes a path in a Makefile rule, escaping spaces
+    /// @param path The path to write
+    /// @param to The string in which to write
+    void WriteMakePath(StringView path, std::string& to) noexcept
+    {
+      for (size_t i = 0; i < path.get_size(); i++)
+      {
+        char chr = path.get_data()[i];
+        if (chr == ' ' || chr == '#')
+          to += '\\';
+        else if (chr == '$')
+          to += '$';
+        to += chr;
+      }
+    }
+  }
+
+  void WriteDepFile(const lang::AST& ast) noexcept
+  {
+    const char* target = args::GlobalArguments.file_out;
+    if (target == nullptr)
+      target = args::GlobalArguments.emit_c;
+    if (target == nullptr)
+      target = args::GlobalArguments.file_in;
+    if (target == nullptr) //The REPL has no output
+      return;
+
+    std::string rule;
+    WriteMakePath({ target, std::strlen(target) }, rule);
+    rule += ':';
+    if (const char* file_in = args::GlobalArguments.file_in)
+    {
+      rule += ' ';
+      WriteMakePath({ file_in, std::strlen(file_in) }, rule);
+    }
+    for (const auto& file : ast.embedded_files)
+    {
+      rule += " \\\n  ";
+      WriteMakePath(file, rule);
+    }
+    rule += '\n';
+
+    std::FILE* file = std::fopen(args::GlobalArguments.dep_file, "w");
+    if (file == nullptr)
+    {
+      io::PrintError("Could not write dependency file '{}'!", args::GlobalArguments.dep_file);
+      return;
+    }
+    std::fputs(rule.c_str(), file);
+    std::fclose(file);
   }
 
 #ifndef COLT_NO_LLVM
+  void WriteSamplingProfile(gen::SamplingProfiler& profiler) noexcept
+  {
+    const char* prefix = std::getenv("COLT_PROFILE");
+    std::string path = prefix != nullptr && *prefix != '\0' ? prefix : "colt_profile";
+    std::FILE* report = std::fopen((path + ".txt").c_str(), "w");
+    std::FILE* folded = std::fopen((path + ".folded").c_str(), "w");
+    ON_EXIT{
+      if (report != nullptr)
+        std::fclose(report);
+      if (folded != nullptr)
+        std::fclose(folded);
+    };
+    if (report == nullptr || folded == nullptr)
+    {
+      io::PrintError("Could not write profile to '{}'!", path);
+      return;
+    }
+    profiler.write_profile(report, folded, 30);
+    io::PrintMessage("Profile written to '{0}.txt' and '{0}.folded'.", path);
+  }
+
   void RunMain(gen::GeneratedIR&& IR, bool print) noexcept
   {
-    if (auto JITError = gen::ColtJIT::Create(); !JITError)
+    //Only 'main' run from the command line is profiled (not the REPL)
+    std::unique_ptr<gen::SamplingProfiler> profiler;
+    if (args::GlobalArguments.profile_hz != 0 && print)
+      profiler = std::make_unique<gen::SamplingProfiler>();
+
+    std::unique_ptr<gen::HugePageArena> arena;
+    if (args::GlobalArguments.jit_huge_pages)
+    {
+      std::string error;
+      arena = gen::HugePageArena::Create(args::GlobalArguments.jit_hot_functions, error);
+      if (arena == nullptr)
+        io::PrintWarning("Huge pages are not used: {}", error);
+    }
+
+    if (auto JITError = gen::ColtJIT::Create(profiler.get(), std::move(arena)); !JITError)
     {
       io::PrintFatal("Could not initialize JIT compiler!");
       abort();
@@ -179,6 +353,13 @@ namespace colt
     else
     {
       const auto& ColtJIT = std::move(*JITError);
+      if (auto HostError = ColtJIT->addHostFunctions(HostFunctions))
+        io::PrintError("Could not define host functions: {}", llvm::toString(std::move(HostError)));
+      for (const auto& lib : args::GlobalArguments.link_libs)
+      {
+        if (auto LibError = ColtJIT->addLibrary(lib.c_str()))
+          io::PrintError("Could not load library '{}': {}", lib, llvm::toString(std::move(LibError)));
+      }
       if (auto AddError = ColtJIT->addModule(std::move(IR)); AddError)
       {
         io::PrintFatal("Could not JIT compile the code!");
@@ -190,7 +371,20 @@ namespace colt
           io::PrintMessage("Running 'main' function...");
         
         auto main_fn = reinterpret_cast<i64(*)()>(main->getValue());
+        if (profiler)
+        {
+          if (auto error = profiler->start(args::GlobalArguments.profile_hz))
+          {
+            io::PrintWarning("Could not start the sampling profiler: {}", error);
+            profiler = nullptr;
+          }
+        }
         i64 ret = main_fn();
+        if (profiler)
+        {
+          profiler->stop();
+          WriteSamplingProfile(*profiler);
+        }
         
         if (print)
           io::PrintMessage("'main' function returned '{}'!", ret);
@@ -198,6 +392,25 @@ namespace colt
       else if (print)
         io::PrintWarning("'main' function was not found!");
     }
+    //The names passed to the profiler were freed with the JIT
+    if (args::GlobalArguments.instrument_functions)
+      runtime::ForgetProfileKeys();
   }  
+#else
+  void RunMain(const std::string& source, bool print) noexcept
+  {
+    if (args::GlobalArguments.profile_hz != 0 && print)
+      io::PrintWarning("'--profile' requires the JIT: compile Colt with LLVM to use it!");
+    if (args::GlobalArguments.jit_huge_pages && print)
+      io::PrintWarning("'--jit-huge-pages' requires the JIT: compile Colt with LLVM to use it!");
+    if (print)
+      io::PrintMessage("Running 'main' function...");
+
+    //Only the low 8 bits of the return value of 'main' are kept by the OS
+    if (auto ret = gen::RunC(source, args::GlobalArguments.opt_level); ret.is_error())
+      io::PrintError("{}", ret.get_error());
+    else if (print)
+      io::PrintMessage("'main' function returned '{}'!", *ret);
+  }
 #endif //!COLT_NO_LLVM
 }
\ No newline at end of file
@@ -18,14 +18,28 @@
 
 #include <util/colt_pch.h>
 #include <ast/colt_ast.h>
+#include <runtime/colt_profiler.h>
+#include <runtime/colt_containers.h>
+#include <runtime/colt_algorithms.h>
+#include <runtime/colt_mapped_file.h>
+#include <runtime/colt_async_io.h>
+#include <runtime/colt_text.h>
+#include <code_gen/c_gen.h>
+#include <lsp/colt_lsp.h>
+#include <interpreter/colt_host_fn.h>
 
 #ifndef COLT_NO_LLVM
   #include <code_gen/llvm_ir_gen.h>
+  #include <code_gen/function_order.h>
   #include <interpreter/colt_JIT.h>
 #endif //!COLT_NO_LLVM
 
 namespace colt
 {
+  /// @brief The functions of the host callable by Colt code (registered in 'main').
+  ///        They are declared in the REPL, and defined as absolute symbols in the JIT.
+  extern gen::HostFnRegistry HostFunctions;
+
   /// @brief Initializes the backend (code generator) of Colt,
   ///        and inserts error message for global allocator
   void InitializeCOLT() noexcept;
@@ -35,21 +49,40 @@ namespace colt
   
   /// @brief Compiles a file, and depending on global arguments, uses the result.
   /// @param path The path of the file to compile
-  void CompileFile(const char* path) noexcept;
+  /// @return False if the file could not be compiled (or an output could not be written)
+  bool CompileFile(const char* path) noexcept;
 
   /// @brief Compiles a string, and depending on global arguments, uses the result.
   /// @param str The StringView to compile
-  void CompileStr(StringView str) noexcept;
+  /// @return False if the string could not be compiled (or an output could not be written)
+  bool CompileStr(StringView str) noexcept;
 
   /// @brief Compiles an Abstract Syntax Tree to IR, and depending on global arguments uses the result.
   /// @param ast The valid AST to compile
-  void CompileAST(const lang::AST& ast) noexcept;
+  /// @return False if the IR could not be generated, if an output could not be written,
+  ///         or if the worst-case stack usage of an entry point exceeds '--stack-budget'
+  bool CompileAST(const lang::AST& ast) noexcept;
+
+  /// @brief Writes the Makefile rule of '--dep-file': the output (object file, C source
+  ///        or compiled file) depends on the compiled file and the files of '@embed'
+  /// @param ast The AST of the compiled file
+  void WriteDepFile(const lang::AST& ast) noexcept;
 
 #ifndef COLT_NO_LLVM
+  /// @brief Writes the profile of a stopped SamplingProfiler to the files whose
+  ///        prefix is specified by 'COLT_PROFILE' (or 'colt_profile')
+  /// @param profiler The profiler whose profile to write
+  void WriteSamplingProfile(gen::SamplingProfiler& profiler) noexcept;
+
   /// @brief Attempts to run the 'main' function from IR
   /// @param IR The IR to compile and in which to search for 'main' symbol
   /// @param print If true, prints messages
   void RunMain(gen::GeneratedIR&& IR, bool print = true) noexcept;
+#else
+  /// @brief Compiles C source code to an executable and runs it
+  /// @param source The C source code which must define 'main'
+  /// @param print If true, prints messages
+  void RunMain(const std::string& source, bool print = true) noexcept;
 #endif //!COLT_NO_LLVM
 }
 
@@ -0,0 +1,538 @@
+/** @file colt_mir.cpp
+* Contains definition of functions declared in 'colt_mir.h'.
+* The passes are defined in 'colt_mir_passes.cpp'.
+*/
+
+#include "colt_mir.h"
+#include <ast/colt_ast.h>
+
+namespace colt::mir
+{
+  namespace
+  {
+    /// @brief Lowers the body of a function to MIR
+    class MIRLowering
+    {
+      /// @brief The function being lowered
+      Function& mir;
+      /// @brief The context in which to create the types of addresses
+      lang::COLTContext& ctx;
+      /// @brief The block in which instructions are appended
+      BlockID current = 0;
+      /// @brief The expression being lowered
+      PTR<const lang::Expr> current_expr;
+      /// @brief Maps the local IDs of the variables in scope to their slots
+      std::vector<SlotID> local_slots = {};
+      /// @brief The blocks to branch to on 'continue' (first) and 'break' (second)
+      std::vector<std::pair<BlockID, BlockID>> loops = {};
+
+    public:
+      /// @brief Lowers a function
+      /// @param mir The MIR in which to lower the function
+      /// @param ctx The context in which to create the types of addresses
+      MIRLowering(Function& mir, lang::COLTContext& ctx) noexcept
+        : mir(mir), ctx(ctx), current_expr(mir.fn)
+      {
+        mir.blocks.emplace_back();
+        //Parameters are copied to slots, as they can be written
+        for (size_t i = 0; i < mir.fn->get_params_count(); i++)
+        {
+          SlotID slot = new_slot(mir.fn->get_params_name()[i], mir.fn->get_params_type()[i]);
+          local_slots.push_back(slot);
+          Instr param = { Opcode::PARAM };
+          param.index = as<u32>(i);
+          param.type = mir.fn->get_params_type()[i];
+          store_slot(slot, emit(std::move(param)));
+        }
+        lower(mir.fn->get_body());
+
+        if (!is_terminated())
+        {
+          //'return' is only missing at the end of 'void' functions
+          if (mir.fn->get_return_type()->is_void())
+            emit({ Opcode::RET });
+          else
+            emit({ Opcode::UNREACHABLE });
+        }
+      }
+
+    private:
+      /// @brief Appends an instruction to the current block
+      /// @param instr The instruction
+      /// @return The ID of the instruction
+      ValueID emit(Instr&& instr) noexcept
+      {
+        //Code following a terminator is unreachable
+        if (is_terminated())
+          current = new_block();
+        instr.expr = current_expr;
+        mir.instrs.push_back(std::move(instr));
+        ValueID id = as<ValueID>(mir.instrs.size() - 1);
+        mir.blocks[current].push_back(id);
+        return id;
+      }
+
+      /// @brief Check if the current block ends with a terminator
+      /// @return True if terminated
+      bool is_terminated() const noexcept
+      {
+        return !mir.blocks[current].empty()
+          && isTerminator(mir.instrs[mir.blocks[current].back()].opcode);
+      }
+
+      /// @brief Creates a new (empty) block
+      /// @return The ID of the block
+      BlockID new_block() noexcept
+      {
+        mir.blocks.emplace_back();
+        return as<BlockID>(mir.blocks.size() - 1);
+      }
+
+      /// @brief Creates a new slot
+      /// @param name The name of the variable
+      /// @param type The type of the variable
+      /// @return The ID of the slot
+      SlotID new_slot(StringView name, PTR<const lang::Type> type) noexcept
+      {
+        mir.slots.push_back({ name, type });
+        return as<SlotID>(mir.slots.size() - 1);
+      }
+
+      /// @brief Branches to a block if the current block is not terminated
+      /// @param to The block to branch to
+      void branch(BlockID to) noexcept
+      {
+        if (is_terminated())
+          return;
+        Instr br = { Opcode::BR };
+        br.index = to;
+        emit(std::move(br));
+      }
+
+      /// @brief Branches on a condition
+      /// @param condition The condition
+      /// @param if_true The block to branch to if true
+      /// @param if_false The block to branch to if false
+      void cond_branch(ValueID condition, BlockID if_true, BlockID if_false) noexcept
+      {
+        Instr br = { Opcode::COND_BR };
+        br.index = if_true;
+        br.index_false = if_false;
+        br.operands = { condition };
+        emit(std::move(br));
+      }
+
+      /// @brief Writes a value to a slot
+      /// @param slot The slot
+      /// @param value The value to write
+      void store_slot(SlotID slot, ValueID value) noexcept
+      {
+        Instr store = { Opcode::SLOT_STORE };
+        store.index = slot;
+        store.operands = { value };
+        emit(std::move(store));
+      }
+
+      /// @brief Reads a slot
+      /// @param slot The slot
+      /// @return The value read
+      ValueID load_slot(SlotID slot) noexcept
+      {
+        Instr load = { Opcode::SLOT_LOAD };
+        load.index = slot;
+        load.type = mir.slots[slot].type;
+        return emit(std::move(load));
+      }
+
+      /// @brief Returns the address of a global variable
+      /// @param name The name of the global variable
+      /// @param type The type of the global variable
+      /// @return The address
+      ValueID global_addr(StringView name, PTR<const lang::Type> type) noexcept
+      {
+        Instr addr = { Opcode::GLOBAL_ADDR };
+        addr.global = name;
+        addr.type = lang::PtrType::CreatePtr(false, type, ctx);
+        return emit(std::move(addr));
+      }
+
+      /// @brief Lowers an expression
+      /// @param expr The expression to lower
+      /// @return The value of the expression, or NoValue for statements
+      ValueID lower(PTR<const lang::Expr> expr) noexcept
+      {
+        using namespace lang;
+
+        ScopedSave save_expr{ current_expr, expr };
+        switch (expr->classof())
+        {
+        case Expr::EXPR_LITERAL:
+        {
+          Instr cst = { Opcode::CONST };
+          cst.value = as<PTR<const LiteralExpr>>(expr)->get_value();
+          cst.type = expr->get_type();
+          return emit(std::move(cst));
+        }
+        break; case Expr::EXPR_UNARY:
+          return lower_unary(as<PTR<const UnaryExpr>>(expr));
+        break; case Expr::EXPR_BINARY:
+          return lower_binary(as<PTR<const BinaryExpr>>(expr));
+        break; case Expr::EXPR_CONVERT:
+        {
+          auto convert = as<PTR<const ConvertExpr>>(expr);
+          Instr cnv = { Opcode::CONVERT };
+          cnv.op = as<u8>(convert->get_conversion_type());
+          cnv.type = convert->get_type();
+          cnv.operands = { lower(convert->get_child()) };
+          return emit(std::move(cnv));
+        }
+        break; case Expr::EXPR_VAR_DECL:
+        {
+          auto decl = as<PTR<const VarDeclExpr>>(expr);
+          assert_true(!decl->is_global(), "Global variables cannot be lowered!");
+          SlotID slot = new_slot(decl->get_name(), decl->get_type());
+          local_slots.push_back(slot);
+          if (decl->get_value() != nullptr)
+            store_slot(slot, lower(decl->get_value()));
+          return NoValue;
+        }
+        break; case Expr::EXPR_VAR_READ:
+        {
+          auto read = as<PTR<const VarReadExpr>>(expr);
+          if (!read->is_global())
+            return load_slot(local_slots[read->get_local_ID()]);
+          Instr load = { Opcode::PTR_LOAD };
+          load.type = read->get_type();
+          load.operands = { global_addr(read->get_name(), read->get_type()) };
+          return emit(std::move(load));
+        }
+        break; case Expr::EXPR_VAR_WRITE:
+        {
+          auto write = as<PTR<const VarWriteExpr>>(expr);
+          ValueID value = lower(write->get_value());
+          if (!write->is_global())
+            store_slot(local_slots[write->get_local_ID()], value);
+          else
+          {
+            Instr store = { Opcode::PTR_STORE };
+            store.operands = { global_addr(write->get_name(), write->get_type()), value };
+            emit(std::move(store));
+          }
+          //The value of an assignment is the value written
+          return value;
+        }
+        break; case Expr::EXPR_FN_CALL:
+        {
+          auto call = as<PTR<const FnCallExpr>>(expr);
+          Instr instr = { Opcode::CALL };
+          instr.callee = call->get_fn_decl();
+          instr.type = call->get_type()->is_void() ? nullptr : call->get_type();
+          for (auto arg : call->get_arguments())
+            instr.operands.push_back(lower(arg));
+          return emit(std::move(instr));
+        }
+        break; case Expr::EXPR_FN_RETURN:
+        {
+          Instr ret = { Opcode::RET };
+          if (auto value = as<PTR<const FnReturnExpr>>(expr)->get_value(); value != nullptr)
+            ret.operands = { lower(value) };
+          emit(std::move(ret));
+          return NoValue;
+        }
+        break; case Expr::EXPR_SCOPE:
+        {
+          //Pop the variables declared in the scope
+          size_t count = local_slots.size();
+          for (auto body_expr : as<PTR<const ScopeExpr>>(expr)->get_body_array())
+            lower(body_expr);
+          local_slots.resize(count);
+          return NoValue;
+        }
+        break; case Expr::EXPR_CONDITION:
+          lower_condition(as<PTR<const ConditionExpr>>(expr));
+          return NoValue;
+        break; case Expr::EXPR_WHILE_LOOP:
+          lower_while_loop(as<PTR<const WhileLoopExpr>>(expr));
+          return NoValue;
+        break; case Expr::EXPR_BREAK_CONTINUE:
+        {
+          assert_true(!loops.empty(), "'break' or 'continue' outside of a loop!");
+          auto [continue_to, break_to] = loops.back();
+          Instr br = { Opcode::BR };
+          br.index = as<PTR<const BreakContinueExpr>>(expr)->is_break() ? break_to : continue_to;
+          emit(std::move(br));
+          return NoValue;
+        }
+        break; case Expr::EXPR_PTR_LOAD:
+        {
+          Instr load = { Opcode::PTR_LOAD };
+          load.type = expr->get_type();
+          load.operands = { lower(as<PTR<const PtrLoadExpr>>(expr)->get_where()) };
+          return emit(std::move(load));
+        }
+        break; case Expr::EXPR_PTR_STORE:
+        {
+          auto ptr_store = as<PTR<const PtrStoreExpr>>(expr);
+          //As in the AST, the value is evaluated before the pointer
+          ValueID value = lower(ptr_store->get_value());
+          Instr store = { Opcode::PTR_STORE };
+          store.operands = { lower(ptr_store->get_where()), value };
+          emit(std::move(store));
+          return value;
+        }
+        break; case Expr::EXPR_EMBED:
+        {
+          Instr embed = { Opcode::EMBED };
+          embed.type = expr->get_type();
+          return emit(std::move(embed));
+        }
+        break; case Expr::EXPR_NOP:
+        case Expr::EXPR_FOR_LOOP:
+          return NoValue;
+        break; default:
+          colt_unreachable("Lowering invalid expression!");
+        }
+      }
+
+      /// @brief Lowers a unary expression
+      /// @param unary The expression to lower
+      /// @return The value of the expression
+      ValueID lower_unary(PTR<const lang::UnaryExpr> unary) noexcept
+      {
+        using namespace lang;
+
+        if (unary->get_operation() == UnaryOperator::OP_ADDRESSOF)
+        {
+          auto var_read = as<PTR<const VarReadExpr>>(unary->get_child());
+          if (var_read->is_global())
+            return global_addr(var_read->get_name(), var_read->get_type());
+          SlotID slot = local_slots[var_read->get_local_ID()];
+          mir.slots[slot].is_address_taken = true;
+          Instr addr = { Opcode::SLOT_ADDR };
+          addr.index = slot;
+          addr.type = unary->get_type();
+          return emit(std::move(addr));
+        }
+        Instr instr = { Opcode::UNARY };
+        instr.op = as<u8>(unary->get_operation());
+        instr.type = unary->get_type();
+        instr.operands = { lower(unary->get_child()) };
+        return emit(std::move(instr));
+      }
+
+      /// @brief Lowers a binary expression.
+      /// '&&' and '||' only evaluate their right hand side if needed.
+      /// @param binary The expression to lower
+      /// @return The value of the expression
+      ValueID lower_binary(PTR<const lang::BinaryExpr> binary) noexcept
+      {
+        using namespace lang;
+
+        auto op = binary->get_operation();
+        if (op == BinaryOperator::OP_BOOL_AND || op == BinaryOperator::OP_BOOL_OR)
+        {
+          //The result is stored in a slot, which the passes can forward
+          SlotID result = new_slot("", binary->get_type());
+          ValueID lhs = lower(binary->get_LHS());
+          store_slot(result, lhs);
+          BlockID rhs_block = new_block();
+          BlockID after = new_block();
+          if (op == BinaryOperator::OP_BOOL_AND)
+            cond_branch(lhs, rhs_block, after);
+          else
+            cond_branch(lhs, after, rhs_block);
+          current = rhs_block;
+          store_slot(result, lower(binary->get_RHS()));
+          branch(after);
+          current = after;
+          return load_slot(result);
+        }
+
+        ValueID lhs = lower(binary->get_LHS());
+        ValueID rhs = lower(binary->get_RHS());
+        Instr instr = { Opcode::BINARY };
+        instr.op = as<u8>(op);
+        instr.type = binary->get_type();
+        instr.operands = { lhs, rhs };
+        return emit(std::move(instr));
+      }
+
+      /// @brief Lowers a conditional expression
+      /// @param condition The expression to lower
+      void lower_condition(PTR<const lang::ConditionExpr> condition) noexcept
+      {
+        ValueID cond = lower(condition->get_if_condition());
+        BlockID if_block = new_block();
+        BlockID else_block = new_block();
+        BlockID after = new_block();
+        cond_branch(cond, if_block, else_block);
+
+        current = if_block;
+        lower(condition->get_if_statement());
+        branch(after);
+
+        current = else_block;
+        if (condition->get_else_statement() != nullptr)
+          lower(condition->get_else_statement());
+        branch(after);
+
+        current = after;
+      }
+
+      /// @brief Lowers a while loop
+      /// @param loop The expression to lower
+      void lower_while_loop(PTR<const lang::WhileLoopExpr> loop) noexcept
+      {
+        BlockID cond_block = new_block();
+        BlockID body = new_block();
+        BlockID after = new_block();
+        branch(cond_block);
+
+        current = cond_block;
+        cond_branch(lower(loop->get_condition()), body, after);
+
+        loops.push_back({ cond_block, after });
+        current = body;
+        lower(loop->get_body());
+        branch(cond_block);
+        loops.pop_back();
+
+        current = after;
+      }
+    };
+
+    /// @brief Appends the name of a type (or 'void' for instructions without results)
+    /// @param to The string to which to append
+    /// @param type The type or nullptr
+    void AppendType(std::string& to, PTR<const lang::Type> type) noexcept
+    {
+      if (type == nullptr)
+        to += "void";
+      else
+        to.append(type->get_name().get_data(), type->get_name().get_size());
+    }
+  }
+
+  const char* OpcodeToString(Opcode opcode) noexcept
+  {
+    switch (opcode)
+    {
+    case Opcode::CONST:
+      return "const";
+    case Opcode::PARAM:
+      return "param";
+    case Opcode::UNARY:
+      return "unary";
+    case Opcode::BINARY:
+      return "binary";
+    case Opcode::CONVERT:
+      return "convert";
+    case Opcode::SLOT_ADDR:
+      return "slot_addr";
+    case Opcode::SLOT_LOAD:
+      return "slot_load";
+    case Opcode::SLOT_STORE:
+      return "slot_store";
+    case Opcode::GLOBAL_ADDR:
+      return "global_addr";
+    case Opcode::PTR_LOAD:
+      return "ptr_load";
+    case Opcode::PTR_STORE:
+      return "ptr_store";
+    case Opcode::CALL:
+      return "call";
+    case Opcode::EMBED:
+      return "embed";
+    case Opcode::BR:
+      return "br";
+    case Opcode::COND_BR:
+      return "cond_br";
+    case Opcode::RET:
+      return "ret";
+    case Opcode::UNREACHABLE:
+      return "unreachable";
+    default:
+      colt_unreachable("Invalid opcode!");
+    }
+  }
+
+  Function Lower(PTR<const lang::FnDefExpr> fn, lang::COLTContext& ctx) noexcept
+  {
+    assert_true(fn->has_body(), "Function should have a body!");
+    Function mir = { fn };
+    MIRLowering lowering = { mir, ctx };
+    return mir;
+  }
+
+  std::string ToString(const Function& fn) noexcept
+  {
+    using namespace lang;
+
+    std::string result = "fn ";
+    result.append(fn.fn->get_name().get_data(), fn.fn->get_name().get_size());
+    result += ":\n";
+    for (size_t i = 0; i < fn.slots.size(); i++)
+    {
+      result += "  slot s" + std::to_string(i) + ' ';
+      result.append(fn.slots[i].name.get_data(), fn.slots[i].name.get_size());
+      result += ": ";
+      AppendType(result, fn.slots[i].type);
+      if (fn.slots[i].is_address_taken)
+        result += " (address taken)";
+      result += '\n';
+    }
+    for (size_t block = 0; block < fn.blocks.size(); block++)
+    {
+      //Unreachable blocks are removed
+      if (fn.blocks[block].empty())
+        continue;
+      result += "bb" + std::to_string(block) + ":\n";
+      for (auto id : fn.blocks[block])
+      {
+        const Instr& instr = fn.instrs[id];
+        result += "  ";
+        if (instr.type != nullptr)
+        {
+          result += '%' + std::to_string(id) + ": ";
+          AppendType(result, instr.type);
+          result += " = ";
+        }
+        result += OpcodeToString(instr.opcode);
+        switch (instr.opcode)
+        {
+        break; case Opcode::CONST:
+          result += ' ' + std::to_string(instr.value.as<u64>());
+        break; case Opcode::PARAM:
+          result += ' ' + std::to_string(instr.index);
+        break; case Opcode::UNARY:
+          result += ' ' + std::to_string(instr.op);
+        break; case Opcode::BINARY:
+          result += ' ';
+          result += BinaryOperatorToString(static_cast<BinaryOperator>(instr.op));
+        break; case Opcode::CONVERT:
+          result += instr.op == ConvertExpr::CNV_AS ? " as" : " bit_as";
+        break; case Opcode::SLOT_ADDR:
+        case Opcode::SLOT_LOAD:
+        case Opcode::SLOT_STORE:
+          result += " s" + std::to_string(instr.index);
+        break; case Opcode::GLOBAL_ADDR:
+          result += ' ';
+          result.append(instr.global.get_data(), instr.global.get_size());
+        break; case Opcode::CALL:
+          result += ' ';
+          result.append(instr.callee->get_name().get_data(), instr.callee->get_name().get_size());
+        break; case Opcode::BR:
+          result += " bb" + std::to_string(instr.index);
+        break; case Opcode::COND_BR:
+          result += " bb" + std::to_string(instr.index) + ", bb" + std::to_string(instr.index_false);
+        break; default:
+          break;
+        }
+        for (auto operand : instr.operands)
+          result += " %" + std::to_string(operand);
+        result += '\n';
+      }
+    }
+    return result;
+  }
+}
@@ -0,0 +1,159 @@
+/** @file colt_mir.h
+* Contains the Colt MIR (mid-level IR), between the AST and LLVM IR.
+* The body of a function is lowered (see 'Lower') to basic blocks of
+* instructions, whose results are SSA values typed by Colt types.
+* Local variables are stack slots, which are only accessed through
+* SLOT_LOAD and SLOT_STORE unless their address is taken: the passes
+* (see 'Optimize') rely on this to forward and remove loads and stores,
+* which LLVM cannot do without running its own optimizations.
+*/
+
+#ifndef HG_COLT_MIR
+#define HG_COLT_MIR
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <util/colt_pch.h>
+#include <ast/colt_expr.h>
+#include <ast/colt_context.h>
+
+/// @brief Contains the Colt mid-level IR and its passes
+namespace colt::mir
+{
+	/// @brief The index of an instruction of a function, which is also the ID of its result
+	using ValueID = u32;
+	/// @brief The index of a basic block of a function (the entry block is 0)
+	using BlockID = u32;
+	/// @brief The index of a stack slot of a function
+	using SlotID = u32;
+
+	/// @brief Represents the absence of a value
+	constexpr ValueID NoValue = std::numeric_limits<ValueID>::max();
+
+	/// @brief The opcode of an instruction
+	enum class Opcode
+		: u8
+	{
+		/// @brief Constant 'value' of the built-in 'type'
+		CONST,
+		/// @brief The parameter 'index' of the function
+		PARAM,
+		/// @brief Unary operation 'op' (UnaryOperator) on operands[0]
+		UNARY,
+		/// @brief Binary operation 'op' (BinaryOperator) on operands[0] and operands[1]
+		BINARY,
+		/// @brief Conversion 'op' (ConvertExpr::ConversionType) of operands[0] to 'type'
+		CONVERT,
+		/// @brief Address of the slot 'index'
+		SLOT_ADDR,
+		/// @brief Reads the slot 'index'
+		SLOT_LOAD,
+		/// @brief Writes operands[0] to the slot 'index'
+		SLOT_STORE,
+		/// @brief Address of the global variable 'global'
+		GLOBAL_ADDR,
+		/// @brief Reads through the pointer operands[0]
+		PTR_LOAD,
+		/// @brief Writes operands[1] through the pointer operands[0]
+		PTR_STORE,
+		/// @brief Calls 'callee' with the operands as arguments
+		CALL,
+		/// @brief Pointer to the content of the embedded file 'expr' (EmbedExpr)
+		EMBED,
+		/// @brief Branches to the block 'index'
+		BR,
+		/// @brief Branches to the block 'index' if operands[0] is true, else to 'index_false'
+		COND_BR,
+		/// @brief Returns operands[0], or nothing if there are no operands
+		RET,
+		/// @brief The end of a function which should have returned
+		UNREACHABLE,
+	};
+
+	/// @brief Converts an opcode to a string
+	/// @param opcode The opcode
+	/// @return The name of the opcode
+	const char* OpcodeToString(Opcode opcode) noexcept;
+
+	/// @brief Check if an opcode ends a basic block
+	/// @param opcode The opcode to check
+	/// @return True if BR, COND_BR, RET or UNREACHABLE
+	constexpr bool isTerminator(Opcode opcode) noexcept
+	{
+		return opcode == Opcode::BR || opcode == Opcode::COND_BR
+			|| opcode == Opcode::RET || opcode == Opcode::UNREACHABLE;
+	}
+
+	/// @brief An instruction of a function
+	struct Instr
+	{
+		/// @brief The opcode
+		Opcode opcode;
+		/// @brief The operator of UNARY, BINARY and CONVERT
+		u8 op = 0;
+		/// @brief The parameter, slot, or block depending on the opcode
+		u32 index = 0;
+		/// @brief The block to branch to if the condition of COND_BR is false
+		u32 index_false = 0;
+		/// @brief The value of CONST
+		QWORD value = {};
+		/// @brief The type of the result, or nullptr if the instruction has no result
+		PTR<const lang::Type> type = nullptr;
+		/// @brief The expression from which the instruction was lowered (for debug locations)
+		PTR<const lang::Expr> expr = nullptr;
+		/// @brief The global variable of GLOBAL_ADDR
+		StringView global = {};
+		/// @brief The function called by CALL
+		PTR<const lang::FnDeclExpr> callee = nullptr;
+		/// @brief The operands (values of the function)
+		std::vector<ValueID> operands = {};
+	};
+
+	/// @brief A stack slot (local variable or parameter)
+	struct Slot
+	{
+		/// @brief The name of the variable
+		StringView name;
+		/// @brief The type of the variable
+		PTR<const lang::Type> type;
+		/// @brief True if the address of the slot is taken (SLOT_ADDR).
+		///        Such slots may be accessed through pointers.
+		bool is_address_taken = false;
+	};
+
+	/// @brief The MIR of a function
+	struct Function
+	{
+		/// @brief The function from which the MIR was lowered
+		PTR<const lang::FnDefExpr> fn;
+		/// @brief All the instructions, indexed by their ValueID.
+		/// Instructions removed by the passes are no longer in any block.
+		std::vector<Instr> instrs = {};
+		/// @brief The instructions of each basic block, in order.
+		/// Unreachable blocks are left empty, so that BlockIDs do not change.
+		std::vector<std::vector<ValueID>> blocks = {};
+		/// @brief The stack slots
+		std::vector<Slot> slots = {};
+	};
+
+	/// @brief Lowers the body of a function to MIR
+	/// @param fn The function (which must have a body)
+	/// @param ctx The context of the AST of the function
+	/// @return The MIR of the function
+	Function Lower(PTR<const lang::FnDefExpr> fn, lang::COLTContext& ctx) noexcept;
+
+	/// @brief Runs the MIR passes on a function:
+	/// forwarding of stores to loads of slots, constant folding (including branches),
+	/// removal of unreachable blocks, dead store and dead code elimination.
+	/// @param fn The function to optimize
+	void Optimize(Function& fn) noexcept;
+
+	/// @brief Converts the MIR of a function to a human readable string
+	/// @param fn The function to print
+	/// @return The MIR as a string
+	std::string ToString(const Function& fn) noexcept;
+}
+
+#endif //!HG_COLT_MIR
@@ -0,0 +1,418 @@
+/** @file colt_mir_passes.cpp
+* Contains the passes run on the MIR (see 'Optimize' in 'colt_mir.h').
+*/
+
+#include "colt_mir.h"
+
+namespace colt::mir
+{
+  namespace
+  {
+    /// @brief Returns the number of bits of an integral built-in type
+    /// @param id The built-in ID
+    /// @return The number of bits, or 0 if not folded by the MIR
+    u32 BitsOf(lang::BuiltInID id) noexcept
+    {
+      using namespace lang;
+
+      switch (id)
+      {
+      case BOOL:
+        return 1;
+      case CHAR:
+      case U8:
+      case I8:
+        return 8;
+      case U16:
+      case I16:
+        return 16;
+      case U32:
+      case I32:
+        return 32;
+      case U64:
+      case I64:
+        return 64;
+      default:
+        return 0;
+      }
+    }
+
+    /// @brief Returns the built-in ID of a type whose values can be folded
+    /// @param type The type (or nullptr)
+    /// @param id The built-in ID of the type (written if true is returned)
+    /// @return True if the type is an integral type of at most 64 bits
+    bool IsFoldable(PTR<const lang::Type> type, lang::BuiltInID& id) noexcept
+    {
+      if (type == nullptr || !type->is_builtin())
+        return false;
+      id = as<PTR<const lang::BuiltInType>>(type)->get_builtin_id();
+      return BitsOf(id) != 0;
+    }
+
+    /// @brief Normalizes an integer: truncated to the bits of its type, then
+    ///        sign-extended if the type is signed.
+    /// @param value The value to normalize
+    /// @param id The built-in ID of the type
+    /// @return The normalized value
+    u64 Normalize(u64 value, lang::BuiltInID id) noexcept
+    {
+      u32 bits = BitsOf(id);
+      if (bits == 64)
+        return value;
+      value &= (u64(1) << bits) - 1;
+      if (lang::is_int(id) && (value >> (bits - 1)) != 0)
+        value |= ~((u64(1) << bits) - 1);
+      return value;
+    }
+
+    /// @brief Folds a binary operation on integers
+    /// @param op The operator
+    /// @param a The (normalized) left hand side
+    /// @param b The (normalized) right hand side
+    /// @param id The built-in ID of the operands
+    /// @param result The result (written if true is returned)
+    /// @return True if folded (false for divisions by zero, overflowing signed divisions and shifts by more than the size)
+    bool FoldBinary(lang::BinaryOperator op, u64 a, u64 b, lang::BuiltInID id, u64& result) noexcept
+    {
+      using namespace lang;
+
+      bool is_signed = is_int(id);
+      //Unsigned values as seen by LLVM (for 'lshr' and unsigned comparisons)
+      u64 ua = BitsOf(id) == 64 ? a : a & ((u64(1) << BitsOf(id)) - 1);
+      u64 ub = BitsOf(id) == 64 ? b : b & ((u64(1) << BitsOf(id)) - 1);
+      switch (op)
+      {
+      break; case BinaryOperator::OP_SUM:
+        result = a + b;
+      break; case BinaryOperator::OP_SUB:
+        result = a - b;
+      break; case BinaryOperator::OP_MUL:
+        result = a * b;
+      break; case BinaryOperator::OP_DIV:
+      case BinaryOperator::OP_MOD:
+        if (b == 0 || (is_signed && static_cast<i64>(b) == -1))
+          return false;
+        if (op == BinaryOperator::OP_DIV)
+          result = is_signed ? static_cast<u64>(static_cast<i64>(a) / static_cast<i64>(b)) : ua / ub;
+        else
+          result = is_signed ? static_cast<u64>(static_cast<i64>(a) % static_cast<i64>(b)) : ua % ub;
+      break; case BinaryOperator::OP_BIT_AND:
+        result = a & b;
+      break; case BinaryOperator::OP_BIT_OR:
+        result = a | b;
+      break; case BinaryOperator::OP_BIT_XOR:
+        result = a ^ b;
+      break; case BinaryOperator::OP_BIT_LSHIFT:
+      case BinaryOperator::OP_BIT_RSHIFT:
+        if (ub >= BitsOf(id))
+          return false;
+        //Right shifts are logical (see 'LLVMIRGenerator::gen_binary')
+        result = op == BinaryOperator::OP_BIT_LSHIFT ? ua << ub : ua >> ub;
+      break; case BinaryOperator::OP_LESS:
+        result = is_signed ? static_cast<i64>(a) < static_cast<i64>(b) : ua < ub;
+      break; case BinaryOperator::OP_LESS_EQUAL:
+        result = is_signed ? static_cast<i64>(a) <= static_cast<i64>(b) : ua <= ub;
+      break; case BinaryOperator::OP_GREAT:
+        result = is_signed ? static_cast<i64>(a) > static_cast<i64>(b) : ua > ub;
+      break; case BinaryOperator::OP_GREAT_EQUAL:
+        result = is_signed ? static_cast<i64>(a) >= static_cast<i64>(b) : ua >= ub;
+      break; case BinaryOperator::OP_EQUAL:
+        result = a == b;
+      break; case BinaryOperator::OP_NOT_EQUAL:
+        result = a != b;
+      break; default:
+        return false;
+      }
+      return true;
+    }
+
+    /// @brief Folds an instruction whose operands are constants into a constant
+    /// @param fn The function containing the instruction
+    /// @param instr The instruction to fold
+    void FoldInstr(Function& fn, Instr& instr) noexcept
+    {
+      using namespace lang;
+
+      if (instr.opcode == Opcode::COND_BR)
+      {
+        const Instr& cond = fn.instrs[instr.operands[0]];
+        if (cond.opcode != Opcode::CONST)
+          return;
+        instr.opcode = Opcode::BR;
+        if ((cond.value.as<u64>() & 1) == 0)
+          instr.index = instr.index_false;
+        instr.operands.clear();
+        return;
+      }
+      if (instr.opcode != Opcode::UNARY && instr.opcode != Opcode::BINARY && instr.opcode != Opcode::CONVERT)
+        return;
+      for (auto operand : instr.operands)
+      {
+        if (fn.instrs[operand].opcode != Opcode::CONST)
+          return;
+      }
+
+      BuiltInID id, result_id;
+      if (!IsFoldable(fn.instrs[instr.operands[0]].type, id) || !IsFoldable(instr.type, result_id))
+        return;
+      u64 a = Normalize(fn.instrs[instr.operands[0]].value.as<u64>(), id);
+      u64 result;
+      switch (instr.opcode)
+      {
+      break; case Opcode::UNARY:
+        switch (static_cast<UnaryOperator>(instr.op))
+        {
+        break; case UnaryOperator::OP_NEGATE:
+          result = 0 - a;
+        break; case UnaryOperator::OP_BIT_NOT:
+        case UnaryOperator::OP_BOOL_NOT:
+          result = ~a;
+        break; default:
+          return;
+        }
+      break; case Opcode::BINARY:
+      {
+        u64 b = Normalize(fn.instrs[instr.operands[1]].value.as<u64>(), id);
+        if (!FoldBinary(static_cast<BinaryOperator>(instr.op), a, b, id, result))
+          return;
+      }
+      break; case Opcode::CONVERT:
+        //Only 'as' conversions between integers are folded
+        if (instr.op != ConvertExpr::CNV_AS)
+          return;
+        result = result_id == BOOL ? a != 0 : a;
+      break; default:
+        return;
+      }
+      instr.opcode = Opcode::CONST;
+      instr.value = QWORD{ Normalize(result, result_id) };
+      instr.operands.clear();
+    }
+
+    /// @brief Empties the blocks that cannot be reached from the entry block
+    /// @param fn The function whose blocks to remove
+    void RemoveUnreachableBlocks(Function& fn) noexcept
+    {
+      std::vector<bool> reachable(fn.blocks.size(), false);
+      std::vector<BlockID> worklist = { 0 };
+      reachable[0] = true;
+      while (!worklist.empty())
+      {
+        BlockID block = worklist.back();
+        worklist.pop_back();
+        if (fn.blocks[block].empty())
+          continue;
+        const Instr& terminator = fn.instrs[fn.blocks[block].back()];
+        auto visit = [&](BlockID to)
+        {
+          if (!reachable[to])
+          {
+            reachable[to] = true;
+            worklist.push_back(to);
+          }
+        };
+        if (terminator.opcode == Opcode::BR || terminator.opcode == Opcode::COND_BR)
+          visit(terminator.index);
+        if (terminator.opcode == Opcode::COND_BR)
+          visit(terminator.index_false);
+      }
+      for (size_t i = 0; i < fn.blocks.size(); i++)
+      {
+        if (!reachable[i])
+          fn.blocks[i].clear();
+      }
+    }
+
+    /// @brief Forwards the values stored in slots (whose address is not taken) to their loads.
+    /// In a block, a load is replaced by the last value stored in the block.
+    /// A slot stored once, in the entry block, is replaced by the stored value in
+    /// the other blocks, as the entry block dominates them.
+    /// @param fn The function whose loads to forward
+    void ForwardSlots(Function& fn) noexcept
+    {
+      //Maps each value to its replacement
+      std::vector<ValueID> replacement(fn.instrs.size());
+      for (size_t i = 0; i < replacement.size(); i++)
+        replacement[i] = as<ValueID>(i);
+      //Values are replaced by values defined before them: one lookup is enough
+      auto resolve = [&](ValueID value) { return replacement[value]; };
+
+      std::vector<u32> store_count(fn.slots.size(), 0);
+      std::vector<ValueID> entry_value(fn.slots.size(), NoValue);
+      for (size_t block = 0; block < fn.blocks.size(); block++)
+      {
+        for (auto id : fn.blocks[block])
+        {
+          if (fn.instrs[id].opcode != Opcode::SLOT_STORE)
+            continue;
+          ++store_count[fn.instrs[id].index];
+          if (block == 0)
+            entry_value[fn.instrs[id].index] = fn.instrs[id].operands[0];
+        }
+      }
+
+      for (size_t block = 0; block < fn.blocks.size(); block++)
+      {
+        std::vector<ValueID> known(fn.slots.size(), NoValue);
+        std::vector<ValueID> body;
+        for (auto id : fn.blocks[block])
+        {
+          Instr& instr = fn.instrs[id];
+          for (auto& operand : instr.operands)
+            operand = resolve(operand);
+          if (instr.opcode == Opcode::SLOT_STORE)
+            known[instr.index] = instr.operands[0];
+          else if (instr.opcode == Opcode::SLOT_LOAD && !fn.slots[instr.index].is_address_taken)
+          {
+            ValueID value = known[instr.index];
+            if (value == NoValue && block != 0 && store_count[instr.index] == 1)
+              value = entry_value[instr.index];
+            if (value != NoValue)
+            {
+              replacement[id] = resolve(value);
+              continue;
+            }
+          }
+          body.push_back(id);
+        }
+        fn.blocks[block] = std::move(body);
+      }
+    }
+
+    /// @brief Folds the instructions whose operands are constants
+    /// @param fn The function whose instructions to fold
+    /// @return True if a branch was folded
+    bool FoldConstants(Function& fn) noexcept
+    {
+      bool folded_branch = false;
+      //Operands are defined before their uses, so folding in order of
+      //definition propagates constants
+      for (auto& instr : fn.instrs)
+      {
+        bool was_cond_br = instr.opcode == Opcode::COND_BR;
+        FoldInstr(fn, instr);
+        folded_branch |= was_cond_br && instr.opcode == Opcode::BR;
+      }
+      return folded_branch;
+    }
+
+    /// @brief Removes the stores to slots (whose address is not taken) which are never read,
+    /// and the stores overwritten in the same block before being read.
+    /// @param fn The function whose dead stores to remove
+    void EliminateDeadStores(Function& fn) noexcept
+    {
+      std::vector<bool> is_read(fn.slots.size(), false);
+      for (const auto& block : fn.blocks)
+      {
+        for (auto id : block)
+        {
+          if (fn.instrs[id].opcode == Opcode::SLOT_LOAD)
+            is_read[fn.instrs[id].index] = true;
+        }
+      }
+
+      for (auto& block : fn.blocks)
+      {
+        std::vector<bool> is_dead(block.size(), false);
+        //The index in the block of the last store to each slot not followed by a load
+        std::vector<size_t> last_store(fn.slots.size(), block.size());
+        for (size_t i = 0; i < block.size(); i++)
+        {
+          const Instr& instr = fn.instrs[block[i]];
+          if (instr.opcode == Opcode::SLOT_LOAD)
+            last_store[instr.index] = block.size();
+          if (instr.opcode != Opcode::SLOT_STORE || fn.slots[instr.index].is_address_taken)
+            continue;
+          if (!is_read[instr.index])
+            is_dead[i] = true;
+          else if (last_store[instr.index] != block.size())
+            is_dead[last_store[instr.index]] = true;
+          last_store[instr.index] = i;
+        }
+        std::vector<ValueID> body;
+        for (size_t i = 0; i < block.size(); i++)
+        {
+          if (!is_dead[i])
+            body.push_back(block[i]);
+        }
+        block = std::move(body);
+      }
+    }
+
+    /// @brief Check if an instruction can be removed if its result is not used
+    /// @param opcode The opcode of the instruction
+    /// @return True if the instruction has no side effects
+    bool IsPure(Opcode opcode) noexcept
+    {
+      switch (opcode)
+      {
+      case Opcode::CONST:
+      case Opcode::PARAM:
+      case Opcode::UNARY:
+      case Opcode::BINARY:
+      case Opcode::CONVERT:
+      case Opcode::SLOT_ADDR:
+      case Opcode::SLOT_LOAD:
+      case Opcode::GLOBAL_ADDR:
+      case Opcode::PTR_LOAD:
+      case Opcode::EMBED:
+        return true;
+      default:
+        return false;
+      }
+    }
+
+    /// @brief Removes the instructions without side effects whose results are not used
+    /// @param fn The function whose dead instructions to remove
+    void EliminateDeadCode(Function& fn) noexcept
+    {
+      std::vector<bool> is_live(fn.instrs.size(), false);
+      std::vector<u32> use_count(fn.instrs.size(), 0);
+      for (const auto& block : fn.blocks)
+      {
+        for (auto id : block)
+        {
+          is_live[id] = true;
+          for (auto operand : fn.instrs[id].operands)
+            ++use_count[operand];
+        }
+      }
+      //Operands are defined before their uses: visiting the
+      //instructions in reverse removes chains of dead instructions
+      for (size_t i = fn.instrs.size(); i-- != 0;)
+      {
+        if (!is_live[i] || use_count[i] != 0 || !IsPure(fn.instrs[i].opcode))
+          continue;
+        is_live[i] = false;
+        for (auto operand : fn.instrs[i].operands)
+          --use_count[operand];
+      }
+      for (auto& block : fn.blocks)
+      {
+        std::vector<ValueID> body;
+        for (auto id : block)
+        {
+          if (is_live[id])
+            body.push_back(id);
+        }
+        block = std::move(body);
+      }
+    }
+  }
+
+  void Optimize(Function& fn) noexcept
+  {
+    RemoveUnreachableBlocks(fn);
+    ForwardSlots(fn);
+    //Folding a branch can make blocks unreachable, whose
+    //stores no longer prevent forwarding
+    if (FoldConstants(fn))
+    {
+      RemoveUnreachableBlocks(fn);
+      ForwardSlots(fn);
+      FoldConstants(fn);
+    }
+    EliminateDeadStores(fn);
+    EliminateDeadCode(fn);
+  }
+}
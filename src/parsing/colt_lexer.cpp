@@ -12,6 +12,7 @@ namespace colt::lang
 		if (strv.is_empty())
 			to_scan = "";
 		assert_true(strv.get_back() == '\0', "The StringView should be NUL-terminated!");
+		invalid_utf8 = ValidateUTF8(to_scan);
 	}
 	
 	Lexer::LineInformations Lexer::get_line_info() const noexcept
@@ -21,8 +22,13 @@ namespace colt::lang
 
 	Token Lexer::get_next_token() noexcept
 	{
+		using namespace details;
+
+		if (invalid_utf8 != nullptr)
+			return handle_invalid_utf8();
+
 		//We skip spaces
-		while (isSpace(current_char))
+		while (getCharClass(current_char) == CHAR_SPACE)
 		{
 			//We increment the line number if the token being parsed is NOT an TKN_EOF
 			//TKN_EOF is returned if a '\0' is found
@@ -34,78 +40,28 @@ namespace colt::lang
 		//we store the current offset, which is the beginning of the current lexeme
 		lexeme_begin = offset - 1;
 
-		if (isAlpha(current_char) || current_char == '_')
+		switch (getCharClass(current_char))
+		{
+		case CHAR_IDENTIFIER:
 			return handle_identifier();
-		else if (isDigit(current_char))
+		case CHAR_DIGIT:
 			return handle_digit();
-
-		switch (current_char)
-		{
-		case '+':
-			return handle_plus();
-		case '-':
-			return handle_minus();
-		case '*':
-			return handle_star();
-		case '/':
+		case CHAR_OPERATOR:
+			return handle_operator();
+		case CHAR_SLASH:
 			return handle_slash();
-		case '.':
+		case CHAR_DOT:
 			return handle_dot();
-		case '<':
-			return handle_less();
-		case '>':
-			return handle_great();
-		case '&':
-			return handle_and();
-		case '|':
-			return handle_or();
-		case '^':
-			return handle_caret();
-		case '=':
-			return handle_equal();
-		case '!':
-			return handle_bang();
-		case '%':
-			return handle_percent();
-		case '"':
+		case CHAR_STRING:
 			return handle_string_literal();
-		case '\'':
+		case CHAR_CHAR:
 			return handle_char_literal();
-		case ':':
-			current_char = get_next_char();
-			return TKN_COLON;
-		case '~':
-			current_char = get_next_char();
-			return TKN_TILDE;
-		case ',':
-			current_char = get_next_char();
-			return TKN_COMMA;
-		case '{':
-			current_char = get_next_char();
-			return TKN_LEFT_CURLY;
-		case '}':
-			current_char = get_next_char();
-			return TKN_RIGHT_CURLY;
-		case '(':
-			current_char = get_next_char();
-			return TKN_LEFT_PAREN;
-		case ')':
-			current_char = get_next_char();
-			return TKN_RIGHT_PAREN;
-		case '[':
-			current_char = get_next_char();
-			return TKN_LEFT_SQUARE;
-		case ']':
-			current_char = get_next_char();
-			return TKN_RIGHT_SQUARE;
-		case ';':
-			current_char = get_next_char();
-			return TKN_SEMICOLON;
-		case '@':
+		case CHAR_AT:
 			return handle_at();
-		case '\0':
-		case EOF:
+		case CHAR_EOF:
 			return TKN_EOF;
+		case CHAR_UTF8:
+			return handle_non_ascii();
 		default:
 			gen_error(get_current_lexeme(), "Invalid character!");
 			current_char = get_next_char();
@@ -123,6 +79,7 @@ namespace colt::lang
 		line_begin_new = 0;
 		current_line = 1;
 		current_char = ' ';
+		invalid_utf8 = ValidateUTF8(to_scan);
 	}
 	
 	StringView Lexer::get_line_strv() const noexcept
@@ -179,24 +136,76 @@ namespace colt::lang
 
 	Token Lexer::handle_identifier() noexcept
 	{
-		//Clear the string
-		temp_str.clear();
-		temp_str += current_char;
-
 		//Save start of the identifier
-		const char* ident_start = to_scan.get_data() + offset - 1;
+		const char* ident_start = to_scan.get_data() + lexeme_begin;
 
-		current_char = get_next_char();
-		while (isAlnum(current_char) || current_char == '_')
+		//Identifiers never contain a '\n' nor the NUL-terminator, so we
+		//can scan the string directly without going through get_next_char.
+		size_t ident_end = offset;
+		for (;;)
 		{
-			temp_str += current_char;
-			current_char = get_next_char();
+			char chr = to_scan[ident_end];
+			if (details::isIdentifierChar(chr))
+				++ident_end;
+			else if (details::getCharClass(chr) == details::CHAR_UTF8)
+			{
+				u8 size;
+				if (!isUnicodeIdentifierContinue(DecodeUTF8(to_scan.get_data() + ident_end, size)))
+					break;
+				ident_end += size;
+			}
+			else
+				break;
 		}
+		offset = ident_end;
+		current_char = get_next_char();
 
 		//Save the parsed identifier
-		parsed_identifier = { ident_start, to_scan.get_data() + offset - 1};
+		parsed_identifier = { ident_start, to_scan.get_data() + ident_end };
 		return get_identifier_or_keyword();
 	}
+
+	Token Lexer::handle_non_ascii() noexcept
+	{
+		u8 size;
+		u32 code_point = DecodeUTF8(to_scan.get_data() + lexeme_begin, size);
+		//Skip the whole UTF-8 sequence
+		offset = lexeme_begin + size;
+		if (isUnicodeIdentifierStart(code_point))
+			return handle_identifier();
+		
+		current_char = get_next_char();
+		gen_error(get_current_lexeme(), "Invalid character!");
+		return TKN_ERROR;
+	}
+
+	Token Lexer::handle_invalid_utf8() noexcept
+	{
+		//Find the line containing the invalid sequence
+		u32 line_nb = 1;
+		const char* line_begin = to_scan.get_data();
+		for (const char* ptr = line_begin; ptr != invalid_utf8; ++ptr)
+		{
+			if (*ptr == '\n')
+			{
+				++line_nb;
+				line_begin = ptr + 1;
+			}
+		}
+		const char* line_end = invalid_utf8;
+		while (*line_end != '\n' && *line_end != '\0')
+			++line_end;
+
+		GenerateError(SourceCodeExprInfo{ line_nb, line_nb, { line_begin, line_end }, { invalid_utf8, invalid_utf8 + 1 } },
+			"Invalid UTF-8 encoding!");
+		
+		//Stop lexing: the next token will be TKN_EOF
+		lexeme_begin = invalid_utf8 - to_scan.get_data();
+		offset = lexeme_begin + 2;
+		invalid_utf8 = nullptr;
+		current_char = EOF;
+		return TKN_ERROR;
+	}
 	
 	Token Lexer::handle_digit() noexcept
 	{
@@ -390,60 +399,35 @@ namespace colt::lang
 		return TKN_CHAR_L;
 	}
 	
-	Token Lexer::handle_plus() noexcept
-	{
-		current_char = get_next_char();
-		switch (current_char)
-		{
-		case '=':
-			current_char = get_next_char();
-			return TKN_PLUS_EQUAL;
-		case '+':
-			current_char = get_next_char();
-			return TKN_PLUS_PLUS;
-		default:
-			return TKN_PLUS;
-		}
-	}
-	
-	Token Lexer::handle_minus() noexcept
+	Token Lexer::handle_operator() noexcept
 	{
-		current_char = get_next_char();
-		switch (current_char)
-		{
-		case '=':
-			current_char = get_next_char();
-			return TKN_MINUS_EQUAL;
-		case '-':
-			current_char = get_next_char();
-			return TKN_MINUS_MINUS;
-		case '>':
-			current_char = get_next_char();
-			return TKN_MINUS_GREAT;
-		default:
-			return TKN_MINUS;
-		}
-	}
-	
-	Token Lexer::handle_star() noexcept
-	{
-		current_char = get_next_char();
-		if (current_char == '=')
+		using namespace details;
+
+		auto& dfa = OperatorStateMachine;
+		u8 state = dfa.transitions[0][dfa.column[as<u8>(current_char)]];
+		assert_true(state != 0, "Character does not start an operator!");
+		//Operators are lexed greedily: we stop on the first character
+		//that does not have a transition from the current state.
+		for (;;)
 		{
 			current_char = get_next_char();
-			return TKN_STAR_EQUAL;
+			u8 next_state = dfa.transitions[state][dfa.column[as<u8>(current_char)]];
+			if (next_state == 0)
+				return dfa.accept[state];
+			state = next_state;
 		}
-		return TKN_STAR;
 	}
-	
+
 	Token Lexer::handle_slash() noexcept
 	{
+		char after_slash = peek_next_char();
+		if (after_slash != '/' && after_slash != '*')
+			return handle_operator();
+
+		//Consume the '/'
 		current_char = get_next_char();
 		switch (current_char)
 		{
-		case '=':
-			current_char = get_next_char();
-			return TKN_SLASH_EQUAL;
 		case '/': // one line comment
 		{
 			current_char = get_next_char();
@@ -482,49 +466,10 @@ namespace colt::lang
 			return TKN_EOF; //Compilation should fail directly
 		}
 		default:
-			return TKN_SLASH;
+			colt_unreachable("Expected a comment!");
 		}
 	}
 	
-	Token Lexer::handle_percent() noexcept
-	{
-		current_char = get_next_char();
-		if (current_char == '=')
-		{
-			current_char = get_next_char();
-			return TKN_PERCENT_EQUAL;
-		}
-		return TKN_PERCENT;
-	}
-	
-	Token Lexer::handle_equal() noexcept
-	{
-		current_char = get_next_char();
-		switch (current_char)
-		{
-		case '=':
-			current_char = get_next_char();
-			return TKN_EQUAL_EQUAL;
-		case '>':
-			current_char = get_next_char();
-			return TKN_EQUAL_GREAT;
-
-		default:
-			return TKN_EQUAL;
-		}
-	}
-	
-	Token Lexer::handle_bang() noexcept
-	{
-		current_char = get_next_char();
-		if (current_char == '=')
-		{
-			current_char = get_next_char();
-			return TKN_BANG_EQUAL;
-		}
-		return TKN_BANG;
-	}
-	
 	Token Lexer::handle_dot() noexcept
 	{
 		current_char = get_next_char();
@@ -564,97 +509,21 @@ namespace colt::lang
 		return TKN_DOT;
 	}
 	
-	Token Lexer::handle_less() noexcept
-	{
-		current_char = get_next_char();
-		switch (current_char)
-		{
-		case '=':
-			current_char = get_next_char();
-			return TKN_LESS_EQUAL;
-		case '<':
-			current_char = get_next_char();
-			if (current_char == '=')
-			{
-				current_char = get_next_char();
-				return TKN_LESS_LESS_EQUAL;
-			}
-			return TKN_LESS_LESS;
-		default:
-			return TKN_LESS;
-		}
-	}
-	
-	Token Lexer::handle_great() noexcept
-	{
-		current_char = get_next_char();
-		switch (current_char)
-		{
-		case '=':
-			current_char = get_next_char();
-			return TKN_GREAT_EQUAL;
-		case '>':
-			current_char = get_next_char();
-			if (current_char == '=')
-			{
-				current_char = get_next_char();
-				return TKN_GREAT_GREAT_EQUAL;
-			}
-			return TKN_GREAT_GREAT;
-		default:
-			return TKN_GREAT;
-		}
-	}
-	
-	Token Lexer::handle_and() noexcept
-	{
-		current_char = get_next_char();
-		switch (current_char)
-		{
-		break; case '=':
-			current_char = get_next_char();
-			return TKN_AND_EQUAL;
-		break; case '&':
-			current_char = get_next_char();
-			return TKN_AND_AND;
-		break; default:
-			return TKN_AND;
-		}
-	}
-	
-	Token Lexer::handle_or() noexcept
-	{
-		current_char = get_next_char();
-		switch (current_char)
-		{
-		break; case '=':
-			current_char = get_next_char();
-			return TKN_OR_EQUAL;
-		break; case '|':
-			current_char = get_next_char();
-			return TKN_OR_OR;
-		break; default:
-			return TKN_OR;
-		}
-	}
-	
-	Token Lexer::handle_caret() noexcept
+	Token Lexer::handle_at() noexcept
 	{
+		temp_str.clear();
+		//The name of the directive can contain '_'
 		current_char = get_next_char();
-		switch (current_char)
+		while (details::isIdentifierChar(current_char))
 		{
-		break; case '=':
+			temp_str += current_char;
 			current_char = get_next_char();
-			return TKN_CARET_EQUAL;
-		break; default:
-			return TKN_CARET;
 		}
-	}
-
-	Token Lexer::handle_at() noexcept
-	{
-		temp_str.clear();
-		current_char = parse_alnum();
+		//'@embed' and '@embed_count' are parsed as expressions
+		if (temp_str == "embed")
+			return TKN_KEYWORD_EMBED;
+		if (temp_str == "embed_count")
+			return TKN_KEYWORD_EMBED_COUNT;
 		if (temp_str == "line")
 		{
 			Token tkn;
@@ -822,121 +691,14 @@ namespace colt::lang
 
 	Token Lexer::get_identifier_or_keyword() noexcept
 	{
-		if (temp_str.get_size() == 1)
+		//There are no keywords of 1 character
+		if (parsed_identifier.get_size() == 1)
 			return TKN_IDENTIFIER;
 
-		//GlobalTable of keywords
-		//We optimize comparisons by comparing the first character
-		switch (temp_str[0])
-		{
-		break; case 'a':
-			if (temp_str == "and")
-				return TKN_AND_AND;
-			else if (temp_str == "as")
-				return TKN_KEYWORD_AS;
-		break; case 'b':
-			if (temp_str == "break")
-				return TKN_KEYWORD_BREAK;
-			else if (temp_str == "bool")
-				return TKN_KEYWORD_BOOL;
-			else if (temp_str == "bit_as")
-				return TKN_KEYWORD_BIT_AS;
-		break; case 'c':
-			if (temp_str == "char")
-				return TKN_KEYWORD_CHAR;
-			else if (temp_str == "case")
-				return TKN_KEYWORD_CASE;
-			else if (temp_str == "const")
-				return TKN_KEYWORD_CONST;
-			else if (temp_str == "continue")
-				return TKN_KEYWORD_CONTINUE;
-		break; case 'd':
-			if (temp_str == "double")
-				return TKN_KEYWORD_DOUBLE;
-			else if (temp_str == "default")
-				return TKN_KEYWORD_DEFAULT;
-		break; case 'e':
-			if (temp_str == "elif")
-				return TKN_KEYWORD_ELIF;
-			else if (temp_str == "else")
-				return TKN_KEYWORD_ELSE;
-			else if (temp_str == "extern")
-				return TKN_KEYWORD_EXTERN;
-		break; case 'f':
-			if (temp_str == "for")
-				return TKN_KEYWORD_FOR;
-			else if (temp_str == "fn")
-				return TKN_KEYWORD_FN;
-			else if (temp_str == "false")
-			{
-				parsed_value = false;
-				return TKN_BOOL_L;
-			}
-			else if (temp_str == "float")
-				return TKN_KEYWORD_FLOAT;
-		break; case 'g':
-			if (temp_str == "goto")
-				return TKN_KEYWORD_GOTO;
-		break; case 'i':
-			if (temp_str == "if")
-				return TKN_KEYWORD_IF;
-			else if (temp_str == "i8")
-				return TKN_KEYWORD_I8;
-			else if (temp_str == "i16")
-				return TKN_KEYWORD_I16;
-			else if (temp_str == "i32")
-				return TKN_KEYWORD_I32;
-			else if (temp_str == "i64")
-				return TKN_KEYWORD_I64;
-		break; case 'l':
-			if (temp_str == "lstring")
-				return TKN_KEYWORD_LSTRING;
-		break; case 'o':
-			if (temp_str == "or")
-				return TKN_OR_OR;
-		break; case 'm':
-			if (temp_str == "mut")
-				return TKN_KEYWORD_MUT;
-		break; case 'P':
-			if (temp_str == "PTR")
-				return TKN_KEYWORD_PTR;
-		break; case 'r':
-			if (temp_str == "return")
-				return TKN_KEYWORD_RETURN;
-		break; case 's':
-			if (temp_str == "switch")
-				return TKN_KEYWORD_SWITCH;
-			else if (temp_str == "sizeof")
-				return TKN_KEYWORD_SIZEOF;
-		break; case 't':
-			if (temp_str == "true")
-			{
-				parsed_value = true;
-				return TKN_BOOL_L;
-			}
-			else if (temp_str == "typeof")
-				return TKN_KEYWORD_TYPEOF;
-		break; case 'u':
-			if (temp_str == "u8")
-				return TKN_KEYWORD_U8;
-			else if (temp_str == "u16")
-				return TKN_KEYWORD_U16;
-			else if (temp_str == "u32")
-				return TKN_KEYWORD_U32;
-			else if (temp_str == "u64")
-				return TKN_KEYWORD_U64;
-		break; case 'w':
-			if (temp_str == "while")
-				return TKN_KEYWORD_WHILE;
-		break; case 'v':
-			if (temp_str == "var")
-				return TKN_KEYWORD_VAR;
-			else if (temp_str == "void")
-				return TKN_KEYWORD_VOID;
-		break; default:
-			return TKN_IDENTIFIER;
-		}
-		return TKN_IDENTIFIER;
+		Token tkn = details::KeywordTable.find(parsed_identifier);
+		if (tkn == TKN_BOOL_L) //true or false
+			parsed_value = parsed_identifier[0] == 't';
+		return tkn;
 	}
 
 	Token Lexer::get_floating_suffix() noexcept
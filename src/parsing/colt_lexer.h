@@ -7,6 +7,8 @@
 
 #include <util/colt_pch.h>
 #include <parsing/colt_token.h>
+#include <parsing/colt_lexer_table.h>
+#include <parsing/colt_unicode.h>
 #include <parsing/colt_error_report.h>
 
 
@@ -17,7 +19,7 @@ namespace colt::lang
 	{
 		/// @brief The string view to scan
 		StringView to_scan = {};
-		/// @brief The currently parsed lexeme
+		/// @brief The last parsed identifier or keyword (a span of 'to_scan')
 		StringView parsed_identifier = {};
 		/// @brief The last parsed literal value
 		QWORD parsed_value = {};
@@ -41,6 +43,9 @@ namespace colt::lang
 		/// @brief The cached line StringView
 		mutable StringView cached_line_strv = {};
 		
+		/// @brief Pointer to the first invalid UTF-8 sequence, or nullptr
+		const char* invalid_utf8 = nullptr;
+
 		/// @brief The current char, which is the one to parse next
 		char current_char = ' ';
 		/// @brief If true, next call of get_next_token should increment 'current_line'
@@ -125,9 +130,17 @@ namespace colt::lang
 		/// @return The character 'offset + 1' after the current one
 		char peek_next_char(uint64_t offset = 0) const noexcept;
 		
-		/// @brief Handles identifiers and keywords 
+		/// @brief Handles identifiers and keywords, setting 'parsed_identifier'
+		///        to their span in 'to_scan' (without copying them)
 		Token handle_identifier() noexcept;
 
+		/// @brief Handles non-ASCII characters, which can start an identifier
+		Token handle_non_ascii() noexcept;
+
+		/// @brief Reports the invalid UTF-8 sequence and stops lexing
+		/// @return TKN_ERROR
+		Token handle_invalid_utf8() noexcept;
+
 		/// @brief Handles floating points, integer (0[xbo])
 		Token handle_digit() noexcept;
 
@@ -137,53 +150,23 @@ namespace colt::lang
 		/// @brief Handles '.' 
 		Token handle_char_literal() noexcept;
 
-		/// @brief Handles +, +=, ++
-		Token handle_plus() noexcept;
+		/// @brief Handles all the operators, using the operator automaton
+		Token handle_operator() noexcept;
 
-		/// @brief Handles -, -=, --
-		Token handle_minus() noexcept;
-		
-		/// @brief Handles *, *=			
-		Token handle_star() noexcept;
-
-		/// @brief Handles /, /= and comments
+		/// @brief Handles comments, or '/' and '/=' through handle_operator
 		Token handle_slash() noexcept;
 
-		/// @brief Handles %, &=
-		Token handle_percent() noexcept;
-
-		/// @brief Handles = and ==
-		Token handle_equal() noexcept;
-
-		/// @brief Handles ! and !=
-		Token handle_bang() noexcept;
-
 		/// @brief Handles . which can be a dot or a float 
 		Token handle_dot() noexcept;
 
-		/// @brief Handles <, <=, <<, <<=
-		Token handle_less() noexcept;
-
-		/// @brief Handles >, >=, >>, >>=
-		Token handle_great() noexcept;
-
-		/// @brief Handles &, &=, &&
-		Token handle_and() noexcept;
-
-		/// @brief Handles |, |=, ||
-		Token handle_or() noexcept;
-
-		/// @brief Handles ^, ^=
-		Token handle_caret() noexcept;
-
 		/// @brief Handles '@' 
 		Token handle_at() noexcept;
 
-		/// @brief Parses digits greedily, storing in temp_str
+		/// @brief Parses digits greedily, appending them to temp_str (for numeric literals)
 		/// @return The first non-digit char
 		char parse_digits() noexcept;
 
-		/// @brief Parses alphanumerics greedily, storing in temp_str
+		/// @brief Parses alphanumerics greedily, appending them to temp_str (for numeric literals)
 		/// @return The first non-alphanumeric char
 		char parse_alnum() noexcept;
 
@@ -214,7 +197,7 @@ namespace colt::lang
 		/// @return Any floating token
 		Token get_floating_suffix() noexcept;
 
-		/// @brief Handles the content of 'temp_str' checking if it contains a keyword or is an identifier.
+		/// @brief Checks if 'parsed_identifier' (the span of the identifier in 'to_scan') is a keyword.
 		/// @return Any keyword token or TKN_IDENTIFIER
 		Token get_identifier_or_keyword() noexcept;
 
@@ -0,0 +1,347 @@
+/** @file colt_lexer_table.h
+* Contains the tables used by the Lexer, generated at compile time from
+* a declarative description of the operators and keywords of Colt.
+*/
+
+#ifndef HG_COLT_LEXER_TABLE
+#define HG_COLT_LEXER_TABLE
+
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <util/colt_pch.h>
+#include <parsing/colt_token.h>
+
+namespace colt::lang::details
+{
+	/// @brief The class of a character, which decides which function of
+	/// the Lexer handles the lexeme starting with that character.
+	enum CharClass
+		: u8
+	{
+		/// @brief Any character that cannot start a lexeme
+		CHAR_INVALID,
+		/// @brief ' ', '\\t', '\\n', '\\v', '\\f', '\\r'
+		CHAR_SPACE,
+		/// @brief [a-zA-Z_]
+		CHAR_IDENTIFIER,
+		/// @brief [0-9]
+		CHAR_DIGIT,
+		/// @brief Any character starting an operator (except '/')
+		CHAR_OPERATOR,
+		/// @brief '/', which can start a comment
+		CHAR_SLASH,
+		/// @brief '.', which can start a floating point literal
+		CHAR_DOT,
+		/// @brief '"'
+		CHAR_STRING,
+		/// @brief '\''
+		CHAR_CHAR,
+		/// @brief '@'
+		CHAR_AT,
+		/// @brief '\\0' or EOF
+		CHAR_EOF,
+		/// @brief Any byte of a non-ASCII UTF-8 sequence
+		CHAR_UTF8,
+	};
+
+	/// @brief Associates a lexeme to the Token it represents
+	struct LexemeSpec
+	{
+		/// @brief The NUL-terminated lexeme
+		const char* lexeme;
+		/// @brief The Token of the lexeme
+		Token token;
+	};
+
+	/// @brief The operators (and punctuation) of Colt.
+	/// Operators are lexed greedily (the longest match wins), and every prefix
+	/// of an operator must itself be an operator (which is checked at compile time).
+	/// '.' is not part of this table as it can start a floating point literal.
+	static constexpr LexemeSpec OperatorSpec[] = {
+		{ "+", TKN_PLUS }, { "+=", TKN_PLUS_EQUAL }, { "++", TKN_PLUS_PLUS },
+		{ "-", TKN_MINUS }, { "-=", TKN_MINUS_EQUAL }, { "--", TKN_MINUS_MINUS }, { "->", TKN_MINUS_GREAT },
+		{ "*", TKN_STAR }, { "*=", TKN_STAR_EQUAL },
+		{ "/", TKN_SLASH }, { "/=", TKN_SLASH_EQUAL },
+		{ "%", TKN_PERCENT }, { "%=", TKN_PERCENT_EQUAL },
+		{ "=", TKN_EQUAL }, { "==", TKN_EQUAL_EQUAL }, { "=>", TKN_EQUAL_GREAT },
+		{ "!", TKN_BANG }, { "!=", TKN_BANG_EQUAL },
+		{ "<", TKN_LESS }, { "<=", TKN_LESS_EQUAL }, { "<<", TKN_LESS_LESS }, { "<<=", TKN_LESS_LESS_EQUAL },
+		{ ">", TKN_GREAT }, { ">=", TKN_GREAT_EQUAL }, { ">>", TKN_GREAT_GREAT }, { ">>=", TKN_GREAT_GREAT_EQUAL },
+		{ "&", TKN_AND }, { "&=", TKN_AND_EQUAL }, { "&&", TKN_AND_AND },
+		{ "|", TKN_OR }, { "|=", TKN_OR_EQUAL }, { "||", TKN_OR_OR },
+		{ "^", TKN_CARET }, { "^=", TKN_CARET_EQUAL },
+		{ ":", TKN_COLON }, { "~", TKN_TILDE }, { ",", TKN_COMMA }, { ";", TKN_SEMICOLON },
+		{ "{", TKN_LEFT_CURLY }, { "}", TKN_RIGHT_CURLY },
+		{ "(", TKN_LEFT_PAREN }, { ")", TKN_RIGHT_PAREN },
+		{ "[", TKN_LEFT_SQUARE }, { "]", TKN_RIGHT_SQUARE },
+	};
+
+	/// @brief The keywords of Colt.
+	/// 'true' and 'false' are both TKN_BOOL_L: the Lexer sets the parsed value.
+	static constexpr LexemeSpec KeywordSpec[] = {
+		{ "and", TKN_AND_AND }, { "or", TKN_OR_OR },
+		{ "true", TKN_BOOL_L }, { "false", TKN_BOOL_L },
+		{ "as", TKN_KEYWORD_AS }, { "bit_as", TKN_KEYWORD_BIT_AS },
+		{ "break", TKN_KEYWORD_BREAK }, { "continue", TKN_KEYWORD_CONTINUE },
+		{ "case", TKN_KEYWORD_CASE }, { "default", TKN_KEYWORD_DEFAULT }, { "switch", TKN_KEYWORD_SWITCH },
+		{ "const", TKN_KEYWORD_CONST }, { "mut", TKN_KEYWORD_MUT }, { "var", TKN_KEYWORD_VAR },
+		{ "if", TKN_KEYWORD_IF }, { "elif", TKN_KEYWORD_ELIF }, { "else", TKN_KEYWORD_ELSE },
+		{ "for", TKN_KEYWORD_FOR }, { "while", TKN_KEYWORD_WHILE }, { "goto", TKN_KEYWORD_GOTO },
+		{ "fn", TKN_KEYWORD_FN }, { "extern", TKN_KEYWORD_EXTERN }, { "return", TKN_KEYWORD_RETURN },
+		{ "sizeof", TKN_KEYWORD_SIZEOF }, { "typeof", TKN_KEYWORD_TYPEOF },
+		{ "void", TKN_KEYWORD_VOID }, { "bool", TKN_KEYWORD_BOOL }, { "char", TKN_KEYWORD_CHAR },
+		{ "i8", TKN_KEYWORD_I8 }, { "i16", TKN_KEYWORD_I16 }, { "i32", TKN_KEYWORD_I32 }, { "i64", TKN_KEYWORD_I64 },
+		{ "u8", TKN_KEYWORD_U8 }, { "u16", TKN_KEYWORD_U16 }, { "u32", TKN_KEYWORD_U32 }, { "u64", TKN_KEYWORD_U64 },
+		{ "float", TKN_KEYWORD_FLOAT }, { "double", TKN_KEYWORD_DOUBLE },
+		{ "lstring", TKN_KEYWORD_LSTRING }, { "PTR", TKN_KEYWORD_PTR },
+	};
+
+	/// @brief Returns the size of a NUL-terminated string
+	/// @param str The string
+	/// @return The size of the string
+	constexpr size_t constexpr_strlen(const char* str) noexcept
+	{
+		size_t size = 0;
+		while (str[size] != '\0')
+			++size;
+		return size;
+	}
+
+	/// @brief Generates the table mapping each byte to its CharClass
+	/// @return The CharClass table
+	constexpr std::array<CharClass, 256> GenerateCharClassTable() noexcept
+	{
+		std::array<CharClass, 256> table = {};
+		for (size_t i = 0; i < 256; i++)
+		{
+			if (('a' <= i && i <= 'z') || ('A' <= i && i <= 'Z') || i == '_')
+				table[i] = CHAR_IDENTIFIER;
+			else if ('0' <= i && i <= '9')
+				table[i] = CHAR_DIGIT;
+			else if (i == ' ' || ('\t' <= i && i <= '\r'))
+				table[i] = CHAR_SPACE;
+			else if (i >= 0x80)
+				table[i] = CHAR_UTF8;
+			else
+				table[i] = CHAR_INVALID;
+		}
+		for (auto& spec : OperatorSpec)
+			table[static_cast<u8>(spec.lexeme[0])] = CHAR_OPERATOR;
+		table[static_cast<u8>('/')] = CHAR_SLASH;
+		table[static_cast<u8>('.')] = CHAR_DOT;
+		table[static_cast<u8>('"')] = CHAR_STRING;
+		table[static_cast<u8>('\'')] = CHAR_CHAR;
+		table[static_cast<u8>('@')] = CHAR_AT;
+		table[static_cast<u8>('\0')] = CHAR_EOF;
+		//EOF (-1) as returned by Lexer::get_next_char.
+		//0xFF is never part of valid UTF-8.
+		table[static_cast<u8>(EOF)] = CHAR_EOF;
+		return table;
+	}
+
+	/// @brief Table mapping each byte to its CharClass
+	static constexpr std::array<CharClass, 256> CharClassTable = GenerateCharClassTable();
+
+	/// @brief Returns the CharClass of a character
+	/// @param chr The character
+	/// @return The class of the character
+	constexpr CharClass getCharClass(char chr) noexcept
+	{
+		return CharClassTable[static_cast<u8>(chr)];
+	}
+
+	/// @brief Check if a character can continue an identifier
+	/// @param chr The character
+	/// @return True if [a-zA-Z0-9_]
+	constexpr bool isIdentifierChar(char chr) noexcept
+	{
+		auto cls = getCharClass(chr);
+		return cls == CHAR_IDENTIFIER || cls == CHAR_DIGIT;
+	}
+
+	/// @brief Returns the number of states needed to recognize all the operators
+	/// @return The number of nodes in the trie of all the operators
+	constexpr size_t getOperatorStateCount() noexcept
+	{
+		//The root, and one state per lexeme: as each prefix of an operator
+		//is also an operator, no other state is needed.
+		return std::size(OperatorSpec) + 1;
+	}
+
+	/// @brief Returns the number of distinct characters appearing in the operators
+	/// @return The number of columns of the transition table
+	constexpr size_t getOperatorColumnCount() noexcept
+	{
+		bool seen[256] = {};
+		size_t count = 1; //column 0 is for characters that are not part of any operator
+		for (auto& spec : OperatorSpec)
+		{
+			for (const char* ptr = spec.lexeme; *ptr != '\0'; ++ptr)
+			{
+				if (!seen[static_cast<u8>(*ptr)])
+				{
+					seen[static_cast<u8>(*ptr)] = true;
+					++count;
+				}
+			}
+		}
+		return count;
+	}
+
+	/// @brief Deterministic finite automaton recognizing the operators of Colt.
+	/// State 0 is the starting state, and a transition to 0 means that the
+	/// operator ends: the accepted Token is the one of the current state.
+	struct OperatorDFA
+	{
+		/// @brief The number of states of the automaton
+		static constexpr size_t STATE_COUNT = getOperatorStateCount();
+		/// @brief The number of columns of the transition table
+		static constexpr size_t COLUMN_COUNT = getOperatorColumnCount();
+
+		/// @brief Maps a byte to its column in 'transitions'
+		u8 column[256];
+		/// @brief The transition table (indexed by [state][column])
+		u8 transitions[STATE_COUNT][COLUMN_COUNT];
+		/// @brief The Token accepted by each state
+		Token accept[STATE_COUNT];
+	};
+
+	/// @brief Generates the automaton recognizing all the operators
+	/// @return The operator automaton
+	constexpr OperatorDFA GenerateOperatorDFA() noexcept
+	{
+		static_assert(OperatorDFA::STATE_COUNT < 256 && OperatorDFA::COLUMN_COUNT < 256,
+			"Operator table too big!");
+
+		OperatorDFA dfa = {};
+		u8 next_column = 1;
+		for (auto& spec : OperatorSpec)
+		{
+			for (const char* ptr = spec.lexeme; *ptr != '\0'; ++ptr)
+				if (dfa.column[static_cast<u8>(*ptr)] == 0)
+					dfa.column[static_cast<u8>(*ptr)] = next_column++;
+		}
+		for (auto& tkn : dfa.accept)
+			tkn = TKN_ERROR;
+
+		u8 next_state = 1;
+		//Lexemes are inserted shortest first so that the state of a prefix
+		//already exists when inserting a longer lexeme.
+		for (size_t size = 1; size <= 3; size++)
+		{
+			for (auto& spec : OperatorSpec)
+			{
+				if (constexpr_strlen(spec.lexeme) != size)
+					continue;
+				u8 state = 0;
+				for (size_t i = 0; i + 1 < size; i++)
+					state = dfa.transitions[state][dfa.column[static_cast<u8>(spec.lexeme[i])]];
+				u8 new_state = next_state++;
+				dfa.transitions[state][dfa.column[static_cast<u8>(spec.lexeme[size - 1])]] = new_state;
+				dfa.accept[new_state] = spec.token;
+			}
+		}
+		return dfa;
+	}
+
+	/// @brief The automaton recognizing all the operators
+	static constexpr OperatorDFA OperatorStateMachine = GenerateOperatorDFA();
+
+	/// @brief Check that every operator is recognized by the automaton,
+	/// and that every state (except the starting one) accepts a Token.
+	/// @return True if the automaton is valid
+	constexpr bool isOperatorDFAValid() noexcept
+	{
+		for (auto& spec : OperatorSpec)
+		{
+			if (constexpr_strlen(spec.lexeme) > 3)
+				return false;
+			u8 state = 0;
+			for (const char* ptr = spec.lexeme; *ptr != '\0'; ++ptr)
+			{
+				state = OperatorStateMachine.transitions[state][OperatorStateMachine.column[static_cast<u8>(*ptr)]];
+				if (state == 0)
+					return false;
+			}
+			if (OperatorStateMachine.accept[state] != spec.token)
+				return false;
+		}
+		for (size_t i = 1; i < OperatorDFA::STATE_COUNT; i++)
+			if (OperatorStateMachine.accept[i] == TKN_ERROR)
+				return false;
+		return true;
+	}
+	static_assert(isOperatorDFAValid(), "Invalid operator table: all the prefixes of an operator must be operators!");
+
+	/// @brief Open addressing hash table of the keywords, generated at compile time
+	struct KeywordMap
+	{
+		/// @brief The number of slots of the table (must be a power of 2)
+		static constexpr size_t SLOT_COUNT = 128;
+
+		/// @brief A slot of the table
+		struct Slot
+		{
+			/// @brief The keyword or nullptr if the slot is empty
+			const char* lexeme;
+			/// @brief The size of the keyword
+			u8 size;
+			/// @brief The Token of the keyword
+			Token token;
+		};
+
+		/// @brief The slots of the table
+		Slot slots[SLOT_COUNT];
+
+		/// @brief Hashes an identifier
+		/// @param ptr Pointer to the identifier
+		/// @param size The size of the identifier (at least 1)
+		/// @return The hash
+		static constexpr size_t hash(const char* ptr, size_t size) noexcept
+		{
+			return (static_cast<u8>(ptr[0]) * 7u + static_cast<u8>(ptr[size - 1]) * 3u + size * 31u)
+				& (SLOT_COUNT - 1);
+		}
+
+		/// @brief Returns the keyword Token of an identifier
+		/// @param identifier The identifier
+		/// @return The keyword Token or TKN_IDENTIFIER
+		Token find(StringView identifier) const noexcept
+		{
+			size_t size = identifier.get_size();
+			for (size_t i = hash(identifier.get_data(), size);
+				slots[i].lexeme != nullptr; i = (i + 1) & (SLOT_COUNT - 1))
+			{
+				if (slots[i].size == size
+					&& std::memcmp(slots[i].lexeme, identifier.get_data(), size) == 0)
+					return slots[i].token;
+			}
+			return TKN_IDENTIFIER;
+		}
+	};
+
+	/// @brief Generates the keyword hash table
+	/// @return The keyword hash table
+	constexpr KeywordMap GenerateKeywordMap() noexcept
+	{
+		static_assert(std::size(KeywordSpec) < KeywordMap::SLOT_COUNT / 2,
+			"Keyword table too small!");
+
+		KeywordMap map = {};
+		for (auto& spec : KeywordSpec)
+		{
+			size_t size = constexpr_strlen(spec.lexeme);
+			size_t i = KeywordMap::hash(spec.lexeme, size);
+			while (map.slots[i].lexeme != nullptr)
+				i = (i + 1) & (KeywordMap::SLOT_COUNT - 1);
+			map.slots[i] = { spec.lexeme, static_cast<u8>(size), spec.token };
+		}
+		return map;
+	}
+
+	/// @brief The keyword hash table
+	static constexpr KeywordMap KeywordTable = GenerateKeywordMap();
+}
+
+#endif //!HG_COLT_LEXER_TABLE
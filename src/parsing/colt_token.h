@@ -292,6 +292,11 @@ namespace colt::lang
 		/// @brief goto
 		TKN_KEYWORD_GOTO,
 
+		/// @brief @embed
+		TKN_KEYWORD_EMBED,
+		/// @brief @embed_count
+		TKN_KEYWORD_EMBED_COUNT,
+
 		/********* ADD NEW KEYWORDS BEGINNING HERE *******/
 
 
@@ -0,0 +1,224 @@
+/** @file colt_unicode.cpp
+* Contains definition of functions declared in 'colt_unicode.h'.
+*/
+
+#include "colt_unicode.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	/// @brief Defined if SSE2 can be used to skip ASCII
+	#define COLT_UTF8_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	#include <arm_neon.h>
+	/// @brief Defined if NEON can be used to skip ASCII
+	#define COLT_UTF8_NEON
+#endif
+
+#ifdef COLT_MSVC
+	#include <intrin.h>
+#endif
+
+namespace colt::lang
+{
+	namespace
+	{
+		/// @brief Returns the index of the lowest set bit of a non-zero value
+		/// @param value The value (must not be 0)
+		/// @return The index of the lowest set bit
+		u32 countTrailingZeros(u32 value) noexcept
+		{
+#ifdef COLT_MSVC
+			unsigned long index;
+			_BitScanForward(&index, value);
+			return as<u32>(index);
+#else
+			return as<u32>(__builtin_ctz(value));
+#endif
+		}
+
+		/// @brief Skips ASCII characters
+		/// @param ptr The beginning of the range
+		/// @param end The end of the range
+		/// @return Pointer to the first non-ASCII byte, or 'end'
+		const u8* skipASCII(const u8* ptr, const u8* end) noexcept
+		{
+#if defined(COLT_UTF8_SSE2)
+			while (end - ptr >= 16)
+			{
+				__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+				//The mask contains the high bit of each byte
+				if (int mask = _mm_movemask_epi8(chunk); mask != 0)
+					return ptr + countTrailingZeros(as<u32>(mask));
+				ptr += 16;
+			}
+#elif defined(COLT_UTF8_NEON)
+			while (end - ptr >= 16)
+			{
+				if (vmaxvq_u8(vld1q_u8(ptr)) >= 0x80)
+					break;
+				ptr += 16;
+			}
+#else
+			while (end - ptr >= 8)
+			{
+				u64 word;
+				std::memcpy(&word, ptr, sizeof(word));
+				if ((word & 0x8080808080808080ULL) != 0)
+					break;
+				ptr += 8;
+			}
+#endif
+			while (ptr != end && *ptr < 0x80)
+				++ptr;
+			return ptr;
+		}
+
+		/// @brief Check if a byte is a continuation byte (10xxxxxx)
+		/// @param byte The byte to check
+		/// @return True if continuation byte
+		constexpr bool isContinuation(u8 byte) noexcept
+		{
+			return (byte & 0xC0) == 0x80;
+		}
+
+		/// @brief Validates a single non-ASCII UTF-8 sequence (RFC 3629).
+		/// Overlong encodings, surrogates and code points over U+10FFFF are rejected.
+		/// @param ptr Pointer to the lead byte
+		/// @param end The end of the range
+		/// @return The size of the sequence, or 0 if invalid
+		size_t validateSequence(const u8* ptr, const u8* end) noexcept
+		{
+			u8 lead = ptr[0];
+			size_t size;
+			//The valid range of the second byte depends on the lead byte
+			u8 second_min = 0x80;
+			u8 second_max = 0xBF;
+			if (0xC2 <= lead && lead <= 0xDF)
+				size = 2;
+			else if (0xE0 <= lead && lead <= 0xEF)
+			{
+				size = 3;
+				if (lead == 0xE0)
+					second_min = 0xA0; //overlong
+				else if (lead == 0xED)
+					second_max = 0x9F; //surrogates
+			}
+			else if (0xF0 <= lead && lead <= 0xF4)
+			{
+				size = 4;
+				if (lead == 0xF0)
+					second_min = 0x90; //overlong
+				else if (lead == 0xF4)
+					second_max = 0x8F; //over U+10FFFF
+			}
+			else
+				return 0;
+
+			if (as<size_t>(end - ptr) < size)
+				return 0;
+			if (ptr[1] < second_min || ptr[1] > second_max)
+				return 0;
+			for (size_t i = 2; i < size; i++)
+				if (!isContinuation(ptr[i]))
+					return 0;
+			return size;
+		}
+
+		/// @brief Inclusive range of code points
+		struct CodePointRange
+		{
+			/// @brief The first code point of the range
+			u32 first;
+			/// @brief The last code point of the range
+			u32 last;
+		};
+
+		/// @brief Code points allowed in identifiers (C11 Annex D.1), sorted
+		static constexpr CodePointRange IdentifierRanges[] = {
+			{ 0x00A8, 0x00A8 }, { 0x00AA, 0x00AA }, { 0x00AD, 0x00AD }, { 0x00AF, 0x00AF },
+			{ 0x00B2, 0x00B5 }, { 0x00B7, 0x00BA }, { 0x00BC, 0x00BE }, { 0x00C0, 0x00D6 },
+			{ 0x00D8, 0x00F6 }, { 0x00F8, 0x00FF }, { 0x0100, 0x167F }, { 0x1681, 0x180D },
+			{ 0x180F, 0x1FFF }, { 0x200B, 0x200D }, { 0x202A, 0x202E }, { 0x203F, 0x2040 },
+			{ 0x2054, 0x2054 }, { 0x2060, 0x206F }, { 0x2070, 0x218F }, { 0x2460, 0x24FF },
+			{ 0x2776, 0x2793 }, { 0x2C00, 0x2DFF }, { 0x2E80, 0x2FFF }, { 0x3004, 0x3007 },
+			{ 0x3021, 0x302F }, { 0x3031, 0x303F }, { 0x3040, 0xD7FF }, { 0xF900, 0xFD3D },
+			{ 0xFD40, 0xFDCF }, { 0xFDF0, 0xFE44 }, { 0xFE47, 0xFFFD }, { 0x10000, 0x1FFFD },
+			{ 0x20000, 0x2FFFD }, { 0x30000, 0x3FFFD }, { 0x40000, 0x4FFFD }, { 0x50000, 0x5FFFD },
+			{ 0x60000, 0x6FFFD }, { 0x70000, 0x7FFFD }, { 0x80000, 0x8FFFD }, { 0x90000, 0x9FFFD },
+			{ 0xA0000, 0xAFFFD }, { 0xB0000, 0xBFFFD }, { 0xC0000, 0xCFFFD }, { 0xD0000, 0xDFFFD },
+			{ 0xE0000, 0xEFFFD },
+		};
+
+		/// @brief Code points that cannot start an identifier (C11 Annex D.2), sorted
+		static constexpr CodePointRange NonStartRanges[] = {
+			{ 0x0300, 0x036F }, { 0x1DC0, 0x1DFF }, { 0x20D0, 0x20FF }, { 0xFE20, 0xFE2F },
+		};
+
+		template<size_t N>
+		/// @brief Check if a code point is part of sorted ranges
+		/// @tparam N The number of ranges
+		/// @param ranges The sorted ranges
+		/// @param code_point The code point to search for
+		/// @return True if any range contains 'code_point'
+		bool isInRanges(const CodePointRange(&ranges)[N], u32 code_point) noexcept
+		{
+			auto it = std::upper_bound(std::begin(ranges), std::end(ranges), code_point,
+				[](u32 value, const CodePointRange& range) { return value < range.first; });
+			if (it == std::begin(ranges))
+				return false;
+			return code_point <= (it - 1)->last;
+		}
+	}
+
+	const char* ValidateUTF8(StringView strv) noexcept
+	{
+		const u8* ptr = reinterpret_cast<const u8*>(strv.get_data());
+		const u8* end = ptr + strv.get_size();
+		for (;;)
+		{
+			ptr = skipASCII(ptr, end);
+			if (ptr == end)
+				return nullptr;
+			size_t size = validateSequence(ptr, end);
+			if (size == 0)
+				return reinterpret_cast<const char*>(ptr);
+			ptr += size;
+		}
+	}
+
+	u32 DecodeUTF8(const char* ptr, u8& size) noexcept
+	{
+		const u8* bytes = reinterpret_cast<const u8*>(ptr);
+		if (bytes[0] < 0x80)
+		{
+			size = 1;
+			return bytes[0];
+		}
+		if (bytes[0] < 0xE0)
+		{
+			size = 2;
+			return (as<u32>(bytes[0] & 0x1F) << 6) | (bytes[1] & 0x3F);
+		}
+		if (bytes[0] < 0xF0)
+		{
+			size = 3;
+			return (as<u32>(bytes[0] & 0x0F) << 12) | (as<u32>(bytes[1] & 0x3F) << 6)
+				| (bytes[2] & 0x3F);
+		}
+		size = 4;
+		return (as<u32>(bytes[0] & 0x07) << 18) | (as<u32>(bytes[1] & 0x3F) << 12)
+			| (as<u32>(bytes[2] & 0x3F) << 6) | (bytes[3] & 0x3F);
+	}
+
+	bool isUnicodeIdentifierStart(u32 code_point) noexcept
+	{
+		return isUnicodeIdentifierContinue(code_point)
+			&& !isInRanges(NonStartRanges, code_point);
+	}
+
+	bool isUnicodeIdentifierContinue(u32 code_point) noexcept
+	{
+		return isInRanges(IdentifierRanges, code_point);
+	}
+}
@@ -0,0 +1,39 @@
+/** @file colt_unicode.h
+* Contains helpers for validating and decoding UTF-8 source code.
+*/
+
+#ifndef HG_COLT_UNICODE
+#define HG_COLT_UNICODE
+
+#include <util/colt_pch.h>
+
+namespace colt::lang
+{
+	/// @brief Validates that a StringView only contains well-formed UTF-8.
+	/// ASCII runs are skipped 16 bytes at a time, so that validating pure ASCII
+	/// files costs close to a memory read.
+	/// @param strv The StringView to validate
+	/// @return Pointer to the first byte of the first invalid sequence, or nullptr if valid
+	const char* ValidateUTF8(StringView strv) noexcept;
+
+	/// @brief Decodes a UTF-8 sequence.
+	/// @param ptr Pointer to the lead byte of a valid UTF-8 sequence
+	/// @param size Out parameter set to the size of the sequence in bytes
+	/// @return The decoded code point
+	/// @pre The sequence pointed by 'ptr' must be valid (see ValidateUTF8)
+	u32 DecodeUTF8(const char* ptr, u8& size) noexcept;
+
+	/// @brief Check if a non-ASCII code point can start an identifier.
+	/// The allowed code points are the ones of C11 (Annex D).
+	/// @param code_point The code point to check
+	/// @return True if the code point can start an identifier
+	bool isUnicodeIdentifierStart(u32 code_point) noexcept;
+
+	/// @brief Check if a non-ASCII code point can continue an identifier.
+	/// The allowed code points are the ones of C11 (Annex D).
+	/// @param code_point The code point to check
+	/// @return True if the code point can be part of an identifier
+	bool isUnicodeIdentifierContinue(u32 code_point) noexcept;
+}
+
+#endif //!HG_COLT_UNICODE
@@ -0,0 +1,863 @@
+/** @file colt_algorithms.cpp
+* Contains definition of functions declared in 'colt_algorithms.h'.
+*/
+
+#include "colt_algorithms.h"
+#include "colt_thread_pool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  #include <immintrin.h>
+  /// @brief Defined if AVX2 functions can be compiled, and called if the processor supports them
+  #define COLT_ALGORITHMS_AVX2
+  /// @brief Compiles a function for processors supporting AVX2
+  #define COLT_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#endif
+
+namespace colt::runtime
+{
+  namespace
+  {
+    /// @brief Arrays smaller than 'RADIX_SORT_THRESHOLD * sizeof(T)' are sorted using pdqsort
+    constexpr std::uint64_t RADIX_SORT_THRESHOLD = 96;
+    /// @brief The minimum size of the chunks sorted by each thread of ParallelSort
+    constexpr std::uint64_t PARALLEL_SORT_MIN_CHUNK = 1 << 16;
+
+    /// @brief The unsigned integer whose order is the sort order of a type
+    /// @tparam T The type
+    template<typename T>
+    using KeyOf = std::conditional_t<sizeof(T) == 1, std::uint8_t,
+      std::conditional_t<sizeof(T) == 2, std::uint16_t,
+      std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+
+    /// @brief Converts a value to an unsigned integer with the same order.
+    /// Signed integers have their sign bit flipped. Positive floats have
+    /// their sign bit set, and negative floats have all their bits flipped.
+    /// @tparam T The type of the value
+    /// @param value The value
+    /// @return The key of the value
+    template<typename T>
+    inline KeyOf<T> ToKey(T value) noexcept
+    {
+      using Key = KeyOf<T>;
+      constexpr Key SIGN = Key(1) << (sizeof(T) * 8 - 1);
+      Key bits;
+      std::memcpy(&bits, &value, sizeof(T));
+      if constexpr (std::is_floating_point_v<T>)
+        return (bits & SIGN) ? static_cast<Key>(~bits) : static_cast<Key>(bits | SIGN);
+      else if constexpr (std::is_signed_v<T>)
+        return static_cast<Key>(bits ^ SIGN);
+      else
+        return bits;
+    }
+
+    /// @brief Compares values by their key (see ToKey)
+    /// @tparam T The type of the values
+    template<typename T>
+    struct KeyLess
+    {
+      bool operator()(T a, T b) const noexcept { return ToKey(a) < ToKey(b); }
+    };
+
+    /// @brief Returns the floor of the base 2 logarithm of a non-zero value
+    /// @param value The value
+    /// @return The logarithm
+    inline int Log2(std::uint64_t value) noexcept
+    {
+      int log = 0;
+      while (value >>= 1)
+        ++log;
+      return log;
+    }
+
+    /*------------------------------------------------------------
+    | PDQSORT: quicksort, with insertion sort for small ranges,  |
+    | heapsort for bad pivots, and detection of sorted ranges.   |
+    ------------------------------------------------------------*/
+
+    /// @brief Ranges smaller than this are sorted using insertion sort
+    constexpr std::uint64_t INSERTION_SORT_THRESHOLD = 24;
+    /// @brief Ranges bigger than this use the median of 3 medians of 3 as pivot
+    constexpr std::uint64_t NINTHER_THRESHOLD = 128;
+    /// @brief The moves after which a partial insertion sort gives up
+    constexpr std::uint64_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+    /// @brief Sorts a range using insertion sort
+    /// @param begin The beginning of the range
+    /// @param end The end of the range
+    /// @param less The comparator
+    template<typename T, typename Less>
+    void InsertionSort(T* begin, T* end, Less less) noexcept
+    {
+      if (begin == end)
+        return;
+      for (T* current = begin + 1; current != end; ++current)
+      {
+        T* sift = current;
+        T* sift_1 = current - 1;
+        if (less(*sift, *sift_1))
+        {
+          T value = *sift;
+          do { *sift-- = *sift_1; } while (sift != begin && less(value, *--sift_1));
+          *sift = value;
+        }
+      }
+    }
+
+    /// @brief Sorts a range using insertion sort, which is preceded by a value
+    ///        not greater than any value of the range (so bounds need not be checked)
+    /// @param begin The beginning of the range
+    /// @param end The end of the range
+    /// @param less The comparator
+    template<typename T, typename Less>
+    void UnguardedInsertionSort(T* begin, T* end, Less less) noexcept
+    {
+      if (begin == end)
+        return;
+      for (T* current = begin + 1; current != end; ++current)
+      {
+        T* sift = current;
+        T* sift_1 = current - 1;
+        if (less(*sift, *sift_1))
+        {
+          T value = *sift;
+          do { *sift-- = *sift_1; } while (less(value, *--sift_1));
+          *sift = value;
+        }
+      }
+    }
+
+    /// @brief Sorts a range using insertion sort, giving up after a few moves
+    /// @param begin The beginning of the range
+    /// @param end The end of the range
+    /// @param less The comparator
+    /// @return True if the range was sorted
+    template<typename T, typename Less>
+    bool PartialInsertionSort(T* begin, T* end, Less less) noexcept
+    {
+      if (begin == end)
+        return true;
+      std::uint64_t moves = 0;
+      for (T* current = begin + 1; current != end; ++current)
+      {
+        T* sift = current;
+        T* sift_1 = current - 1;
+        if (less(*sift, *sift_1))
+        {
+          T value = *sift;
+          do { *sift-- = *sift_1; } while (sift != begin && less(value, *--sift_1));
+          *sift = value;
+          moves += current - sift;
+          if (moves > PARTIAL_INSERTION_SORT_LIMIT)
+            return false;
+        }
+      }
+      return true;
+    }
+
+    /// @brief Sorts 3 values
+    template<typename T, typename Less>
+    void Sort3(T* a, T* b, T* c, Less less) noexcept
+    {
+      if (less(*b, *a))
+        std::iter_swap(a, b);
+      if (less(*c, *b))
+        std::iter_swap(b, c);
+      if (less(*b, *a))
+        std::iter_swap(a, b);
+    }
+
+    /// @brief Partitions a range around its first value: values equal to the pivot
+    ///        go to the right. The range must end with a value not less than the pivot.
+    /// @param begin The beginning of the range (the pivot)
+    /// @param end The end of the range
+    /// @param less The comparator
+    /// @return The position of the pivot, and true if the range was already partitioned
+    template<typename T, typename Less>
+    std::pair<T*, bool> PartitionRight(T* begin, T* end, Less less) noexcept
+    {
+      T pivot = *begin;
+      T* first = begin;
+      T* last = end;
+
+      while (less(*++first, pivot));
+      //If no value was less than the pivot, the search from the right must be bounded
+      if (first - 1 == begin)
+        while (first < last && !less(*--last, pivot));
+      else
+        while (!less(*--last, pivot));
+
+      bool already_partitioned = first >= last;
+      while (first < last)
+      {
+        std::iter_swap(first, last);
+        while (less(*++first, pivot));
+        while (!less(*--last, pivot));
+      }
+
+      T* pivot_pos = first - 1;
+      *begin = *pivot_pos;
+      *pivot_pos = pivot;
+      return { pivot_pos, already_partitioned };
+    }
+
+    /// @brief Partitions a range around its first value: values equal to the pivot
+    ///        go to the left. Used when many values are equal to the pivot.
+    /// @param begin The beginning of the range (the pivot)
+    /// @param end The end of the range
+    /// @param less The comparator
+    /// @return The position of the pivot
+    template<typename T, typename Less>
+    T* PartitionLeft(T* begin, T* end, Less less) noexcept
+    {
+      T pivot = *begin;
+      T* first = begin;
+      T* last = end;
+
+      while (less(pivot, *--last));
+      if (last + 1 == end)
+        while (first < last && !less(pivot, *++first));
+      else
+        while (!less(pivot, *++first));
+
+      while (first < last)
+      {
+        std::iter_swap(first, last);
+        while (less(pivot, *--last));
+        while (!less(pivot, *++first));
+      }
+
+      T* pivot_pos = last;
+      *begin = *pivot_pos;
+      *pivot_pos = pivot;
+      return pivot_pos;
+    }
+
+    /// @brief Sorts a range using pattern-defeating quicksort
+    /// @param begin The beginning of the range
+    /// @param end The end of the range
+    /// @param less The comparator
+    /// @param bad_allowed The number of bad pivots after which heapsort is used
+    /// @param leftmost True if the range is not preceded by a partitioned value
+    template<typename T, typename Less>
+    void PdqSortLoop(T* begin, T* end, Less less, int bad_allowed, bool leftmost) noexcept
+    {
+      for (;;)
+      {
+        std::uint64_t size = end - begin;
+        if (size < INSERTION_SORT_THRESHOLD)
+        {
+          if (leftmost)
+            InsertionSort(begin, end, less);
+          else
+            UnguardedInsertionSort(begin, end, less);
+          return;
+        }
+
+        //The pivot is moved to 'begin'
+        std::uint64_t half = size / 2;
+        if (size > NINTHER_THRESHOLD)
+        {
+          Sort3(begin, begin + half, end - 1, less);
+          Sort3(begin + 1, begin + (half - 1), end - 2, less);
+          Sort3(begin + 2, begin + (half + 1), end - 3, less);
+          Sort3(begin + (half - 1), begin + half, begin + (half + 1), less);
+          std::iter_swap(begin, begin + half);
+        }
+        else
+          Sort3(begin + half, begin, end - 1, less);
+
+        //If the pivot is equal to the value preceding the range (the pivot of a
+        //previous partition), no value is less than it: the values equal to
+        //the pivot are put on the left, and need not be sorted
+        if (!leftmost && !less(*(begin - 1), *begin))
+        {
+          begin = PartitionLeft(begin, end, less) + 1;
+          continue;
+        }
+
+        auto [pivot_pos, already_partitioned] = PartitionRight(begin, end, less);
+        std::uint64_t left_size = pivot_pos - begin;
+        std::uint64_t right_size = end - (pivot_pos + 1);
+        if (left_size < size / 8 || right_size < size / 8)
+        {
+          if (--bad_allowed == 0)
+          {
+            std::make_heap(begin, end, less);
+            std::sort_heap(begin, end, less);
+            return;
+          }
+          //Shuffle values to break patterns causing bad pivots
+          if (left_size >= INSERTION_SORT_THRESHOLD)
+          {
+            std::iter_swap(begin, begin + left_size / 4);
+            std::iter_swap(pivot_pos - 1, pivot_pos - left_size / 4);
+            if (left_size > NINTHER_THRESHOLD)
+            {
+              std::iter_swap(begin + 1, begin + (left_size / 4 + 1));
+              std::iter_swap(begin + 2, begin + (left_size / 4 + 2));
+              std::iter_swap(pivot_pos - 2, pivot_pos - (left_size / 4 + 1));
+              std::iter_swap(pivot_pos - 3, pivot_pos - (left_size / 4 + 2));
+            }
+          }
+          if (right_size >= INSERTION_SORT_THRESHOLD)
+          {
+            std::iter_swap(pivot_pos + 1, pivot_pos + (1 + right_size / 4));
+            std::iter_swap(end - 1, end - right_size / 4);
+            if (right_size > NINTHER_THRESHOLD)
+            {
+              std::iter_swap(pivot_pos + 2, pivot_pos + (2 + right_size / 4));
+              std::iter_swap(pivot_pos + 3, pivot_pos + (3 + right_size / 4));
+              std::iter_swap(end - 2, end - (1 + right_size / 4));
+              std::iter_swap(end - 3, end - (2 + right_size / 4));
+            }
+          }
+        }
+        else if (already_partitioned && PartialInsertionSort(begin, pivot_pos, less)
+          && PartialInsertionSort(pivot_pos + 1, end, less))
+          return; //The range was (nearly) sorted
+
+        //Recurse on the left, loop on the right
+        PdqSortLoop(begin, pivot_pos, less, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+      }
+    }
+
+    /// @brief Sorts a range using pattern-defeating quicksort
+    /// @param begin The beginning of the range
+    /// @param end The end of the range
+    template<typename T>
+    void PdqSort(T* begin, T* end) noexcept
+    {
+      if (end - begin < 2)
+        return;
+      PdqSortLoop(begin, end, KeyLess<T>{}, Log2(end - begin), true);
+    }
+
+    /*------------------------------------------------------------
+    | RADIX SORT: least significant digit first, a byte per pass |
+    ------------------------------------------------------------*/
+
+    /// @brief Sorts an array using an LSD radix sort
+    /// @param data The array
+    /// @param buffer A buffer of the same size as the array
+    /// @param size The size of the array
+    template<typename T>
+    void RadixSort(T* data, T* buffer, std::uint64_t size) noexcept
+    {
+      constexpr std::size_t DIGITS = sizeof(T);
+      std::uint64_t counts[DIGITS][256] = {};
+      for (std::uint64_t i = 0; i < size; i++)
+      {
+        auto key = ToKey(data[i]);
+        for (std::size_t digit = 0; digit < DIGITS; digit++)
+          ++counts[digit][(key >> (digit * 8)) & 0xFF];
+      }
+
+      T* from = data;
+      T* to = buffer;
+      for (std::size_t digit = 0; digit < DIGITS; digit++)
+      {
+        auto& count = counts[digit];
+        //All the values have the same digit: the pass would not move them
+        if (count[(ToKey(from[0]) >> (digit * 8)) & 0xFF] == size)
+          continue;
+        std::uint64_t offset = 0;
+        for (auto& bucket : count)
+          offset += std::exchange(bucket, offset);
+        for (std::uint64_t i = 0; i < size; i++)
+          to[count[(ToKey(from[i]) >> (digit * 8)) & 0xFF]++] = from[i];
+        std::swap(from, to);
+      }
+      if (from != data)
+        std::memcpy(data, from, size * sizeof(T));
+    }
+
+    /// @brief Sorts an array
+    /// @param data The array
+    /// @param buffer A buffer of the same size as the array, or nullptr
+    /// @param size The size of the array
+    template<typename T>
+    void SortWithBuffer(T* data, T* buffer, std::uint64_t size) noexcept
+    {
+      if (size < RADIX_SORT_THRESHOLD * sizeof(T) || buffer == nullptr)
+        PdqSort(data, data + size);
+      else
+        RadixSort(data, buffer, size);
+    }
+
+    /// @brief Sorts an array
+    /// @param data The array
+    /// @param size The size of the array
+    template<typename T>
+    void Sort(T* data, std::uint64_t size) noexcept
+    {
+      if (size < RADIX_SORT_THRESHOLD * sizeof(T))
+        return PdqSort(data, data + size);
+      //Without memory, pdqsort sorts in place
+      T* buffer = static_cast<T*>(std::malloc(size * sizeof(T)));
+      SortWithBuffer(data, buffer, size);
+      std::free(buffer);
+    }
+
+    /// @brief Returns the count of values of 'a' among the first 'diagonal' values of
+    ///        the stable merge of 'a' and 'b' (the others are values of 'b').
+    /// @param diagonal The count of merged values
+    /// @param a The first sorted array
+    /// @param a_size The size of 'a'
+    /// @param b The second sorted array
+    /// @param b_size The size of 'b'
+    /// @return The count of values of 'a'
+    template<typename T>
+    std::uint64_t MergeCoRank(std::uint64_t diagonal, const T* a, std::uint64_t a_size, const T* b, std::uint64_t b_size) noexcept
+    {
+      KeyLess<T> less;
+      std::uint64_t low = diagonal > b_size ? diagonal - b_size : 0;
+      std::uint64_t high = std::min(diagonal, a_size);
+      while (low < high)
+      {
+        std::uint64_t i = low + (high - low) / 2;
+        std::uint64_t j = diagonal - i;
+        //a[i] is merged before b[j - 1]: more values of 'a' are needed
+        if (j > 0 && i < a_size && !less(b[j - 1], a[i]))
+          low = i + 1;
+        else
+          high = i;
+      }
+      return low;
+    }
+
+    /// @brief Sorts an array by sorting chunks on the thread pool, then merging them
+    /// @param data The array
+    /// @param size The size of the array
+    template<typename T>
+    void ParallelSort(T* data, std::uint64_t size) noexcept
+    {
+      std::uint64_t chunks = std::min<std::uint64_t>(ThreadCount(), size / PARALLEL_SORT_MIN_CHUNK);
+      if (chunks < 2)
+        return Sort(data, size);
+      T* buffer = static_cast<T*>(std::malloc(size * sizeof(T)));
+      if (buffer == nullptr)
+        return Sort(data, size);
+
+      std::vector<std::uint64_t> bounds;
+      for (std::uint64_t i = 0; i <= chunks; i++)
+        bounds.push_back(size * i / chunks);
+      ParallelFor(chunks, [&](std::uint64_t i)
+        { SortWithBuffer(data + bounds[i], buffer + bounds[i], bounds[i + 1] - bounds[i]); });
+
+      //Pairs of sorted runs are merged until one remains. Each merge is split
+      //in parts of equal sizes (using MergeCoRank), so that all threads work.
+      T* from = data;
+      T* to = buffer;
+      while (bounds.size() > 2)
+      {
+        std::uint64_t runs = bounds.size() - 1;
+        std::uint64_t pairs = (runs + 1) / 2;
+        std::uint64_t parts = std::max<std::uint64_t>(chunks / pairs, 1);
+        ParallelFor(pairs * parts, [&](std::uint64_t index)
+          {
+            std::uint64_t pair = index / parts;
+            std::uint64_t part = index % parts;
+            std::uint64_t begin = bounds[2 * pair];
+            std::uint64_t middle = bounds[std::min(2 * pair + 1, runs)];
+            std::uint64_t end = bounds[std::min(2 * pair + 2, runs)];
+            const T* a = from + begin;
+            const T* b = from + middle;
+            std::uint64_t a_size = middle - begin;
+            std::uint64_t b_size = end - middle;
+
+            std::uint64_t first = (end - begin) * part / parts;
+            std::uint64_t last = (end - begin) * (part + 1) / parts;
+            std::uint64_t a_first = MergeCoRank(first, a, a_size, b, b_size);
+            std::uint64_t a_last = MergeCoRank(last, a, a_size, b, b_size);
+            std::merge(a + a_first, a + a_last, b + (first - a_first), b + (last - a_last),
+              to + begin + first, KeyLess<T>{});
+          });
+
+        std::vector<std::uint64_t> merged;
+        for (std::uint64_t i = 0; i < bounds.size(); i += 2)
+          merged.push_back(bounds[i]);
+        if (merged.back() != size)
+          merged.push_back(size);
+        bounds = std::move(merged);
+        std::swap(from, to);
+      }
+      if (from != data)
+        std::memcpy(data, from, size * sizeof(T));
+      std::free(buffer);
+    }
+
+    /*------------------------------------------------------------
+    | AVX2: partitions and unique compress the values to keep    |
+    | using permutations indexed by the mask of the comparison.  |
+    ------------------------------------------------------------*/
+
+#ifdef COLT_ALGORITHMS_AVX2
+    /// @brief The permutations moving the lanes whose bit is set in a mask first
+    struct CompressTables
+    {
+      /// @brief The 32-bit lanes to move first, for each mask of 8 lanes
+      std::uint8_t lanes32[256][8];
+      /// @brief The 32-bit lanes to move first, for each mask of 4 64-bit lanes
+      std::uint8_t lanes64[16][8];
+
+      /// @brief Generates the tables
+      constexpr CompressTables() noexcept
+        : lanes32(), lanes64()
+      {
+        for (unsigned mask = 0; mask < 256; mask++)
+        {
+          unsigned lane = 0;
+          for (unsigned i = 0; i < 8; i++)
+            if (mask & (1u << i))
+              lanes32[mask][lane++] = static_cast<std::uint8_t>(i);
+          while (lane < 8)
+            lanes32[mask][lane++] = 0;
+        }
+        for (unsigned mask = 0; mask < 16; mask++)
+        {
+          unsigned lane = 0;
+          for (unsigned i = 0; i < 4; i++)
+          {
+            if (mask & (1u << i))
+            {
+              lanes64[mask][lane++] = static_cast<std::uint8_t>(2 * i);
+              lanes64[mask][lane++] = static_cast<std::uint8_t>(2 * i + 1);
+            }
+          }
+          while (lane < 8)
+            lanes64[mask][lane++] = 0;
+        }
+      }
+    };
+
+    /// @brief The permutations used to compress lanes
+    constexpr CompressTables COMPRESS = {};
+
+    /// @brief Check if the processor supports AVX2
+    /// @return True if AVX2 functions can be called
+    bool HasAVX2() noexcept
+    {
+      static const bool has_avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+      return has_avx2;
+    }
+
+    /// @brief Broadcasts a value to all the lanes of a vector
+    template<typename T>
+    COLT_TARGET_AVX2 inline __m256i Broadcast(T value) noexcept
+    {
+      KeyOf<T> bits;
+      std::memcpy(&bits, &value, sizeof(T));
+      if constexpr (sizeof(T) == 4)
+        return _mm256_set1_epi32(static_cast<int>(bits));
+      else
+        return _mm256_set1_epi64x(static_cast<long long>(bits));
+    }
+
+    /// @brief Returns the mask of the lanes whose value is less than the pivot
+    template<typename T>
+    COLT_TARGET_AVX2 inline unsigned LessMask(__m256i values, __m256i pivots) noexcept
+    {
+      if constexpr (std::is_same_v<T, float>)
+        return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_castsi256_ps(values), _mm256_castsi256_ps(pivots), _CMP_LT_OQ));
+      else if constexpr (std::is_same_v<T, double>)
+        return _mm256_movemask_pd(_mm256_cmp_pd(_mm256_castsi256_pd(values), _mm256_castsi256_pd(pivots), _CMP_LT_OQ));
+      else
+      {
+        if constexpr (std::is_unsigned_v<T>)
+        {
+          //Unsigned comparisons are signed comparisons with flipped sign bits
+          __m256i sign = Broadcast<T>(T(1) << (sizeof(T) * 8 - 1));
+          values = _mm256_xor_si256(values, sign);
+          pivots = _mm256_xor_si256(pivots, sign);
+        }
+        if constexpr (sizeof(T) == 4)
+          return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(pivots, values)));
+        else
+          return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(pivots, values)));
+      }
+    }
+
+    /// @brief Returns the mask of the lanes whose values are different ('!=')
+    template<typename T>
+    COLT_TARGET_AVX2 inline unsigned NotEqualMask(__m256i a, __m256i b) noexcept
+    {
+      constexpr unsigned ALL = (1u << (32 / sizeof(T))) - 1;
+      if constexpr (std::is_same_v<T, float>)
+        return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_NEQ_UQ));
+      else if constexpr (std::is_same_v<T, double>)
+        return _mm256_movemask_pd(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_NEQ_UQ));
+      else if constexpr (sizeof(T) == 4)
+        return ~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))) & ALL;
+      else
+        return ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b))) & ALL;
+    }
+
+    /// @brief Moves the lanes whose bit is set in a mask first
+    template<typename T>
+    COLT_TARGET_AVX2 inline __m256i Compress(__m256i values, unsigned mask) noexcept
+    {
+      const std::uint8_t* lanes = sizeof(T) == 4 ? COMPRESS.lanes32[mask] : COMPRESS.lanes64[mask];
+      return _mm256_permutevar8x32_epi32(values,
+        _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(lanes))));
+    }
+
+    /// @brief Stable partition (see Partition) of values of 32 or 64 bits
+    /// @param data The values
+    /// @param size The number of values
+    /// @param pivot The pivot
+    /// @param right Buffer for the values not less than the pivot (of 'size + 8' values)
+    /// @return The count of values less than the pivot
+    template<typename T>
+    COLT_TARGET_AVX2 std::uint64_t PartitionAVX2(T* data, std::uint64_t size, T pivot, T* right) noexcept
+    {
+      constexpr std::uint64_t LANES = 32 / sizeof(T);
+      constexpr unsigned ALL = (1u << LANES) - 1;
+      __m256i pivots = Broadcast(pivot);
+      std::uint64_t left_size = 0;
+      std::uint64_t right_size = 0;
+      std::uint64_t i = 0;
+      //The values on the left are written over values that were already read
+      for (; i + LANES <= size; i += LANES)
+      {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        unsigned mask = LessMask<T>(values, pivots);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + left_size), Compress<T>(values, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(right + right_size), Compress<T>(values, ~mask & ALL));
+        unsigned less_count = static_cast<unsigned>(__builtin_popcount(mask));
+        left_size += less_count;
+        right_size += LANES - less_count;
+      }
+      for (; i < size; i++)
+      {
+        if (data[i] < pivot)
+          data[left_size++] = data[i];
+        else
+          right[right_size++] = data[i];
+      }
+      std::memcpy(data + left_size, right, right_size * sizeof(T));
+      return left_size;
+    }
+
+    /// @brief Unique (see Unique) of values of 32 or 64 bits
+    /// @param data The values
+    /// @param size The number of values (not 0)
+    /// @return The new number of values
+    template<typename T>
+    COLT_TARGET_AVX2 std::uint64_t UniqueAVX2(T* data, std::uint64_t size) noexcept
+    {
+      constexpr std::uint64_t LANES = 32 / sizeof(T);
+      std::uint64_t kept = 1;
+      std::uint64_t i = 1;
+      //The value preceding the vector, in all lanes: it may have been overwritten in 'data'
+      __m256i last = Broadcast(data[0]);
+      for (; i + LANES <= size; i += LANES)
+      {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i previous;
+        if constexpr (sizeof(T) == 4)
+        {
+          previous = _mm256_permutevar8x32_epi32(values, _mm256_set_epi32(6, 5, 4, 3, 2, 1, 0, 7));
+          previous = _mm256_blend_epi32(previous, last, 0x01);
+          last = _mm256_permutevar8x32_epi32(values, _mm256_set1_epi32(7));
+        }
+        else
+        {
+          previous = _mm256_permute4x64_epi64(values, _MM_SHUFFLE(2, 1, 0, 3));
+          previous = _mm256_blend_epi32(previous, last, 0x03);
+          last = _mm256_permute4x64_epi64(values, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+        unsigned mask = NotEqualMask<T>(values, previous);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + kept), Compress<T>(values, mask));
+        kept += static_cast<unsigned>(__builtin_popcount(mask));
+      }
+      T previous;
+      KeyOf<T> bits = sizeof(T) == 4
+        ? static_cast<KeyOf<T>>(_mm_cvtsi128_si32(_mm256_castsi256_si128(last)))
+        : static_cast<KeyOf<T>>(_mm_cvtsi128_si64(_mm256_castsi256_si128(last)));
+      std::memcpy(&previous, &bits, sizeof(T));
+      for (; i < size; i++)
+      {
+        T value = data[i];
+        if (value != previous)
+          data[kept++] = value;
+        previous = value;
+      }
+      return kept;
+    }
+
+    /// @brief Prefix sum (see PrefixSum) of integers of 32 or 64 bits
+    /// @param data The integers
+    /// @param size The number of integers
+    template<typename T>
+    COLT_TARGET_AVX2 void PrefixSumAVX2(T* data, std::uint64_t size) noexcept
+    {
+      constexpr std::uint64_t LANES = 32 / sizeof(T);
+      const __m256i zero = _mm256_setzero_si256();
+      //The sum of the previous values, in all lanes
+      __m256i carry = zero;
+      std::uint64_t i = 0;
+      for (; i + LANES <= size; i += LANES)
+      {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        //Sums in each 128-bit half, then adds the sum of the low half to the high half
+        if constexpr (sizeof(T) == 4)
+        {
+          values = _mm256_add_epi32(values, _mm256_slli_si256(values, 4));
+          values = _mm256_add_epi32(values, _mm256_slli_si256(values, 8));
+          __m256i low_sum = _mm256_permutevar8x32_epi32(values, _mm256_set_epi32(3, 3, 3, 3, 0, 0, 0, 0));
+          values = _mm256_add_epi32(values, _mm256_blend_epi32(zero, low_sum, 0xF0));
+          values = _mm256_add_epi32(values, carry);
+          carry = _mm256_permutevar8x32_epi32(values, _mm256_set1_epi32(7));
+        }
+        else
+        {
+          values = _mm256_add_epi64(values, _mm256_slli_si256(values, 8));
+          __m256i low_sum = _mm256_permute4x64_epi64(values, _MM_SHUFFLE(1, 1, 0, 0));
+          values = _mm256_add_epi64(values, _mm256_blend_epi32(zero, low_sum, 0xF0));
+          values = _mm256_add_epi64(values, carry);
+          carry = _mm256_permute4x64_epi64(values, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i), values);
+      }
+      using Key = KeyOf<T>;
+      Key sum = sizeof(T) == 4
+        ? static_cast<Key>(_mm_cvtsi128_si32(_mm256_castsi256_si128(carry)))
+        : static_cast<Key>(_mm_cvtsi128_si64(_mm256_castsi256_si128(carry)));
+      for (; i < size; i++)
+      {
+        sum = static_cast<Key>(sum + static_cast<Key>(data[i]));
+        data[i] = static_cast<T>(sum);
+      }
+    }
+#endif //COLT_ALGORITHMS_AVX2
+
+    /// @brief Moves the values less than a pivot first, keeping the order of the values
+    /// @param data The values
+    /// @param size The number of values
+    /// @param pivot The pivot
+    /// @return The count of values less than the pivot
+    template<typename T>
+    std::uint64_t Partition(T* data, std::uint64_t size, T pivot) noexcept
+    {
+      if (size == 0)
+        return 0;
+      auto is_less = [pivot](T value) { return value < pivot; };
+      T* right = static_cast<T*>(std::malloc((size + 8) * sizeof(T)));
+      if (right == nullptr)
+        return std::stable_partition(data, data + size, is_less) - data;
+      std::uint64_t left_size = 0;
+#ifdef COLT_ALGORITHMS_AVX2
+      if constexpr (sizeof(T) >= 4)
+      {
+        if (HasAVX2())
+        {
+          left_size = PartitionAVX2(data, size, pivot, right);
+          std::free(right);
+          return left_size;
+        }
+      }
+#endif
+      std::uint64_t right_size = 0;
+      for (std::uint64_t i = 0; i < size; i++)
+      {
+        if (is_less(data[i]))
+          data[left_size++] = data[i];
+        else
+          right[right_size++] = data[i];
+      }
+      std::memcpy(data + left_size, right, right_size * sizeof(T));
+      std::free(right);
+      return left_size;
+    }
+
+    /// @brief Removes the values equal to their predecessor
+    /// @param data The values
+    /// @param size The number of values
+    /// @return The new number of values
+    template<typename T>
+    std::uint64_t Unique(T* data, std::uint64_t size) noexcept
+    {
+      if (size == 0)
+        return 0;
+#ifdef COLT_ALGORITHMS_AVX2
+      if constexpr (sizeof(T) >= 4)
+      {
+        if (HasAVX2())
+          return UniqueAVX2(data, size);
+      }
+#endif
+      std::uint64_t kept = 1;
+      T previous = data[0];
+      for (std::uint64_t i = 1; i < size; i++)
+      {
+        T value = data[i];
+        if (value != previous)
+          data[kept++] = value;
+        previous = value;
+      }
+      return kept;
+    }
+
+    /// @brief Replaces each value by the sum of the values up to it
+    /// @param data The values
+    /// @param size The number of values
+    template<typename T>
+    void PrefixSum(T* data, std::uint64_t size) noexcept
+    {
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        //The additions are not reordered, so that the results are reproducible
+        T sum = 0;
+        for (std::uint64_t i = 0; i < size; i++)
+          data[i] = sum += data[i];
+      }
+      else
+      {
+#ifdef COLT_ALGORITHMS_AVX2
+        if constexpr (sizeof(T) >= 4)
+        {
+          if (HasAVX2())
+            return PrefixSumAVX2(data, size);
+        }
+#endif
+        //Unsigned arithmetic wraps around
+        using Key = KeyOf<T>;
+        Key sum = 0;
+        for (std::uint64_t i = 0; i < size; i++)
+        {
+          sum = static_cast<Key>(sum + static_cast<Key>(data[i]));
+          data[i] = static_cast<T>(sum);
+        }
+      }
+    }
+  }
+}
+
+using namespace colt::runtime;
+
+/// @brief Defines the algorithms of a type (see COLT_RUNTIME_NUMERIC_TYPES)
+#define COLT_RUNTIME_DEFINE_ALGORITHMS(NAME, TYPE) \
+  COLT_RUNTIME_EXPORT void _ColtSort##NAME(TYPE* data, std::uint64_t size) noexcept \
+  { Sort(data, size); } \
+  COLT_RUNTIME_EXPORT void _ColtParallelSort##NAME(TYPE* data, std::uint64_t size) noexcept \
+  { ParallelSort(data, size); } \
+  COLT_RUNTIME_EXPORT std::uint64_t _ColtPartition##NAME(TYPE* data, std::uint64_t size, TYPE pivot) noexcept \
+  { return Partition(data, size, pivot); } \
+  COLT_RUNTIME_EXPORT std::uint64_t _ColtUnique##NAME(TYPE* data, std::uint64_t size) noexcept \
+  { return Unique(data, size); } \
+  COLT_RUNTIME_EXPORT void _ColtPrefixSum##NAME(TYPE* data, std::uint64_t size) noexcept \
+  { PrefixSum(data, size); }
+
+COLT_RUNTIME_NUMERIC_TYPES(COLT_RUNTIME_DEFINE_ALGORITHMS)
+
+#undef COLT_RUNTIME_DEFINE_ALGORITHMS
@@ -0,0 +1,47 @@
+/** @file colt_algorithms.h
+* Contains the algorithms of the runtime over arrays of built-in numeric types.
+* For each type T of COLT_RUNTIME_NUMERIC_TYPES, named 'i64' for example:
+* - '_ColtSorti64(PTR<mut i64> data, u64 size)' sorts an array.
+*   Big arrays are sorted using an LSD radix sort, small ones using pdqsort.
+*   Floats are ordered by their bits, so that NaNs are sorted too:
+*   negative NaNs come first, then -0.0 before +0.0, and positive NaNs come last.
+* - '_ColtParallelSorti64(PTR<mut i64> data, u64 size)' sorts an array by sorting
+*   chunks on the thread pool of the runtime, then merging them in parallel.
+* - '_ColtPartitioni64(PTR<mut i64> data, u64 size, i64 pivot)->u64' moves the values
+*   smaller than the pivot first, keeping their order (and the order of the others),
+*   and returns the count of values smaller than the pivot.
+* - '_ColtUniquei64(PTR<mut i64> data, u64 size)->u64' removes the values equal to
+*   their predecessor (duplicates of a sorted array), and returns the new size.
+* - '_ColtPrefixSumi64(PTR<mut i64> data, u64 size)' replaces each value by the sum
+*   of the values up to it (integers wrap around).
+* Partitions and unique of 32 and 64-bit values, and prefix sums of 32 and 64-bit
+* integers, are vectorized using AVX2 if the processor supports it.
+*/
+
+#ifndef HG_COLT_ALGORITHMS
+#define HG_COLT_ALGORITHMS
+
+#include <cstdint>
+
+#include "colt_runtime.h"
+
+/// @brief Calls 'X(NAME, TYPE)' for each built-in numeric type of Colt,
+///        where NAME is the Colt name of the type, and TYPE the C++ type.
+#define COLT_RUNTIME_NUMERIC_TYPES(X) \
+	X(i8, std::int8_t) X(i16, std::int16_t) X(i32, std::int32_t) X(i64, std::int64_t) \
+	X(u8, std::uint8_t) X(u16, std::uint16_t) X(u32, std::uint32_t) X(u64, std::uint64_t) \
+	X(f32, float) X(f64, double)
+
+/// @brief Declares the algorithms of a type (see the file documentation)
+#define COLT_RUNTIME_DECLARE_ALGORITHMS(NAME, TYPE) \
+	COLT_RUNTIME_EXPORT void _ColtSort##NAME(TYPE* data, std::uint64_t size) noexcept; \
+	COLT_RUNTIME_EXPORT void _ColtParallelSort##NAME(TYPE* data, std::uint64_t size) noexcept; \
+	COLT_RUNTIME_EXPORT std::uint64_t _ColtPartition##NAME(TYPE* data, std::uint64_t size, TYPE pivot) noexcept; \
+	COLT_RUNTIME_EXPORT std::uint64_t _ColtUnique##NAME(TYPE* data, std::uint64_t size) noexcept; \
+	COLT_RUNTIME_EXPORT void _ColtPrefixSum##NAME(TYPE* data, std::uint64_t size) noexcept;
+
+COLT_RUNTIME_NUMERIC_TYPES(COLT_RUNTIME_DECLARE_ALGORITHMS)
+
+#undef COLT_RUNTIME_DECLARE_ALGORITHMS
+
+#endif //!HG_COLT_ALGORITHMS
@@ -0,0 +1,591 @@
+/** @file colt_async_io.cpp
+* Contains definition of functions declared in 'colt_async_io.h'.
+*/
+
+#include "colt_async_io.h"
+#include "colt_thread_pool.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+  #include <fcntl.h>
+  #include <io.h>
+  #include <sys/stat.h>
+#else
+  #include <fcntl.h>
+  #include <sys/socket.h>
+  #include <sys/uio.h>
+  #include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+  #include <linux/io_uring.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  /// @brief Defined if io_uring can be used (if the kernel supports it)
+  #define COLT_IO_URING
+#endif
+
+namespace colt::runtime
+{
+  namespace
+  {
+    /// @brief The alignment of the buffers (a page, as required by 'O_DIRECT')
+    constexpr std::uint64_t BUFFER_ALIGNMENT = 4096;
+
+    /// @brief The kind of an operation
+    enum class IoKind : std::uint8_t
+    {
+      Read, Write, Accept, Recv
+    };
+
+    /// @brief An operation queued to a ring
+    struct IoOperation
+    {
+      /// @brief The kind of the operation
+      IoKind kind;
+      /// @brief The file descriptor
+      std::int32_t fd;
+      /// @brief The buffer (nullptr for accepts)
+      std::uint8_t* buffer;
+      /// @brief The index of the buffer
+      std::uint32_t buffer_index;
+      /// @brief The count of bytes
+      std::uint32_t size;
+      /// @brief The offset in the file
+      std::uint64_t offset;
+      /// @brief The user data
+      std::uint64_t user_data;
+    };
+
+    /// @brief The completion of an operation
+    struct IoCompletion
+    {
+      /// @brief The user data of the operation
+      std::uint64_t user_data;
+      /// @brief The result of the operation
+      std::int64_t result;
+    };
+
+    /// @brief Runs an operation synchronously
+    /// @param op The operation
+    /// @return The result of the operation (negated 'errno' on errors)
+    std::int64_t RunOperation(const IoOperation& op) noexcept
+    {
+#ifdef _WIN32
+      if (op.kind == IoKind::Accept || op.kind == IoKind::Recv)
+        return -ENOTSUP; //Sockets are not file descriptors
+      auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(op.fd));
+      if (handle == INVALID_HANDLE_VALUE)
+        return -EBADF;
+      OVERLAPPED overlapped = {};
+      overlapped.Offset = static_cast<DWORD>(op.offset);
+      overlapped.OffsetHigh = static_cast<DWORD>(op.offset >> 32);
+      DWORD transferred = 0;
+      BOOL success = op.kind == IoKind::Read
+        ? ReadFile(handle, op.buffer, op.size, &transferred, &overlapped)
+        : WriteFile(handle, op.buffer, op.size, &transferred, &overlapped);
+      //Reading past the end of a file is not an error
+      if (!success && GetLastError() != ERROR_HANDLE_EOF)
+        return -EIO;
+      return static_cast<std::int64_t>(transferred);
+#else
+      ssize_t result = -1;
+      switch (op.kind)
+      {
+      break; case IoKind::Read:
+        result = pread(op.fd, op.buffer, op.size, static_cast<off_t>(op.offset));
+      break; case IoKind::Write:
+        result = pwrite(op.fd, op.buffer, op.size, static_cast<off_t>(op.offset));
+      break; case IoKind::Accept:
+        result = accept(op.fd, nullptr, nullptr);
+      break; case IoKind::Recv:
+        result = recv(op.fd, op.buffer, op.size, 0);
+      }
+      return result < 0 ? -static_cast<std::int64_t>(errno) : static_cast<std::int64_t>(result);
+#endif
+    }
+
+    /// @brief Buffers, and operations run by io_uring or by the thread pool
+    class IoRing
+    {
+      /// @brief The maximum count of queued operations
+      std::uint32_t entries;
+      /// @brief The buffers (contiguous)
+      std::uint8_t* buffers = nullptr;
+      /// @brief The count of buffers
+      std::uint32_t buffer_count;
+      /// @brief The size of each buffer
+      std::uint64_t buffer_size;
+      /// @brief The completions collected by the last poll
+      std::vector<IoCompletion> completions;
+      /// @brief The count of operations queued but not collected
+      std::uint64_t pending = 0;
+
+      /// @brief The operations queued to the thread pool, not submitted
+      std::vector<IoOperation> queued;
+      /// @brief Protects 'finished' and 'running'
+      std::mutex lock;
+      /// @brief Notified when an operation run by the thread pool completes
+      std::condition_variable wake;
+      /// @brief The completions of the operations run by the thread pool, not collected
+      std::vector<IoCompletion> finished;
+      /// @brief The count of operations being run by the thread pool
+      std::uint64_t running = 0;
+
+#ifdef COLT_IO_URING
+      /// @brief The io_uring instance, or -1 if the thread pool is used
+      int ring_fd = -1;
+      /// @brief The submission queue (and the completion queue, with IORING_FEAT_SINGLE_MMAP)
+      void* sq_ring = nullptr;
+      /// @brief The size of 'sq_ring'
+      std::size_t sq_ring_size = 0;
+      /// @brief The completion queue
+      void* cq_ring = nullptr;
+      /// @brief The size of 'cq_ring'
+      std::size_t cq_ring_size = 0;
+      /// @brief The submission queue entries
+      io_uring_sqe* sqes = nullptr;
+      /// @brief The size of 'sqes'
+      std::size_t sqes_size = 0;
+      /// @brief The head of the submission queue (written by the kernel)
+      unsigned* sq_head;
+      /// @brief The tail of the submission queue
+      unsigned* sq_tail;
+      /// @brief The mask of indices of the submission queue
+      unsigned sq_mask;
+      /// @brief The count of entries of the submission queue
+      unsigned sq_entries;
+      /// @brief The indices of the entries to submit
+      unsigned* sq_array;
+      /// @brief The head of the completion queue
+      unsigned* cq_head;
+      /// @brief The tail of the completion queue (written by the kernel)
+      unsigned* cq_tail;
+      /// @brief The mask of indices of the completion queue
+      unsigned cq_mask;
+      /// @brief The completion queue entries
+      io_uring_cqe* cqes;
+      /// @brief The count of queued entries not submitted
+      unsigned unsubmitted = 0;
+      /// @brief True if the buffers are registered (fixed reads and writes are used)
+      bool registered = false;
+
+      /// @brief Creates the io_uring instance.
+      /// Fails if the kernel does not support io_uring or any of the operations.
+      /// @return True on success
+      bool setup_uring() noexcept
+      {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd < 0)
+          return false;
+
+        constexpr unsigned PROBE_OPS = 64;
+        alignas(io_uring_probe) unsigned char storage[sizeof(io_uring_probe) + PROBE_OPS * sizeof(io_uring_probe_op)] = {};
+        auto probe = reinterpret_cast<io_uring_probe*>(storage);
+        if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, PROBE_OPS) < 0)
+          return false;
+        for (unsigned op : { IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED,
+          IORING_OP_WRITE_FIXED, IORING_OP_ACCEPT, IORING_OP_RECV })
+        {
+          if (op > probe->last_op || (probe->ops[op].flags & IO_URING_OP_SUPPORTED) == 0)
+            return false;
+        }
+
+        sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap)
+          sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+        sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+        if (sq_ring == MAP_FAILED)
+          return sq_ring = nullptr, false;
+        if (single_mmap)
+          cq_ring = sq_ring;
+        else
+        {
+          cq_ring = mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+          if (cq_ring == MAP_FAILED)
+            return cq_ring = nullptr, false;
+        }
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes_ptr = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+        if (sqes_ptr == MAP_FAILED)
+          return false;
+        sqes = static_cast<io_uring_sqe*>(sqes_ptr);
+
+        auto sq = static_cast<char*>(sq_ring);
+        sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_entries = params.sq_entries;
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        auto cq = static_cast<char*>(cq_ring);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        //Registering may fail because of RLIMIT_MEMLOCK: the buffers are then
+        //passed by address (and mapped by the kernel for each operation)
+        if (buffer_count != 0)
+        {
+          std::vector<iovec> iovecs(buffer_count);
+          for (std::uint32_t i = 0; i < buffer_count; i++)
+            iovecs[i] = { buffers + i * buffer_size, buffer_size };
+          registered = syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_BUFFERS,
+            iovecs.data(), buffer_count) == 0;
+        }
+        return true;
+      }
+
+      /// @brief Unmaps the queues, and closes the io_uring instance
+      void close_uring() noexcept
+      {
+        if (sqes != nullptr)
+          munmap(sqes, sqes_size);
+        if (cq_ring != nullptr && cq_ring != sq_ring)
+          munmap(cq_ring, cq_ring_size);
+        if (sq_ring != nullptr)
+          munmap(sq_ring, sq_ring_size);
+        if (ring_fd >= 0)
+          close(ring_fd);
+        sqes = nullptr;
+        sq_ring = cq_ring = nullptr;
+        ring_fd = -1;
+      }
+
+      /// @brief Submits the queued entries, and waits for completions
+      /// @param min_complete The count of completions to wait for
+      /// @return False on errors
+      bool enter(unsigned min_complete) noexcept
+      {
+        for (;;)
+        {
+          if (unsubmitted == 0 && min_complete == 0)
+            return true;
+          long submitted = syscall(__NR_io_uring_enter, ring_fd, unsubmitted, min_complete,
+            min_complete == 0 ? 0u : static_cast<unsigned>(IORING_ENTER_GETEVENTS), nullptr, 0);
+          if (submitted >= 0)
+          {
+            unsubmitted -= static_cast<unsigned>(submitted);
+            return true;
+          }
+          if (errno != EINTR)
+            return false;
+        }
+      }
+
+      /// @brief Moves the entries of the completion queue to 'completions'
+      void reap() noexcept
+      {
+        unsigned head = *cq_head;
+        unsigned tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head)
+        {
+          const io_uring_cqe& cqe = cqes[head & cq_mask];
+          completions.push_back({ cqe.user_data, cqe.res });
+          --pending;
+        }
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+      }
+#endif
+
+    public:
+      /// @brief Allocates the buffers, and sets up io_uring if possible
+      /// @param entries The maximum count of queued operations
+      /// @param buffer_count The count of buffers
+      /// @param buffer_size The size of each buffer
+      IoRing(std::uint32_t entries, std::uint32_t buffer_count, std::uint64_t buffer_size) noexcept
+        : entries(std::max<std::uint32_t>(entries, 1)), buffer_count(buffer_count),
+        buffer_size((buffer_size + BUFFER_ALIGNMENT - 1) & ~(BUFFER_ALIGNMENT - 1))
+      {
+        if (std::uint64_t total = this->buffer_count * this->buffer_size; total != 0)
+          buffers = static_cast<std::uint8_t*>(::operator new(total, std::align_val_t{ BUFFER_ALIGNMENT }, std::nothrow));
+#ifdef COLT_IO_URING
+        //COLT_IO_NO_URING forces the thread pool (to test it, or to avoid kernel bugs)
+        if (std::getenv("COLT_IO_NO_URING") != nullptr || !setup_uring())
+          close_uring();
+#endif
+      }
+
+      /// @brief Waits for the operations run by the thread pool, and frees the buffers
+      ~IoRing() noexcept
+      {
+        {
+          std::unique_lock guard{ lock };
+          wake.wait(guard, [this]() { return running == 0; });
+        }
+#ifdef COLT_IO_URING
+        close_uring();
+#endif
+        if (buffers != nullptr)
+          ::operator delete(buffers, std::align_val_t{ BUFFER_ALIGNMENT });
+      }
+
+      /// @brief Check if the buffers could be allocated
+      /// @return True if the ring is usable
+      bool is_valid() const noexcept { return buffers != nullptr || buffer_count * buffer_size == 0; }
+
+      /// @brief Check if io_uring is used
+      /// @return True if io_uring is used
+      bool uses_uring() const noexcept
+      {
+#ifdef COLT_IO_URING
+        return ring_fd >= 0;
+#else
+        return false;
+#endif
+      }
+
+      /// @brief Returns a buffer
+      /// @param index The index of the buffer
+      /// @return The buffer
+      std::uint8_t* buffer(std::uint32_t index) const noexcept { return buffers + index * buffer_size; }
+      /// @brief Returns the size of the buffers
+      /// @return The size of the buffers
+      std::uint64_t size_of_buffers() const noexcept { return buffer_size; }
+      /// @brief Returns the count of operations queued but not collected
+      /// @return The count of pending operations
+      std::uint64_t pending_count() const noexcept { return pending; }
+      /// @brief Returns a collected completion
+      /// @param index The index of the completion
+      /// @return The completion
+      const IoCompletion& completion(std::uint32_t index) const noexcept { return completions[index]; }
+
+      /// @brief Queues an operation
+      /// @param op The operation
+      /// @return False if too many operations are queued or pending
+      bool queue(const IoOperation& op) noexcept
+      {
+        //So that the completion queue (twice as big as the submission queue) cannot overflow
+        if (pending >= 2 * std::uint64_t(entries))
+          return false;
+#ifdef COLT_IO_URING
+        if (uses_uring())
+        {
+          unsigned tail = *sq_tail;
+          if (tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries)
+            return false;
+          unsigned index = tail & sq_mask;
+          io_uring_sqe* sqe = &sqes[index];
+          std::memset(sqe, 0, sizeof(*sqe));
+          sqe->fd = op.fd;
+          sqe->user_data = op.user_data;
+          sqe->addr = reinterpret_cast<std::uint64_t>(op.buffer);
+          sqe->len = op.size;
+          switch (op.kind)
+          {
+          break; case IoKind::Read:
+            sqe->opcode = registered ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            sqe->off = op.offset;
+            sqe->buf_index = static_cast<std::uint16_t>(op.buffer_index);
+          break; case IoKind::Write:
+            sqe->opcode = registered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+            sqe->off = op.offset;
+            sqe->buf_index = static_cast<std::uint16_t>(op.buffer_index);
+          break; case IoKind::Accept:
+            sqe->opcode = IORING_OP_ACCEPT;
+          break; case IoKind::Recv:
+            sqe->opcode = IORING_OP_RECV;
+          }
+          sq_array[index] = index;
+          __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+          ++unsubmitted;
+          ++pending;
+          return true;
+        }
+#endif
+        if (queued.size() >= entries)
+          return false;
+        queued.push_back(op);
+        ++pending;
+        return true;
+      }
+
+      /// @brief Submits the queued operations
+      /// @return The count of submitted operations
+      std::uint32_t submit() noexcept
+      {
+#ifdef COLT_IO_URING
+        if (uses_uring())
+        {
+          unsigned before = unsubmitted;
+          enter(0);
+          return before - unsubmitted;
+        }
+#endif
+        auto count = static_cast<std::uint32_t>(queued.size());
+        //Without threads in the pool, the operations are run by the caller
+        bool run_inline = ThreadCount() == 1;
+        for (const auto& op : queued)
+        {
+          if (run_inline)
+          {
+            auto result = RunOperation(op);
+            std::scoped_lock guard{ lock };
+            finished.push_back({ op.user_data, result });
+            continue;
+          }
+          {
+            std::scoped_lock guard{ lock };
+            ++running;
+          }
+          SubmitTask([this, op]()
+            {
+              auto result = RunOperation(op);
+              //Notified while locked: once unlocked, the ring may be freed
+              std::scoped_lock guard{ lock };
+              finished.push_back({ op.user_data, result });
+              --running;
+              wake.notify_all();
+            });
+        }
+        queued.clear();
+        return count;
+      }
+
+      /// @brief Submits the queued operations, and collects completions
+      /// @param min_complete The count of completions to wait for
+      /// @return The count of collected completions
+      std::uint32_t poll(std::uint32_t min_complete) noexcept
+      {
+        completions.clear();
+        auto wait_for = static_cast<std::uint32_t>(std::min<std::uint64_t>(min_complete, pending));
+#ifdef COLT_IO_URING
+        if (uses_uring())
+        {
+          reap();
+          enter(0);
+          while (completions.size() < wait_for)
+          {
+            if (!enter(wait_for - static_cast<unsigned>(completions.size())))
+              break;
+            reap();
+          }
+          return static_cast<std::uint32_t>(completions.size());
+        }
+#endif
+        submit();
+        std::unique_lock guard{ lock };
+        wake.wait(guard, [&]() { return finished.size() >= wait_for; });
+        completions.swap(finished);
+        finished.clear();
+        pending -= completions.size();
+        return static_cast<std::uint32_t>(completions.size());
+      }
+    };
+  }
+}
+
+using namespace colt::runtime;
+
+COLT_RUNTIME_EXPORT void* _ColtIoNew(std::uint32_t entries, std::uint32_t buffer_count, std::uint64_t buffer_size) noexcept
+{
+  auto ring = new(std::nothrow) IoRing(entries, buffer_count, buffer_size);
+  if (ring == nullptr)
+    return nullptr;
+  if (ring->is_valid())
+    return ring;
+  delete ring;
+  return nullptr;
+}
+
+COLT_RUNTIME_EXPORT void _ColtIoFree(void* ring) noexcept
+{
+  delete static_cast<IoRing*>(ring);
+}
+
+COLT_RUNTIME_EXPORT bool _ColtIoUsesUring(void* ring) noexcept
+{
+  return static_cast<IoRing*>(ring)->uses_uring();
+}
+
+COLT_RUNTIME_EXPORT std::uint8_t* _ColtIoBuffer(void* ring, std::uint32_t index) noexcept
+{
+  return static_cast<IoRing*>(ring)->buffer(index);
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtIoBufferSize(void* ring) noexcept
+{
+  return static_cast<IoRing*>(ring)->size_of_buffers();
+}
+
+COLT_RUNTIME_EXPORT std::int32_t _ColtIoOpen(const char* path, bool write) noexcept
+{
+#ifdef _WIN32
+  return _open(path, write ? _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY : _O_RDONLY | _O_BINARY,
+    _S_IREAD | _S_IWRITE);
+#else
+  return open(path, write ? O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+#endif
+}
+
+COLT_RUNTIME_EXPORT void _ColtIoClose(std::int32_t fd) noexcept
+{
+#ifdef _WIN32
+  _close(fd);
+#else
+  close(fd);
+#endif
+}
+
+COLT_RUNTIME_EXPORT bool _ColtIoRead(void* ring, std::int32_t fd, std::uint32_t buffer, std::uint64_t offset, std::uint32_t size, std::uint64_t user_data) noexcept
+{
+  auto io = static_cast<IoRing*>(ring);
+  return io->queue({ IoKind::Read, fd, io->buffer(buffer), buffer, size, offset, user_data });
+}
+
+COLT_RUNTIME_EXPORT bool _ColtIoWrite(void* ring, std::int32_t fd, std::uint32_t buffer, std::uint64_t offset, std::uint32_t size, std::uint64_t user_data) noexcept
+{
+  auto io = static_cast<IoRing*>(ring);
+  return io->queue({ IoKind::Write, fd, io->buffer(buffer), buffer, size, offset, user_data });
+}
+
+COLT_RUNTIME_EXPORT bool _ColtIoAccept(void* ring, std::int32_t fd, std::uint64_t user_data) noexcept
+{
+  return static_cast<IoRing*>(ring)->queue({ IoKind::Accept, fd, nullptr, 0, 0, 0, user_data });
+}
+
+COLT_RUNTIME_EXPORT bool _ColtIoRecv(void* ring, std::int32_t fd, std::uint32_t buffer, std::uint32_t size, std::uint64_t user_data) noexcept
+{
+  auto io = static_cast<IoRing*>(ring);
+  return io->queue({ IoKind::Recv, fd, io->buffer(buffer), buffer, size, 0, user_data });
+}
+
+COLT_RUNTIME_EXPORT std::uint32_t _ColtIoSubmit(void* ring) noexcept
+{
+  return static_cast<IoRing*>(ring)->submit();
+}
+
+COLT_RUNTIME_EXPORT std::uint32_t _ColtIoPoll(void* ring, std::uint32_t min_complete) noexcept
+{
+  return static_cast<IoRing*>(ring)->poll(min_complete);
+}
+
+COLT_RUNTIME_EXPORT std::int64_t _ColtIoResult(void* ring, std::uint32_t index) noexcept
+{
+  return static_cast<IoRing*>(ring)->completion(index).result;
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtIoUserData(void* ring, std::uint32_t index) noexcept
+{
+  return static_cast<IoRing*>(ring)->completion(index).user_data;
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtIoPending(void* ring) noexcept
+{
+  return static_cast<IoRing*>(ring)->pending_count();
+}
@@ -0,0 +1,134 @@
+/** @file colt_async_io.h
+* Contains the asynchronous I/O of the runtime.
+* An I/O ring is an opaque pointer ('PTR<void>') owning buffers, to which operations
+* (reads, writes, accepts and receives) are queued, then submitted in batches:
+* ```
+* var ring = _ColtIoNew(64u32, 64u32, 65536u64);
+* _ColtIoRead(ring, fd, 0u32, 0u64, 65536u32, 0u64); //Reads to the buffer 0
+* ...
+* var count = _ColtIoPoll(ring, 1u32); //Submits, and waits for a completion
+* //_ColtIoUserData(ring, i) and _ColtIoResult(ring, i) for i in [0, count)
+* ```
+* On Linux, operations are run by io_uring: a call to '_ColtIoPoll' submits all the
+* queued operations and waits for completions using a single system call, and the
+* buffers are registered with the kernel (so that they are not mapped for each operation).
+* If io_uring is not available (older kernels, seccomp filters, other systems), the
+* operations are run by the thread pool of the runtime (see 'colt_thread_pool.h').
+* Setting the environment variable COLT_IO_NO_URING also forces the use of the thread pool.
+* Results follow the conventions of io_uring: the number of bytes read or written (or
+* the accepted socket), or a negated 'errno' value.
+*/
+
+#ifndef HG_COLT_ASYNC_IO
+#define HG_COLT_ASYNC_IO
+
+#include <cstdint>
+
+#include "colt_runtime.h"
+
+/// @brief Creates an I/O ring
+/// @param entries The maximum count of queued operations (and half the maximum count of pending operations)
+/// @param buffer_count The count of buffers to allocate
+/// @param buffer_size The size of each buffer (rounded up to a multiple of 4096)
+/// @return The I/O ring, or nullptr if the ring or its buffers could not be allocated
+COLT_RUNTIME_EXPORT void* _ColtIoNew(std::uint32_t entries, std::uint32_t buffer_count, std::uint64_t buffer_size) noexcept;
+
+/// @brief Frees an I/O ring and its buffers.
+/// No operation may be pending (see '_ColtIoPending').
+/// @param ring The I/O ring
+COLT_RUNTIME_EXPORT void _ColtIoFree(void* ring) noexcept;
+
+/// @brief Check if an I/O ring runs its operations using io_uring
+/// @param ring The I/O ring
+/// @return True if io_uring is used, false if the thread pool is used
+COLT_RUNTIME_EXPORT bool _ColtIoUsesUring(void* ring) noexcept;
+
+/// @brief Returns a buffer of an I/O ring
+/// @param ring The I/O ring
+/// @param index The index of the buffer
+/// @return The buffer
+COLT_RUNTIME_EXPORT std::uint8_t* _ColtIoBuffer(void* ring, std::uint32_t index) noexcept;
+
+/// @brief Returns the size of the buffers of an I/O ring
+/// @param ring The I/O ring
+/// @return The size of each buffer
+COLT_RUNTIME_EXPORT std::uint64_t _ColtIoBufferSize(void* ring) noexcept;
+
+/// @brief Opens a file
+/// @param path The path of the file (NUL-terminated)
+/// @param write True to create (or truncate) the file for writing, false to read it
+/// @return The file descriptor, or -1 on errors
+COLT_RUNTIME_EXPORT std::int32_t _ColtIoOpen(const char* path, bool write) noexcept;
+
+/// @brief Closes a file descriptor (of a file or a socket)
+/// @param fd The file descriptor
+COLT_RUNTIME_EXPORT void _ColtIoClose(std::int32_t fd) noexcept;
+
+/// @brief Queues a read of a file to a buffer of the ring
+/// @param ring The I/O ring
+/// @param fd The file descriptor
+/// @param buffer The index of the buffer
+/// @param offset The offset in the file
+/// @param size The count of bytes to read (at most the size of the buffer)
+/// @param user_data The value identifying the completion of the operation
+/// @return False if the operation cannot be queued (too many queued or pending operations)
+COLT_RUNTIME_EXPORT bool _ColtIoRead(void* ring, std::int32_t fd, std::uint32_t buffer, std::uint64_t offset, std::uint32_t size, std::uint64_t user_data) noexcept;
+
+/// @brief Queues a write of a buffer of the ring to a file
+/// @param ring The I/O ring
+/// @param fd The file descriptor
+/// @param buffer The index of the buffer
+/// @param offset The offset in the file
+/// @param size The count of bytes to write (at most the size of the buffer)
+/// @param user_data The value identifying the completion of the operation
+/// @return False if the operation cannot be queued (too many queued or pending operations)
+COLT_RUNTIME_EXPORT bool _ColtIoWrite(void* ring, std::int32_t fd, std::uint32_t buffer, std::uint64_t offset, std::uint32_t size, std::uint64_t user_data) noexcept;
+
+/// @brief Queues an accept of a connection on a listening socket.
+/// The result of the operation is the socket of the connection.
+/// @param ring The I/O ring
+/// @param fd The listening socket
+/// @param user_data The value identifying the completion of the operation
+/// @return False if the operation cannot be queued (too many queued or pending operations)
+COLT_RUNTIME_EXPORT bool _ColtIoAccept(void* ring, std::int32_t fd, std::uint64_t user_data) noexcept;
+
+/// @brief Queues a receive from a socket to a buffer of the ring
+/// @param ring The I/O ring
+/// @param fd The socket
+/// @param buffer The index of the buffer
+/// @param size The maximum count of bytes to receive (at most the size of the buffer)
+/// @param user_data The value identifying the completion of the operation
+/// @return False if the operation cannot be queued (too many queued or pending operations)
+COLT_RUNTIME_EXPORT bool _ColtIoRecv(void* ring, std::int32_t fd, std::uint32_t buffer, std::uint32_t size, std::uint64_t user_data) noexcept;
+
+/// @brief Submits the queued operations, without waiting for their completion
+/// @param ring The I/O ring
+/// @return The count of submitted operations
+COLT_RUNTIME_EXPORT std::uint32_t _ColtIoSubmit(void* ring) noexcept;
+
+/// @brief Submits the queued operations, and collects completions.
+/// The completions of the previous call are discarded.
+/// @param ring The I/O ring
+/// @param min_complete The count of completions to wait for (0 to not wait),
+///                     capped by the count of pending operations
+/// @return The count of collected completions
+COLT_RUNTIME_EXPORT std::uint32_t _ColtIoPoll(void* ring, std::uint32_t min_complete) noexcept;
+
+/// @brief Returns the result of a completion collected by the last '_ColtIoPoll'
+/// @param ring The I/O ring
+/// @param index The index of the completion
+/// @return The result of the operation (negative on errors)
+COLT_RUNTIME_EXPORT std::int64_t _ColtIoResult(void* ring, std::uint32_t index) noexcept;
+
+/// @brief Returns the user data of a completion collected by the last '_ColtIoPoll'
+/// @param ring The I/O ring
+/// @param index The index of the completion
+/// @return The user data of the operation
+COLT_RUNTIME_EXPORT std::uint64_t _ColtIoUserData(void* ring, std::uint32_t index) noexcept;
+
+/// @brief Returns the count of operations that were queued but not collected
+/// @param ring The I/O ring
+/// @return The count of pending operations
+COLT_RUNTIME_EXPORT std::uint64_t _ColtIoPending(void* ring) noexcept;
+
+#endif //!HG_COLT_ASYNC_IO
@@ -0,0 +1,643 @@
+/** @file colt_containers.cpp
+* Contains definition of functions declared in 'colt_containers.h'.
+*/
+
+#include "colt_containers.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  /// @brief Defined if groups of control bytes are compared using SSE2
+  #define COLT_CONTAINERS_SSE2
+#endif
+
+#ifdef _MSC_VER
+  #include <intrin.h>
+#endif
+
+namespace colt::runtime
+{
+  namespace
+  {
+    /// @brief Aborts if an allocation failed
+    /// @param ptr The result of the allocation
+    /// @return ptr
+    void* CheckAllocation(void* ptr) noexcept
+    {
+      if (ptr == nullptr)
+      {
+        std::fputs("Not enough memory to continue execution! Aborting...\n", stderr);
+        std::abort();
+      }
+      return ptr;
+    }
+
+    /// @brief The header of a block of an arena, followed by the memory of the block
+    struct alignas(16) ArenaBlock
+    {
+      /// @brief The previously allocated block, or nullptr
+      ArenaBlock* previous;
+      /// @brief The size of the memory of the block
+      std::size_t size;
+    };
+
+    /// @brief Allocates by incrementing an offset in its current block.
+    ///        All the memory is freed at once, when the arena is freed.
+    struct Arena
+    {
+      /// @brief The default size of blocks
+      static constexpr std::size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+      /// @brief The block from which to allocate, or nullptr
+      ArenaBlock* current = nullptr;
+      /// @brief The bytes used in the current block
+      std::size_t used = 0;
+      /// @brief The size of the blocks
+      std::size_t block_size = DEFAULT_BLOCK_SIZE;
+
+      /// @brief Allocates memory aligned on 16 bytes
+      /// @param size The size of the memory
+      /// @return The memory
+      void* allocate(std::size_t size) noexcept
+      {
+        size = (size + 15) & ~std::size_t{ 15 };
+        if (current != nullptr && current->size - used >= size)
+        {
+          void* ptr = reinterpret_cast<char*>(current + 1) + used;
+          used += size;
+          return ptr;
+        }
+        //Allocations bigger than a quarter of a block get their own block,
+        //placed behind the current one, which is still used afterwards
+        if (current != nullptr && size > block_size / 4)
+        {
+          auto block = NewBlock(size);
+          block->previous = current->previous;
+          current->previous = block;
+          return block + 1;
+        }
+        auto block = NewBlock(std::max(size, block_size));
+        block->previous = current;
+        current = block;
+        used = size;
+        return block + 1;
+      }
+
+      /// @brief Frees all the blocks
+      ~Arena() noexcept
+      {
+        while (current != nullptr)
+          std::free(std::exchange(current, current->previous));
+      }
+
+    private:
+      /// @brief Allocates a block
+      /// @param size The size of the memory of the block
+      /// @return The block (whose 'previous' is not initialized)
+      static ArenaBlock* NewBlock(std::size_t size) noexcept
+      {
+        auto block = static_cast<ArenaBlock*>(CheckAllocation(std::malloc(sizeof(ArenaBlock) + size)));
+        block->size = size;
+        return block;
+      }
+    };
+
+    /// @brief Allocates memory aligned on 16 bytes
+    /// @param arena The arena from which to allocate, or nullptr for the heap
+    /// @param size The size of the memory
+    /// @return The memory
+    void* Allocate(Arena* arena, std::size_t size) noexcept
+    {
+      if (arena != nullptr)
+        return arena->allocate(size);
+      return CheckAllocation(std::malloc(size));
+    }
+
+    /// @brief Frees memory returned by Allocate
+    /// @param arena The arena from which the memory was allocated, or nullptr for the heap
+    /// @param ptr The memory (or nullptr)
+    void Deallocate(Arena* arena, void* ptr) noexcept
+    {
+      //The memory of an arena is freed with the arena
+      if (arena == nullptr)
+        std::free(ptr);
+    }
+
+    /// @brief Creates an object using Allocate
+    /// @tparam T The type of the object
+    /// @param arena The arena from which to allocate, or nullptr for the heap
+    /// @return The object
+    template<typename T>
+    T* New(Arena* arena) noexcept
+    {
+      return new(Allocate(arena, sizeof(T))) T{ arena };
+    }
+
+    /// @brief A growable vector of u64
+    struct Vector
+    {
+      /// @brief The arena from which the vector is allocated, or nullptr
+      Arena* arena;
+      /// @brief The values
+      std::uint64_t* data = nullptr;
+      /// @brief The number of values
+      std::uint64_t size = 0;
+      /// @brief The number of values that can be stored without growing
+      std::uint64_t capacity = 0;
+
+      /// @brief Grows the vector, at least doubling its capacity
+      /// @param min_capacity The minimum capacity after growing
+      void grow(std::uint64_t min_capacity) noexcept
+      {
+        std::uint64_t new_capacity = std::max({ capacity * 2, min_capacity, std::uint64_t{ 8 } });
+        if (arena == nullptr)
+        {
+          //Big buffers are moved without copying by the system allocator
+          data = static_cast<std::uint64_t*>(CheckAllocation(std::realloc(data, new_capacity * sizeof(std::uint64_t))));
+        }
+        else
+        {
+          auto new_data = static_cast<std::uint64_t*>(arena->allocate(new_capacity * sizeof(std::uint64_t)));
+          if (size != 0)
+            std::memcpy(new_data, data, size * sizeof(std::uint64_t));
+          data = new_data;
+        }
+        capacity = new_capacity;
+      }
+    };
+
+    /// @brief The control byte of an empty slot
+    constexpr std::int8_t CTRL_EMPTY = -128;
+    /// @brief The control byte of the slot of a removed key, so that searches
+    ///        continue past it (the control byte of a key is positive)
+    constexpr std::int8_t CTRL_DELETED = -2;
+
+    /// @brief Returns the index of the lowest set bit of a non-zero value
+    /// @param value The value (must not be 0)
+    /// @return The index of the lowest set bit
+    inline std::uint32_t CountTrailingZeros(std::uint64_t value) noexcept
+    {
+#ifdef _MSC_VER
+      unsigned long index;
+      _BitScanForward64(&index, value);
+      return static_cast<std::uint32_t>(index);
+#else
+      return static_cast<std::uint32_t>(__builtin_ctzll(value));
+#endif
+    }
+
+    /// @brief A group of control bytes, compared at once.
+    /// Each match is a set bit of a mask, from which MaskIndex returns the
+    /// index of the control byte in the group.
+    struct Group
+    {
+#ifdef COLT_CONTAINERS_SSE2
+      /// @brief The number of control bytes of a group
+      static constexpr std::uint64_t WIDTH = 16;
+
+      /// @brief The control bytes
+      __m128i ctrl;
+
+      /// @brief Loads a group
+      /// @param ptr Pointer to the first control byte of the group
+      explicit Group(const std::int8_t* ptr) noexcept
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr))) {}
+
+      /// @brief Returns the control bytes of a group equal to a byte
+      /// @param h2 The byte (the 7 low bits of a hash)
+      /// @return A bit per matching control byte
+      std::uint64_t match(std::int8_t h2) const noexcept
+      {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2))));
+      }
+
+      /// @brief Returns the empty control bytes of the group
+      /// @return A bit per empty control byte
+      std::uint64_t match_empty() const noexcept
+      {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(CTRL_EMPTY))));
+      }
+
+      /// @brief Returns the empty or deleted control bytes of the group
+      /// @return A bit per empty or deleted control byte
+      std::uint64_t match_empty_or_deleted() const noexcept
+      {
+        //Only the control bytes of keys are positive
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+      }
+
+      /// @brief Returns the index of the control byte of the lowest match of a mask
+      /// @param mask The mask (must not be 0)
+      /// @return The index in the group
+      static std::uint64_t MaskIndex(std::uint64_t mask) noexcept { return CountTrailingZeros(mask); }
+#else
+      /// @brief The number of control bytes of a group
+      static constexpr std::uint64_t WIDTH = 8;
+      /// @brief The lowest bit of each byte
+      static constexpr std::uint64_t LSBS = 0x0101010101010101ULL;
+      /// @brief The highest bit of each byte
+      static constexpr std::uint64_t MSBS = 0x8080808080808080ULL;
+
+      /// @brief The control bytes
+      std::uint64_t ctrl;
+
+      /// @brief Loads a group
+      /// @param ptr Pointer to the first control byte of the group
+      explicit Group(const std::int8_t* ptr) noexcept
+      {
+        std::memcpy(&ctrl, ptr, sizeof(ctrl));
+      }
+
+      /// @brief Returns the control bytes of a group equal to a byte.
+      /// There may be false positives (never on empty or deleted bytes):
+      /// the keys of the slots of the matches are compared anyway.
+      /// @param h2 The byte (the 7 low bits of a hash)
+      /// @return The high bit of each matching control byte
+      std::uint64_t match(std::int8_t h2) const noexcept
+      {
+        std::uint64_t x = ctrl ^ (LSBS * static_cast<std::uint8_t>(h2));
+        return (x - LSBS) & ~x & MSBS;
+      }
+
+      /// @brief Returns the empty control bytes of the group
+      /// @return The high bit of each empty control byte
+      std::uint64_t match_empty() const noexcept
+      {
+        //Empty bytes are the only ones whose 2 high bits are '10'
+        return ctrl & ~(ctrl << 1) & MSBS;
+      }
+
+      /// @brief Returns the empty or deleted control bytes of the group
+      /// @return The high bit of each empty or deleted control byte
+      std::uint64_t match_empty_or_deleted() const noexcept
+      {
+        return ctrl & MSBS;
+      }
+
+      /// @brief Returns the index of the control byte of the lowest match of a mask
+      /// @param mask The mask (must not be 0)
+      /// @return The index in the group
+      static std::uint64_t MaskIndex(std::uint64_t mask) noexcept { return CountTrailingZeros(mask) / 8; }
+#endif
+    };
+
+    /// @brief A key and its value
+    struct Slot
+    {
+      /// @brief The key
+      std::uint64_t key;
+      /// @brief The value
+      std::uint64_t value;
+    };
+
+    /// @brief Hashes a key
+    /// @param key The key
+    /// @return The hash (the finalizer of MurmurHash3)
+    inline std::uint64_t Hash(std::uint64_t key) noexcept
+    {
+      key ^= key >> 33;
+      key *= 0xFF51AFD7ED558CCDULL;
+      key ^= key >> 33;
+      key *= 0xC4CEB9FE1A85EC53ULL;
+      return key ^ (key >> 33);
+    }
+
+    /// @brief An open addressing hash table of u64, whose slots are found
+    ///        by comparing groups of control bytes (see Group).
+    struct HashMap
+    {
+      /// @brief Returned by 'find' if a key is not present
+      static constexpr std::uint64_t NOT_FOUND = ~std::uint64_t{ 0 };
+
+      /// @brief The arena from which the hash map is allocated, or nullptr
+      Arena* arena;
+      /// @brief The slots (followed by the control bytes in the same allocation)
+      Slot* slots = nullptr;
+      /// @brief The control byte of each slot, followed by a copy of the first
+      ///        'Group::WIDTH' bytes, so that groups can be loaded at any index
+      std::int8_t* ctrl = nullptr;
+      /// @brief The number of slots (0, or a power of 2 not smaller than 'Group::WIDTH')
+      std::uint64_t capacity = 0;
+      /// @brief The number of keys
+      std::uint64_t size = 0;
+      /// @brief The number of empty slots that can be filled before growing
+      std::uint64_t growth_left = 0;
+
+      /// @brief Returns the index of the slot of a key
+      /// @param key The key
+      /// @param hash The hash of the key
+      /// @return The index of the slot, or NOT_FOUND
+      std::uint64_t find(std::uint64_t key, std::uint64_t hash) const noexcept
+      {
+        if (capacity == 0)
+          return NOT_FOUND;
+        auto h2 = static_cast<std::int8_t>(hash & 0x7F);
+        std::uint64_t mask = capacity - 1;
+        std::uint64_t offset = (hash >> 7) & mask;
+        //Triangular probing visits every group, and there is always an empty slot
+        for (std::uint64_t step = Group::WIDTH;; step += Group::WIDTH)
+        {
+          Group group{ ctrl + offset };
+          for (auto matches = group.match(h2); matches != 0; matches &= matches - 1)
+          {
+            std::uint64_t index = (offset + Group::MaskIndex(matches)) & mask;
+            if (slots[index].key == key)
+              return index;
+          }
+          if (group.match_empty() != 0)
+            return NOT_FOUND;
+          offset = (offset + step) & mask;
+        }
+      }
+
+      /// @brief Returns the index of the slot of a key, inserting it if needed
+      /// @param key The key
+      /// @param value The value of the key if it is inserted
+      /// @param inserted Set to true if the key was inserted
+      /// @return The index of the slot of the key
+      std::uint64_t find_or_insert(std::uint64_t key, std::uint64_t value, bool& inserted) noexcept
+      {
+        std::uint64_t hash = Hash(key);
+        if (auto index = find(key, hash); index != NOT_FOUND)
+        {
+          inserted = false;
+          return index;
+        }
+        if (growth_left == 0)
+          rehash(size + 1 > MaxLoad(capacity) / 2 ? std::max(capacity * 2, Group::WIDTH) : capacity);
+        std::uint64_t index = find_insert_slot(hash);
+        //Reusing the slot of a removed key does not reduce the empty slots
+        growth_left -= ctrl[index] == CTRL_EMPTY;
+        set_ctrl(index, static_cast<std::int8_t>(hash & 0x7F));
+        slots[index] = { key, value };
+        ++size;
+        inserted = true;
+        return index;
+      }
+
+      /// @brief Removes the key of a slot
+      /// @param index The index of the slot
+      void erase_at(std::uint64_t index) noexcept
+      {
+        set_ctrl(index, CTRL_DELETED);
+        --size;
+      }
+
+      /// @brief Removes all the keys
+      void clear() noexcept
+      {
+        if (capacity == 0)
+          return;
+        std::memset(ctrl, CTRL_EMPTY, capacity + Group::WIDTH);
+        size = 0;
+        growth_left = MaxLoad(capacity);
+      }
+
+      /// @brief Frees the slots
+      ~HashMap() noexcept
+      {
+        Deallocate(arena, slots);
+      }
+
+    private:
+      /// @brief Returns the maximum number of keys of a table
+      /// @param capacity The number of slots
+      /// @return The number of keys after which the table grows (7/8 of the slots)
+      static std::uint64_t MaxLoad(std::uint64_t capacity) noexcept
+      {
+        return capacity - capacity / 8;
+      }
+
+      /// @brief Sets the control byte of a slot, and its copy
+      /// @param index The index of the slot
+      /// @param value The control byte
+      void set_ctrl(std::uint64_t index, std::int8_t value) noexcept
+      {
+        ctrl[index] = value;
+        if (index < Group::WIDTH)
+          ctrl[capacity + index] = value;
+      }
+
+      /// @brief Returns the first empty or deleted slot on the probe sequence of a hash
+      /// @param hash The hash
+      /// @return The index of the slot
+      std::uint64_t find_insert_slot(std::uint64_t hash) const noexcept
+      {
+        std::uint64_t mask = capacity - 1;
+        std::uint64_t offset = (hash >> 7) & mask;
+        for (std::uint64_t step = Group::WIDTH;; step += Group::WIDTH)
+        {
+          if (auto free = Group{ ctrl + offset }.match_empty_or_deleted(); free != 0)
+            return (offset + Group::MaskIndex(free)) & mask;
+          offset = (offset + step) & mask;
+        }
+      }
+
+      /// @brief Moves the keys to new slots, removing the deleted ones
+      /// @param new_capacity The new number of slots
+      void rehash(std::uint64_t new_capacity) noexcept
+      {
+        Slot* old_slots = slots;
+        std::int8_t* old_ctrl = ctrl;
+        std::uint64_t old_capacity = capacity;
+
+        slots = static_cast<Slot*>(Allocate(arena, new_capacity * sizeof(Slot) + new_capacity + Group::WIDTH));
+        ctrl = reinterpret_cast<std::int8_t*>(slots + new_capacity);
+        capacity = new_capacity;
+        std::memset(ctrl, CTRL_EMPTY, new_capacity + Group::WIDTH);
+        growth_left = MaxLoad(new_capacity) - size;
+
+        for (std::uint64_t i = 0; i < old_capacity; i++)
+        {
+          if (old_ctrl[i] < 0)
+            continue;
+          std::uint64_t hash = Hash(old_slots[i].key);
+          std::uint64_t index = find_insert_slot(hash);
+          set_ctrl(index, static_cast<std::int8_t>(hash & 0x7F));
+          slots[index] = old_slots[i];
+        }
+        Deallocate(arena, old_slots);
+      }
+    };
+  }
+}
+
+using namespace colt::runtime;
+
+COLT_RUNTIME_EXPORT void* _ColtArenaNew(std::uint64_t block_size) noexcept
+{
+  auto arena = new(CheckAllocation(std::malloc(sizeof(Arena)))) Arena{};
+  if (block_size != 0)
+    arena->block_size = static_cast<std::size_t>(block_size);
+  return arena;
+}
+
+COLT_RUNTIME_EXPORT void _ColtArenaFree(void* arena) noexcept
+{
+  if (arena == nullptr)
+    return;
+  static_cast<Arena*>(arena)->~Arena();
+  std::free(arena);
+}
+
+COLT_RUNTIME_EXPORT void* _ColtVecNew() noexcept
+{
+  return New<Vector>(nullptr);
+}
+
+COLT_RUNTIME_EXPORT void* _ColtVecNewIn(void* arena) noexcept
+{
+  return New<Vector>(static_cast<Arena*>(arena));
+}
+
+COLT_RUNTIME_EXPORT void _ColtVecFree(void* vec) noexcept
+{
+  auto vector = static_cast<Vector*>(vec);
+  if (vector == nullptr || vector->arena != nullptr)
+    return;
+  std::free(vector->data);
+  std::free(vector);
+}
+
+COLT_RUNTIME_EXPORT void _ColtVecPush(void* vec, std::uint64_t value) noexcept
+{
+  auto vector = static_cast<Vector*>(vec);
+  if (vector->size == vector->capacity)
+    vector->grow(vector->size + 1);
+  vector->data[vector->size++] = value;
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtVecPop(void* vec) noexcept
+{
+  auto vector = static_cast<Vector*>(vec);
+  return vector->data[--vector->size];
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtVecGet(void* vec, std::uint64_t index) noexcept
+{
+  return static_cast<Vector*>(vec)->data[index];
+}
+
+COLT_RUNTIME_EXPORT void _ColtVecSet(void* vec, std::uint64_t index, std::uint64_t value) noexcept
+{
+  static_cast<Vector*>(vec)->data[index] = value;
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtVecSize(void* vec) noexcept
+{
+  return static_cast<Vector*>(vec)->size;
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t* _ColtVecData(void* vec) noexcept
+{
+  return static_cast<Vector*>(vec)->data;
+}
+
+COLT_RUNTIME_EXPORT void _ColtVecReserve(void* vec, std::uint64_t capacity) noexcept
+{
+  auto vector = static_cast<Vector*>(vec);
+  if (capacity > vector->capacity)
+    vector->grow(capacity);
+}
+
+COLT_RUNTIME_EXPORT void _ColtVecClear(void* vec) noexcept
+{
+  static_cast<Vector*>(vec)->size = 0;
+}
+
+COLT_RUNTIME_EXPORT void* _ColtMapNew() noexcept
+{
+  return New<HashMap>(nullptr);
+}
+
+COLT_RUNTIME_EXPORT void* _ColtMapNewIn(void* arena) noexcept
+{
+  return New<HashMap>(static_cast<Arena*>(arena));
+}
+
+COLT_RUNTIME_EXPORT void _ColtMapFree(void* map) noexcept
+{
+  auto hash_map = static_cast<HashMap*>(map);
+  if (hash_map == nullptr || hash_map->arena != nullptr)
+    return;
+  hash_map->~HashMap();
+  std::free(hash_map);
+}
+
+COLT_RUNTIME_EXPORT bool _ColtMapInsert(void* map, std::uint64_t key, std::uint64_t value) noexcept
+{
+  auto hash_map = static_cast<HashMap*>(map);
+  bool inserted;
+  auto index = hash_map->find_or_insert(key, value, inserted);
+  hash_map->slots[index].value = value;
+  return inserted;
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtMapAdd(void* map, std::uint64_t key, std::uint64_t delta) noexcept
+{
+  auto hash_map = static_cast<HashMap*>(map);
+  bool inserted;
+  auto index = hash_map->find_or_insert(key, 0, inserted);
+  return hash_map->slots[index].value += delta;
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtMapGet(void* map, std::uint64_t key, std::uint64_t if_absent) noexcept
+{
+  auto hash_map = static_cast<HashMap*>(map);
+  auto index = hash_map->find(key, Hash(key));
+  return index == HashMap::NOT_FOUND ? if_absent : hash_map->slots[index].value;
+}
+
+COLT_RUNTIME_EXPORT bool _ColtMapContains(void* map, std::uint64_t key) noexcept
+{
+  return static_cast<HashMap*>(map)->find(key, Hash(key)) != HashMap::NOT_FOUND;
+}
+
+COLT_RUNTIME_EXPORT bool _ColtMapErase(void* map, std::uint64_t key) noexcept
+{
+  auto hash_map = static_cast<HashMap*>(map);
+  auto index = hash_map->find(key, Hash(key));
+  if (index == HashMap::NOT_FOUND)
+    return false;
+  hash_map->erase_at(index);
+  return true;
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtMapSize(void* map) noexcept
+{
+  return static_cast<HashMap*>(map)->size;
+}
+
+COLT_RUNTIME_EXPORT void _ColtMapClear(void* map) noexcept
+{
+  static_cast<HashMap*>(map)->clear();
+}
+
+COLT_RUNTIME_EXPORT void _ColtMapKeys(void* map, void* vec) noexcept
+{
+  auto hash_map = static_cast<HashMap*>(map);
+  _ColtVecReserve(vec, _ColtVecSize(vec) + hash_map->size);
+  for (std::uint64_t i = 0; i < hash_map->capacity; i++)
+  {
+    if (hash_map->ctrl[i] >= 0)
+      _ColtVecPush(vec, hash_map->slots[i].key);
+  }
+}
+
+COLT_RUNTIME_EXPORT void _ColtMapValues(void* map, void* vec) noexcept
+{
+  auto hash_map = static_cast<HashMap*>(map);
+  _ColtVecReserve(vec, _ColtVecSize(vec) + hash_map->size);
+  for (std::uint64_t i = 0; i < hash_map->capacity; i++)
+  {
+    if (hash_map->ctrl[i] >= 0)
+      _ColtVecPush(vec, hash_map->slots[i].value);
+  }
+}
@@ -0,0 +1,151 @@
+/** @file colt_containers.h
+* Contains the containers of the runtime.
+* Containers are opaque pointers ('PTR<void>') storing 'u64' values: pointers and
+* floats are stored using 'bit_as'.
+* - The vector grows geometrically: pushing is amortized O(1).
+* - The hash map is an open addressing table (a SwissTable): the 7 low bits of the hash of
+*   each key are stored in a control byte, and a group of 16 control bytes is compared at once
+*   using SSE2 (or 8 bytes at once using 64-bit arithmetic), so that slots are only read on a match.
+* Containers are allocated on the heap, or from an arena (functions ending with 'In').
+* The memory of an arena is only freed with the arena: freeing a container
+* allocated from an arena does nothing.
+*/
+
+#ifndef HG_COLT_CONTAINERS
+#define HG_COLT_CONTAINERS
+
+#include <cstdint>
+
+#include "colt_runtime.h"
+
+/// @brief Creates an arena
+/// @param block_size The size of the blocks allocated by the arena (0 for the default size)
+/// @return The arena
+COLT_RUNTIME_EXPORT void* _ColtArenaNew(std::uint64_t block_size) noexcept;
+
+/// @brief Frees an arena, and all the containers allocated from it
+/// @param arena The arena to free
+COLT_RUNTIME_EXPORT void _ColtArenaFree(void* arena) noexcept;
+
+/// @brief Creates an empty vector allocated on the heap
+/// @return The vector
+COLT_RUNTIME_EXPORT void* _ColtVecNew() noexcept;
+
+/// @brief Creates an empty vector allocated from an arena
+/// @param arena The arena from which to allocate
+/// @return The vector
+COLT_RUNTIME_EXPORT void* _ColtVecNewIn(void* arena) noexcept;
+
+/// @brief Frees a vector
+/// @param vec The vector
+COLT_RUNTIME_EXPORT void _ColtVecFree(void* vec) noexcept;
+
+/// @brief Appends a value at the end of a vector
+/// @param vec The vector
+/// @param value The value to append
+COLT_RUNTIME_EXPORT void _ColtVecPush(void* vec, std::uint64_t value) noexcept;
+
+/// @brief Removes the last value of a non-empty vector
+/// @param vec The vector
+/// @return The removed value
+COLT_RUNTIME_EXPORT std::uint64_t _ColtVecPop(void* vec) noexcept;
+
+/// @brief Returns a value of a vector
+/// @param vec The vector
+/// @param index The index of the value (must be smaller than the size)
+/// @return The value
+COLT_RUNTIME_EXPORT std::uint64_t _ColtVecGet(void* vec, std::uint64_t index) noexcept;
+
+/// @brief Modifies a value of a vector
+/// @param vec The vector
+/// @param index The index of the value (must be smaller than the size)
+/// @param value The new value
+COLT_RUNTIME_EXPORT void _ColtVecSet(void* vec, std::uint64_t index, std::uint64_t value) noexcept;
+
+/// @brief Returns the number of values of a vector
+/// @param vec The vector
+/// @return The size of the vector
+COLT_RUNTIME_EXPORT std::uint64_t _ColtVecSize(void* vec) noexcept;
+
+/// @brief Returns the values of a vector, to iterate over them without calls.
+/// The pointer is invalidated by any function that adds values to the vector.
+/// @param vec The vector
+/// @return Pointer to the first value
+COLT_RUNTIME_EXPORT std::uint64_t* _ColtVecData(void* vec) noexcept;
+
+/// @brief Ensures that a vector can hold a number of values without growing
+/// @param vec The vector
+/// @param capacity The number of values
+COLT_RUNTIME_EXPORT void _ColtVecReserve(void* vec, std::uint64_t capacity) noexcept;
+
+/// @brief Removes all the values of a vector (its capacity is kept)
+/// @param vec The vector
+COLT_RUNTIME_EXPORT void _ColtVecClear(void* vec) noexcept;
+
+/// @brief Creates an empty hash map allocated on the heap
+/// @return The hash map
+COLT_RUNTIME_EXPORT void* _ColtMapNew() noexcept;
+
+/// @brief Creates an empty hash map allocated from an arena
+/// @param arena The arena from which to allocate
+/// @return The hash map
+COLT_RUNTIME_EXPORT void* _ColtMapNewIn(void* arena) noexcept;
+
+/// @brief Frees a hash map
+/// @param map The hash map
+COLT_RUNTIME_EXPORT void _ColtMapFree(void* map) noexcept;
+
+/// @brief Inserts a key, or modifies its value if it is already present
+/// @param map The hash map
+/// @param key The key
+/// @param value The value of the key
+/// @return True if the key was inserted, false if it was already present
+COLT_RUNTIME_EXPORT bool _ColtMapInsert(void* map, std::uint64_t key, std::uint64_t value) noexcept;
+
+/// @brief Adds to the value of a key, which is inserted with a value of 0 if not present.
+/// This is the only lookup needed to count or sum values per key.
+/// @param map The hash map
+/// @param key The key
+/// @param delta The value to add (wraps around)
+/// @return The new value of the key
+COLT_RUNTIME_EXPORT std::uint64_t _ColtMapAdd(void* map, std::uint64_t key, std::uint64_t delta) noexcept;
+
+/// @brief Returns the value of a key
+/// @param map The hash map
+/// @param key The key
+/// @param if_absent The value to return if the key is not present
+/// @return The value of the key, or 'if_absent'
+COLT_RUNTIME_EXPORT std::uint64_t _ColtMapGet(void* map, std::uint64_t key, std::uint64_t if_absent) noexcept;
+
+/// @brief Check if a key is present
+/// @param map The hash map
+/// @param key The key
+/// @return True if the key is present
+COLT_RUNTIME_EXPORT bool _ColtMapContains(void* map, std::uint64_t key) noexcept;
+
+/// @brief Removes a key
+/// @param map The hash map
+/// @param key The key
+/// @return True if the key was present
+COLT_RUNTIME_EXPORT bool _ColtMapErase(void* map, std::uint64_t key) noexcept;
+
+/// @brief Returns the number of keys of a hash map
+/// @param map The hash map
+/// @return The size of the hash map
+COLT_RUNTIME_EXPORT std::uint64_t _ColtMapSize(void* map) noexcept;
+
+/// @brief Removes all the keys of a hash map (its capacity is kept)
+/// @param map The hash map
+COLT_RUNTIME_EXPORT void _ColtMapClear(void* map) noexcept;
+
+/// @brief Appends the keys of a hash map to a vector, in an unspecified order
+/// @param map The hash map
+/// @param vec The vector
+COLT_RUNTIME_EXPORT void _ColtMapKeys(void* map, void* vec) noexcept;
+
+/// @brief Appends the values of a hash map to a vector, in the order of '_ColtMapKeys'
+/// @param map The hash map
+/// @param vec The vector
+COLT_RUNTIME_EXPORT void _ColtMapValues(void* map, void* vec) noexcept;
+
+#endif //!HG_COLT_CONTAINERS
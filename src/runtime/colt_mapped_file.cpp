@@ -0,0 +1,259 @@
+/** @file colt_mapped_file.cpp
+* Contains definition of functions declared in 'colt_mapped_file.h'.
+*/
+
+#include "colt_mapped_file.h"
+
+#include <new>
+
+#ifdef _WIN32
+  #define WIN32_LEAN_AND_MEAN
+  #define NOMINMAX
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace colt::runtime
+{
+  namespace
+  {
+    /// @brief A mapped file
+    struct MappedFile
+    {
+      /// @brief The bytes of the file, or nullptr if the file is empty
+      std::uint8_t* data = nullptr;
+      /// @brief The size of the file
+      std::uint64_t size = 0;
+      /// @brief True if the file is mapped for writing
+      bool writable = false;
+#ifdef _WIN32
+      /// @brief The file
+      HANDLE file = INVALID_HANDLE_VALUE;
+      /// @brief The mapping of the file, or nullptr if the file is empty
+      HANDLE mapping = nullptr;
+#else
+      /// @brief The descriptor of the file (only kept open for writing)
+      int descriptor = -1;
+#endif
+    };
+
+    /// @brief Maps 'size' bytes of the file
+    /// @param file The file
+    /// @return True on success
+    bool Map(MappedFile& file) noexcept
+    {
+      file.data = nullptr;
+      if (file.size == 0)
+        return true;
+#ifdef _WIN32
+      file.mapping = CreateFileMappingW(file.file, nullptr,
+        file.writable ? PAGE_READWRITE : PAGE_READONLY,
+        static_cast<DWORD>(file.size >> 32), static_cast<DWORD>(file.size), nullptr);
+      if (file.mapping == nullptr)
+        return false;
+      void* view = MapViewOfFile(file.mapping, file.writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+      if (view == nullptr)
+      {
+        CloseHandle(file.mapping);
+        file.mapping = nullptr;
+        return false;
+      }
+#else
+      void* view = mmap(nullptr, file.size,
+        file.writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, file.descriptor, 0);
+      if (view == MAP_FAILED)
+        return false;
+      if (!file.writable)
+      {
+        //Only hints: the kernel reads ahead, and frees the pages already read first
+        madvise(view, file.size, MADV_SEQUENTIAL);
+  #ifdef MADV_HUGEPAGE
+        //Only used by file systems supporting huge pages for files
+        madvise(view, file.size, MADV_HUGEPAGE);
+  #endif
+      }
+#endif
+      file.data = static_cast<std::uint8_t*>(view);
+      return true;
+    }
+
+    /// @brief Unmaps the bytes of the file
+    /// @param file The file
+    void Unmap(MappedFile& file) noexcept
+    {
+      if (file.data == nullptr)
+        return;
+#ifdef _WIN32
+      UnmapViewOfFile(file.data);
+      CloseHandle(file.mapping);
+      file.mapping = nullptr;
+#else
+      munmap(file.data, file.size);
+#endif
+      file.data = nullptr;
+    }
+
+    /// @brief Changes the size of an (unmapped) file opened for writing
+    /// @param file The file
+    /// @param size The new size
+    /// @return True on success
+    bool Truncate(MappedFile& file, std::uint64_t size) noexcept
+    {
+#ifdef _WIN32
+      LARGE_INTEGER end;
+      end.QuadPart = static_cast<LONGLONG>(size);
+      return SetFilePointerEx(file.file, end, nullptr, FILE_BEGIN) && SetEndOfFile(file.file);
+#else
+      return ftruncate(file.descriptor, static_cast<off_t>(size)) == 0;
+#endif
+    }
+
+    /// @brief Closes the file (which must be unmapped)
+    /// @param file The file
+    void Close(MappedFile& file) noexcept
+    {
+#ifdef _WIN32
+      if (file.file != INVALID_HANDLE_VALUE)
+        CloseHandle(file.file);
+      file.file = INVALID_HANDLE_VALUE;
+#else
+      if (file.descriptor != -1)
+        close(file.descriptor);
+      file.descriptor = -1;
+#endif
+    }
+
+    /// @brief Opens a file, and reads its size
+    /// @param file The file
+    /// @param path The path of the file
+    /// @return True on success
+    bool Open(MappedFile& file, const char* path) noexcept
+    {
+#ifdef _WIN32
+      file.file = CreateFileA(path, file.writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+        FILE_SHARE_READ, nullptr, file.writable ? CREATE_ALWAYS : OPEN_EXISTING,
+        file.writable ? FILE_ATTRIBUTE_NORMAL : FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+      if (file.file == INVALID_HANDLE_VALUE)
+        return false;
+      LARGE_INTEGER size;
+      if (!GetFileSizeEx(file.file, &size))
+        return false;
+      file.size = static_cast<std::uint64_t>(size.QuadPart);
+#else
+      file.descriptor = file.writable
+        ? open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)
+        : open(path, O_RDONLY | O_CLOEXEC);
+      if (file.descriptor == -1)
+        return false;
+      struct stat status;
+      if (fstat(file.descriptor, &status) != 0)
+        return false;
+      file.size = static_cast<std::uint64_t>(status.st_size);
+#endif
+      return true;
+    }
+  }
+}
+
+using namespace colt::runtime;
+
+COLT_RUNTIME_EXPORT void* _ColtMmapRead(const char* path) noexcept
+{
+  auto file = new(std::nothrow) MappedFile();
+  if (file == nullptr)
+    return nullptr;
+  if (!Open(*file, path) || !Map(*file))
+  {
+    Close(*file);
+    delete file;
+    return nullptr;
+  }
+#ifndef _WIN32
+  //The mapping keeps a reference to the file
+  Close(*file);
+#endif
+  return file;
+}
+
+COLT_RUNTIME_EXPORT void* _ColtMmapWrite(const char* path, std::uint64_t size) noexcept
+{
+  auto file = new(std::nothrow) MappedFile();
+  if (file == nullptr)
+    return nullptr;
+  file->writable = true;
+  if (!Open(*file, path) || !Truncate(*file, size))
+  {
+    Close(*file);
+    delete file;
+    return nullptr;
+  }
+  file->size = size;
+  if (!Map(*file))
+  {
+    Close(*file);
+    delete file;
+    return nullptr;
+  }
+  return file;
+}
+
+COLT_RUNTIME_EXPORT std::uint8_t* _ColtMmapData(void* file) noexcept
+{
+  return static_cast<MappedFile*>(file)->data;
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtMmapSize(void* file) noexcept
+{
+  return static_cast<MappedFile*>(file)->size;
+}
+
+COLT_RUNTIME_EXPORT bool _ColtMmapResize(void* file, std::uint64_t size) noexcept
+{
+  auto& mapped = *static_cast<MappedFile*>(file);
+  if (!mapped.writable)
+    return false;
+  Unmap(mapped);
+  if (!Truncate(mapped, size))
+  {
+    //The file keeps its size: map it again
+    if (!Map(mapped))
+      mapped.size = 0;
+    return false;
+  }
+  mapped.size = size;
+  if (Map(mapped))
+    return true;
+  mapped.size = 0;
+  return false;
+}
+
+COLT_RUNTIME_EXPORT bool _ColtMmapSync(void* file) noexcept
+{
+  auto& mapped = *static_cast<MappedFile*>(file);
+  if (!mapped.writable)
+    return true;
+#ifdef _WIN32
+  if (mapped.data != nullptr && !FlushViewOfFile(mapped.data, 0))
+    return false;
+  return FlushFileBuffers(mapped.file) != 0;
+#else
+  if (mapped.data != nullptr && msync(mapped.data, mapped.size, MS_SYNC) != 0)
+    return false;
+  //Also writes the size of the file
+  return fsync(mapped.descriptor) == 0;
+#endif
+}
+
+COLT_RUNTIME_EXPORT void _ColtMmapClose(void* file) noexcept
+{
+  if (file == nullptr)
+    return;
+  auto mapped = static_cast<MappedFile*>(file);
+  Unmap(*mapped);
+  Close(*mapped);
+  delete mapped;
+}
@@ -0,0 +1,58 @@
+/** @file colt_mapped_file.h
+* Contains the memory-mapped files of the runtime.
+* Mapped files are opaque pointers ('PTR<void>'), whose bytes are read and written
+* through the pointer returned by '_ColtMmapData', without copies to or from a buffer.
+* - Files mapped for reading are advised to be read sequentially (and to use huge
+*   pages where supported), so that the kernel reads ahead of the accesses.
+* - Files mapped for writing are created (or truncated) with a fixed size, which can
+*   be changed using '_ColtMmapResize' (for example, to trim an output whose final size
+*   was not known). Modifications are written to the file by the operating system:
+*   '_ColtMmapSync' waits for them to reach the disk.
+* Empty files are mapped to a null pointer of size 0.
+*/
+
+#ifndef HG_COLT_MAPPED_FILE
+#define HG_COLT_MAPPED_FILE
+
+#include <cstdint>
+
+#include "colt_runtime.h"
+
+/// @brief Maps a file for reading
+/// @param path The path of the file (NUL-terminated)
+/// @return The mapped file, or nullptr if the file could not be opened or mapped (or if out of memory)
+COLT_RUNTIME_EXPORT void* _ColtMmapRead(const char* path) noexcept;
+
+/// @brief Creates (or truncates) a file of a given size, and maps it for writing
+/// @param path The path of the file (NUL-terminated)
+/// @param size The size of the file
+/// @return The mapped file, or nullptr if the file could not be created or mapped (or if out of memory)
+COLT_RUNTIME_EXPORT void* _ColtMmapWrite(const char* path, std::uint64_t size) noexcept;
+
+/// @brief Returns the bytes of a mapped file
+/// @param file The mapped file
+/// @return The bytes (nullptr if the file is empty)
+COLT_RUNTIME_EXPORT std::uint8_t* _ColtMmapData(void* file) noexcept;
+
+/// @brief Returns the size of a mapped file
+/// @param file The mapped file
+/// @return The size of the file
+COLT_RUNTIME_EXPORT std::uint64_t _ColtMmapSize(void* file) noexcept;
+
+/// @brief Changes the size of a file mapped for writing.
+/// The bytes are mapped at a new address: pointers to the old bytes are invalidated.
+/// @param file The mapped file
+/// @param size The new size of the file
+/// @return True on success, false if the file was mapped for reading or on errors
+COLT_RUNTIME_EXPORT bool _ColtMmapResize(void* file, std::uint64_t size) noexcept;
+
+/// @brief Waits for the modifications of a file mapped for writing to reach the disk
+/// @param file The mapped file
+/// @return True on success (always for files mapped for reading)
+COLT_RUNTIME_EXPORT bool _ColtMmapSync(void* file) noexcept;
+
+/// @brief Unmaps a file, and closes it
+/// @param file The mapped file (or nullptr)
+COLT_RUNTIME_EXPORT void _ColtMmapClose(void* file) noexcept;
+
+#endif //!HG_COLT_MAPPED_FILE
@@ -0,0 +1,29 @@
+/** @file colt_print.c
+* Contains the print helpers of the runtime, compiled to LLVM bitcode.
+* This file is not compiled with the compiler: it is compiled by clang to
+* bitcode, which is embedded in the compiler (see 'COLT RUNTIME BITCODE' in
+* CMakeLists.txt), and linked in each module before optimizations, so that the
+* helpers can be inlined in the generated code (see 'GenerateIR').
+* The helpers must print exactly as the native ones of 'main.cpp' (which
+* use {fmt}): helpers whose output cannot be reproduced using 'printf'
+* (such as floating points, printed using the shortest representation)
+* are only provided natively.
+*/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+void _ColtPrinti8(int8_t a)        { printf("%" PRId8, a); }
+void _ColtPrinti16(int16_t a)      { printf("%" PRId16, a); }
+void _ColtPrinti32(int32_t a)      { printf("%" PRId32, a); }
+void _ColtPrinti64(int64_t a)      { printf("%" PRId64, a); }
+void _ColtPrintu8(uint8_t a)       { printf("%" PRIu8, a); }
+void _ColtPrintu16(uint16_t a)     { printf("%" PRIu16, a); }
+void _ColtPrintu32(uint32_t a)     { printf("%" PRIu32, a); }
+void _ColtPrintu64(uint64_t a)     { printf("%" PRIu64, a); }
+void _ColtPrintbool(bool a)        { fputs(a ? "true" : "false", stdout); }
+void _ColtPrintchar(char a)        { putchar(a); }
+void _ColtPrintlstring(const char* a) { fputs(a, stdout); }
+void _ColtPrintPTR(const void* a)  { printf("0x%" PRIxPTR, (uintptr_t)a); }
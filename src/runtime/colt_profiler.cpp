@@ -0,0 +1,365 @@
+/** @file colt_profiler.cpp
+* Contains definition of functions declared in 'colt_profiler.h'.
+*/
+
+#include "colt_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #include <intrin.h>
+  /// @brief Defined if the time stamp counter can be read
+  #define COLT_PROFILER_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  /// @brief Defined if the time stamp counter can be read
+  #define COLT_PROFILER_TSC
+#endif
+
+namespace colt::runtime
+{
+  namespace
+  {
+    /// @brief Returns the current timestamp, in ticks
+    /// @return The time stamp counter, or nanoseconds if not available
+    inline std::uint64_t ReadTicks() noexcept
+    {
+#ifdef COLT_PROFILER_TSC
+      return __rdtsc();
+#else
+      return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /// @brief A node of the call tree
+    struct CallNode
+    {
+      /// @brief The last pointer passed to '_ColtProfEnter' for this function, or nullptr
+      const char* key;
+      /// @brief The name of the function (owned by the registry)
+      const char* name;
+      /// @brief The index of the caller node
+      std::uint32_t parent;
+      /// @brief The index of the first callee node, or 0
+      std::uint32_t first_child = 0;
+      /// @brief The index of the next node with the same caller, or 0
+      std::uint32_t next_sibling = 0;
+      /// @brief The number of calls that returned
+      std::uint64_t calls = 0;
+      /// @brief The ticks spent in the calls (including callees)
+      std::uint64_t total = 0;
+      /// @brief The ticks spent in the callees
+      std::uint64_t children = 0;
+    };
+
+    /// @brief A call that has not yet returned
+    struct Frame
+    {
+      /// @brief The index of the node of the call
+      std::uint32_t node;
+      /// @brief The ticks at which the call started
+      std::uint64_t start;
+    };
+
+    /// @brief The profile of a single thread
+    struct ThreadProfile
+    {
+      /// @brief The call tree, whose first node is the root (which is never called).
+      ///        Callees are always stored after their caller.
+      std::vector<CallNode> nodes = { CallNode{ nullptr, "<root>", 0 } };
+      /// @brief The calls that have not yet returned
+      std::vector<Frame> stack;
+      /// @brief The index of the node of the current call
+      std::uint32_t current = 0;
+      /// @brief True if the thread exited (protected by the lock of the registry).
+      ///        The profiles of running threads are not read, as they are not locked.
+      bool exited = false;
+    };
+
+    /// @brief Owns the profiles of all the threads
+    struct ProfileRegistry
+    {
+      /// @brief Protects 'profiles' and 'names'
+      std::mutex lock;
+      /// @brief The profiles of all the threads
+      std::vector<std::unique_ptr<ThreadProfile>> profiles;
+      /// @brief The names of the functions, which may outlive the code that passed them
+      std::unordered_set<std::string> names;
+      /// @brief The ticks at which profiling started
+      std::uint64_t start_ticks = ReadTicks();
+      /// @brief The time at which profiling started (to convert ticks to time)
+      std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    };
+
+    /// @brief Returns the global registry
+    /// @return The registry
+    ProfileRegistry& GetRegistry() noexcept
+    {
+      static ProfileRegistry registry;
+      return registry;
+    }
+
+    /// @brief Writes the profile to the files whose prefix is specified by 'COLT_PROFILE'
+    void WriteProfileAtExit() noexcept
+    {
+      const char* prefix = std::getenv("COLT_PROFILE");
+      std::string path = prefix != nullptr && *prefix != '\0' ? prefix : "colt_profile";
+      std::FILE* report = std::fopen((path + ".txt").c_str(), "w");
+      std::FILE* folded = std::fopen((path + ".folded").c_str(), "w");
+      if (report != nullptr && folded != nullptr)
+      {
+        WriteProfile(report, folded);
+        std::fprintf(stderr, "Profile written to '%s.txt' and '%s.folded'.\n", path.c_str(), path.c_str());
+      }
+      else
+        std::fprintf(stderr, "Could not write profile to '%s'!\n", path.c_str());
+      if (report != nullptr)
+        std::fclose(report);
+      if (folded != nullptr)
+        std::fclose(folded);
+    }
+
+    /// @brief Registers the profile of the current thread
+    /// @return The profile of the current thread
+    ThreadProfile* RegisterThread() noexcept
+    {
+      //Constructed before registering the exit handler, so destroyed after it runs
+      auto& registry = GetRegistry();
+      static std::once_flag at_exit;
+      std::call_once(at_exit, []() { std::atexit(&WriteProfileAtExit); });
+
+      std::scoped_lock guard{ registry.lock };
+      return registry.profiles.emplace_back(std::make_unique<ThreadProfile>()).get();
+    }
+
+    /// @brief Returns a copy of a name owned by the registry
+    /// @param name The name to copy
+    /// @return The copy
+    const char* InternName(const char* name) noexcept
+    {
+      auto& registry = GetRegistry();
+      std::scoped_lock guard{ registry.lock };
+      return registry.names.insert(name).first->c_str();
+    }
+
+    /// @brief The profile of the current thread, or nullptr if not yet registered.
+    ///        Profiles are owned by the registry, so that they outlive their threads.
+    thread_local ThreadProfile* local_profile = nullptr;
+
+    /// @brief Marks the profile of a thread as exited when the thread exits
+    struct ThreadExitMarker
+    {
+      /// @brief The profile to mark, or nullptr
+      ThreadProfile* profile = nullptr;
+
+      /// @brief Marks the profile as exited
+      ~ThreadExitMarker() noexcept
+      {
+        if (profile == nullptr)
+          return;
+        auto& registry = GetRegistry();
+        std::scoped_lock guard{ registry.lock };
+        profile->exited = true;
+      }
+    };
+
+    /// @brief Marks the profile of the current thread as exited (constructed on registration)
+    thread_local ThreadExitMarker exit_marker;
+
+    /// @brief Aggregated informations about a function
+    struct FunctionStats
+    {
+      /// @brief The name of the function
+      std::string_view name;
+      /// @brief The number of calls
+      std::uint64_t calls = 0;
+      /// @brief The ticks spent in the function only
+      std::uint64_t self = 0;
+      /// @brief The ticks spent in the function and its callees (recursion counted once)
+      std::uint64_t total = 0;
+    };
+
+    /// @brief Aggregates the call tree of a thread
+    /// @param profile The profile to aggregate
+    /// @param stats The per-function statistics to update
+    /// @param stacks The ticks spent in each stack (folded using ';')
+    void Aggregate(const ThreadProfile& profile, std::unordered_map<std::string_view, FunctionStats>& stats,
+      std::map<std::string, std::uint64_t>& stacks) noexcept
+    {
+      //Count of each function on the current path, to not count recursive calls twice
+      std::unordered_map<std::string_view, std::uint32_t> on_path;
+      std::string path;
+      //The size of 'path' before appending each node of the DFS stack
+      std::vector<std::pair<std::uint32_t, size_t>> dfs;
+
+      for (auto child = profile.nodes[0].first_child; child != 0; child = profile.nodes[child].next_sibling)
+        dfs.push_back({ child, 0 });
+      while (!dfs.empty())
+      {
+        auto [index, path_size] = dfs.back();
+        const CallNode& node = profile.nodes[index];
+        std::string_view name = node.name;
+        if (index == 0) //Marks the end of the callees of a node
+        {
+          dfs.pop_back();
+          auto it = on_path.find(profile.nodes[path_size].name);
+          if (--it->second == 0)
+            on_path.erase(it);
+          continue;
+        }
+        dfs.back() = { 0, index };
+
+        path.resize(path_size);
+        if (path_size != 0)
+          path += ';';
+        path += name;
+
+        std::uint64_t self = node.total - std::min(node.total, node.children);
+        auto& stat = stats[name];
+        stat.name = name;
+        stat.calls += node.calls;
+        stat.self += self;
+        if (on_path[name]++ == 0)
+          stat.total += node.total;
+        if (self != 0)
+          stacks[path] += self;
+
+        for (auto child = node.first_child; child != 0; child = profile.nodes[child].next_sibling)
+          dfs.push_back({ child, path.size() });
+      }
+    }
+  }
+
+  void ForgetProfileKeys() noexcept
+  {
+    auto& registry = GetRegistry();
+    std::scoped_lock guard{ registry.lock };
+    for (auto& profile : registry.profiles)
+      for (auto& node : profile->nodes)
+        node.key = nullptr;
+  }
+
+  void WriteProfile(std::FILE* report, std::FILE* folded) noexcept
+  {
+    auto& registry = GetRegistry();
+    std::scoped_lock guard{ registry.lock };
+
+    //Close the calls of the current thread that have not returned (through 'exit')
+    while (local_profile != nullptr && !local_profile->stack.empty())
+      _ColtProfExit();
+
+    auto elapsed_ticks = ReadTicks() - registry.start_ticks;
+    auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - registry.start_time).count();
+    double ns_per_tick = elapsed_ticks == 0 ? 1.0 : static_cast<double>(elapsed_ns) / static_cast<double>(elapsed_ticks);
+
+    std::unordered_map<std::string_view, FunctionStats> stats;
+    std::map<std::string, std::uint64_t> stacks;
+    std::uint64_t total_ticks = 0;
+    size_t thread_count = 0;
+    for (const auto& profile : registry.profiles)
+    {
+      //Running threads modify their call tree without locking
+      if (!profile->exited && profile.get() != local_profile)
+        continue;
+      ++thread_count;
+      Aggregate(*profile, stats, stacks);
+      for (auto child = profile->nodes[0].first_child; child != 0; child = profile->nodes[child].next_sibling)
+        total_ticks += profile->nodes[child].total;
+    }
+
+    std::vector<FunctionStats> sorted;
+    sorted.reserve(stats.size());
+    for (const auto& [name, stat] : stats)
+      sorted.push_back(stat);
+    std::sort(sorted.begin(), sorted.end(), [](const FunctionStats& a, const FunctionStats& b)
+      { return a.self > b.self || (a.self == b.self && a.name < b.name); });
+
+    auto to_ms = [=](std::uint64_t ticks) { return static_cast<double>(ticks) * ns_per_tick / 1e6; };
+    std::fprintf(report, "Colt profile: %zu thread(s), %.3f ms in instrumented functions\n",
+      thread_count, to_ms(total_ticks));
+    if (thread_count != registry.profiles.size())
+      std::fprintf(report, "%zu running thread(s) not included\n", registry.profiles.size() - thread_count);
+    std::fputc('\n', report);
+    std::fprintf(report, "%12s %8s %12s %12s  %s\n", "Self (ms)", "Self %", "Total (ms)", "Calls", "Function");
+    for (const auto& stat : sorted)
+    {
+      double percent = total_ticks == 0 ? 0.0 : 100.0 * static_cast<double>(stat.self) / static_cast<double>(total_ticks);
+      std::fprintf(report, "%12.3f %7.2f%% %12.3f %12" PRIu64 "  %.*s\n", to_ms(stat.self), percent,
+        to_ms(stat.total), stat.calls, static_cast<int>(stat.name.size()), stat.name.data());
+    }
+
+    for (const auto& [stack, ticks] : stacks)
+    {
+      auto us = static_cast<std::uint64_t>(static_cast<double>(ticks) * ns_per_tick / 1e3);
+      if (us != 0)
+        std::fprintf(folded, "%s %" PRIu64 "\n", stack.c_str(), us);
+    }
+  }
+}
+
+using namespace colt::runtime;
+
+COLT_RUNTIME_EXPORT void _ColtProfEnter(const char* name) noexcept
+{
+  if (local_profile == nullptr)
+  {
+    local_profile = RegisterThread();
+    exit_marker.profile = local_profile;
+  }
+  auto& profile = *local_profile;
+
+  //Names are unique constants of their module, so comparing pointers is enough
+  std::uint32_t node = profile.nodes[profile.current].first_child;
+  while (node != 0 && profile.nodes[node].key != name)
+    node = profile.nodes[node].next_sibling;
+  if (node == 0)
+  {
+    //The function may have been called from another module (or a forgotten one)
+    node = profile.nodes[profile.current].first_child;
+    while (node != 0 && std::strcmp(profile.nodes[node].name, name) != 0)
+      node = profile.nodes[node].next_sibling;
+    if (node != 0)
+      profile.nodes[node].key = name;
+  }
+  if (node == 0)
+  {
+    node = static_cast<std::uint32_t>(profile.nodes.size());
+    profile.nodes.push_back(CallNode{ name, InternName(name), profile.current,
+      0, profile.nodes[profile.current].first_child });
+    profile.nodes[profile.current].first_child = node;
+  }
+  profile.current = node;
+  profile.stack.push_back({ node, ReadTicks() });
+}
+
+COLT_RUNTIME_EXPORT void _ColtProfExit() noexcept
+{
+  auto end = ReadTicks();
+  if (local_profile == nullptr || local_profile->stack.empty())
+    return;
+  auto& profile = *local_profile;
+
+  Frame frame = profile.stack.back();
+  profile.stack.pop_back();
+  auto elapsed = end - frame.start;
+  auto& node = profile.nodes[frame.node];
+  node.calls += 1;
+  node.total += elapsed;
+  profile.nodes[node.parent].children += elapsed;
+  profile.current = node.parent;
+}
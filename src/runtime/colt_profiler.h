@@ -0,0 +1,44 @@
+/** @file colt_profiler.h
+* Contains the runtime of the function instrumentation profiler.
+* When compiling with '--instrument-functions', each function calls
+* '_ColtProfEnter' on entry and '_ColtProfExit' before returning.
+* The runtime only depends on the standard library, so that it can be linked
+* with object files produced by the compiler (see the 'colt-runtime' target).
+* At exit, a report sorted by self time and folded stacks (for flamegraphs)
+* are written to '<prefix>.txt' and '<prefix>.folded', where the prefix is the
+* value of the 'COLT_PROFILE' environment variable or 'colt_profile'.
+*/
+
+#ifndef HG_COLT_PROFILER
+#define HG_COLT_PROFILER
+
+#include <cstdio>
+
+#include "colt_runtime.h"
+
+/// @brief Called on entry of an instrumented function
+/// @param name The (demangled) name of the function, which must outlive the program
+COLT_RUNTIME_EXPORT void _ColtProfEnter(const char* name) noexcept;
+
+/// @brief Called before an instrumented function returns
+COLT_RUNTIME_EXPORT void _ColtProfExit() noexcept;
+
+/// @brief Contains the runtime used by compiled Colt code
+namespace colt::runtime
+{
+	/// @brief Forgets the names pointers passed to '_ColtProfEnter'.
+	/// Must be called when the code that passed them is freed (JIT), so that
+	/// a new name allocated at the same address is not confused with an old one.
+	/// No instrumented function may be running while calling this function.
+	void ForgetProfileKeys() noexcept;
+
+	/// @brief Writes the profile of the current thread, and of the threads that exited.
+	/// Threads that are still running are not included, as their profile is not locked.
+	/// Calls that have not yet returned on the current thread are closed first.
+	/// This function is registered through 'atexit' on the first call to '_ColtProfEnter'.
+	/// @param report The file in which to write the report sorted by self time
+	/// @param folded The file in which to write the folded stacks (in microseconds)
+	void WriteProfile(std::FILE* report, std::FILE* folded) noexcept;
+}
+
+#endif //!HG_COLT_PROFILER
@@ -0,0 +1,19 @@
+/** @file colt_runtime.h
+* Contains the macro through which the runtime exports the functions
+* called by compiled Colt code (see the 'colt-runtime' target).
+* Colt code calls these functions through extern declarations: the JIT
+* registers them as host functions (see 'RegisterHostFunctions').
+*/
+
+#ifndef HG_COLT_RUNTIME
+#define HG_COLT_RUNTIME
+
+#ifdef _WIN32
+	/// @brief Makes a runtime function available for JIT and linking
+	#define COLT_RUNTIME_EXPORT extern "C" __declspec(dllexport)
+#else
+	/// @brief Makes a runtime function available for JIT and linking
+	#define COLT_RUNTIME_EXPORT extern "C"
+#endif
+
+#endif //!HG_COLT_RUNTIME
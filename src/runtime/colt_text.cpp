@@ -0,0 +1,496 @@
+/** @file colt_text.cpp
+* Contains definition of functions declared in 'colt_text.h'.
+*/
+
+#include "colt_text.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  /// @brief Defined if blocks of text are classified using SSE2
+  #define COLT_TEXT_SSE2
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+  #include <immintrin.h>
+  /// @brief Defined if AVX2 functions can be compiled, and called if the processor supports them
+  #define COLT_TEXT_AVX2
+  /// @brief Compiles a function for processors supporting AVX2
+  #define COLT_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  /// @brief Defined if 8 digits are parsed at once (which requires little endian loads)
+  #define COLT_TEXT_SWAR_DIGITS
+#endif
+
+#ifdef _MSC_VER
+  #include <intrin.h>
+#endif
+
+namespace colt::runtime
+{
+  namespace
+  {
+    /// @brief The size of the blocks of text classified at once
+    constexpr std::uint64_t BLOCK_SIZE = 64;
+
+    /// @brief Returns the index of the lowest set bit of a non-zero value
+    /// @param value The value
+    /// @return The index of the lowest set bit
+    inline std::uint64_t CountTrailingZeros(std::uint64_t value) noexcept
+    {
+#ifdef _MSC_VER
+      unsigned long index;
+      _BitScanForward64(&index, value);
+      return index;
+#else
+      return static_cast<std::uint64_t>(__builtin_ctzll(value));
+#endif
+    }
+
+    /// @brief Returns the prefix XOR of the bits of a value: bit i of the result
+    ///        is the XOR of the bits [0, i] of the value
+    /// @param value The value
+    /// @return The prefix XOR
+    inline std::uint64_t PrefixXor(std::uint64_t value) noexcept
+    {
+      value ^= value << 1;
+      value ^= value << 2;
+      value ^= value << 4;
+      value ^= value << 8;
+      value ^= value << 16;
+      value ^= value << 32;
+      return value;
+    }
+
+    /// @brief The classification of a block of text: bit i is set for byte i
+    struct BlockMasks
+    {
+      /// @brief The separators
+      std::uint64_t separators;
+      /// @brief The quotes
+      std::uint64_t quotes;
+    };
+
+    /// @brief Classifies a block of text
+    /// @param block The block (of BLOCK_SIZE bytes)
+    /// @param first The first separator
+    /// @param second The second separator
+    /// @param quote The quote, or 0 if there is no quoting
+    /// @return The masks of the separators and quotes
+    inline BlockMasks Classify(const std::uint8_t* block, std::uint8_t first, std::uint8_t second, std::uint8_t quote) noexcept
+    {
+      BlockMasks masks = { 0, 0 };
+#ifdef COLT_TEXT_SSE2
+      const __m128i firsts = _mm_set1_epi8(static_cast<char>(first));
+      const __m128i seconds = _mm_set1_epi8(static_cast<char>(second));
+      const __m128i quotes = _mm_set1_epi8(static_cast<char>(quote));
+      for (std::uint64_t i = 0; i < BLOCK_SIZE; i += 16)
+      {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        __m128i separators = _mm_or_si128(_mm_cmpeq_epi8(bytes, firsts), _mm_cmpeq_epi8(bytes, seconds));
+        masks.separators |= static_cast<std::uint64_t>(_mm_movemask_epi8(separators)) << i;
+        if (quote != 0)
+          masks.quotes |= static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quotes))) << i;
+      }
+#else
+      for (std::uint64_t i = 0; i < BLOCK_SIZE; i++)
+      {
+        masks.separators |= static_cast<std::uint64_t>(block[i] == first || block[i] == second) << i;
+        if (quote != 0)
+          masks.quotes |= static_cast<std::uint64_t>(block[i] == quote) << i;
+      }
+#endif
+      return masks;
+    }
+
+    /// @brief The state of a search for separators
+    struct SeparatorScan
+    {
+      /// @brief The array to which to write the positions
+      std::uint64_t* positions;
+      /// @brief The capacity of the array
+      std::uint64_t capacity;
+      /// @brief The count of positions written
+      std::uint64_t count = 0;
+      /// @brief All bits set if the end of the last block was inside quotes
+      std::uint64_t inside_quotes = 0;
+      /// @brief True if the array is full
+      bool full = false;
+
+      /// @brief Writes the positions of the separators of a block that are not quoted
+      /// @param offset The offset of the block
+      /// @param masks The classification of the block
+      /// @return False if the array is full
+      bool add(std::uint64_t offset, BlockMasks masks) noexcept
+      {
+        //The quotes opening a quoted field are set, the quotes closing it are not
+        std::uint64_t inside = PrefixXor(masks.quotes) ^ inside_quotes;
+        inside_quotes = static_cast<std::uint64_t>(static_cast<std::int64_t>(inside) >> 63);
+        std::uint64_t separators = masks.separators & ~inside;
+        while (separators != 0)
+        {
+          if (count == capacity)
+            return !(full = true);
+          positions[count++] = offset + CountTrailingZeros(separators);
+          separators &= separators - 1;
+        }
+        return true;
+      }
+    };
+
+    /// @brief Searches the whole blocks of text for separators
+    /// @param data The text
+    /// @param size The size of the text
+    /// @param first The first separator
+    /// @param second The second separator
+    /// @param quote The quote, or 0 if there is no quoting
+    /// @param scan The state of the search
+    /// @return The offset of the first block not searched
+    std::uint64_t ScanBlocks(const std::uint8_t* data, std::uint64_t size, std::uint8_t first, std::uint8_t second, std::uint8_t quote, SeparatorScan& scan) noexcept
+    {
+      std::uint64_t offset = 0;
+      for (; offset + BLOCK_SIZE <= size; offset += BLOCK_SIZE)
+        if (!scan.add(offset, Classify(data + offset, first, second, quote)))
+          break;
+      return offset;
+    }
+
+#ifdef COLT_TEXT_AVX2
+    /// @brief Check if the processor supports AVX2
+    /// @return True if AVX2 functions can be called
+    bool HasAVX2() noexcept
+    {
+      static const bool has_avx2 = __builtin_cpu_supports("avx2");
+      return has_avx2;
+    }
+
+    /// @brief Classifies a block of text (see Classify)
+    COLT_TARGET_AVX2 inline BlockMasks ClassifyAVX2(const std::uint8_t* block, std::uint8_t first, std::uint8_t second, std::uint8_t quote) noexcept
+    {
+      const __m256i firsts = _mm256_set1_epi8(static_cast<char>(first));
+      const __m256i seconds = _mm256_set1_epi8(static_cast<char>(second));
+      __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+      __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+      auto low_separators = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(low, firsts), _mm256_cmpeq_epi8(low, seconds))));
+      auto high_separators = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(high, firsts), _mm256_cmpeq_epi8(high, seconds))));
+      BlockMasks masks = { low_separators | (static_cast<std::uint64_t>(high_separators) << 32), 0 };
+      if (quote != 0)
+      {
+        const __m256i quotes = _mm256_set1_epi8(static_cast<char>(quote));
+        auto low_quotes = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, quotes)));
+        auto high_quotes = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, quotes)));
+        masks.quotes = low_quotes | (static_cast<std::uint64_t>(high_quotes) << 32);
+      }
+      return masks;
+    }
+
+    /// @brief Searches the whole blocks of text for separators (see ScanBlocks)
+    COLT_TARGET_AVX2 std::uint64_t ScanBlocksAVX2(const std::uint8_t* data, std::uint64_t size, std::uint8_t first, std::uint8_t second, std::uint8_t quote, SeparatorScan& scan) noexcept
+    {
+      std::uint64_t offset = 0;
+      for (; offset + BLOCK_SIZE <= size; offset += BLOCK_SIZE)
+        if (!scan.add(offset, ClassifyAVX2(data + offset, first, second, quote)))
+          break;
+      return offset;
+    }
+#endif //COLT_TEXT_AVX2
+
+    /// @brief Finds the positions of the separators of text that are not quoted
+    /// @param data The text
+    /// @param size The size of the text
+    /// @param first The first separator
+    /// @param second The second separator
+    /// @param quote The quote, or 0 if there is no quoting
+    /// @param positions The array to which to write the positions
+    /// @param capacity The capacity of the array
+    /// @return The count of positions written
+    std::uint64_t FindSeparators(const std::uint8_t* data, std::uint64_t size, std::uint8_t first, std::uint8_t second,
+      std::uint8_t quote, std::uint64_t* positions, std::uint64_t capacity) noexcept
+    {
+      SeparatorScan scan = { positions, capacity };
+      std::uint64_t offset;
+#ifdef COLT_TEXT_AVX2
+      if (HasAVX2())
+        offset = ScanBlocksAVX2(data, size, first, second, quote, scan);
+      else
+#endif
+        offset = ScanBlocks(data, size, first, second, quote, scan);
+
+      //The last partial block is copied, so that no byte past the end is read
+      if (!scan.full && offset < size)
+      {
+        std::uint8_t block[BLOCK_SIZE] = {};
+        std::memcpy(block, data + offset, size - offset);
+        BlockMasks masks = Classify(block, first, second, quote);
+        std::uint64_t valid = (std::uint64_t(1) << (size - offset)) - 1;
+        scan.add(offset, { masks.separators & valid, masks.quotes & valid });
+      }
+      return scan.count;
+    }
+
+#ifdef COLT_TEXT_SWAR_DIGITS
+    /// @brief Loads 8 bytes
+    /// @param bytes The bytes
+    /// @return The bytes, the first in the low byte
+    inline std::uint64_t Load8(const std::uint8_t* bytes) noexcept
+    {
+      std::uint64_t value;
+      std::memcpy(&value, bytes, sizeof(value));
+      return value;
+    }
+
+    /// @brief Check if 8 bytes are all digits
+    /// @param bytes The bytes (see Load8)
+    /// @return True if all the bytes are in ['0', '9']
+    inline bool IsEightDigits(std::uint64_t bytes) noexcept
+    {
+      return (((bytes + 0x4646464646464646) | (bytes - 0x3030303030303030)) & 0x8080808080808080) == 0;
+    }
+
+    /// @brief Parses 8 digits
+    /// @param bytes The digits (see Load8)
+    /// @return The value of the digits
+    inline std::uint64_t ParseEightDigits(std::uint64_t bytes) noexcept
+    {
+      constexpr std::uint64_t MASK = 0x000000FF000000FF;
+      constexpr std::uint64_t MUL1 = 100 + (1000000ULL << 32);
+      constexpr std::uint64_t MUL2 = 1 + (10000ULL << 32);
+      bytes -= 0x3030303030303030;
+      //Each pair of digits, then each group of 4 digits, is combined
+      bytes = (bytes * 10) + (bytes >> 8);
+      return (((bytes & MASK) * MUL1) + (((bytes >> 16) & MASK) * MUL2)) >> 32;
+    }
+#endif
+
+    /// @brief Accumulates digits to a value (which wraps around on overflow)
+    /// @param begin The beginning of the digits
+    /// @param end The end of the text
+    /// @param value The value to which to accumulate
+    /// @return The end of the digits
+    inline const std::uint8_t* ParseDigits(const std::uint8_t* begin, const std::uint8_t* end, std::uint64_t& value) noexcept
+    {
+#ifdef COLT_TEXT_SWAR_DIGITS
+      while (end - begin >= 8 && IsEightDigits(Load8(begin)))
+      {
+        value = value * 100000000 + ParseEightDigits(Load8(begin));
+        begin += 8;
+      }
+#endif
+      while (begin != end && static_cast<unsigned>(*begin - '0') <= 9)
+        value = value * 10 + static_cast<unsigned>(*begin++ - '0');
+      return begin;
+    }
+
+    /// @brief Removes the trailing '\r' of a span
+    /// @param begin The beginning of the span
+    /// @param end The end of the span
+    /// @return The new end of the span
+    inline const std::uint8_t* TrimCarriageReturn(const std::uint8_t* begin, const std::uint8_t* end) noexcept
+    {
+      return begin != end && end[-1] == '\r' ? end - 1 : end;
+    }
+
+    /// @brief Parses a signed integer (see '_ColtParseI64')
+    /// @param begin The beginning of the integer
+    /// @param end The end of the integer
+    /// @param value The parsed integer
+    /// @return False if the bytes are not an integer
+    bool ParseInteger(const std::uint8_t* begin, const std::uint8_t* end, std::int64_t& value) noexcept
+    {
+      end = TrimCarriageReturn(begin, end);
+      bool negative = false;
+      if (begin != end && (*begin == '-' || *begin == '+'))
+        negative = *begin++ == '-';
+      if (begin == end)
+        return false;
+      //Leading zeros do not count as significant digits
+      while (begin != end - 1 && *begin == '0')
+        ++begin;
+      std::uint64_t magnitude = 0;
+      const std::uint8_t* digits_end = ParseDigits(begin, end, magnitude);
+      //19 digits cannot overflow a u64
+      if (digits_end != end || digits_end == begin || digits_end - begin > 19)
+        return false;
+      if (magnitude > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) + negative)
+        return false;
+      value = negative ? static_cast<std::int64_t>(0 - magnitude) : static_cast<std::int64_t>(magnitude);
+      return true;
+    }
+
+    /// @brief The powers of 10 that are exactly represented by a double
+    constexpr double EXACT_POWERS_OF_10[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    /// @brief Parses a float that is not computed exactly by 'ParseFloat',
+    ///        independently of the locale
+    /// @param begin The beginning of the float
+    /// @param end The end of the float
+    /// @param value The parsed float
+    /// @return False if the bytes are not a float, or if it is out of the range of a double
+    bool ParseFloatSlow(const std::uint8_t* begin, const std::uint8_t* end, double& value) noexcept
+    {
+      //As by the fast path, the sign is followed by the digits (or "inf", "nan"):
+      //leading whitespace, which 'strtod' would skip, is rejected
+      const char* first = reinterpret_cast<const char*>(begin);
+      const char* last = reinterpret_cast<const char*>(end);
+      bool negative = false;
+      if (first != last && (*first == '-' || *first == '+'))
+        negative = *first++ == '-';
+      if (first == last || *first == '-' || *first == '+' || std::isspace(static_cast<unsigned char>(*first)))
+        return false;
+
+#ifdef __cpp_lib_to_chars
+      //'from_chars' does not depend on the locale
+      auto [ptr, err] = std::from_chars(first, last, value);
+      if (err != std::errc{} || ptr != last)
+        return false;
+#else
+      //'strtod' requires a NUL-terminated string, and expects the decimal
+      //separator of the current locale
+      std::string text(first, last);
+      if (char separator = *std::localeconv()->decimal_point; separator != '.')
+      {
+        if (text.find(separator) != std::string::npos)
+          return false;
+        std::replace(text.begin(), text.end(), '.', separator);
+      }
+      char* parsed_end;
+      errno = 0;
+      value = std::strtod(text.c_str(), &parsed_end);
+      if (errno == ERANGE || parsed_end != text.c_str() + text.size())
+        return false;
+#endif
+      value = negative ? -value : value;
+      return true;
+    }
+
+    /// @brief Parses a float (see '_ColtParseF64')
+    /// @param begin The beginning of the float
+    /// @param end The end of the float
+    /// @param value The parsed float
+    /// @return False if the bytes are not a float
+    bool ParseFloat(const std::uint8_t* begin, const std::uint8_t* end, double& value) noexcept
+    {
+      end = TrimCarriageReturn(begin, end);
+      const std::uint8_t* current = begin;
+      bool negative = false;
+      if (current != end && (*current == '-' || *current == '+'))
+        negative = *current++ == '-';
+
+      std::uint64_t mantissa = 0;
+      const std::uint8_t* integer = current;
+      current = ParseDigits(current, end, mantissa);
+      std::int64_t digits = current - integer;
+      std::int64_t exponent = 0;
+      if (current != end && *current == '.')
+      {
+        const std::uint8_t* fraction = ++current;
+        current = ParseDigits(current, end, mantissa);
+        exponent = -(current - fraction);
+        digits += current - fraction;
+      }
+      //"inf", "nan"...
+      if (digits == 0)
+        return ParseFloatSlow(begin, end, value);
+
+      if (current != end && (*current == 'e' || *current == 'E'))
+      {
+        bool negative_exponent = false;
+        if (++current != end && (*current == '-' || *current == '+'))
+          negative_exponent = *current++ == '-';
+        const std::uint8_t* exponent_digits = current;
+        std::int64_t explicit_exponent = 0;
+        for (; current != end && static_cast<unsigned>(*current - '0') <= 9; ++current)
+          if (explicit_exponent < 100000)
+            explicit_exponent = explicit_exponent * 10 + (*current - '0');
+        if (current == exponent_digits)
+          return false;
+        exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+      }
+      if (current != end)
+        return false;
+
+      //The mantissa and the power of 10 are exact: the result of a single
+      //multiplication or division is correctly rounded
+      if (digits <= 19 && mantissa <= (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+      {
+        value = static_cast<double>(mantissa);
+        value = exponent < 0 ? value / EXACT_POWERS_OF_10[-exponent] : value * EXACT_POWERS_OF_10[exponent];
+        value = negative ? -value : value;
+        return true;
+      }
+      return ParseFloatSlow(begin, end, value);
+    }
+  }
+}
+
+using namespace colt::runtime;
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtFindByte(const std::uint8_t* data, std::uint64_t size, std::uint8_t byte, std::uint64_t* positions, std::uint64_t capacity) noexcept
+{
+  return FindSeparators(data, size, byte, byte, 0, positions, capacity);
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtFindSeparators(const std::uint8_t* data, std::uint64_t size, std::uint8_t delimiter, std::uint8_t quote, std::uint64_t* positions, std::uint64_t capacity) noexcept
+{
+  return FindSeparators(data, size, delimiter, '\n', quote, positions, capacity);
+}
+
+COLT_RUNTIME_EXPORT bool _ColtParseI64(const std::uint8_t* data, std::uint64_t size, std::int64_t* value) noexcept
+{
+  return ParseInteger(data, data + size, *value);
+}
+
+COLT_RUNTIME_EXPORT bool _ColtParseF64(const std::uint8_t* data, std::uint64_t size, double* value) noexcept
+{
+  return ParseFloat(data, data + size, *value);
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtParseI64Fields(const std::uint8_t* data, std::uint64_t start, const std::uint64_t* separators, std::uint64_t count, std::int64_t* values) noexcept
+{
+  std::uint64_t invalid = 0;
+  for (std::uint64_t i = 0; i < count; i++)
+  {
+    std::int64_t value;
+    if (!ParseInteger(data + start, data + separators[i], value))
+    {
+      value = 0;
+      ++invalid;
+    }
+    values[i] = value;
+    start = separators[i] + 1;
+  }
+  return invalid;
+}
+
+COLT_RUNTIME_EXPORT std::uint64_t _ColtParseF64Fields(const std::uint8_t* data, std::uint64_t start, const std::uint64_t* separators, std::uint64_t count, double* values) noexcept
+{
+  std::uint64_t invalid = 0;
+  for (std::uint64_t i = 0; i < count; i++)
+  {
+    double value;
+    if (!ParseFloat(data + start, data + separators[i], value))
+    {
+      value = std::numeric_limits<double>::quiet_NaN();
+      ++invalid;
+    }
+    values[i] = value;
+    start = separators[i] + 1;
+  }
+  return invalid;
+}
@@ -0,0 +1,83 @@
+/** @file colt_text.h
+* Contains the text ingestion routines of the runtime.
+* They split text (CSV, TSV or lines of logs, usually mapped using '_ColtMmapRead')
+* in bulk, writing the positions of the separators to an array of 'u64':
+* ```
+* var count = _ColtFindSeparators(data, size, ',' as u8, '"' as u8, positions, capacity);
+* //Field i spans [positions[i - 1] + 1, positions[i]) (from 0 for the first field)
+* ```
+* If the array is full, the functions return early: the search can be resumed
+* after the last position found.
+* Text is classified 64 bytes at a time, using AVX2 if the processor supports it,
+* SSE2 otherwise (or byte by byte on other processors).
+* Quoted fields are found without branches: the prefix XOR of the mask of quotes
+* is the mask of the bytes inside quotes.
+*
+* Numbers are parsed from spans of bytes (8 digits at once using 64-bit arithmetic).
+* A trailing '\r' (of lines ending with "\r\n") is ignored. Floats whose mantissa
+* fits in 53 bits, and whose exponent is small, are computed exactly using a
+* single multiplication or division: others are parsed by 'std::from_chars'.
+*/
+
+#ifndef HG_COLT_TEXT
+#define HG_COLT_TEXT
+
+#include <cstdint>
+
+#include "colt_runtime.h"
+
+/// @brief Finds the positions of a byte in text
+/// @param data The text
+/// @param size The size of the text
+/// @param byte The byte to search for (usually '\n')
+/// @param positions The array to which to write the positions of the byte
+/// @param capacity The capacity of the array
+/// @return The count of positions written (less than capacity only if the text was searched entirely)
+COLT_RUNTIME_EXPORT std::uint64_t _ColtFindByte(const std::uint8_t* data, std::uint64_t size, std::uint8_t byte, std::uint64_t* positions, std::uint64_t capacity) noexcept;
+
+/// @brief Finds the positions of the delimiters and new lines ('\n') of text, that
+///        are not quoted. The text must not begin inside quotes.
+/// @param data The text
+/// @param size The size of the text
+/// @param delimiter The delimiter of fields (usually ',' or '\t')
+/// @param quote The quote (usually '"'), or 0 if fields are not quoted
+/// @param positions The array to which to write the positions of the separators
+/// @param capacity The capacity of the array
+/// @return The count of positions written (less than capacity only if the text was searched entirely)
+COLT_RUNTIME_EXPORT std::uint64_t _ColtFindSeparators(const std::uint8_t* data, std::uint64_t size, std::uint8_t delimiter, std::uint8_t quote, std::uint64_t* positions, std::uint64_t capacity) noexcept;
+
+/// @brief Parses a signed decimal integer (with an optional sign)
+/// @param data The bytes of the integer
+/// @param size The count of bytes
+/// @param value The parsed integer
+/// @return False if the bytes are not an integer, or if it does not fit in an 'i64'
+COLT_RUNTIME_EXPORT bool _ColtParseI64(const std::uint8_t* data, std::uint64_t size, std::int64_t* value) noexcept;
+
+/// @brief Parses a float (with an optional sign, fraction and exponent)
+/// @param data The bytes of the float
+/// @param size The count of bytes
+/// @param value The parsed float
+/// @return False if the bytes are not a float (leading whitespace is rejected), or if it is out of the range of a 'f64'
+COLT_RUNTIME_EXPORT bool _ColtParseF64(const std::uint8_t* data, std::uint64_t size, double* value) noexcept;
+
+/// @brief Parses the integers of consecutive fields, delimited by separators
+///        (found by '_ColtFindSeparators'). Invalid integers are replaced by 0.
+/// @param data The text
+/// @param start The position of the first field
+/// @param separators The positions of the separators ending each field
+/// @param count The count of fields
+/// @param values The array to which to write the integers
+/// @return The count of invalid integers
+COLT_RUNTIME_EXPORT std::uint64_t _ColtParseI64Fields(const std::uint8_t* data, std::uint64_t start, const std::uint64_t* separators, std::uint64_t count, std::int64_t* values) noexcept;
+
+/// @brief Parses the floats of consecutive fields, delimited by separators
+///        (found by '_ColtFindSeparators'). Invalid floats are replaced by NaN.
+/// @param data The text
+/// @param start The position of the first field
+/// @param separators The positions of the separators ending each field
+/// @param count The count of fields
+/// @param values The array to which to write the floats
+/// @return The count of invalid floats
+COLT_RUNTIME_EXPORT std::uint64_t _ColtParseF64Fields(const std::uint8_t* data, std::uint64_t start, const std::uint64_t* separators, std::uint64_t count, double* values) noexcept;
+
+#endif //!HG_COLT_TEXT
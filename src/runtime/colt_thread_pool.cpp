@@ -0,0 +1,164 @@
+/** @file colt_thread_pool.cpp
+* Contains definition of functions declared in 'colt_thread_pool.h'.
+*/
+
+#include "colt_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace colt::runtime
+{
+  namespace
+  {
+    /// @brief Threads waiting for tasks
+    class ThreadPool
+    {
+      /// @brief Protects 'tasks' and 'stop'
+      std::mutex lock;
+      /// @brief Notified when a task is submitted, or when stopping
+      std::condition_variable wake;
+      /// @brief The tasks that were not started
+      std::deque<std::function<void()>> tasks;
+      /// @brief True if the threads must exit once the tasks are done
+      bool stop = false;
+      /// @brief The threads
+      std::vector<std::thread> threads;
+
+      /// @brief Runs tasks until the pool is stopped
+      void run() noexcept
+      {
+        for (;;)
+        {
+          std::function<void()> task;
+          {
+            std::unique_lock guard{ lock };
+            wake.wait(guard, [this]() { return stop || !tasks.empty(); });
+            if (tasks.empty())
+              return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+          }
+          task();
+        }
+      }
+
+    public:
+      /// @brief Starts the threads
+      ThreadPool() noexcept
+      {
+        unsigned hardware = std::max(std::thread::hardware_concurrency(), 1u);
+        for (unsigned i = 1; i < hardware; i++)
+          threads.emplace_back([this]() { run(); });
+      }
+
+      /// @brief Runs the remaining tasks and joins the threads
+      ~ThreadPool() noexcept
+      {
+        {
+          std::scoped_lock guard{ lock };
+          stop = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads)
+          thread.join();
+      }
+
+      /// @brief Returns the number of threads
+      /// @return The number of threads
+      std::uint32_t size() const noexcept { return static_cast<std::uint32_t>(threads.size()); }
+
+      /// @brief Adds a task, run by the first available thread
+      /// @param task The task
+      void submit(std::function<void()> task) noexcept
+      {
+        {
+          std::scoped_lock guard{ lock };
+          tasks.push_back(std::move(task));
+        }
+        wake.notify_one();
+      }
+    };
+
+    /// @brief Returns the thread pool, starting it on the first call
+    /// @return The thread pool
+    ThreadPool& GetPool() noexcept
+    {
+      static ThreadPool pool;
+      return pool;
+    }
+
+    /// @brief The state of a call to ParallelFor, shared with the tasks of the pool
+    ///        (which may start after the call returned)
+    struct ParallelForState
+    {
+      /// @brief The task
+      void(*task)(void*, std::uint64_t);
+      /// @brief The context of the task
+      void* context;
+      /// @brief The number of indices
+      std::uint64_t count;
+      /// @brief The next index to run
+      std::atomic<std::uint64_t> next = 0;
+      /// @brief The number of indices that were run
+      std::atomic<std::uint64_t> done = 0;
+      /// @brief Protects 'finished'
+      std::mutex lock;
+      /// @brief Notified once all the indices were run
+      std::condition_variable finished;
+
+      /// @brief Runs indices until all of them were started
+      void run() noexcept
+      {
+        for (std::uint64_t index = next++; index < count; index = next++)
+        {
+          task(context, index);
+          if (++done == count)
+          {
+            std::scoped_lock guard{ lock };
+            finished.notify_all();
+          }
+        }
+      }
+    };
+  }
+
+  std::uint32_t ThreadCount() noexcept
+  {
+    return GetPool().size() + 1;
+  }
+
+  void SubmitTask(std::function<void()> task) noexcept
+  {
+    GetPool().submit(std::move(task));
+  }
+
+  void ParallelFor(std::uint64_t count, void(*task)(void*, std::uint64_t), void* context) noexcept
+  {
+    if (count == 0)
+      return;
+    if (count == 1)
+      return task(context, 0);
+
+    auto state = std::make_shared<ParallelForState>();
+    state->task = task;
+    state->context = context;
+    state->count = count;
+
+    auto& pool = GetPool();
+    std::uint64_t helpers = std::min<std::uint64_t>(count - 1, pool.size());
+    for (std::uint64_t i = 0; i < helpers; i++)
+      pool.submit([state]() { state->run(); });
+    state->run();
+
+    //Indices started by the pool may still be running
+    std::unique_lock guard{ state->lock };
+    state->finished.wait(guard, [&]() { return state->done == count; });
+  }
+}
@@ -0,0 +1,45 @@
+/** @file colt_thread_pool.h
+* Contains the thread pool of the runtime, used by the parallel algorithms.
+* The threads (one less than the hardware threads, as callers also work)
+* are started on the first use of the pool, and joined at exit.
+*/
+
+#ifndef HG_COLT_THREAD_POOL
+#define HG_COLT_THREAD_POOL
+
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+namespace colt::runtime
+{
+	/// @brief Returns the number of threads that run parallel tasks, including the caller
+	/// @return The number of threads of the pool plus 1
+	std::uint32_t ThreadCount() noexcept;
+
+	/// @brief Runs a task on a thread of the pool
+	/// @param task The task to run
+	void SubmitTask(std::function<void()> task) noexcept;
+
+	/// @brief Calls 'task(context, i)' for each 'i' in [0, count), on the threads of the pool
+	///        and on the calling thread, returning once all the calls returned.
+	/// Can be called from a task of the pool: the calling thread runs the indices
+	/// that no thread of the pool is available for.
+	/// @param count The number of indices
+	/// @param task The task
+	/// @param context The context passed to the task
+	void ParallelFor(std::uint64_t count, void(*task)(void*, std::uint64_t), void* context) noexcept;
+
+	/// @brief Calls 'fn(i)' for each 'i' in [0, count) (see ParallelFor)
+	/// @tparam Fn The type of the function
+	/// @param count The number of indices
+	/// @param fn The function
+	template<typename Fn>
+	void ParallelFor(std::uint64_t count, Fn&& fn) noexcept
+	{
+		ParallelFor(count, [](void* context, std::uint64_t index)
+			{ (*static_cast<std::remove_reference_t<Fn>*>(context))(index); }, &fn);
+	}
+}
+
+#endif //!HG_COLT_THREAD_POOL
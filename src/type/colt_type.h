@@ -628,6 +628,8 @@ namespace colt::lang
       T fn = nullptr;
       return details::from_cpp_equivalent_fn(fn, ctx);
     }
+    else if constexpr (std::is_same_v<std::decay_t<T>, const char*>)
+      return BuiltInType::CreateLString(ctx);
     else if constexpr (std::is_pointer_v<T>)
       return PtrType::CreatePtr(std::is_const_v<T>, from_cpp_equivalent<std::remove_pointer_t<T>>(ctx), ctx);
     else if constexpr (std::is_void_v<T>)
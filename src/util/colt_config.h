@@ -0,0 +1,45 @@
+#ifndef COLT_CONFIG
+#define COLT_CONFIG
+
+/// @brief Major version of Colt
+#define COLT_VERSION_MAJOR 		0
+/// @brief Minor version of Colt
+#define COLT_VERSION_MINOR 		0
+/// @brief Patch version of Colt
+#define COLT_VERSION_PATCH 		11
+/// @brief Tweak version of Colt
+#define COLT_VERSION_TWEAK 		0
+/// @brief The project version as a string
+#define COLT_VERSION_STRING 	"0.0.11.0"
+
+#define COLT_OS_STRING			"Linux"
+
+#ifdef COLT_DEBUG_BUILD
+	#define COLT_CONFIG_STRING		"Debug"
+#else
+	#define COLT_CONFIG_STRING		"Release"
+#endif
+
+//Determine the current operating system
+#if 0 == 1
+	#define COLT_WINDOWS
+#elif 0 == 1
+	#define COLT_APPLE
+#elif 1 == 1
+	#define COLT_LINUX
+#else
+	#error "Unsupported platform!"
+#endif
+
+//Determine the current compiler
+#if 0 == 1
+	#define COLT_CLANG
+#elif 1 == 1
+	#define COLT_GNU
+#elif 0 == 1
+	#define COLT_INTEL
+#elif 0 == 1
+	#define COLT_MSVC
+#endif
+
+#endif //COLT_CONFIG